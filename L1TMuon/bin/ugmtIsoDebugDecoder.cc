@@ -0,0 +1,35 @@
+// Prints the iso debug file written by the L1TMuonProducer (isoDebugFileName parameter)
+// in the old iso_debug.dat text format: "<hwCaloPhi> <hwCaloEta>" per output muon.
+//
+// ugmtIsoDebugDecoder <iso_debug.bin> [iso_debug.dat]
+// without the second argument the text is written to the standard output.
+
+#include "L1Trigger/L1TMuon/interface/MicroGMTIsoDebugWriter.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char** argv) {
+  if (argc != 2 && argc != 3) {
+    std::cerr << "usage:\n" << argv[0] << " <iso_debug.bin> [iso_debug.dat]" << std::endl;
+    return 2;
+  }
+
+  try {
+    if (argc == 3) {
+      std::ofstream outFile(argv[2]);
+      if (!outFile.good()) {
+        std::cerr << "ugmtIsoDebugDecoder: cannot open " << argv[2] << std::endl;
+        return 1;
+      }
+      l1t::MicroGMTIsoDebugWriter::decodeToText(argv[1], outFile);
+    } else {
+      l1t::MicroGMTIsoDebugWriter::decodeToText(argv[1], std::cout);
+    }
+  } catch (cms::Exception& e) {
+    std::cerr << "ugmtIsoDebugDecoder: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
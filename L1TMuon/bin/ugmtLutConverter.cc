@@ -0,0 +1,56 @@
+// Converts a uGMT LUT file between the text format and the binary format of the MicroGMTLUT.
+// That both formats give the same LUT is checked by the testMicroGMTLUT.
+//
+// ugmtLutConverter <input LUT> <output LUT> [text|binary]
+// without the third argument a text input is converted to the binary format and a binary input to the text format.
+
+#include "L1Trigger/L1TMuon/interface/MicroGMTLUT.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <fstream>
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+  if (argc != 3 && argc != 4) {
+    std::cerr << "usage:\n" << argv[0] << " <input LUT> <output LUT> [text|binary]" << std::endl;
+    return 2;
+  }
+
+  try {
+    bool toBinary = !l1t::MicroGMTLUT::isBinaryFile(argv[1]);
+    if (argc == 4) {
+      std::string format = argv[3];
+      if (format != "text" && format != "binary") {
+        std::cerr << "ugmtLutConverter: unknown output format " << format << std::endl;
+        return 2;
+      }
+      toBinary = format == "binary";
+    }
+
+    l1t::MicroGMTLUT inLUT;
+    int readCode = inLUT.loadFile(argv[1]);
+    if (readCode != l1t::LUT::SUCCESS) {
+      std::cerr << "ugmtLutConverter: reading " << argv[1] << " returned " << readCode << std::endl;
+      return 1;
+    }
+
+    std::ofstream outFile(argv[2], std::ios::out | std::ios::binary);
+    if (!outFile.good()) {
+      std::cerr << "ugmtLutConverter: cannot open " << argv[2] << std::endl;
+      return 1;
+    }
+    if (toBinary) {
+      inLUT.saveBinary(outFile);
+    } else {
+      inLUT.save(outFile);
+    }
+
+    std::cout << argv[1] << " -> " << argv[2] << " (" << (toBinary ? "binary" : "text") << "), "
+              << (inLUT.empty() ? 0u : (1u << inLUT.nrBitsAddress())) << " addresses" << std::endl;
+  } catch (cms::Exception& e) {
+    std::cerr << "ugmtLutConverter: " << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
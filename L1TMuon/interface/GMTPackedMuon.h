@@ -0,0 +1,139 @@
+#ifndef __l1t_gmt_packed_muon_h__
+#define __l1t_gmt_packed_muon_h__
+
+#include "DataFormats/L1TMuon/interface/RegionalMuonCand.h"
+
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+namespace l1t {
+  /// The uGMT internal muon as a fixed-size POD record, the alternative to the GMTInternalMuon.
+  /// The quantities of the RegionalMuonCand used by the uGMT (including the track address sub-addresses needed
+  /// by the cancel-out) and the ones computed by the uGMT stages are bit-packed into three 64-bit words,
+  /// so the record does not refer to the input collection and is copied by value.
+  /// The widths of the fields cover the hardware widths of the quantities (e.g. 9 bits for the pT,
+  /// 9 bits signed for the eta), the larger values would be truncated.
+  class GMTPackedMuon {
+  public:
+    /// number of the track address sub-addresses kept, the bmtfAddress and emtfAddress keys 0-7
+    /// (wheel side, wheel number and the stations for the BMTF, the segments and chambers of ME1-ME4 for the EMTF)
+    static constexpr unsigned kTrackAddressSize = 8;
+
+    /// sets the input quantities from the regional muon and resets the ones computed by the uGMT stages
+    void set(const RegionalMuonCand& regional, int globalPhi, int tfMuonIndex);
+
+    // the input quantities
+    int hwPt() const { return getUnsigned(m_input, kPtPos, kPtBits); }
+    int hwPtUnconstrained() const { return getUnsigned(m_input, kPtUnconstrainedPos, kPtUnconstrainedBits); }
+    int hwEta() const { return getSigned(m_input, kEtaPos, kEtaBits); }
+    int hwGlobalPhi() const { return getUnsigned(m_input, kGlobalPhiPos, kGlobalPhiBits); }
+    int hwQual() const { return getUnsigned(m_input, kQualPos, kQualBits); }
+    int hwSign() const { return getUnsigned(m_input, kSignPos, 1); }
+    int hwSignValid() const { return getUnsigned(m_input, kSignValidPos, 1); }
+    int hwHF() const { return getUnsigned(m_input, kHFPos, 1); }
+    int hwDXY() const { return getUnsigned(m_input, kDXYPos, kDXYBits); }
+    tftype trackFinderType() const { return static_cast<tftype>(getUnsigned(m_input, kTfTypePos, kTfTypeBits)); }
+    int processor() const { return getUnsigned(m_input, kProcessorPos, kProcessorBits); }
+    int tfMuonIndex() const { return getSigned(m_input, kTfMuonIndexPos, kTfMuonIndexBits); }
+    /// the track address sub-address with the given key (0 if not present in the regional muon)
+    int trackAddress(unsigned key) const { return getSigned(m_trackAddress, key * 8, 8); }
+
+    // the quantities computed by the uGMT stages
+    int hwRank() const { return getUnsigned(m_state, kRankPos, kRankBits); }
+    int hwCancelBit() const { return getUnsigned(m_state, kCancelBitPos, 1); }
+    int hwDEta() const { return getSigned(m_state, kDEtaPos, kDeltaBits); }
+    int hwDPhi() const { return getSigned(m_state, kDPhiPos, kDeltaBits); }
+    int hwIsoSum() const { return getUnsigned(m_state, kIsoSumPos, kIsoSumBits); }
+    int hwAbsIso() const { return getSigned(m_state, kAbsIsoPos, 2); }
+    int hwRelIso() const { return getSigned(m_state, kRelIsoPos, 2); }
+    int hwCaloEta() const { return getUnsigned(m_state, kCaloEtaPos, kCaloIndexBits); }
+    int hwCaloPhi() const { return getUnsigned(m_state, kCaloPhiPos, kCaloIndexBits); }
+
+    void setHwRank(int rank) { setField(m_state, kRankPos, kRankBits, rank); }
+    void setHwCancelBit(int bit) { setField(m_state, kCancelBitPos, 1, bit); }
+    void setExtrapolation(int deta, int dphi) {
+      setField(m_state, kDEtaPos, kDeltaBits, deta);
+      setField(m_state, kDPhiPos, kDeltaBits, dphi);
+    }
+    void setHwIsoSum(int isosum) { setField(m_state, kIsoSumPos, kIsoSumBits, isosum); }
+    void setHwAbsIso(int iso) { setField(m_state, kAbsIsoPos, 2, iso); }
+    void setHwRelIso(int iso) { setField(m_state, kRelIsoPos, 2, iso); }
+    void setHwCaloEta(int idx) { setField(m_state, kCaloEtaPos, kCaloIndexBits, idx); }
+    void setHwCaloPhi(int idx) { setField(m_state, kCaloPhiPos, kCaloIndexBits, idx); }
+
+  private:
+    // m_input layout
+    static const unsigned kPtPos = 0, kPtBits = 9;
+    static const unsigned kPtUnconstrainedPos = 9, kPtUnconstrainedBits = 8;
+    static const unsigned kEtaPos = 17, kEtaBits = 9;
+    static const unsigned kGlobalPhiPos = 26, kGlobalPhiBits = 10;
+    static const unsigned kQualPos = 36, kQualBits = 4;
+    static const unsigned kSignPos = 40;
+    static const unsigned kSignValidPos = 41;
+    static const unsigned kHFPos = 42;
+    static const unsigned kDXYPos = 43, kDXYBits = 2;
+    static const unsigned kTfTypePos = 45, kTfTypeBits = 3;
+    static const unsigned kProcessorPos = 48, kProcessorBits = 4;
+    static const unsigned kTfMuonIndexPos = 52, kTfMuonIndexBits = 8;
+
+    // m_state layout
+    static const unsigned kRankPos = 0, kRankBits = 10;
+    static const unsigned kCancelBitPos = 10;
+    static const unsigned kDEtaPos = 11, kDPhiPos = 21, kDeltaBits = 10;
+    static const unsigned kIsoSumPos = 31, kIsoSumBits = 8;
+    static const unsigned kAbsIsoPos = 39;
+    static const unsigned kRelIsoPos = 41;
+    static const unsigned kCaloEtaPos = 43, kCaloPhiPos = 50, kCaloIndexBits = 7;
+
+    static int getUnsigned(uint64_t word, unsigned pos, unsigned bits) {
+      return static_cast<int>((word >> pos) & ((uint64_t(1) << bits) - 1));
+    }
+
+    static int getSigned(uint64_t word, unsigned pos, unsigned bits) {
+      int value = getUnsigned(word, pos, bits);
+      return value >= (1 << (bits - 1)) ? value - (1 << bits) : value;
+    }
+
+    static void setField(uint64_t& word, unsigned pos, unsigned bits, int value) {
+      uint64_t mask = ((uint64_t(1) << bits) - 1) << pos;
+      word = (word & ~mask) | ((static_cast<uint64_t>(value) << pos) & mask);
+    }
+
+    uint64_t m_input;
+    // the kTrackAddressSize sub-addresses, 8 bits signed each
+    uint64_t m_trackAddress;
+    uint64_t m_state;
+  };
+
+  static_assert(std::is_trivial<GMTPackedMuon>::value, "GMTPackedMuon must be a POD");
+
+  /// All uGMT input muons of one BX. The stages refer to them by the index (GMTPackedMuonList),
+  /// the muons are never moved or copied after the conversion of the inputs.
+  struct GMTPackedMuons {
+    /// 36 track finder links x 3 muons
+    static constexpr unsigned kMaxMuons = 108;
+
+    std::array<GMTPackedMuon, kMaxMuons> muons;
+    unsigned size = 0;
+
+    GMTPackedMuon& operator[](unsigned index) { return muons[index]; }
+    const GMTPackedMuon& operator[](unsigned index) const { return muons[index]; }
+  };
+
+  /// Ordered list of the indices of the muons in the GMTPackedMuons, the counterpart of the GMTInternalMuonList.
+  /// The wedges are not kept separately, the muons of a wedge are the ones of the list with the given processor.
+  struct GMTPackedMuonList {
+    std::array<uint8_t, GMTPackedMuons::kMaxMuons> indices;
+    unsigned size = 0;
+
+    void push_back(unsigned index) { indices[size++] = index; }
+    void clear() { size = 0; }
+    bool empty() const { return size == 0; }
+    unsigned operator[](unsigned i) const { return indices[i]; }
+    const uint8_t* begin() const { return indices.data(); }
+    const uint8_t* end() const { return indices.data() + size; }
+  };
+}  // namespace l1t
+
+#endif /* define __l1t_gmt_packed_muon_h__ */
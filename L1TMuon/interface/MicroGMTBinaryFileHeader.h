@@ -0,0 +1,36 @@
+#ifndef __l1microgmtbinaryfileheader_h
+#define __l1microgmtbinaryfileheader_h
+
+#include <cstdint>
+#include <string>
+
+namespace l1t {
+  /*
+   * The beginning of the binary files of the uGMT (MicroGMTLUT::saveBinary, MicroGMTIsoDebugWriter):
+   * the magic identifying the type of the file, the version of its layout and the byteOrderMark.
+   * The files are written in the native byte order, the byteOrderMark of a file written on a machine
+   * with the other byte order is different than the nativeByteOrderMark.
+   */
+  struct MicroGMTBinaryFileHeader {
+    typedef char Magic[8];
+
+    static constexpr uint32_t nativeByteOrderMark = 0x01020304;
+
+    Magic magic;
+    uint32_t version;
+    uint32_t byteOrderMark;
+
+    // the header of the file with the given magic and version
+    static MicroGMTBinaryFileHeader make(const Magic& magic, uint32_t version);
+
+    bool hasMagic(const Magic& magic) const;
+
+    // throws cms::Exception if the file has the other byte order or version
+    void checkVersion(uint32_t version, const std::string& fileName) const;
+
+    // true if the file starts with the magic
+    static bool fileStartsWith(const std::string& fileName, const Magic& magic);
+  };
+}  // namespace l1t
+
+#endif /* defined(__l1microgmtbinaryfileheader_h) */
@@ -6,6 +6,9 @@
 
 #include "L1Trigger/L1TMuon/interface/L1TMuonGlobalParamsHelper.h"
 #include "L1Trigger/L1TMuon/interface/MicroGMTLUTFactories.h"
+#include "L1Trigger/L1TMuon/interface/GMTPackedMuon.h"
+
+#include <array>
 
 namespace l1t {
   enum cancelmode { tracks, kftracks, coordinate };
@@ -24,6 +27,19 @@ namespace l1t {
     /// Cancel-out between overlap and endcap track finders
     void setCancelOutBitsOverlapEndcap(GMTInternalWedges&, GMTInternalWedges&, cancelmode);
 
+    /// The same on the packed muons, the muons of a wedge are the ones of the track finder list with the given processor.
+    /// The quantities used by the cancel-out are extracted from the muons once per call (CancelOutMuons),
+    /// the wedges are then compared by the cancelOut kernel. The results are the same as of the GMTInternalWedges versions
+    void setCancelOutBits(GMTPackedMuons&, const GMTPackedMuonList&, tftype, cancelmode);
+    void setCancelOutBitsOverlapBarrel(GMTPackedMuons&,
+                                       const GMTPackedMuonList& omtfMuons,
+                                       const GMTPackedMuonList& bmtfMuons,
+                                       cancelmode);
+    void setCancelOutBitsOverlapEndcap(GMTPackedMuons&,
+                                       const GMTPackedMuonList& omtfMuons,
+                                       const GMTPackedMuonList& emtfMuons,
+                                       cancelmode);
+
   private:
     /// Compares all muons from coll1 with all muons from coll2 and sets the cancel-bits based on eta/phi coordinates
     void getCoordinateCancelBits(std::vector<std::shared_ptr<GMTInternalMuon>>&,
@@ -41,6 +57,67 @@ namespace l1t {
     void getTrackAddrCancelBitsKfBMTF(std::vector<std::shared_ptr<GMTInternalMuon>>&,
                                       std::vector<std::shared_ptr<GMTInternalMuon>>&);
 
+    /// The track address sub-addresses used by the cancel-out, indexed by the bmtfAddress / emtfAddress key
+    typedef std::array<int, GMTPackedMuon::kTrackAddressSize> TrackAddress;
+
+    /// The quantities used by the cancel-out of the muons of one track finder list, ordered by the wedge (processor),
+    /// within a wedge in the order of the list. The muons with the processor >= nWedges are not compared at all
+    struct CancelOutMuons {
+      static constexpr unsigned kMaxWedges = 12;
+
+      CancelOutMuons(const GMTPackedMuons&, const GMTPackedMuonList&, unsigned nWedges, bool withTrackAddress);
+
+      unsigned size = 0;
+      /// the muons of the wedge w are [wedgeBegin[w], wedgeBegin[w + 1])
+      std::array<unsigned, kMaxWedges + 1> wedgeBegin;
+      /// index in the GMTPackedMuons
+      std::array<uint8_t, GMTPackedMuons::kMaxMuons> index;
+      std::array<tftype, GMTPackedMuons::kMaxMuons> tfType;
+      std::array<int, GMTPackedMuons::kMaxMuons> eta;
+      std::array<int, GMTPackedMuons::kMaxMuons> phi;
+      std::array<int, GMTPackedMuons::kMaxMuons> qual;
+      std::array<int, GMTPackedMuons::kMaxMuons> etaFine;
+      /// only filled if withTrackAddress
+      std::array<TrackAddress, GMTPackedMuons::kMaxMuons> trackAddress;
+    };
+
+    /// The positions in the CancelOutMuons of the muons of the wedges compared in one step
+    struct CancelOutSelection {
+      unsigned size = 0;
+      std::array<uint8_t, GMTPackedMuons::kMaxMuons> pos;
+
+      void addWedge(const CancelOutMuons&, unsigned wedge);
+    };
+
+    /// Compares all muons of sel1 with all muons of sel2 and sets the cancel bits, as the getCoordinateCancelBits
+    /// (mode coordinate) or getTrackAddrCancelBits (other modes) with the coll1 and coll2 of the selected muons
+    void cancelOut(cancelmode,
+                   GMTPackedMuons&,
+                   const CancelOutMuons& muons1,
+                   const CancelOutSelection& sel1,
+                   const CancelOutMuons& muons2,
+                   const CancelOutSelection& sel2);
+
+    /// Sets the cancel bit of the muon 1 or of the muons of the sel2 matching it (match[i2]), the one with
+    /// the lower quality is cancelled, for the equal quality the muon 2 if coll1WinsTie, otherwise the muon 1
+    static void setCancelBits(GMTPackedMuons&,
+                              const CancelOutMuons& muons1,
+                              unsigned pos1,
+                              const CancelOutMuons& muons2,
+                              const CancelOutSelection& sel2,
+                              const std::array<bool, GMTPackedMuons::kMaxMuons>& match,
+                              bool coll1WinsTie);
+
+    /// The match quality LUT for the pair of track finders, the same as the m_lutDict.at()
+    MicroGMTMatchQualLUT* matchQualLUT(tftype tfType1, tftype tfType2) const;
+
+    static TrackAddress trackAddress(const GMTPackedMuon&);
+
+    /// Number of the stations in which the two tracks share the hits
+    static int nMatchedStationsOrigBMTF(const TrackAddress&, const TrackAddress&);
+    static int nMatchedStationsKfBMTF(const TrackAddress&, const TrackAddress&);
+    static int nMatchedStationsEMTF(const TrackAddress&, const TrackAddress&);
+
     std::shared_ptr<MicroGMTMatchQualLUT> m_boPosMatchQualLUT;
     std::shared_ptr<MicroGMTMatchQualLUT> m_boNegMatchQualLUT;
     std::shared_ptr<MicroGMTMatchQualLUT> m_foPosMatchQualLUT;
@@ -51,6 +128,9 @@ namespace l1t {
     std::shared_ptr<MicroGMTMatchQualLUT> m_fwdPosSingleMatchQualLUT;
     std::shared_ptr<MicroGMTMatchQualLUT> m_fwdNegSingleMatchQualLUT;
     std::map<int, std::shared_ptr<MicroGMTMatchQualLUT>> m_lutDict;
+    /// the LUTs of the m_lutDict indexed by tfType1 + kNTfTypes * tfType2, nullptr if not in the m_lutDict
+    static constexpr unsigned kNTfTypes = tftype::emtf_pos + 1;
+    std::array<MicroGMTMatchQualLUT*, kNTfTypes * kNTfTypes> m_lutArray{};
   };
 }  // namespace l1t
 #endif /* defined(__l1microgmtcanceloutunit_h) */
@@ -0,0 +1,76 @@
+#ifndef __l1microgmtisodebugwriter_h
+#define __l1microgmtisodebugwriter_h
+
+#include "L1Trigger/L1TMuon/interface/MicroGMTBinaryFileHeader.h"
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace l1t {
+  /*
+   * Debug output of the calo indices used by the isolation of the output muons (formerly the iso_debug.dat text file
+   * always written by the L1TMuonProducer). The event thread only puts the records into a bounded single producer /
+   * single consumer lock-free ring buffer, the file is written by a background thread. The records are compact
+   * binary, decodeToText renders them in the old text format ("<hwCaloPhi> <hwCaloEta>" per line).
+   *
+   * The file layout (native byte order, see the MicroGMTBinaryFileHeader): FileHeader, then the Records.
+   */
+  class MicroGMTIsoDebugWriter {
+  public:
+    static constexpr MicroGMTBinaryFileHeader::Magic magic = {'U', 'G', 'M', 'T', 'I', 'S', 'O', '\0'};
+
+    //to be incremented if the layout is changed
+    static constexpr uint32_t version = 1;
+
+    struct Record {
+      int16_t hwCaloPhi;
+      int16_t hwCaloEta;
+    };
+
+    /// opens the file and starts the writer thread, throws cms::Exception if the file cannot be opened
+    explicit MicroGMTIsoDebugWriter(const std::string& fileName, unsigned bufferSizeLog2 = 16);
+    /// calls close()
+    ~MicroGMTIsoDebugWriter();
+
+    MicroGMTIsoDebugWriter(const MicroGMTIsoDebugWriter&) = delete;
+    MicroGMTIsoDebugWriter& operator=(const MicroGMTIsoDebugWriter&) = delete;
+
+    /// to be called from a single thread, waits only if the buffer is full, i.e. if the writer thread does not keep up
+    void write(int hwCaloPhi, int hwCaloEta) {
+      uint64_t head = m_head.load(std::memory_order_relaxed);
+      while (head - m_tail.load(std::memory_order_acquire) >= m_buffer.size()) {
+        std::this_thread::yield();
+      }
+      m_buffer[head & m_mask] = Record{static_cast<int16_t>(hwCaloPhi), static_cast<int16_t>(hwCaloEta)};
+      m_head.store(head + 1, std::memory_order_release);
+    }
+
+    /// writes all the queued records, stops the writer thread and closes the file
+    void close();
+
+    /// writes the content of the file in the old iso_debug.dat text format, throws cms::Exception if the file is not valid
+    static void decodeToText(const std::string& fileName, std::ostream& out);
+
+  private:
+    void run();
+
+    /// moves the queued records to the file, returns false if there were none
+    bool drain();
+
+    std::ofstream m_file;
+    std::vector<Record> m_buffer;
+    uint64_t m_mask;
+    // number of the records written to (head) and taken from (tail) the buffer
+    std::atomic<uint64_t> m_head;
+    std::atomic<uint64_t> m_tail;
+    std::atomic<bool> m_stop;
+    std::thread m_thread;
+  };
+}  // namespace l1t
+
+#endif /* __l1microgmtisodebugwriter_h */
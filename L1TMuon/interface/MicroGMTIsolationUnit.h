@@ -9,6 +9,7 @@
 
 #include "L1Trigger/L1TMuon/interface/L1TMuonGlobalParamsHelper.h"
 #include "L1Trigger/L1TMuon/interface/MicroGMTLUTFactories.h"
+#include "L1Trigger/L1TMuon/interface/GMTPackedMuon.h"
 
 namespace l1t {
   class MicroGMTIsolationUnit {
@@ -20,6 +21,7 @@ namespace l1t {
     void initialise(L1TMuonGlobalParamsHelper*);
     // returns the index corresponding to the calo tower sum using the LUT
     int getCaloIndex(MicroGMTConfiguration::InterMuon&) const;
+    int getCaloIndex(GMTPackedMuon&) const;
     // copies the energy values to the m_towerEnergies map for consistent access
     void setTowerSums(const MicroGMTConfiguration::CaloInputCollection& inputs, int bx);
     // First step done for calo input preparation, calculates strip sums
@@ -31,10 +33,20 @@ namespace l1t {
     void isolate(MicroGMTConfiguration::InterMuonList&) const;
     // Checks with LUT isolation for all muons in list, assuming input calo is pre-summed
     void isolatePreSummed(MicroGMTConfiguration::InterMuonList& muons) const;
+    void isolatePreSummed(GMTPackedMuons& muons, const GMTPackedMuonList& isolatedMuons) const;
     // Uses *Extrapolation LUTs to project trajectory to the vertex and adds info to muon
     void extrapolateMuons(MicroGMTConfiguration::InterMuonList&) const;
+    void extrapolateMuons(GMTPackedMuons& muons, const GMTPackedMuonList& inputmuons) const;
 
   private:
+    // the implementations for both the GMTInternalMuon and the GMTPackedMuon
+    template <class MuonType>
+    int caloIndex(MuonType&) const;
+    template <class MuonType>
+    void extrapolateMuon(MuonType&) const;
+    template <class MuonType>
+    void isolatePreSummedMuon(MuonType&) const;
+
     int m_fwVersion;
 
     std::shared_ptr<MicroGMTExtrapolationLUT> m_BEtaExtrapolation;
@@ -5,14 +5,36 @@
 #include <fstream>
 #include <sstream>
 #include <bitset>
+#include <cstdint>
 #include <vector>
 
 #include "CondFormats/L1TObjects/interface/LUT.h"
 #include "L1Trigger/L1TMuon/interface/MicroGMTConfiguration.h"
+#include "L1Trigger/L1TMuon/interface/MicroGMTBinaryFileHeader.h"
 
 namespace l1t {
+  /*
+   * Besides the text format of the l1t::LUT, the LUTs can be stored in a compact binary format (saveBinary),
+   * load() recognises it by the magic at the beginning of the file.
+   * The binary layout (native byte order, see the MicroGMTBinaryFileHeader): BinaryHeader, then the values of all
+   * (1 << addressWidth) addresses as int16_t, nEntries = 0 for an empty LUT.
+   * The checksum is the 32-bit FNV-1a hash of the values.
+   */
   class MicroGMTLUT : public LUT {
   public:
+    static constexpr MicroGMTBinaryFileHeader::Magic magic = {'U', 'G', 'M', 'T', 'L', 'U', 'T', '\0'};
+
+    //to be incremented if the layout is changed
+    static constexpr uint32_t version = 1;
+
+    struct BinaryHeader {
+      MicroGMTBinaryFileHeader fileType;
+      uint32_t addressWidth;  // the total input width
+      uint32_t dataWidth;     // the output width
+      uint32_t nEntries;
+      uint32_t checksum;
+    };
+
     MicroGMTLUT() : m_totalInWidth(0), m_outWidth(0), m_initialized(false){};
     MicroGMTLUT(l1t::LUT* lut);
     virtual ~MicroGMTLUT(){};
@@ -24,17 +46,52 @@ namespace l1t {
     // populates the m_contents map.
     void initialize();
 
-    int checkedInput(unsigned in, unsigned maxWidth) const;
+    // saturates the input to the maxWidth bits
+    int checkedInput(unsigned in, unsigned maxWidth) const {
+      unsigned maxIn = (1u << maxWidth) - 1;
+      return (in < maxIn ? in : maxIn);
+    }
 
     // I/O functions
     void save(std::ofstream& output);
+    void saveBinary(std::ofstream& output) const;
+    // the inFileName is resolved with the edm::FileInPath, the file can be in the text or binary format
     int load(const std::string& inFileName);
+    // the same with the full path of the file, throws cms::Exception if the binary file is not valid
+    int loadFile(const std::string& fullPath);
+    // true if the file starts with the magic of the binary format
+    static bool isBinaryFile(const std::string& fullPath) {
+      return MicroGMTBinaryFileHeader::fileStartsWith(fullPath, magic);
+    }
 
   protected:
+    // the lookup in the flat table, the same as data(address) for the addresses within the LUT address width.
+    // Only valid if the LUT is initialized, for the empty LUT the table has the single 0 entry
+    int lookupFlat(unsigned address) const { return m_flatContents[address & m_flatAddressMask]; }
+
+    // copies the LUT contents to the flat table, called whenever the contents are set
+    void flatten();
+
+    // empties the LUT and the flat table
+    void clear();
+
+    // sets the contents of all (1 << addressWidth) addresses and the flat table from them, empties the LUT if no contents
+    int setContents(unsigned addressWidth, unsigned dataWidth, const std::vector<int>& contents);
+
+    static uint32_t checksum(const std::vector<int16_t>& values);
+
     unsigned m_totalInWidth;
     unsigned m_outWidth;
     std::vector<MicroGMTConfiguration::input_t> m_inputs;
     bool m_initialized;
+
+  private:
+    // the flat table of the empty LUT
+    void clearFlat();
+
+    // the contents of all addresses, the outputs of the uGMT LUTs are at most 10 bits wide
+    std::vector<int16_t> m_flatContents = std::vector<int16_t>(1, 0);
+    unsigned m_flatAddressMask = 0;
   };
 }  // namespace l1t
 
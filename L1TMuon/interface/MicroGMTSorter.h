@@ -0,0 +1,43 @@
+#ifndef __l1microgmtsorter_h
+#define __l1microgmtsorter_h
+
+#include "L1Trigger/L1TMuon/interface/GMTInternalMuonFwd.h"
+#include "L1Trigger/L1TMuon/interface/GMTPackedMuon.h"
+
+#include <cstdint>
+
+namespace l1t {
+  /// Sorts the muons by rank and keeps the best nSurvivors, as the uGMT sorter.
+  /// Every muon is compared with all the others, the one with the higher rank wins (the earlier one in case of
+  /// equal ranks) and the cancelled muons always lose and are removed. The muons with the most wins survive.
+  /// Since such wins define a total order, the same result is obtained by a top-nSurvivors insertion sort
+  /// over a fixed-size array of (rank, index) records, which is done here without any heap allocation
+  /// (the surviving muons are only spliced in the list).
+  class MicroGMTSorter {
+  public:
+    /// maximum number of the input muons for the flat-array sort: 12 BMTF wedges x 3 muons
+    static const unsigned kMaxInputs = 36;
+    /// maximum number of the survivors for the flat-array sort: 8 for the BMTF and the final sort
+    static const unsigned kMaxSurvivors = 8;
+
+    /// Sorts the muons and removes the cancelled ones and all but the best nSurvivors.
+    /// The wins of the survivors are set as in the pairwise comparison (those of the removed muons are reset to 0).
+    /// Falls back to the sortMuonsByWins if there are more than kMaxInputs muons or nSurvivors > kMaxSurvivors.
+    static void sortMuons(GMTInternalMuonList& muons, unsigned nSurvivors);
+
+    /// The same for the packed muons: sorts the list of the muon indices, keeping the best nSurvivors not cancelled ones.
+    /// The wins are not needed, the survivors are in the list in the order of the wins.
+    static void sortMuons(const GMTPackedMuons& muons, GMTPackedMuonList& sortedMuons, unsigned nSurvivors);
+
+    /// The pairwise comparison of all muons counting their wins, followed by the sort by wins
+    static void sortMuonsByWins(GMTInternalMuonList& muons, unsigned nSurvivors);
+
+  private:
+    struct SortRecord {
+      int rank;
+      uint8_t index;
+    };
+  };
+}  // namespace l1t
+
+#endif /* defined(__l1microgmtsorter_h) */
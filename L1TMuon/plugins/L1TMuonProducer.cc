@@ -18,8 +18,9 @@
 //
 
 // system include files
+#include <array>
 #include <memory>
-#include <fstream>
+#include <string>
 
 // user include files
 #include "FWCore/Framework/interface/EventSetup.h"
@@ -32,13 +33,17 @@
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/Utilities/interface/ESGetToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include "L1Trigger/L1TMuon/interface/MicroGMTConfiguration.h"
 #include "L1Trigger/L1TMuon/interface/MicroGMTRankPtQualLUT.h"
 #include "L1Trigger/L1TMuon/interface/MicroGMTIsolationUnit.h"
 #include "L1Trigger/L1TMuon/interface/MicroGMTCancelOutUnit.h"
+#include "L1Trigger/L1TMuon/interface/MicroGMTSorter.h"
 #include "L1Trigger/L1TMuon/interface/MicroGMTLUTFactories.h"
 #include "L1Trigger/L1TMuon/interface/GMTInternalMuon.h"
+#include "L1Trigger/L1TMuon/interface/GMTPackedMuon.h"
+#include "L1Trigger/L1TMuon/interface/MicroGMTIsoDebugWriter.h"
 
 #include "DataFormats/Math/interface/LorentzVector.h"
 #include "DataFormats/L1Trigger/interface/Muon.h"
@@ -64,18 +69,45 @@ public:
   static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
 
 private:
+  // the output collections of one event
+  struct OutputCollections {
+    std::unique_ptr<MuonBxCollection> outMuons{new MuonBxCollection()};
+    std::unique_ptr<MuonBxCollection> imdMuonsBMTF{new MuonBxCollection()};
+    std::unique_ptr<MuonBxCollection> imdMuonsEMTFPos{new MuonBxCollection()};
+    std::unique_ptr<MuonBxCollection> imdMuonsEMTFNeg{new MuonBxCollection()};
+    std::unique_ptr<MuonBxCollection> imdMuonsOMTFPos{new MuonBxCollection()};
+    std::unique_ptr<MuonBxCollection> imdMuonsOMTFNeg{new MuonBxCollection()};
+
+    void setBXRange(int bxMin, int bxMax);
+    void put(edm::Event& iEvent);
+  };
+
   void produce(edm::Event&, const edm::EventSetup&) override;
 
+  // the uGMT processing of one BX with the GMTInternalMuons
+  void produceBx(edm::Handle<MicroGMTConfiguration::InputCollection> const& bmtfMuons,
+                 edm::Handle<MicroGMTConfiguration::InputCollection> const& emtfMuons,
+                 edm::Handle<MicroGMTConfiguration::InputCollection> const& omtfMuons,
+                 int bx,
+                 OutputCollections& out,
+                 MicroGMTIsoDebugWriter* isoDebugWriter);
+
+  // the same with the GMTPackedMuons, gives exactly the same outputs
+  void produceBxPacked(edm::Handle<MicroGMTConfiguration::InputCollection> const& bmtfMuons,
+                       edm::Handle<MicroGMTConfiguration::InputCollection> const& emtfMuons,
+                       edm::Handle<MicroGMTConfiguration::InputCollection> const& omtfMuons,
+                       int bx,
+                       OutputCollections& out,
+                       MicroGMTIsoDebugWriter* isoDebugWriter);
+
+  void beginStream(edm::StreamID) override;
+  void endStream() override;
+
   void beginRun(edm::Run const&, edm::EventSetup const&) override;
   void endRun(edm::Run const&, edm::EventSetup const&) override;
   void beginLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) override;
   void endLuminosityBlock(edm::LuminosityBlock const&, edm::EventSetup const&) override;
 
-  static bool compareMuons(const std::shared_ptr<MicroGMTConfiguration::InterMuon>& mu1,
-                           const std::shared_ptr<MicroGMTConfiguration::InterMuon>& mu2);
-
-  void sortMuons(MicroGMTConfiguration::InterMuonList&, unsigned) const;
-
   void calculateRank(MicroGMTConfiguration::InterMuonList& muons) const;
 
   void splitAndConvertMuons(edm::Handle<MicroGMTConfiguration::InputCollection> const& in,
@@ -97,6 +129,42 @@ private:
                              std::unique_ptr<MuonBxCollection>& out,
                              int bx) const;
 
+  void calculateRank(GMTPackedMuons& muons, const GMTPackedMuonList& muonList) const;
+
+  void splitAndConvertMuons(edm::Handle<MicroGMTConfiguration::InputCollection> const& in,
+                            GMTPackedMuons& muons,
+                            GMTPackedMuonList& out_pos,
+                            GMTPackedMuonList& out_neg,
+                            int bx) const;
+
+  void convertMuons(edm::Handle<MicroGMTConfiguration::InputCollection> const& in,
+                    GMTPackedMuons& muons,
+                    GMTPackedMuonList& out,
+                    int bx) const;
+
+  // adds the muon to the muons and its index to the out, returns false if the muons are full
+  bool addPackedMuon(
+      const RegionalMuonCand& in, int gPhi, int tfMuonIdx, GMTPackedMuons& muons, GMTPackedMuonList& out) const;
+
+  void addMuonsToCollections(const GMTPackedMuons& muons,
+                             const GMTPackedMuonList& coll,
+                             GMTPackedMuonList& interout,
+                             std::unique_ptr<MuonBxCollection>& out,
+                             int bx) const;
+
+  // the final output muon and the intermediate muon, from the GMTInternalMuon or GMTPackedMuon
+  template <class MuonType>
+  static Muon makeOutputMuon(const MuonType& mu);
+  template <class MuonType>
+  static Muon makeIntermediateMuon(const MuonType& mu);
+
+  // compares the outputs of the GMTPackedMuon and GMTInternalMuon versions in the bx, reports the differences
+  void compareOutputs(const OutputCollections& out,
+                      const OutputCollections& compareOut,
+                      int bx,
+                      const edm::EventID& eventId);
+  static bool sameMuon(const Muon& mu1, const Muon& mu2);
+
   // ----------member data ---------------------------
   bool m_autoBxRange;
   int m_bxMin;
@@ -120,7 +188,16 @@ private:
   std::shared_ptr<MicroGMTRankPtQualLUT> m_rankPtQualityLUT;
   MicroGMTIsolationUnit m_isolationUnit;
   MicroGMTCancelOutUnit m_cancelOutUnit;
-  std::ofstream m_debugOut;
+  // if true the uGMT processing is done on the GMTPackedMuons, otherwise on the GMTInternalMuons
+  bool m_usePackedMuons;
+  // if true both versions are run and their outputs compared, the differences are reported as errors
+  // and the job fails at the end of the stream
+  bool m_comparePackedMuons;
+  unsigned long m_comparedBxCnt;
+  unsigned long m_differentBxCnt;
+  // the iso debug output is written only if the isoDebugFileName is not empty
+  std::string m_isoDebugFileName;
+  std::unique_ptr<MicroGMTIsoDebugWriter> m_isoDebugWriter;
   l1t::cancelmode m_bmtfCancelMode;
   l1t::cancelmode m_emtfCancelMode;
 
@@ -144,7 +221,11 @@ private:
 // constructors and destructor
 //
 L1TMuonProducer::L1TMuonProducer(const edm::ParameterSet& iConfig)
-    : m_debugOut("test/debug/iso_debug.dat"),
+    : m_usePackedMuons(iConfig.getUntrackedParameter<bool>("usePackedMuons", false)),
+      m_comparePackedMuons(iConfig.getUntrackedParameter<bool>("comparePackedMuons", false)),
+      m_comparedBxCnt(0),
+      m_differentBxCnt(0),
+      m_isoDebugFileName(iConfig.getUntrackedParameter<std::string>("isoDebugFileName", "")),
       m_bmtfCancelMode(cancelmode::tracks),
       m_emtfCancelMode(cancelmode::coordinate) {
   // edm::InputTag barrelTfInputTag = iConfig.getParameter<edm::InputTag>("barrelTFInput");
@@ -186,7 +267,7 @@ L1TMuonProducer::L1TMuonProducer(const edm::ParameterSet& iConfig)
   produces<MuonBxCollection>("imdMuonsOMTFNeg");
 }
 
-L1TMuonProducer::~L1TMuonProducer() { m_debugOut.close(); }
+L1TMuonProducer::~L1TMuonProducer() {}
 
 //
 // member functions
@@ -195,12 +276,12 @@ L1TMuonProducer::~L1TMuonProducer() { m_debugOut.close(); }
 // ------------ method called to produce the data  ------------
 void L1TMuonProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup) {
   using namespace edm;
-  std::unique_ptr<MuonBxCollection> outMuons(new MuonBxCollection());
-  std::unique_ptr<MuonBxCollection> imdMuonsBMTF(new MuonBxCollection());
-  std::unique_ptr<MuonBxCollection> imdMuonsEMTFPos(new MuonBxCollection());
-  std::unique_ptr<MuonBxCollection> imdMuonsEMTFNeg(new MuonBxCollection());
-  std::unique_ptr<MuonBxCollection> imdMuonsOMTFPos(new MuonBxCollection());
-  std::unique_ptr<MuonBxCollection> imdMuonsOMTFNeg(new MuonBxCollection());
+  OutputCollections out;
+  // the outputs of the other (GMTInternalMuon or GMTPackedMuon) version, for the comparison
+  std::unique_ptr<OutputCollections> compareOut;
+  if (m_comparePackedMuons) {
+    compareOut = std::make_unique<OutputCollections>();
+  }
 
   Handle<MicroGMTConfiguration::InputCollection> bmtfMuons;
   Handle<MicroGMTConfiguration::InputCollection> emtfMuons;
@@ -252,129 +333,42 @@ void L1TMuonProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
   }
 
   // set BX range for outputs
-  outMuons->setBXRange(m_bxMin, m_bxMax);
-  imdMuonsBMTF->setBXRange(m_bxMin, m_bxMax);
-  imdMuonsEMTFPos->setBXRange(m_bxMin, m_bxMax);
-  imdMuonsEMTFNeg->setBXRange(m_bxMin, m_bxMax);
-  imdMuonsOMTFPos->setBXRange(m_bxMin, m_bxMax);
-  imdMuonsOMTFNeg->setBXRange(m_bxMin, m_bxMax);
+  out.setBXRange(m_bxMin, m_bxMax);
+  if (compareOut) {
+    compareOut->setBXRange(m_bxMin, m_bxMax);
+  }
 
   for (int bx = m_bxMin; bx <= m_bxMax; ++bx) {
     m_isolationUnit.setTowerSums(*trigTowers, bx);
-    MicroGMTConfiguration::InterMuonList internMuonsBmtf;
-    MicroGMTConfiguration::InterMuonList internMuonsEmtfPos;
-    MicroGMTConfiguration::InterMuonList internMuonsEmtfNeg;
-    MicroGMTConfiguration::InterMuonList internMuonsOmtfPos;
-    MicroGMTConfiguration::InterMuonList internMuonsOmtfNeg;
-
-    // These wedges contain shared pointers to the ones in the InterMuonList
-    GMTInternalWedges omtfNegWedges;
-    GMTInternalWedges bmtfWedges;
-    GMTInternalWedges emtfPosWedges;
-    GMTInternalWedges emtfNegWedges;
-    GMTInternalWedges omtfPosWedges;
-
-    // this converts the InputMuon type to the InternalMuon type and splits them into
-    // positive / negative eta collections necessary as LUTs may differ for pos / neg.
-    convertMuons(bmtfMuons, internMuonsBmtf, bmtfWedges, bx);
-    splitAndConvertMuons(emtfMuons, internMuonsEmtfPos, internMuonsEmtfNeg, emtfPosWedges, emtfNegWedges, bx);
-    splitAndConvertMuons(omtfMuons, internMuonsOmtfPos, internMuonsOmtfNeg, omtfPosWedges, omtfNegWedges, bx);
-
-    // cancel out within the track finders:
-    m_cancelOutUnit.setCancelOutBits(bmtfWedges, tftype::bmtf, m_bmtfCancelMode);
-    m_cancelOutUnit.setCancelOutBits(omtfPosWedges, tftype::omtf_pos, cancelmode::coordinate);
-    m_cancelOutUnit.setCancelOutBits(omtfNegWedges, tftype::omtf_neg, cancelmode::coordinate);
-    m_cancelOutUnit.setCancelOutBits(emtfPosWedges, tftype::emtf_pos, m_emtfCancelMode);
-    m_cancelOutUnit.setCancelOutBits(emtfNegWedges, tftype::emtf_neg, m_emtfCancelMode);
-
-    // cancel out between track finder acceptance overlaps:
-    m_cancelOutUnit.setCancelOutBitsOverlapBarrel(omtfPosWedges, bmtfWedges, cancelmode::coordinate);
-    m_cancelOutUnit.setCancelOutBitsOverlapBarrel(omtfNegWedges, bmtfWedges, cancelmode::coordinate);
-    m_cancelOutUnit.setCancelOutBitsOverlapEndcap(omtfPosWedges, emtfPosWedges, cancelmode::coordinate);
-    m_cancelOutUnit.setCancelOutBitsOverlapEndcap(omtfNegWedges, emtfNegWedges, cancelmode::coordinate);
-
-    m_isolationUnit.extrapolateMuons(internMuonsBmtf);
-    m_isolationUnit.extrapolateMuons(internMuonsEmtfNeg);
-    m_isolationUnit.extrapolateMuons(internMuonsEmtfPos);
-    m_isolationUnit.extrapolateMuons(internMuonsOmtfNeg);
-    m_isolationUnit.extrapolateMuons(internMuonsOmtfPos);
-
-    // the rank calculated here is used in the sort below
-    calculateRank(internMuonsBmtf);
-    calculateRank(internMuonsEmtfNeg);
-    calculateRank(internMuonsEmtfPos);
-    calculateRank(internMuonsOmtfNeg);
-    calculateRank(internMuonsOmtfPos);
-
-    // The sort function both sorts and removes all but best "nSurvivors"
-    sortMuons(internMuonsBmtf, 8);
-    sortMuons(internMuonsOmtfPos, 4);
-    sortMuons(internMuonsOmtfNeg, 4);
-    sortMuons(internMuonsEmtfPos, 4);
-    sortMuons(internMuonsEmtfNeg, 4);
-
-    // This combines the 5 streams into one InternalMuon collection for
-    // the final global sort.
-    MicroGMTConfiguration::InterMuonList internalMuons;
-    addMuonsToCollections(internMuonsEmtfPos, internalMuons, imdMuonsEMTFPos, bx);
-    addMuonsToCollections(internMuonsOmtfPos, internalMuons, imdMuonsOMTFPos, bx);
-    addMuonsToCollections(internMuonsBmtf, internalMuons, imdMuonsBMTF, bx);
-    addMuonsToCollections(internMuonsOmtfNeg, internalMuons, imdMuonsOMTFNeg, bx);
-    addMuonsToCollections(internMuonsEmtfNeg, internalMuons, imdMuonsEMTFNeg, bx);
-
-    // sort internal muons and delete all but best 8
-    sortMuons(internalMuons, 8);
-
-    m_isolationUnit.isolatePreSummed(internalMuons);
-    // copy muons to output collection...
-    for (const auto& mu : internalMuons) {
-      if (mu->hwPt() > 0) {
-        math::PtEtaPhiMLorentzVector vec{
-            (mu->hwPt() - 1) * 0.5, mu->hwEta() * 0.010875, mu->hwGlobalPhi() * 0.010908, 0.0};
-        int iso = mu->hwAbsIso() + (mu->hwRelIso() << 1);
-        int outMuQual = MicroGMTConfiguration::setOutputMuonQuality(mu->hwQual(), mu->trackFinderType(), mu->hwHF());
-        Muon outMu{vec,
-                   mu->hwPt(),
-                   mu->hwEta(),
-                   mu->hwGlobalPhi(),
-                   outMuQual,
-                   mu->hwSign(),
-                   mu->hwSignValid(),
-                   iso,
-                   mu->tfMuonIndex(),
-                   0,
-                   true,
-                   mu->hwIsoSum(),
-                   mu->hwDPhi(),
-                   mu->hwDEta(),
-                   mu->hwRank()};
-
-        // Set coordinates at the vertex
-        outMu.setHwEtaAtVtx(MicroGMTConfiguration::calcMuonHwEtaExtra(outMu));
-        outMu.setHwPhiAtVtx(MicroGMTConfiguration::calcMuonHwPhiExtra(outMu));
-        outMu.setEtaAtVtx(MicroGMTConfiguration::calcMuonEtaExtra(outMu));
-        outMu.setPhiAtVtx(MicroGMTConfiguration::calcMuonPhiExtra(outMu));
-
-        // Set displacement information
-        int hwPtUnconstrained{mu->hwPtUnconstrained()};
-        outMu.setPtUnconstrained(
-            hwPtUnconstrained == 0
-                ? 0
-                : (hwPtUnconstrained - 1));  // Don't want negative pT, unconstr. pT has LSB of 1 GeV.
-        outMu.setHwPtUnconstrained(hwPtUnconstrained);
-        outMu.setHwDXY(mu->hwDXY());
-
-        if (mu->hwSignValid()) {
-          outMu.setCharge(1 - 2 * mu->hwSign());
-        } else {
-          outMu.setCharge(0);
-        }
-        m_debugOut << mu->hwCaloPhi() << " " << mu->hwCaloEta() << std::endl;
-        outMuons->push_back(bx, outMu);
+    if (m_usePackedMuons) {
+      produceBxPacked(bmtfMuons, emtfMuons, omtfMuons, bx, out, m_isoDebugWriter.get());
+    } else {
+      produceBx(bmtfMuons, emtfMuons, omtfMuons, bx, out, m_isoDebugWriter.get());
+    }
+
+    if (compareOut) {
+      if (m_usePackedMuons) {
+        produceBx(bmtfMuons, emtfMuons, omtfMuons, bx, *compareOut, nullptr);
+      } else {
+        produceBxPacked(bmtfMuons, emtfMuons, omtfMuons, bx, *compareOut, nullptr);
       }
+      compareOutputs(out, *compareOut, bx, iEvent.id());
     }
   }
 
+  out.put(iEvent);
+}
+
+void L1TMuonProducer::OutputCollections::setBXRange(int bxMin, int bxMax) {
+  outMuons->setBXRange(bxMin, bxMax);
+  imdMuonsBMTF->setBXRange(bxMin, bxMax);
+  imdMuonsEMTFPos->setBXRange(bxMin, bxMax);
+  imdMuonsEMTFNeg->setBXRange(bxMin, bxMax);
+  imdMuonsOMTFPos->setBXRange(bxMin, bxMax);
+  imdMuonsOMTFNeg->setBXRange(bxMin, bxMax);
+}
+
+void L1TMuonProducer::OutputCollections::put(edm::Event& iEvent) {
   iEvent.put(std::move(outMuons));
   iEvent.put(std::move(imdMuonsBMTF), "imdMuonsBMTF");
   iEvent.put(std::move(imdMuonsEMTFPos), "imdMuonsEMTFPos");
@@ -383,46 +377,237 @@ void L1TMuonProducer::produce(edm::Event& iEvent, const edm::EventSetup& iSetup)
   iEvent.put(std::move(imdMuonsOMTFNeg), "imdMuonsOMTFNeg");
 }
 
-bool L1TMuonProducer::compareMuons(const std::shared_ptr<MicroGMTConfiguration::InterMuon>& mu1,
-                                   const std::shared_ptr<MicroGMTConfiguration::InterMuon>& mu2) {
-  return (mu1->hwWins() >= mu2->hwWins());
+void L1TMuonProducer::produceBx(edm::Handle<MicroGMTConfiguration::InputCollection> const& bmtfMuons,
+                                edm::Handle<MicroGMTConfiguration::InputCollection> const& emtfMuons,
+                                edm::Handle<MicroGMTConfiguration::InputCollection> const& omtfMuons,
+                                int bx,
+                                OutputCollections& out,
+                                MicroGMTIsoDebugWriter* isoDebugWriter) {
+  MicroGMTConfiguration::InterMuonList internMuonsBmtf;
+  MicroGMTConfiguration::InterMuonList internMuonsEmtfPos;
+  MicroGMTConfiguration::InterMuonList internMuonsEmtfNeg;
+  MicroGMTConfiguration::InterMuonList internMuonsOmtfPos;
+  MicroGMTConfiguration::InterMuonList internMuonsOmtfNeg;
+
+  // These wedges contain shared pointers to the ones in the InterMuonList
+  GMTInternalWedges omtfNegWedges;
+  GMTInternalWedges bmtfWedges;
+  GMTInternalWedges emtfPosWedges;
+  GMTInternalWedges emtfNegWedges;
+  GMTInternalWedges omtfPosWedges;
+
+  // this converts the InputMuon type to the InternalMuon type and splits them into
+  // positive / negative eta collections necessary as LUTs may differ for pos / neg.
+  convertMuons(bmtfMuons, internMuonsBmtf, bmtfWedges, bx);
+  splitAndConvertMuons(emtfMuons, internMuonsEmtfPos, internMuonsEmtfNeg, emtfPosWedges, emtfNegWedges, bx);
+  splitAndConvertMuons(omtfMuons, internMuonsOmtfPos, internMuonsOmtfNeg, omtfPosWedges, omtfNegWedges, bx);
+
+  // cancel out within the track finders:
+  m_cancelOutUnit.setCancelOutBits(bmtfWedges, tftype::bmtf, m_bmtfCancelMode);
+  m_cancelOutUnit.setCancelOutBits(omtfPosWedges, tftype::omtf_pos, cancelmode::coordinate);
+  m_cancelOutUnit.setCancelOutBits(omtfNegWedges, tftype::omtf_neg, cancelmode::coordinate);
+  m_cancelOutUnit.setCancelOutBits(emtfPosWedges, tftype::emtf_pos, m_emtfCancelMode);
+  m_cancelOutUnit.setCancelOutBits(emtfNegWedges, tftype::emtf_neg, m_emtfCancelMode);
+
+  // cancel out between track finder acceptance overlaps:
+  m_cancelOutUnit.setCancelOutBitsOverlapBarrel(omtfPosWedges, bmtfWedges, cancelmode::coordinate);
+  m_cancelOutUnit.setCancelOutBitsOverlapBarrel(omtfNegWedges, bmtfWedges, cancelmode::coordinate);
+  m_cancelOutUnit.setCancelOutBitsOverlapEndcap(omtfPosWedges, emtfPosWedges, cancelmode::coordinate);
+  m_cancelOutUnit.setCancelOutBitsOverlapEndcap(omtfNegWedges, emtfNegWedges, cancelmode::coordinate);
+
+  m_isolationUnit.extrapolateMuons(internMuonsBmtf);
+  m_isolationUnit.extrapolateMuons(internMuonsEmtfNeg);
+  m_isolationUnit.extrapolateMuons(internMuonsEmtfPos);
+  m_isolationUnit.extrapolateMuons(internMuonsOmtfNeg);
+  m_isolationUnit.extrapolateMuons(internMuonsOmtfPos);
+
+  // the rank calculated here is used in the sort below
+  calculateRank(internMuonsBmtf);
+  calculateRank(internMuonsEmtfNeg);
+  calculateRank(internMuonsEmtfPos);
+  calculateRank(internMuonsOmtfNeg);
+  calculateRank(internMuonsOmtfPos);
+
+  // The sort function both sorts and removes all but best "nSurvivors"
+  MicroGMTSorter::sortMuons(internMuonsBmtf, 8);
+  MicroGMTSorter::sortMuons(internMuonsOmtfPos, 4);
+  MicroGMTSorter::sortMuons(internMuonsOmtfNeg, 4);
+  MicroGMTSorter::sortMuons(internMuonsEmtfPos, 4);
+  MicroGMTSorter::sortMuons(internMuonsEmtfNeg, 4);
+
+  // This combines the 5 streams into one InternalMuon collection for
+  // the final global sort.
+  MicroGMTConfiguration::InterMuonList internalMuons;
+  addMuonsToCollections(internMuonsEmtfPos, internalMuons, out.imdMuonsEMTFPos, bx);
+  addMuonsToCollections(internMuonsOmtfPos, internalMuons, out.imdMuonsOMTFPos, bx);
+  addMuonsToCollections(internMuonsBmtf, internalMuons, out.imdMuonsBMTF, bx);
+  addMuonsToCollections(internMuonsOmtfNeg, internalMuons, out.imdMuonsOMTFNeg, bx);
+  addMuonsToCollections(internMuonsEmtfNeg, internalMuons, out.imdMuonsEMTFNeg, bx);
+
+  // sort internal muons and delete all but best 8
+  MicroGMTSorter::sortMuons(internalMuons, 8);
+
+  m_isolationUnit.isolatePreSummed(internalMuons);
+  // copy muons to output collection...
+  for (const auto& mu : internalMuons) {
+    if (mu->hwPt() > 0) {
+      Muon outMu = makeOutputMuon(*mu);
+      if (isoDebugWriter) {
+        isoDebugWriter->write(mu->hwCaloPhi(), mu->hwCaloEta());
+      }
+      out.outMuons->push_back(bx, outMu);
+    }
+  }
 }
 
-void L1TMuonProducer::sortMuons(MicroGMTConfiguration::InterMuonList& muons, unsigned nSurvivors) const {
-  MicroGMTConfiguration::InterMuonList::iterator mu1;
-  // reset from previous sort stage
-  for (mu1 = muons.begin(); mu1 != muons.end(); ++mu1) {
-    (*mu1)->setHwWins(0);
-  }
-
-  int nCancelled = 0;
-  for (mu1 = muons.begin(); mu1 != muons.end(); ++mu1) {
-    int mu1CancelBit = (*mu1)->hwCancelBit();
-    nCancelled += mu1CancelBit;
-    auto mu2 = mu1;
-    mu2++;
-    for (; mu2 != muons.end(); ++mu2) {
-      if (mu1CancelBit != 1 && (*mu2)->hwCancelBit() != 1) {
-        if ((*mu1)->hwRank() >= (*mu2)->hwRank()) {
-          (*mu1)->increaseWins();
-        } else {
-          (*mu2)->increaseWins();
-        }
-      } else if (mu1CancelBit != 1) {
-        (*mu1)->increaseWins();
-      } else if ((*mu2)->hwCancelBit() != 1) {
-        (*mu2)->increaseWins();
+void L1TMuonProducer::produceBxPacked(edm::Handle<MicroGMTConfiguration::InputCollection> const& bmtfMuons,
+                                      edm::Handle<MicroGMTConfiguration::InputCollection> const& emtfMuons,
+                                      edm::Handle<MicroGMTConfiguration::InputCollection> const& omtfMuons,
+                                      int bx,
+                                      OutputCollections& out,
+                                      MicroGMTIsoDebugWriter* isoDebugWriter) {
+  // all input muons of the BX, the lists below refer to them by the index
+  GMTPackedMuons muons;
+  GMTPackedMuonList muonsBmtf;
+  GMTPackedMuonList muonsEmtfPos;
+  GMTPackedMuonList muonsEmtfNeg;
+  GMTPackedMuonList muonsOmtfPos;
+  GMTPackedMuonList muonsOmtfNeg;
+
+  convertMuons(bmtfMuons, muons, muonsBmtf, bx);
+  splitAndConvertMuons(emtfMuons, muons, muonsEmtfPos, muonsEmtfNeg, bx);
+  splitAndConvertMuons(omtfMuons, muons, muonsOmtfPos, muonsOmtfNeg, bx);
+
+  // cancel out within the track finders:
+  m_cancelOutUnit.setCancelOutBits(muons, muonsBmtf, tftype::bmtf, m_bmtfCancelMode);
+  m_cancelOutUnit.setCancelOutBits(muons, muonsOmtfPos, tftype::omtf_pos, cancelmode::coordinate);
+  m_cancelOutUnit.setCancelOutBits(muons, muonsOmtfNeg, tftype::omtf_neg, cancelmode::coordinate);
+  m_cancelOutUnit.setCancelOutBits(muons, muonsEmtfPos, tftype::emtf_pos, m_emtfCancelMode);
+  m_cancelOutUnit.setCancelOutBits(muons, muonsEmtfNeg, tftype::emtf_neg, m_emtfCancelMode);
+
+  // cancel out between track finder acceptance overlaps:
+  m_cancelOutUnit.setCancelOutBitsOverlapBarrel(muons, muonsOmtfPos, muonsBmtf, cancelmode::coordinate);
+  m_cancelOutUnit.setCancelOutBitsOverlapBarrel(muons, muonsOmtfNeg, muonsBmtf, cancelmode::coordinate);
+  m_cancelOutUnit.setCancelOutBitsOverlapEndcap(muons, muonsOmtfPos, muonsEmtfPos, cancelmode::coordinate);
+  m_cancelOutUnit.setCancelOutBitsOverlapEndcap(muons, muonsOmtfNeg, muonsEmtfNeg, cancelmode::coordinate);
+
+  m_isolationUnit.extrapolateMuons(muons, muonsBmtf);
+  m_isolationUnit.extrapolateMuons(muons, muonsEmtfNeg);
+  m_isolationUnit.extrapolateMuons(muons, muonsEmtfPos);
+  m_isolationUnit.extrapolateMuons(muons, muonsOmtfNeg);
+  m_isolationUnit.extrapolateMuons(muons, muonsOmtfPos);
+
+  calculateRank(muons, muonsBmtf);
+  calculateRank(muons, muonsEmtfNeg);
+  calculateRank(muons, muonsEmtfPos);
+  calculateRank(muons, muonsOmtfNeg);
+  calculateRank(muons, muonsOmtfPos);
+
+  MicroGMTSorter::sortMuons(muons, muonsBmtf, 8);
+  MicroGMTSorter::sortMuons(muons, muonsOmtfPos, 4);
+  MicroGMTSorter::sortMuons(muons, muonsOmtfNeg, 4);
+  MicroGMTSorter::sortMuons(muons, muonsEmtfPos, 4);
+  MicroGMTSorter::sortMuons(muons, muonsEmtfNeg, 4);
+
+  GMTPackedMuonList internalMuons;
+  addMuonsToCollections(muons, muonsEmtfPos, internalMuons, out.imdMuonsEMTFPos, bx);
+  addMuonsToCollections(muons, muonsOmtfPos, internalMuons, out.imdMuonsOMTFPos, bx);
+  addMuonsToCollections(muons, muonsBmtf, internalMuons, out.imdMuonsBMTF, bx);
+  addMuonsToCollections(muons, muonsOmtfNeg, internalMuons, out.imdMuonsOMTFNeg, bx);
+  addMuonsToCollections(muons, muonsEmtfNeg, internalMuons, out.imdMuonsEMTFNeg, bx);
+
+  MicroGMTSorter::sortMuons(muons, internalMuons, 8);
+
+  m_isolationUnit.isolatePreSummed(muons, internalMuons);
+  // the l1t::Muon objects are created only here
+  for (unsigned index : internalMuons) {
+    const GMTPackedMuon& mu = muons[index];
+    if (mu.hwPt() > 0) {
+      if (isoDebugWriter) {
+        isoDebugWriter->write(mu.hwCaloPhi(), mu.hwCaloEta());
       }
+      out.outMuons->push_back(bx, makeOutputMuon(mu));
     }
   }
+}
 
-  size_t nMuonsBefore = muons.size();
-  int minWins = nMuonsBefore - nSurvivors;
+template <class MuonType>
+Muon L1TMuonProducer::makeOutputMuon(const MuonType& mu) {
+  math::PtEtaPhiMLorentzVector vec{(mu.hwPt() - 1) * 0.5, mu.hwEta() * 0.010875, mu.hwGlobalPhi() * 0.010908, 0.0};
+  int iso = mu.hwAbsIso() + (mu.hwRelIso() << 1);
+  int outMuQual = MicroGMTConfiguration::setOutputMuonQuality(mu.hwQual(), mu.trackFinderType(), mu.hwHF());
+  Muon outMu{vec,
+             mu.hwPt(),
+             mu.hwEta(),
+             mu.hwGlobalPhi(),
+             outMuQual,
+             mu.hwSign(),
+             mu.hwSignValid(),
+             iso,
+             mu.tfMuonIndex(),
+             0,
+             true,
+             mu.hwIsoSum(),
+             mu.hwDPhi(),
+             mu.hwDEta(),
+             mu.hwRank()};
+
+  // Set coordinates at the vertex
+  outMu.setHwEtaAtVtx(MicroGMTConfiguration::calcMuonHwEtaExtra(outMu));
+  outMu.setHwPhiAtVtx(MicroGMTConfiguration::calcMuonHwPhiExtra(outMu));
+  outMu.setEtaAtVtx(MicroGMTConfiguration::calcMuonEtaExtra(outMu));
+  outMu.setPhiAtVtx(MicroGMTConfiguration::calcMuonPhiExtra(outMu));
+
+  // Set displacement information
+  int hwPtUnconstrained{mu.hwPtUnconstrained()};
+  outMu.setPtUnconstrained(hwPtUnconstrained == 0
+                               ? 0
+                               : (hwPtUnconstrained - 1));  // Don't want negative pT, unconstr. pT has LSB of 1 GeV.
+  outMu.setHwPtUnconstrained(hwPtUnconstrained);
+  outMu.setHwDXY(mu.hwDXY());
+
+  if (mu.hwSignValid()) {
+    outMu.setCharge(1 - 2 * mu.hwSign());
+  } else {
+    outMu.setCharge(0);
+  }
+  return outMu;
+}
 
-  // remove all muons that were cancelled or that do not have sufficient rank
-  // (reduces the container size to nSurvivors)
-  muons.remove_if([&minWins](auto muon) { return ((muon->hwWins() < minWins) || (muon->hwCancelBit() == 1)); });
-  muons.sort(L1TMuonProducer::compareMuons);
+template <class MuonType>
+Muon L1TMuonProducer::makeIntermediateMuon(const MuonType& mu) {
+  math::PtEtaPhiMLorentzVector vec{(mu.hwPt() - 1) * 0.5, mu.hwEta() * 0.010875, mu.hwGlobalPhi() * 0.010908, 0.0};
+  int outMuQual = MicroGMTConfiguration::setOutputMuonQuality(mu.hwQual(), mu.trackFinderType(), mu.hwHF());
+  // set tfMuonIndex and iso to 0 like in the FW
+  Muon outMu{vec,
+             mu.hwPt(),
+             mu.hwEta(),
+             mu.hwGlobalPhi(),
+             outMuQual,
+             mu.hwSign(),
+             mu.hwSignValid(),
+             0,
+             0,
+             0,
+             true,
+             0,
+             mu.hwDPhi(),
+             mu.hwDEta(),
+             mu.hwRank()};
+
+  int hwPtUnconstrained{mu.hwPtUnconstrained()};
+  outMu.setPtUnconstrained(hwPtUnconstrained == 0
+                               ? 0
+                               : (hwPtUnconstrained - 1));  // Don't want negative pT, unconstr. pT has LSB of 1 GeV.
+  outMu.setHwPtUnconstrained(hwPtUnconstrained);
+  outMu.setHwDXY(mu.hwDXY());
+
+  if (mu.hwSignValid()) {
+    outMu.setCharge(1 - 2 * mu.hwSign());
+  } else {
+    outMu.setCharge(0);
+  }
+  return outMu;
 }
 
 void L1TMuonProducer::calculateRank(MicroGMTConfiguration::InterMuonList& muons) const {
@@ -438,38 +623,7 @@ void L1TMuonProducer::addMuonsToCollections(MicroGMTConfiguration::InterMuonList
                                             int bx) const {
   for (auto& mu : coll) {
     interout.push_back(mu);
-    math::PtEtaPhiMLorentzVector vec{(mu->hwPt() - 1) * 0.5, mu->hwEta() * 0.010875, mu->hwGlobalPhi() * 0.010908, 0.0};
-    int outMuQual = MicroGMTConfiguration::setOutputMuonQuality(mu->hwQual(), mu->trackFinderType(), mu->hwHF());
-    // set tfMuonIndex and iso to 0 like in the FW
-    Muon outMu{vec,
-               mu->hwPt(),
-               mu->hwEta(),
-               mu->hwGlobalPhi(),
-               outMuQual,
-               mu->hwSign(),
-               mu->hwSignValid(),
-               0,
-               0,
-               0,
-               true,
-               0,
-               mu->hwDPhi(),
-               mu->hwDEta(),
-               mu->hwRank()};
-
-    int hwPtUnconstrained{mu->hwPtUnconstrained()};
-    outMu.setPtUnconstrained(hwPtUnconstrained == 0
-                                 ? 0
-                                 : (hwPtUnconstrained - 1));  // Don't want negative pT, unconstr. pT has LSB of 1 GeV.
-    outMu.setHwPtUnconstrained(hwPtUnconstrained);
-    outMu.setHwDXY(mu->hwDXY());
-
-    if (mu->hwSignValid()) {
-      outMu.setCharge(1 - 2 * mu->hwSign());
-    } else {
-      outMu.setCharge(0);
-    }
-
+    Muon outMu = makeIntermediateMuon(*mu);
     out->push_back(bx, outMu);
   }
 }
@@ -564,6 +718,168 @@ void L1TMuonProducer::convertMuons(const edm::Handle<MicroGMTConfiguration::Inpu
   }
 }
 
+void L1TMuonProducer::calculateRank(GMTPackedMuons& muons, const GMTPackedMuonList& muonList) const {
+  for (unsigned index : muonList) {
+    muons[index].setHwRank(m_rankPtQualityLUT->lookup(muons[index].hwPt(), muons[index].hwQual()));
+  }
+}
+
+void L1TMuonProducer::addMuonsToCollections(const GMTPackedMuons& muons,
+                                            const GMTPackedMuonList& coll,
+                                            GMTPackedMuonList& interout,
+                                            std::unique_ptr<MuonBxCollection>& out,
+                                            int bx) const {
+  for (unsigned index : coll) {
+    interout.push_back(index);
+    out->push_back(bx, makeIntermediateMuon(muons[index]));
+  }
+}
+
+bool L1TMuonProducer::addPackedMuon(const RegionalMuonCand& in,
+                                    int gPhi,
+                                    int tfMuonIdx,
+                                    GMTPackedMuons& muons,
+                                    GMTPackedMuonList& out) const {
+  if (muons.size == GMTPackedMuons::kMaxMuons) {
+    edm::LogError("Input Mismatch") << " more than " << GMTPackedMuons::kMaxMuons
+                                    << " input muons in one BX, the remaining ones are ignored";
+    return false;
+  }
+  muons[muons.size].set(in, gPhi, tfMuonIdx);
+  out.push_back(muons.size);
+  ++muons.size;
+  return true;
+}
+
+void L1TMuonProducer::splitAndConvertMuons(const edm::Handle<MicroGMTConfiguration::InputCollection>& in,
+                                           GMTPackedMuons& muons,
+                                           GMTPackedMuonList& out_pos,
+                                           GMTPackedMuonList& out_neg,
+                                           int bx) const {
+  if (bx < in->getFirstBX() || bx > in->getLastBX())
+    return;
+  // the numbers of muons per wedge, only for the check
+  std::array<unsigned, 6> wedgeSizes_pos{};
+  std::array<unsigned, 6> wedgeSizes_neg{};
+  int muIdxAuto = 0;
+  int currentLink = 0;
+  for (size_t i = 0; i < in->size(bx); ++i, ++muIdxAuto) {
+    if (in->at(bx, i).hwPt() > 0) {
+      int link = in->at(bx, i).link();
+      if (m_inputsToDisable.test(link) || m_maskedInputs.test(link)) {
+        continue;  // only process if input link is enabled and not masked
+      }
+      if (currentLink != link) {
+        muIdxAuto = 0;
+        currentLink = link;
+      }
+      int gPhi = MicroGMTConfiguration::calcGlobalPhi(
+          in->at(bx, i).hwPhi(), in->at(bx, i).trackFinderType(), in->at(bx, i).processor());
+      int tfMuonIdx{computeMuonIdx(in->at(bx, i), currentLink, muIdxAuto)};
+      unsigned processor = in->at(bx, i).processor();
+      if (in->at(bx, i).hwEta() > 0) {
+        if (addPackedMuon(in->at(bx, i), gPhi, tfMuonIdx, muons, out_pos) && processor < wedgeSizes_pos.size())
+          ++wedgeSizes_pos[processor];
+      } else {
+        if (addPackedMuon(in->at(bx, i), gPhi, tfMuonIdx, muons, out_neg) && processor < wedgeSizes_neg.size())
+          ++wedgeSizes_neg[processor];
+      }
+    }
+  }
+  for (int i = 0; i < 6; ++i) {
+    if (wedgeSizes_pos[i] > 3)
+      edm::LogWarning("Input Mismatch") << " too many inputs per processor for emtf+ / omtf+. Wedge " << i << ": Size "
+                                        << wedgeSizes_pos[i] << std::endl;
+    if (wedgeSizes_neg[i] > 3)
+      edm::LogWarning("Input Mismatch") << " too many inputs per processor for emtf- / omtf-. Wedge " << i << ": Size "
+                                        << wedgeSizes_neg[i] << std::endl;
+  }
+}
+
+void L1TMuonProducer::convertMuons(const edm::Handle<MicroGMTConfiguration::InputCollection>& in,
+                                   GMTPackedMuons& muons,
+                                   GMTPackedMuonList& out,
+                                   int bx) const {
+  if (bx < in->getFirstBX() || bx > in->getLastBX()) {
+    return;
+  }
+  // the numbers of muons per wedge, only for the check
+  std::array<unsigned, 12> wedgeSizes{};
+  int muIdxAuto = 0;
+  int currentLink = 0;
+  for (size_t i = 0; i < in->size(bx); ++i, ++muIdxAuto) {
+    if (in->at(bx, i).hwPt() > 0) {
+      int link = in->at(bx, i).link();
+      if (m_inputsToDisable.test(link) || m_maskedInputs.test(link)) {
+        continue;  // only process if input link is enabled and not masked
+      }
+      if (currentLink != link) {
+        muIdxAuto = 0;
+        currentLink = link;
+      }
+      int gPhi = MicroGMTConfiguration::calcGlobalPhi(
+          in->at(bx, i).hwPhi(), in->at(bx, i).trackFinderType(), in->at(bx, i).processor());
+      int tfMuonIdx{computeMuonIdx(in->at(bx, i), currentLink, muIdxAuto)};
+      unsigned processor = in->at(bx, i).processor();
+      if (addPackedMuon(in->at(bx, i), gPhi, tfMuonIdx, muons, out) && processor < wedgeSizes.size())
+        ++wedgeSizes[processor];
+    }
+  }
+  for (int i = 0; i < 12; ++i) {
+    if (wedgeSizes[i] > 3) {
+      edm::LogWarning("Input Mismatch") << " too many inputs per processor for barrel. Wedge " << i << ": Size "
+                                        << wedgeSizes[i] << std::endl;
+    }
+  }
+}
+
+void L1TMuonProducer::compareOutputs(const OutputCollections& out,
+                                     const OutputCollections& compareOut,
+                                     int bx,
+                                     const edm::EventID& eventId) {
+  std::array<std::pair<const MuonBxCollection*, const MuonBxCollection*>, 6> collections = {
+      {{out.outMuons.get(), compareOut.outMuons.get()},
+       {out.imdMuonsBMTF.get(), compareOut.imdMuonsBMTF.get()},
+       {out.imdMuonsEMTFPos.get(), compareOut.imdMuonsEMTFPos.get()},
+       {out.imdMuonsEMTFNeg.get(), compareOut.imdMuonsEMTFNeg.get()},
+       {out.imdMuonsOMTFPos.get(), compareOut.imdMuonsOMTFPos.get()},
+       {out.imdMuonsOMTFNeg.get(), compareOut.imdMuonsOMTFNeg.get()}}};
+  static const std::array<const char*, 6> collectionNames = {
+      {"", "imdMuonsBMTF", "imdMuonsEMTFPos", "imdMuonsEMTFNeg", "imdMuonsOMTFPos", "imdMuonsOMTFNeg"}};
+
+  ++m_comparedBxCnt;
+  bool same = true;
+  for (unsigned iColl = 0; iColl < collections.size(); ++iColl) {
+    const MuonBxCollection& muons = *collections[iColl].first;
+    const MuonBxCollection& compareMuons = *collections[iColl].second;
+    bool sameColl = muons.size(bx) == compareMuons.size(bx);
+    for (unsigned i = 0; sameColl && i < muons.size(bx); ++i) {
+      sameColl = sameMuon(muons.at(bx, i), compareMuons.at(bx, i));
+    }
+    if (!sameColl) {
+      edm::LogError("L1TMuonProducer") << "GMTPackedMuon and GMTInternalMuon outputs differ: " << eventId << " BX " << bx
+                                       << " collection '" << collectionNames[iColl] << "'";
+    }
+    same &= sameColl;
+  }
+  if (!same) {
+    ++m_differentBxCnt;
+  }
+}
+
+bool L1TMuonProducer::sameMuon(const Muon& mu1, const Muon& mu2) {
+  return mu1.pt() == mu2.pt() && mu1.eta() == mu2.eta() && mu1.phi() == mu2.phi() && mu1.charge() == mu2.charge() &&
+         mu1.hwPt() == mu2.hwPt() && mu1.hwEta() == mu2.hwEta() && mu1.hwPhi() == mu2.hwPhi() &&
+         mu1.hwQual() == mu2.hwQual() && mu1.hwCharge() == mu2.hwCharge() &&
+         mu1.hwChargeValid() == mu2.hwChargeValid() && mu1.hwIso() == mu2.hwIso() &&
+         mu1.tfMuonIndex() == mu2.tfMuonIndex() && mu1.hwTag() == mu2.hwTag() && mu1.hwIsoSum() == mu2.hwIsoSum() &&
+         mu1.hwDPhiExtra() == mu2.hwDPhiExtra() && mu1.hwDEtaExtra() == mu2.hwDEtaExtra() &&
+         mu1.hwRank() == mu2.hwRank() && mu1.hwEtaAtVtx() == mu2.hwEtaAtVtx() && mu1.hwPhiAtVtx() == mu2.hwPhiAtVtx() &&
+         mu1.etaAtVtx() == mu2.etaAtVtx() && mu1.phiAtVtx() == mu2.phiAtVtx() &&
+         mu1.hwPtUnconstrained() == mu2.hwPtUnconstrained() && mu1.ptUnconstrained() == mu2.ptUnconstrained() &&
+         mu1.hwDXY() == mu2.hwDXY();
+}
+
 int L1TMuonProducer::computeMuonIdx(const RegionalMuonCand& mu, int currentLink, int muIdxAuto) const {
   // If the muon index was set in the data format we should use that. Otherwise we use the value computed from the position in the vector.
   if (mu.muIdx() != -1) {
@@ -573,6 +889,33 @@ int L1TMuonProducer::computeMuonIdx(const RegionalMuonCand& mu, int currentLink,
   }
 }
 
+// ------------ method called when starting to processes a stream  ------------
+void L1TMuonProducer::beginStream(edm::StreamID streamID) {
+  if (!m_isoDebugFileName.empty()) {
+    // each stream writes its own file
+    std::string fileName = m_isoDebugFileName;
+    if (streamID.value() > 0) {
+      fileName += "." + std::to_string(streamID.value());
+    }
+    m_isoDebugWriter = std::make_unique<MicroGMTIsoDebugWriter>(fileName);
+  }
+}
+
+// ------------ method called when ending the processing of a stream  ------------
+void L1TMuonProducer::endStream() {
+  if (m_isoDebugWriter) {
+    m_isoDebugWriter->close();
+  }
+  if (m_comparePackedMuons) {
+    edm::LogVerbatim("L1TMuonProducer") << "GMTPackedMuon vs GMTInternalMuon comparison: " << m_differentBxCnt << " of "
+                                        << m_comparedBxCnt << " BXs with different outputs";
+    if (m_differentBxCnt > 0) {
+      throw cms::Exception("L1TMuonProducer") << "GMTPackedMuon and GMTInternalMuon outputs differ in "
+                                              << m_differentBxCnt << " of " << m_comparedBxCnt << " BXs";
+    }
+  }
+}
+
 // ------------ method called when starting to processes a run  ------------
 void L1TMuonProducer::beginRun(edm::Run const& run, edm::EventSetup const& iSetup) {
   edm::ESHandle<L1TMuonGlobalParams> microGMTParamsHandle = iSetup.getHandle(m_microGMTParamsToken);
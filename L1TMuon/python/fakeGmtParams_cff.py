@@ -48,6 +48,7 @@ gmtParams = cms.ESProducer('L1TMuonGlobalParamsESProducer',
     # paths to external lookup tables
     # The paths can be empty for MatchQual and SortRAnk LUTs, in which case
     # the LUTs are generated on the fly by the parameters defined below.
+    # The LUT files can also be in the binary format (convert them with ugmtLutConverter).
     AbsIsoCheckMemLUTPath        = cms.string(os.path.join(lut_dir, 'AbsIsoCheckMem.txt')),
     RelIsoCheckMemLUTPath        = cms.string(os.path.join(lut_dir, 'RelIsoCheckMem.txt')),
     IdxSelMemPhiLUTPath          = cms.string(os.path.join(lut_dir, 'IdxSelMemPhi.txt')),
@@ -17,7 +17,10 @@ simGmtStage2Digis = cms.EDProducer('L1TMuonProducer',
     bxMax = cms.int32(2),
     autoCancelMode = cms.bool(True), # if True the cancel out methods are configured depending on the FW version number and 'bmtfCancelMode' + 'emtfCancelMode' are ignored
     bmtfCancelMode = cms.string("kftracks"), # 'tracks' or 'kftracks' (when using the Run-3 BMTF)
-    emtfCancelMode = cms.string("coordinate") # 'tracks' or 'coordinate'
+    emtfCancelMode = cms.string("coordinate"), # 'tracks' or 'coordinate'
+    #isoDebugFileName = cms.untracked.string("iso_debug.bin"), # binary dump of the calo indices of the output muons, off if empty; decode with ugmtIsoDebugDecoder
+    #usePackedMuons = cms.untracked.bool(False), # if True the muons are processed as the GMTPackedMuon records instead of the GMTInternalMuons
+    #comparePackedMuons = cms.untracked.bool(False), # run both versions, report the BXs where their outputs differ and fail the job if any
 )
 
 # Muon shower trigger
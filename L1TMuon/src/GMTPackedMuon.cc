@@ -0,0 +1,33 @@
+#include "L1Trigger/L1TMuon/interface/GMTPackedMuon.h"
+
+namespace l1t {
+
+  void GMTPackedMuon::set(const RegionalMuonCand& regional, int globalPhi, int tfMuonIndex) {
+    m_input = 0;
+    setField(m_input, kPtPos, kPtBits, regional.hwPt());
+    setField(m_input, kPtUnconstrainedPos, kPtUnconstrainedBits, regional.hwPtUnconstrained());
+    setField(m_input, kEtaPos, kEtaBits, regional.hwEta());
+    setField(m_input, kGlobalPhiPos, kGlobalPhiBits, globalPhi);
+    setField(m_input, kQualPos, kQualBits, regional.hwQual());
+    setField(m_input, kSignPos, 1, regional.hwSign());
+    setField(m_input, kSignValidPos, 1, regional.hwSignValid());
+    setField(m_input, kHFPos, 1, regional.hwHF());
+    setField(m_input, kDXYPos, kDXYBits, regional.hwDXY());
+    setField(m_input, kTfTypePos, kTfTypeBits, regional.trackFinderType());
+    setField(m_input, kProcessorPos, kProcessorBits, regional.processor());
+    setField(m_input, kTfMuonIndexPos, kTfMuonIndexBits, tfMuonIndex);
+
+    m_trackAddress = 0;
+    for (const auto& subAddress : regional.trackAddress()) {
+      if (subAddress.first >= 0 && subAddress.first < (int)kTrackAddressSize) {
+        setField(m_trackAddress, subAddress.first * 8, 8, subAddress.second);
+      }
+    }
+
+    // as in the GMTInternalMuon constructor
+    m_state = 0;
+    setHwAbsIso(-1);
+    setHwRelIso(-1);
+  }
+
+}  // namespace l1t
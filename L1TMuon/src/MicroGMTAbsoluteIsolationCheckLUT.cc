@@ -22,5 +22,8 @@ l1t::MicroGMTAbsoluteIsolationCheckLUT::MicroGMTAbsoluteIsolationCheckLUT(l1t::L
 }
 
 int l1t::MicroGMTAbsoluteIsolationCheckLUT::lookup(int energySum) const {
+  if (m_initialized) {
+    return lookupFlat(checkedInput(energySum, m_energySumInWidth));
+  }
   return lookupPacked(checkedInput(energySum, m_energySumInWidth));
 }
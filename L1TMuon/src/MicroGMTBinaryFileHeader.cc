@@ -0,0 +1,34 @@
+#include "L1Trigger/L1TMuon/interface/MicroGMTBinaryFileHeader.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstring>
+#include <fstream>
+
+l1t::MicroGMTBinaryFileHeader l1t::MicroGMTBinaryFileHeader::make(const Magic& magic, uint32_t version) {
+  MicroGMTBinaryFileHeader header;
+  std::memcpy(header.magic, magic, sizeof(Magic));
+  header.version = version;
+  header.byteOrderMark = nativeByteOrderMark;
+  return header;
+}
+
+bool l1t::MicroGMTBinaryFileHeader::hasMagic(const Magic& magic) const {
+  return std::memcmp(this->magic, magic, sizeof(Magic)) == 0;
+}
+
+void l1t::MicroGMTBinaryFileHeader::checkVersion(uint32_t version, const std::string& fileName) const {
+  if (byteOrderMark != nativeByteOrderMark) {
+    throw cms::Exception("FileFormatError") << fileName << " was written on a machine with a different byte order";
+  }
+  if (this->version != version) {
+    throw cms::Exception("FileFormatError")
+        << fileName << " has version " << this->version << ", expected " << version;
+  }
+}
+
+bool l1t::MicroGMTBinaryFileHeader::fileStartsWith(const std::string& fileName, const Magic& magic) {
+  std::ifstream fstream(fileName, std::ios::in | std::ios::binary);
+  Magic fileMagic;
+  fstream.read(fileMagic, sizeof(fileMagic));
+  return fstream.gcount() == sizeof(fileMagic) && std::memcmp(fileMagic, magic, sizeof(Magic)) == 0;
+}
@@ -34,4 +34,9 @@ l1t::MicroGMTCaloIndexSelectionLUT::MicroGMTCaloIndexSelectionLUT(l1t::LUT* lut,
   m_initialized = true;
 }
 
-int l1t::MicroGMTCaloIndexSelectionLUT::lookup(int angle) const { return lookupPacked(angle); }
+int l1t::MicroGMTCaloIndexSelectionLUT::lookup(int angle) const {
+  if (m_initialized) {
+    return lookupFlat(angle);
+  }
+  return lookupPacked(angle);
+}
@@ -3,6 +3,23 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 namespace l1t {
+  static_assert(RegionalMuonCand::bmtfAddress::kWheelSide < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::bmtfAddress::kWheelNum < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::bmtfAddress::kStat1 < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::bmtfAddress::kStat2 < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::bmtfAddress::kStat3 < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::bmtfAddress::kStat4 < GMTPackedMuon::kTrackAddressSize,
+                "the BMTF sub-addresses used by the cancel-out must be kept in the GMTPackedMuon");
+  static_assert(RegionalMuonCand::emtfAddress::kME1Seg < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::emtfAddress::kME1Ch < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::emtfAddress::kME2Seg < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::emtfAddress::kME2Ch < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::emtfAddress::kME3Seg < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::emtfAddress::kME3Ch < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::emtfAddress::kME4Seg < GMTPackedMuon::kTrackAddressSize &&
+                    RegionalMuonCand::emtfAddress::kME4Ch < GMTPackedMuon::kTrackAddressSize,
+                "the EMTF sub-addresses used by the cancel-out must be kept in the GMTPackedMuon");
+
   MicroGMTCancelOutUnit::MicroGMTCancelOutUnit() {}
 
   MicroGMTCancelOutUnit::~MicroGMTCancelOutUnit() {}
@@ -34,6 +51,11 @@ namespace l1t {
     m_lutDict[tftype::emtf_neg + tftype::emtf_neg * 10] = m_fwdNegSingleMatchQualLUT;
     m_lutDict[tftype::omtf_pos + tftype::emtf_pos * 10] = m_foPosMatchQualLUT;
     m_lutDict[tftype::omtf_neg + tftype::emtf_neg * 10] = m_foNegMatchQualLUT;
+
+    m_lutArray.fill(nullptr);
+    for (const auto& lut : m_lutDict) {
+      m_lutArray[(lut.first % 10) + kNTfTypes * (lut.first / 10)] = lut.second.get();
+    }
   }
 
   void MicroGMTCancelOutUnit::setCancelOutBits(GMTInternalWedges& wedges, tftype trackFinder, cancelmode mode) {
@@ -433,4 +455,375 @@ namespace l1t {
     }
   }
 
+  MicroGMTCancelOutUnit::CancelOutMuons::CancelOutMuons(const GMTPackedMuons& muons,
+                                                        const GMTPackedMuonList& trackFinderMuons,
+                                                        unsigned nWedges,
+                                                        bool withTrackAddress) {
+    // counting sort by the wedge, keeping the order of the list within the wedge
+    std::array<unsigned, kMaxWedges + 1> wedgeEnd{};
+    for (unsigned muonIndex : trackFinderMuons) {
+      unsigned wedge = muons[muonIndex].processor();
+      if (wedge < nWedges) {
+        ++wedgeEnd[wedge + 1];
+      }
+    }
+    for (unsigned wedge = 0; wedge < kMaxWedges; ++wedge) {
+      wedgeEnd[wedge + 1] += wedgeEnd[wedge];
+    }
+    wedgeBegin = wedgeEnd;
+    size = wedgeEnd[nWedges];
+
+    for (unsigned muonIndex : trackFinderMuons) {
+      const GMTPackedMuon& mu = muons[muonIndex];
+      unsigned wedge = mu.processor();
+      if (wedge >= nWedges) {
+        continue;
+      }
+      unsigned pos = wedgeEnd[wedge]++;
+      index[pos] = muonIndex;
+      tfType[pos] = mu.trackFinderType();
+      eta[pos] = mu.hwEta();
+      phi[pos] = mu.hwGlobalPhi();
+      qual[pos] = mu.hwQual();
+      // for EMTF muons set eta fine bit to true since hwHF is the halo bit
+      etaFine[pos] = (tfType[pos] == tftype::emtf_pos || tfType[pos] == tftype::emtf_neg) ? 1 : mu.hwHF();
+      if (withTrackAddress) {
+        trackAddress[pos] = MicroGMTCancelOutUnit::trackAddress(mu);
+      }
+    }
+  }
+
+  void MicroGMTCancelOutUnit::CancelOutSelection::addWedge(const CancelOutMuons& muons, unsigned wedge) {
+    for (unsigned i = muons.wedgeBegin[wedge]; i < muons.wedgeBegin[wedge + 1]; ++i) {
+      pos[size++] = i;
+    }
+  }
+
+  MicroGMTMatchQualLUT* MicroGMTCancelOutUnit::matchQualLUT(tftype tfType1, tftype tfType2) const {
+    MicroGMTMatchQualLUT* lut = m_lutArray[tfType1 + kNTfTypes * tfType2];
+    if (lut == nullptr) {
+      // throws std::out_of_range for the pairs without the LUT, as the GMTInternalMuon version
+      lut = m_lutDict.at(tfType1 + tfType2 * 10).get();
+    }
+    return lut;
+  }
+
+  void MicroGMTCancelOutUnit::setCancelOutBits(GMTPackedMuons& muons,
+                                               const GMTPackedMuonList& trackFinderMuons,
+                                               tftype trackFinder,
+                                               cancelmode mode) {
+    unsigned maxWedges = 6;
+    if (trackFinder == bmtf) {
+      maxWedges = 12;
+    }
+    CancelOutMuons coMuons(muons, trackFinderMuons, maxWedges, mode != cancelmode::coordinate);
+    for (unsigned currentWedge = 0; currentWedge < maxWedges; ++currentWedge) {
+      CancelOutSelection sel1;
+      sel1.addWedge(coMuons, currentWedge);
+      // handle wrap around: max "wedge" has to be compared to first "wedge"
+      CancelOutSelection sel2;
+      sel2.addWedge(coMuons, (currentWedge + 1) % maxWedges);
+      if (mode == cancelmode::coordinate) {
+        cancelOut(mode, muons, coMuons, sel2, coMuons, sel1);  // in case of a tie sel1 muon wins
+      } else {
+        cancelOut(mode, muons, coMuons, sel1, coMuons, sel2);
+      }
+    }
+  }
+
+  void MicroGMTCancelOutUnit::setCancelOutBitsOverlapBarrel(GMTPackedMuons& muons,
+                                                            const GMTPackedMuonList& omtfMuons,
+                                                            const GMTPackedMuonList& bmtfMuons,
+                                                            cancelmode mode) {
+    bool withTrackAddress = mode != cancelmode::coordinate;
+    CancelOutMuons coOmtfMuons(muons, omtfMuons, 6, withTrackAddress);
+    CancelOutMuons coBmtfMuons(muons, bmtfMuons, 12, withTrackAddress);
+    for (unsigned currentSector = 0; currentSector < 6; ++currentSector) {
+      CancelOutSelection sel1;
+      sel1.addWedge(coOmtfMuons, currentSector);
+      // OMTF sector x with the BMTF wedges 2x .. 2x+3, see the GMTInternalWedges version
+      CancelOutSelection sel2;
+      for (unsigned i = 0; i < 4; ++i) {
+        sel2.addWedge(coBmtfMuons, (currentSector * 2 + i) % 12);
+      }
+      cancelOut(mode, muons, coOmtfMuons, sel1, coBmtfMuons, sel2);
+    }
+  }
+
+  void MicroGMTCancelOutUnit::setCancelOutBitsOverlapEndcap(GMTPackedMuons& muons,
+                                                            const GMTPackedMuonList& omtfMuons,
+                                                            const GMTPackedMuonList& emtfMuons,
+                                                            cancelmode mode) {
+    bool withTrackAddress = mode != cancelmode::coordinate;
+    CancelOutMuons coOmtfMuons(muons, omtfMuons, 6, withTrackAddress);
+    CancelOutMuons coEmtfMuons(muons, emtfMuons, 6, withTrackAddress);
+    for (unsigned curOmtfSector = 0; curOmtfSector < 6; ++curOmtfSector) {
+      CancelOutSelection sel1;
+      sel1.addWedge(coOmtfMuons, curOmtfSector);
+      // OMTF sector x with the EMTF sectors x-1, x, x+1, see the GMTInternalWedges version
+      CancelOutSelection sel2;
+      for (unsigned i = 0; i < 3; ++i) {
+        sel2.addWedge(coEmtfMuons, ((curOmtfSector + 5) + i) % 6);
+      }
+      cancelOut(mode, muons, coOmtfMuons, sel1, coEmtfMuons, sel2);
+    }
+  }
+
+  void MicroGMTCancelOutUnit::cancelOut(cancelmode mode,
+                                        GMTPackedMuons& muons,
+                                        const CancelOutMuons& muons1,
+                                        const CancelOutSelection& sel1,
+                                        const CancelOutMuons& muons2,
+                                        const CancelOutSelection& sel2) {
+    if (sel1.size == 0 || sel2.size == 0) {
+      return;
+    }
+    tftype coll1TfType = muons1.tfType[sel1.pos[0]];
+    tftype coll2TfType = muons2.tfType[sel2.pos[0]];
+
+    // the match matrix, match[i2] for the muon i1 is computed first, then the cancel bits are set.
+    // The matches do not depend on the cancel bits, so the order does not change the result
+    std::array<bool, GMTPackedMuons::kMaxMuons> match;
+
+    if (mode == cancelmode::coordinate) {
+      if (coll2TfType != tftype::bmtf && coll1TfType % 2 != coll2TfType % 2) {
+        edm::LogError("Detector side mismatch")
+            << "Overlap-Endcap cancel out between positive and negative detector side attempted. Check eta assignment. "
+               "OMTF candidate: TF type: "
+            << coll1TfType << ", hwEta: " << muons1.eta[sel1.pos[0]] << ". EMTF candidate: TF type: " << coll2TfType
+            << ", hwEta: " << muons2.eta[sel2.pos[0]] << ". TF type even: pos. side; odd: neg. side." << std::endl;
+        return;
+      }
+
+      // resolved once for the wedge pair
+      MicroGMTMatchQualLUT* matchLUT = matchQualLUT(coll1TfType, coll2TfType);
+      // The LUT for cancellation takes reduced width phi and eta, we need the LSBs
+      const int dPhiMask = (1 << matchLUT->getDeltaPhiWidth()) - 1;
+      const int dEtaMask = (1 << matchLUT->getDeltaEtaWidth()) - 1;
+
+      for (unsigned i1 = 0; i1 < sel1.size; ++i1) {
+        const unsigned pos1 = sel1.pos[i1];
+        const int eta1 = muons1.eta[pos1];
+        const int phi1 = muons1.phi[pos1];
+        const int etaFine1 = muons1.etaFine[pos1];
+        for (unsigned i2 = 0; i2 < sel2.size; ++i2) {
+          const unsigned pos2 = sel2.pos[i2];
+          int dPhi = std::abs(phi1 - muons2.phi[pos2]);
+          if (dPhi > 338)
+            dPhi -= 576;  // shifts dPhi to [-pi, pi) in integer scale
+          dPhi = std::abs(dPhi);
+          int dEta = std::abs(eta1 - muons2.eta[pos2]);
+          // the LUT is looked up only for the close muons
+          match[i2] = dEta <= dEtaMask && dPhi <= dPhiMask;
+          if (match[i2]) {
+            // both muons must have the eta fine bit set in order to use the eta fine part of the LUT
+            int etaFine = (int)(etaFine1 > 0 && muons2.etaFine[pos2] > 0);
+            match[i2] = matchLUT->lookup(etaFine, dEta & dEtaMask, dPhi & dPhiMask) == 1;
+          }
+        }
+        // the muon 1 is cancelled for the equal quality
+        setCancelBits(muons, muons1, pos1, muons2, sel2, match, false);
+      }
+      return;
+    }
+
+    int (*nMatchedStations)(const TrackAddress&, const TrackAddress&) = nullptr;
+    if (coll1TfType == tftype::bmtf && coll2TfType == tftype::bmtf) {
+      if (mode == cancelmode::tracks) {
+        nMatchedStations = nMatchedStationsOrigBMTF;
+      } else if (mode == cancelmode::kftracks) {
+        nMatchedStations = nMatchedStationsKfBMTF;
+      } else {
+        return;
+      }
+    } else if ((coll1TfType == tftype::emtf_pos && coll2TfType == tftype::emtf_pos) ||
+               (coll1TfType == tftype::emtf_neg && coll2TfType == tftype::emtf_neg)) {
+      nMatchedStations = nMatchedStationsEMTF;
+    } else {
+      edm::LogError("Cancel out not implemented")
+          << "Address based cancel out is currently only implemented for the barrel track finder.";
+      return;
+    }
+
+    for (unsigned i1 = 0; i1 < sel1.size; ++i1) {
+      const unsigned pos1 = sel1.pos[i1];
+      const TrackAddress& trkAddr1 = muons1.trackAddress[pos1];
+      for (unsigned i2 = 0; i2 < sel2.size; ++i2) {
+        match[i2] = nMatchedStations(trkAddr1, muons2.trackAddress[sel2.pos[i2]]) > 0;
+      }
+      // the muon 2 is cancelled for the equal quality
+      setCancelBits(muons, muons1, pos1, muons2, sel2, match, true);
+    }
+  }
+
+  void MicroGMTCancelOutUnit::setCancelBits(GMTPackedMuons& muons,
+                                            const CancelOutMuons& muons1,
+                                            unsigned pos1,
+                                            const CancelOutMuons& muons2,
+                                            const CancelOutSelection& sel2,
+                                            const std::array<bool, GMTPackedMuons::kMaxMuons>& match,
+                                            bool coll1WinsTie) {
+    const int qual1 = muons1.qual[pos1];
+    for (unsigned i2 = 0; i2 < sel2.size; ++i2) {
+      if (match[i2]) {
+        const unsigned pos2 = sel2.pos[i2];
+        const int qual2 = muons2.qual[pos2];
+        if (qual1 > qual2 || (coll1WinsTie && qual1 == qual2)) {
+          muons[muons2.index[pos2]].setHwCancelBit(1);
+        } else {
+          muons[muons1.index[pos1]].setHwCancelBit(1);
+        }
+      }
+    }
+  }
+
+  MicroGMTCancelOutUnit::TrackAddress MicroGMTCancelOutUnit::trackAddress(const GMTPackedMuon& mu) {
+    TrackAddress trkAddr;
+    for (unsigned key = 0; key < trkAddr.size(); ++key) {
+      trkAddr[key] = mu.trackAddress(key);
+    }
+    return trkAddr;
+  }
+
+  int MicroGMTCancelOutUnit::nMatchedStationsEMTF(const TrackAddress& trkAddr_s1, const TrackAddress& trkAddr_s2) {
+    int me1_ch_s1 = trkAddr_s1[l1t::RegionalMuonCand::emtfAddress::kME1Ch];
+    int me2_ch_s1 = trkAddr_s1[l1t::RegionalMuonCand::emtfAddress::kME2Ch];
+    int me3_ch_s1 = trkAddr_s1[l1t::RegionalMuonCand::emtfAddress::kME3Ch];
+    int me4_ch_s1 = trkAddr_s1[l1t::RegionalMuonCand::emtfAddress::kME4Ch];
+    if (me1_ch_s1 + me2_ch_s1 + me3_ch_s1 + me4_ch_s1 == 0) {
+      return 0;
+    }
+    int me1_ch_s2 = trkAddr_s2[l1t::RegionalMuonCand::emtfAddress::kME1Ch];
+    int me2_ch_s2 = trkAddr_s2[l1t::RegionalMuonCand::emtfAddress::kME2Ch];
+    int me3_ch_s2 = trkAddr_s2[l1t::RegionalMuonCand::emtfAddress::kME3Ch];
+    int me4_ch_s2 = trkAddr_s2[l1t::RegionalMuonCand::emtfAddress::kME4Ch];
+    if (me1_ch_s2 + me2_ch_s2 + me3_ch_s2 + me4_ch_s2 == 0) {
+      return 0;
+    }
+    int me1_seg_s1 = trkAddr_s1[l1t::RegionalMuonCand::emtfAddress::kME1Seg];
+    int me2_seg_s1 = trkAddr_s1[l1t::RegionalMuonCand::emtfAddress::kME2Seg];
+    int me3_seg_s1 = trkAddr_s1[l1t::RegionalMuonCand::emtfAddress::kME3Seg];
+    int me4_seg_s1 = trkAddr_s1[l1t::RegionalMuonCand::emtfAddress::kME4Seg];
+    int me1_seg_s2 = trkAddr_s2[l1t::RegionalMuonCand::emtfAddress::kME1Seg];
+    int me2_seg_s2 = trkAddr_s2[l1t::RegionalMuonCand::emtfAddress::kME2Seg];
+    int me3_seg_s2 = trkAddr_s2[l1t::RegionalMuonCand::emtfAddress::kME3Seg];
+    int me4_seg_s2 = trkAddr_s2[l1t::RegionalMuonCand::emtfAddress::kME4Seg];
+
+    int nMatchedStations = 0;
+    if (me1_ch_s2 != 0 && me1_ch_s1 == me1_ch_s2 + 3 && me1_seg_s1 == me1_seg_s2) {
+      ++nMatchedStations;
+    }
+    if (me2_ch_s2 != 0 && me2_ch_s1 == me2_ch_s2 + 2 && me2_seg_s1 == me2_seg_s2) {
+      ++nMatchedStations;
+    }
+    if (me3_ch_s2 != 0 && me3_ch_s1 == me3_ch_s2 + 2 && me3_seg_s1 == me3_seg_s2) {
+      ++nMatchedStations;
+    }
+    if (me4_ch_s2 != 0 && me4_ch_s1 == me4_ch_s2 + 2 && me4_seg_s1 == me4_seg_s2) {
+      ++nMatchedStations;
+    }
+    return nMatchedStations;
+  }
+
+  int MicroGMTCancelOutUnit::nMatchedStationsOrigBMTF(const TrackAddress& trkAddr_w1, const TrackAddress& trkAddr_w2) {
+    int wheelNum_w1 = trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kWheelNum];
+    int wheelSide_w1 = trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kWheelSide];
+    const int stations_w1[4] = {trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kStat1],
+                                 trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kStat2],
+                                 trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kStat3],
+                                 trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kStat4]};
+    int wheelNum_w2 = trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kWheelNum];
+    int wheelSide_w2 = trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kWheelSide];
+    const int stations_w2[4] = {trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kStat1],
+                                 trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kStat2],
+                                 trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kStat3],
+                                 trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kStat4]};
+
+    int nMatchedStations = 0;
+    // search for duplicates in stations 2-4
+    for (int i = 1; i < 4; ++i) {
+      if (wheelSide_w1 == wheelSide_w2) {  // both tracks are on the same detector side
+        if (wheelNum_w1 == wheelNum_w2) {  // both tracks have the same reference wheel
+          if ((stations_w1[i] == 0x0 && stations_w2[i] == 0x2) || (stations_w1[i] == 0x1 && stations_w2[i] == 0x3) ||
+              (stations_w1[i] == 0x4 && stations_w2[i] == 0x0) || (stations_w1[i] == 0x5 && stations_w2[i] == 0x1) ||
+              (stations_w1[i] == 0x8 && stations_w2[i] == 0xA) || (stations_w1[i] == 0x9 && stations_w2[i] == 0xB) ||
+              (stations_w1[i] == 0xC && stations_w2[i] == 0x8) || (stations_w1[i] == 0xD && stations_w2[i] == 0x9)) {
+            ++nMatchedStations;
+          }
+        } else if (wheelNum_w1 == wheelNum_w2 - 1) {  // track 2 is one wheel higher than track 1
+          if ((stations_w1[i] == 0x0 && stations_w2[i] == 0xA) || (stations_w1[i] == 0x1 && stations_w2[i] == 0xB) ||
+              (stations_w1[i] == 0x4 && stations_w2[i] == 0x8) || (stations_w1[i] == 0x5 && stations_w2[i] == 0x9)) {
+            ++nMatchedStations;
+          }
+        } else if (wheelNum_w1 == wheelNum_w2 + 1) {  // track 2 is one wheel lower than track 1
+          if ((stations_w1[i] == 0x8 && stations_w2[i] == 0x2) || (stations_w1[i] == 0x9 && stations_w2[i] == 0x3) ||
+              (stations_w1[i] == 0xC && stations_w2[i] == 0x0) || (stations_w1[i] == 0xD && stations_w2[i] == 0x1)) {
+            ++nMatchedStations;
+          }
+        }
+      } else {
+        if (wheelNum_w1 == 0 && wheelNum_w2 == 0) {  // both tracks are on either side of the central wheel (+0 and -0)
+          if ((stations_w1[i] == 0x8 && stations_w2[i] == 0xA) || (stations_w1[i] == 0x9 && stations_w2[i] == 0xB) ||
+              (stations_w1[i] == 0xC && stations_w2[i] == 0x8) || (stations_w1[i] == 0xD && stations_w2[i] == 0x9)) {
+            ++nMatchedStations;
+          }
+        }
+      }
+    }
+    return nMatchedStations;
+  }
+
+  int MicroGMTCancelOutUnit::nMatchedStationsKfBMTF(const TrackAddress& trkAddr_w1, const TrackAddress& trkAddr_w2) {
+    int wheelNum_w1 = trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kWheelNum];
+    int wheelSide_w1 = trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kWheelSide];
+    const int stations_w1[4] = {trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kStat1],
+                                 trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kStat2],
+                                 trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kStat3],
+                                 trkAddr_w1[l1t::RegionalMuonCand::bmtfAddress::kStat4]};
+    int wheelNum_w2 = trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kWheelNum];
+    int wheelSide_w2 = trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kWheelSide];
+    const int stations_w2[4] = {trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kStat1],
+                                 trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kStat2],
+                                 trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kStat3],
+                                 trkAddr_w2[l1t::RegionalMuonCand::bmtfAddress::kStat4]};
+
+    int nMatchedStations = 0;
+    // search for duplicates in stations 1-3
+    for (int i = 0; i < 3; ++i) {
+      if (wheelSide_w1 == wheelSide_w2) {  // both tracks are on the same detector side
+        if (wheelNum_w1 == wheelNum_w2) {  // both tracks have the same reference wheel
+          if ((stations_w1[i] == 0x2 && stations_w2[i] == 0x0) || (stations_w1[i] == 0x3 && stations_w2[i] == 0x1) ||
+              (stations_w1[i] == 0x0 && stations_w2[i] == 0x4) || (stations_w1[i] == 0x1 && stations_w2[i] == 0x5) ||
+              (stations_w1[i] == 0xA && stations_w2[i] == 0x8) || (stations_w1[i] == 0xB && stations_w2[i] == 0x9) ||
+              (stations_w1[i] == 0x8 && stations_w2[i] == 0xC) || (stations_w1[i] == 0x9 && stations_w2[i] == 0xD)) {
+            ++nMatchedStations;
+          }
+        } else if (wheelNum_w1 == wheelNum_w2 - 1) {  // track 2 is one wheel higher than track 1
+          if ((stations_w1[i] == 0xA && stations_w2[i] == 0x0) || (stations_w1[i] == 0xB && stations_w2[i] == 0x1) ||
+              (stations_w1[i] == 0x8 && stations_w2[i] == 0x4) || (stations_w1[i] == 0x9 && stations_w2[i] == 0x5)) {
+            ++nMatchedStations;
+          }
+        } else if (wheelNum_w1 == wheelNum_w2 + 1) {  // track 2 is one wheel lower than track 1
+          if ((stations_w1[i] == 0x2 && stations_w2[i] == 0x8) || (stations_w1[i] == 0x3 && stations_w2[i] == 0x9) ||
+              (stations_w1[i] == 0x0 && stations_w2[i] == 0xC) || (stations_w1[i] == 0x1 && stations_w2[i] == 0xD)) {
+            ++nMatchedStations;
+          }
+        }
+      } else {  // If one muon in 0+ and one muon in 0- (0+ and 0- are physically the same wheel), however wheel 0 is not split in kalman algorithm
+        if (wheelNum_w1 == 0 && wheelNum_w2 == 1) {
+          if ((stations_w1[i] == 0xA && stations_w2[i] == 0x0) || (stations_w1[i] == 0xB && stations_w2[i] == 0x1) ||
+              (stations_w1[i] == 0x8 && stations_w2[i] == 0x4) || (stations_w1[i] == 0x9 && stations_w2[i] == 0x5)) {
+            ++nMatchedStations;
+          }
+        } else if (wheelNum_w1 == 1 && wheelNum_w2 == 0) {
+          if ((stations_w1[i] == 0x2 && stations_w2[i] == 0x8) || (stations_w1[i] == 0x3 && stations_w2[i] == 0x9) ||
+              (stations_w1[i] == 0x0 && stations_w2[i] == 0xC) || (stations_w1[i] == 0x1 && stations_w2[i] == 0xD)) {
+            ++nMatchedStations;
+          }
+        }
+      }
+    }
+    return nMatchedStations;
+  }
+
 }  // namespace l1t
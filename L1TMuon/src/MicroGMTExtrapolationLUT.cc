@@ -40,7 +40,7 @@ int l1t::MicroGMTExtrapolationLUT::lookup(int eta, int pt) const {
   // normalize these two to the same scale and then calculate?
   if (m_initialized) {
     // unsigned eta_twocomp = MicroGMTConfiguration::getTwosComp(eta, m_etaRedInWidth);
-    return lookupPacked(hashInput(checkedInput(eta, m_etaRedInWidth), checkedInput(pt, m_ptRedInWidth)));
+    return lookupFlat(hashInput(checkedInput(eta, m_etaRedInWidth), checkedInput(pt, m_ptRedInWidth)));
   }
   int result = 0;
   // normalize to out width
@@ -0,0 +1,90 @@
+#include "L1Trigger/L1TMuon/interface/MicroGMTIsoDebugWriter.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <chrono>
+
+l1t::MicroGMTIsoDebugWriter::MicroGMTIsoDebugWriter(const std::string& fileName, unsigned bufferSizeLog2)
+    : m_file(fileName, std::ios::out | std::ios::binary),
+      m_buffer(1ULL << bufferSizeLog2),
+      m_mask((1ULL << bufferSizeLog2) - 1),
+      m_head(0),
+      m_tail(0),
+      m_stop(false) {
+  if (!m_file.good()) {
+    throw cms::Exception("FileOpenError") << "Failed to open iso debug file: " << fileName;
+  }
+  MicroGMTBinaryFileHeader header = MicroGMTBinaryFileHeader::make(magic, version);
+  m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  m_thread = std::thread(&MicroGMTIsoDebugWriter::run, this);
+}
+
+l1t::MicroGMTIsoDebugWriter::~MicroGMTIsoDebugWriter() { close(); }
+
+void l1t::MicroGMTIsoDebugWriter::close() {
+  if (!m_thread.joinable()) {
+    return;
+  }
+  m_stop.store(true, std::memory_order_release);
+  m_thread.join();
+  m_file.close();
+}
+
+void l1t::MicroGMTIsoDebugWriter::run() {
+  while (true) {
+    // the records written before the stop was set are drained below
+    bool stop = m_stop.load(std::memory_order_acquire);
+    bool drained = drain();
+    if (stop) {
+      break;
+    }
+    if (!drained) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  }
+  m_file.flush();
+}
+
+bool l1t::MicroGMTIsoDebugWriter::drain() {
+  uint64_t tail = m_tail.load(std::memory_order_relaxed);
+  uint64_t head = m_head.load(std::memory_order_acquire);
+  if (head == tail) {
+    return false;
+  }
+  // the ring buffer content is written in at most two contiguous pieces
+  while (tail != head) {
+    uint64_t begin = tail & m_mask;
+    uint64_t count = std::min<uint64_t>(head - tail, m_buffer.size() - begin);
+    m_file.write(reinterpret_cast<const char*>(&m_buffer[begin]), count * sizeof(Record));
+    tail += count;
+    m_tail.store(tail, std::memory_order_release);
+  }
+  return true;
+}
+
+void l1t::MicroGMTIsoDebugWriter::decodeToText(const std::string& fileName, std::ostream& out) {
+  std::ifstream inFile(fileName, std::ios::in | std::ios::binary);
+  if (!inFile.good()) {
+    throw cms::Exception("FileOpenError") << "Failed to open iso debug file: " << fileName;
+  }
+
+  MicroGMTBinaryFileHeader header;
+  inFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (inFile.gcount() != sizeof(header) || !header.hasMagic(magic)) {
+    throw cms::Exception("FileFormatError") << fileName << " is not an iso debug file";
+  }
+  header.checkVersion(version, fileName);
+
+  std::vector<Record> records(4096);
+  while (inFile) {
+    inFile.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(Record));
+    std::streamsize nRecords = inFile.gcount() / sizeof(Record);
+    if (inFile.gcount() % sizeof(Record) != 0) {
+      throw cms::Exception("FileFormatError") << fileName << " is truncated";
+    }
+    for (std::streamsize i = 0; i < nRecords; ++i) {
+      out << records[i].hwCaloPhi << " " << records[i].hwCaloEta << "\n";
+    }
+  }
+}
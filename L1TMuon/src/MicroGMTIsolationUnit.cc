@@ -47,8 +47,12 @@ void l1t::MicroGMTIsolationUnit::initialise(L1TMuonGlobalParamsHelper* microGMTP
   m_maskedCaloInputs = microGMTParamsHelper->maskedCaloInputs();
 }
 
-int l1t::MicroGMTIsolationUnit::getCaloIndex(MicroGMTConfiguration::InterMuon& mu) const {
-  // handle the wrap-around of phi:
+int l1t::MicroGMTIsolationUnit::getCaloIndex(MicroGMTConfiguration::InterMuon& mu) const { return caloIndex(mu); }
+
+int l1t::MicroGMTIsolationUnit::getCaloIndex(GMTPackedMuon& mu) const { return caloIndex(mu); }
+
+template <class MuonType>
+int l1t::MicroGMTIsolationUnit::caloIndex(MuonType& mu) const {
   int phi = (mu.hwGlobalPhi() + mu.hwDPhi()) % 576;
   if (phi < 0) {
     phi = 576 + phi;
@@ -65,6 +69,19 @@ int l1t::MicroGMTIsolationUnit::getCaloIndex(MicroGMTConfiguration::InterMuon& m
 }
 
 void l1t::MicroGMTIsolationUnit::extrapolateMuons(MicroGMTConfiguration::InterMuonList& inputmuons) const {
+  for (auto& mu : inputmuons) {
+    extrapolateMuon(*mu);
+  }
+}
+
+void l1t::MicroGMTIsolationUnit::extrapolateMuons(GMTPackedMuons& muons, const GMTPackedMuonList& inputmuons) const {
+  for (unsigned index : inputmuons) {
+    extrapolateMuon(muons[index]);
+  }
+}
+
+template <class MuonType>
+void l1t::MicroGMTIsolationUnit::extrapolateMuon(MuonType& mu) const {
   int outputShiftPhi = 3;
   int outputShiftEta = 3;
   if (m_fwVersion >= 0x4010000) {
@@ -72,36 +89,31 @@ void l1t::MicroGMTIsolationUnit::extrapolateMuons(MicroGMTConfiguration::InterMu
     outputShiftEta = 0;
   }
 
-  for (auto& mu : inputmuons) {
-    // get input format
-    std::shared_ptr<MicroGMTExtrapolationLUT> phiExtrapolationLUT = m_phiExtrapolationLUTs.at(mu->trackFinderType());
-    int ptRedInWidth = phiExtrapolationLUT->getPtRedInWidth();
-    int ptMask = (1 << ptRedInWidth) - 1;
-    int etaRedInWidth = phiExtrapolationLUT->getEtaRedInWidth();
-    int redEtaShift = 8 - etaRedInWidth;
-
-    // only use LSBs of pt:
-    int ptRed = mu->hwPt() & ptMask;
-    // here we drop the LSBs and mask the MSB
-    int etaAbsRed = (std::abs(mu->hwEta()) >> redEtaShift) & ((1 << etaRedInWidth) - 1);
-
-    int deltaPhi = 0;
-    int deltaEta = 0;
-
-    if (mu->hwPt() < (1 << ptRedInWidth)) {  // extrapolation only for "low" pT muons
-      int sign = 1;
-      if (mu->hwSign() == 1) {
-        sign = -1;
-      }
-      deltaPhi = (phiExtrapolationLUT->lookup(etaAbsRed, ptRed) << outputShiftPhi) * sign;
-      deltaEta = (m_etaExtrapolationLUTs.at(mu->trackFinderType())->lookup(etaAbsRed, ptRed) << outputShiftEta);
-      if (mu->hwEta() > 0) {
-        deltaEta *= -1;
-      }
-    }
+  std::shared_ptr<MicroGMTExtrapolationLUT> phiExtrapolationLUT = m_phiExtrapolationLUTs.at(mu.trackFinderType());
+  int ptRedInWidth = phiExtrapolationLUT->getPtRedInWidth();
+  int ptMask = (1 << ptRedInWidth) - 1;
+  int etaRedInWidth = phiExtrapolationLUT->getEtaRedInWidth();
+  int redEtaShift = 8 - etaRedInWidth;
 
-    mu->setExtrapolation(deltaEta, deltaPhi);
+  int ptRed = mu.hwPt() & ptMask;
+  int etaAbsRed = (std::abs(mu.hwEta()) >> redEtaShift) & ((1 << etaRedInWidth) - 1);
+
+  int deltaPhi = 0;
+  int deltaEta = 0;
+
+  if (mu.hwPt() < (1 << ptRedInWidth)) {  // extrapolation only for "low" pT muons
+    int sign = 1;
+    if (mu.hwSign() == 1) {
+      sign = -1;
+    }
+    deltaPhi = (phiExtrapolationLUT->lookup(etaAbsRed, ptRed) << outputShiftPhi) * sign;
+    deltaEta = (m_etaExtrapolationLUTs.at(mu.trackFinderType())->lookup(etaAbsRed, ptRed) << outputShiftEta);
+    if (mu.hwEta() > 0) {
+      deltaEta *= -1;
+    }
   }
+
+  mu.setExtrapolation(deltaEta, deltaPhi);
 }
 
 void l1t::MicroGMTIsolationUnit::calculate5by1Sums(const MicroGMTConfiguration::CaloInputCollection& inputs, int bx) {
@@ -202,18 +214,29 @@ void l1t::MicroGMTIsolationUnit::setTowerSums(const MicroGMTConfiguration::CaloI
 
 void l1t::MicroGMTIsolationUnit::isolatePreSummed(MicroGMTConfiguration::InterMuonList& muons) const {
   for (const auto& mu : muons) {
-    int caloIndex = getCaloIndex(*mu);
-    int energySum = 0;
-    if (m_towerEnergies.count(caloIndex) == 1) {
-      energySum = m_towerEnergies.at(caloIndex);
-    }
-
-    mu->setHwIsoSum(energySum);
+    isolatePreSummedMuon(*mu);
+  }
+}
 
-    int absIso = m_AbsIsoCheckMem->lookup(energySum);
-    int relIso = m_RelIsoCheckMem->lookup(energySum, mu->hwPt());
+void l1t::MicroGMTIsolationUnit::isolatePreSummed(GMTPackedMuons& muons, const GMTPackedMuonList& isolatedMuons) const {
+  for (unsigned index : isolatedMuons) {
+    isolatePreSummedMuon(muons[index]);
+  }
+}
 
-    mu->setHwRelIso(relIso);
-    mu->setHwAbsIso(absIso);
+template <class MuonType>
+void l1t::MicroGMTIsolationUnit::isolatePreSummedMuon(MuonType& mu) const {
+  int caloIdx = caloIndex(mu);
+  int energySum = 0;
+  if (m_towerEnergies.count(caloIdx) == 1) {
+    energySum = m_towerEnergies.at(caloIdx);
   }
+
+  mu.setHwIsoSum(energySum);
+
+  int absIso = m_AbsIsoCheckMem->lookup(energySum);
+  int relIso = m_RelIsoCheckMem->lookup(energySum, mu.hwPt());
+
+  mu.setHwRelIso(relIso);
+  mu.setHwAbsIso(absIso);
 }
@@ -3,33 +3,91 @@
 #include "FWCore/Utilities/interface/Exception.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
+#include <charconv>
+#include <limits>
+
 l1t::MicroGMTLUT::MicroGMTLUT(l1t::LUT* lut) : m_totalInWidth(0), m_outWidth(0), m_initialized(true) {
-  std::stringstream ss;
-  lut->write(ss);
-  read(ss);
+  // copies the contents directly, without writing and reading them as text
+  LUT::operator=(*lut);
+  flatten();
 }
 
 // I/O functions
 void l1t::MicroGMTLUT::save(std::ofstream& output) { write(output); }
 
+void l1t::MicroGMTLUT::saveBinary(std::ofstream& output) const {
+  std::vector<int16_t> values;
+  if (!empty()) {
+    values.resize(1u << nrBitsAddress());
+    for (unsigned address = 0; address < values.size(); ++address) {
+      int value = data(address);
+      if (value < std::numeric_limits<int16_t>::min() || value > std::numeric_limits<int16_t>::max()) {
+        throw cms::Exception("LUTError") << "LUT value " << value << " at address " << address
+                                         << " does not fit into the binary format";
+      }
+      values[address] = value;
+    }
+  }
+
+  BinaryHeader header;
+  header.fileType = MicroGMTBinaryFileHeader::make(magic, version);
+  header.addressWidth = nrBitsAddress();
+  header.dataWidth = nrBitsData();
+  header.nEntries = values.size();
+  header.checksum = checksum(values);
+
+  output.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(int16_t));
+}
+
 int l1t::MicroGMTLUT::load(const std::string& inFileName) {
-  std::ifstream fstream;
-  fstream.open(edm::FileInPath(inFileName.c_str()).fullPath());
+  return loadFile(edm::FileInPath(inFileName.c_str()).fullPath());
+}
+
+int l1t::MicroGMTLUT::loadFile(const std::string& fullPath) {
+  std::ifstream fstream(fullPath, std::ios::in | std::ios::binary);
   if (!fstream.good()) {
-    fstream.close();
-    throw cms::Exception("FileOpenError") << "Failed to open LUT file: " << inFileName;
+    throw cms::Exception("FileOpenError") << "Failed to open LUT file: " << fullPath;
   }
-  int readCode = read(fstream);
 
-  m_initialized = true;
-  fstream.close();
+  BinaryHeader header;
+  fstream.read(reinterpret_cast<char*>(&header), sizeof(header));
+  if (fstream.gcount() != sizeof(header) || !header.fileType.hasMagic(magic)) {
+    // the text format
+    fstream.clear();
+    fstream.seekg(0);
+    int readCode = read(fstream);
+    flatten();
 
+    m_initialized = true;
+    return readCode;
+  }
+
+  header.fileType.checkVersion(version, fullPath);
+  if (header.nEntries != 0 && (header.addressWidth > 20 || header.nEntries != (1u << header.addressWidth))) {
+    throw cms::Exception("FileFormatError") << fullPath << " has " << header.nEntries << " entries for the address width "
+                                            << header.addressWidth;
+  }
+
+  std::vector<int16_t> values(header.nEntries);
+  fstream.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(int16_t));
+  if (fstream.gcount() != static_cast<std::streamsize>(values.size() * sizeof(int16_t))) {
+    throw cms::Exception("FileFormatError") << fullPath << " is truncated";
+  }
+  if (checksum(values) != header.checksum) {
+    throw cms::Exception("FileFormatError") << fullPath << " has a wrong checksum";
+  }
+
+  // for the empty LUT also the contents loaded before are dropped
+  int readCode = setContents(header.addressWidth, header.dataWidth, std::vector<int>(values.begin(), values.end()));
+
+  m_initialized = true;
   return readCode;
 }
 
 int l1t::MicroGMTLUT::lookupPacked(const int input) const {
   if (m_initialized) {
-    return data((unsigned int)input);
+    return lookupFlat((unsigned int)input);
   }
   throw cms::Exception("Uninitialized") << "If you're not loading a LUT from file you need to implement lookupPacked.";
   return 0;
@@ -37,18 +95,92 @@ int l1t::MicroGMTLUT::lookupPacked(const int input) const {
 
 void l1t::MicroGMTLUT::initialize() {
   if (empty()) {
-    std::stringstream stream;
-    stream << "#<header> V1 " << m_totalInWidth << " " << m_outWidth << " </header> " << std::endl;
+    std::vector<int> contents(1 << m_totalInWidth);
     for (int in = 0; in < (1 << m_totalInWidth); ++in) {
-      int out = lookupPacked(in);
-      stream << in << " " << out << std::endl;
+      contents[in] = lookupPacked(in);
     }
-    read(stream);
+    setContents(m_totalInWidth, m_outWidth, contents);
+  } else {
+    flatten();
   }
   m_initialized = true;
 }
 
-int l1t::MicroGMTLUT::checkedInput(unsigned in, unsigned maxWidth) const {
-  unsigned maxIn = (1 << maxWidth) - 1;
-  return (in < maxIn ? in : maxIn);
+int l1t::MicroGMTLUT::setContents(unsigned addressWidth, unsigned dataWidth, const std::vector<int>& contents) {
+  if (contents.empty()) {
+    clear();
+    return LUT::SUCCESS;
+  }
+  if (addressWidth > 20 || contents.size() != (1u << addressWidth)) {
+    throw cms::Exception("LUTError") << contents.size() << " LUT values for the address width " << addressWidth;
+  }
+  if (dataWidth > 15) {
+    throw cms::Exception("LUTError") << "LUT data width " << dataWidth << " too large for the flat table";
+  }
+
+  // the l1t::LUT (CondFormats/L1TObjects) has no setter, its contents can be set only by reading the text format,
+  // it is formatted in one go into the buffer, without the stream formatting of each number
+  std::string text = "#<header> V1 " + std::to_string(addressWidth) + " " + std::to_string(dataWidth) + " </header>\n";
+  text.reserve(text.size() + contents.size() * 12);
+  char number[16];
+  for (unsigned address = 0; address < contents.size(); ++address) {
+    text.append(number, std::to_chars(number, number + sizeof(number), address).ptr);
+    text += ' ';
+    text.append(number, std::to_chars(number, number + sizeof(number), contents[address]).ptr);
+    text += '\n';
+  }
+  std::istringstream stream(text);
+  int readCode = read(stream);
+
+  // the flat table is filled from the contents, not from the data(), masked to the dataWidth as the data() gives them
+  const int dataMask = (1 << dataWidth) - 1;
+  m_flatAddressMask = contents.size() - 1;
+  m_flatContents.resize(contents.size());
+  for (unsigned address = 0; address < contents.size(); ++address) {
+    m_flatContents[address] = contents[address] & dataMask;
+  }
+  return readCode;
+}
+
+void l1t::MicroGMTLUT::clear() {
+  LUT::operator=(LUT());
+  clearFlat();
+}
+
+void l1t::MicroGMTLUT::clearFlat() {
+  // data() of the empty LUT gives 0 for all addresses, the single entry is looked up for any address
+  m_flatContents.assign(1, 0);
+  m_flatAddressMask = 0;
+}
+
+void l1t::MicroGMTLUT::flatten() {
+  if (empty()) {
+    clearFlat();
+    return;
+  }
+  if (nrBitsAddress() > 20) {
+    throw cms::Exception("LUTError") << "LUT address width " << nrBitsAddress() << " too large for the flat table";
+  }
+  m_flatAddressMask = (1u << nrBitsAddress()) - 1;
+  m_flatContents.resize(m_flatAddressMask + 1);
+  for (unsigned address = 0; address <= m_flatAddressMask; ++address) {
+    int value = data(address);
+    if (value < std::numeric_limits<int16_t>::min() || value > std::numeric_limits<int16_t>::max()) {
+      throw cms::Exception("LUTError") << "LUT value " << value << " at address " << address
+                                       << " does not fit into the flat table";
+    }
+    m_flatContents[address] = value;
+  }
+}
+
+uint32_t l1t::MicroGMTLUT::checksum(const std::vector<int16_t>& values) {
+  uint32_t hash = 2166136261u;
+  for (int16_t value : values) {
+    uint16_t bits = value;
+    for (int i = 0; i < 2; ++i) {
+      hash ^= (bits >> (8 * i)) & 0xff;
+      hash *= 16777619u;
+    }
+  }
+  return hash;
 }
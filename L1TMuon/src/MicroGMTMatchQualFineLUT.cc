@@ -62,7 +62,7 @@ l1t::MicroGMTMatchQualFineLUT::MicroGMTMatchQualFineLUT(l1t::LUT* lut, cancel_t
 int l1t::MicroGMTMatchQualFineLUT::lookup(int etaFine, int dEtaRed, int dPhiRed) const {
   // normalize these two to the same scale and then calculate?
   if (m_initialized) {
-    return data((unsigned)hashInput(
+    return lookupFlat(hashInput(
         checkedInput(etaFine, 1), checkedInput(dEtaRed, m_dEtaRedInWidth), checkedInput(dPhiRed, m_dPhiRedInWidth)));
   }
   double dEta = m_fEtaCoarse * dEtaRed * m_etaScale;
@@ -79,7 +79,7 @@ int l1t::MicroGMTMatchQualFineLUT::lookup(int etaFine, int dEtaRed, int dPhiRed)
 
 int l1t::MicroGMTMatchQualFineLUT::lookupPacked(int in) const {
   if (m_initialized) {
-    return data((unsigned)in);
+    return lookupFlat(in);
   }
 
   int etaFine = 0;
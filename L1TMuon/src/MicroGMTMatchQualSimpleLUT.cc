@@ -55,7 +55,7 @@ int l1t::MicroGMTMatchQualSimpleLUT::lookup(int etaFine, int dEtaRed, int dPhiRe
 {
   // normalize these two to the same scale and then calculate?
   if (m_initialized) {
-    return data((unsigned)hashInput(checkedInput(dEtaRed, m_dEtaRedInWidth), checkedInput(dPhiRed, m_dPhiRedInWidth)));
+    return lookupFlat(hashInput(checkedInput(dEtaRed, m_dEtaRedInWidth), checkedInput(dPhiRed, m_dPhiRedInWidth)));
   }
   double dEta = m_fEta * dEtaRed * m_etaScale;
   double dPhi = m_fPhi * dPhiRed * m_phiScale;
@@ -68,7 +68,7 @@ int l1t::MicroGMTMatchQualSimpleLUT::lookup(int etaFine, int dEtaRed, int dPhiRe
 
 int l1t::MicroGMTMatchQualSimpleLUT::lookupPacked(int in) const {
   if (m_initialized) {
-    return data((unsigned)in);
+    return lookupFlat(in);
   }
 
   int dEtaRed = 0;
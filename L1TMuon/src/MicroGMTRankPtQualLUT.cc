@@ -43,7 +43,7 @@ l1t::MicroGMTRankPtQualLUT::MicroGMTRankPtQualLUT(l1t::LUT* lut)
 int l1t::MicroGMTRankPtQualLUT::lookup(int pt, int qual) const {
   // normalize these two to the same scale and then calculate?
   if (m_initialized) {
-    return data((unsigned)hashInput(checkedInput(pt, m_ptInWidth), checkedInput(qual, m_qualInWidth)));
+    return lookupFlat(hashInput(checkedInput(pt, m_ptInWidth), checkedInput(qual, m_qualInWidth)));
   }
 
   int result = 0;
@@ -54,7 +54,7 @@ int l1t::MicroGMTRankPtQualLUT::lookup(int pt, int qual) const {
 
 int l1t::MicroGMTRankPtQualLUT::lookupPacked(int in) const {
   if (m_initialized) {
-    return data((unsigned)in);
+    return lookupFlat(in);
   }
 
   int pt = 0;
@@ -30,6 +30,9 @@ l1t::MicroGMTRelativeIsolationCheckLUT::MicroGMTRelativeIsolationCheckLUT(l1t::L
 
 int l1t::MicroGMTRelativeIsolationCheckLUT::lookup(int energySum, int pt) const {
   // normalize these two to the same scale and then calculate?
+  if (m_initialized) {
+    return lookupFlat(hashInput(checkedInput(energySum, m_energySumInWidth), checkedInput(pt, m_ptInWidth)));
+  }
   return lookupPacked(hashInput(checkedInput(energySum, m_energySumInWidth), checkedInput(pt, m_ptInWidth)));
 }
 
@@ -0,0 +1,134 @@
+#include "L1Trigger/L1TMuon/interface/MicroGMTSorter.h"
+#include "L1Trigger/L1TMuon/interface/GMTInternalMuon.h"
+
+#include <algorithm>
+#include <array>
+
+namespace l1t {
+  void MicroGMTSorter::sortMuons(GMTInternalMuonList& muons, unsigned nSurvivors) {
+    if (muons.size() > kMaxInputs || nSurvivors > kMaxSurvivors) {
+      sortMuonsByWins(muons, nSurvivors);
+      return;
+    }
+
+    std::array<GMTInternalMuonList::iterator, kMaxInputs> inputs;
+    // the best muons, ordered by rank, the muons with the same rank are ordered by index
+    std::array<SortRecord, kMaxSurvivors> best;
+    unsigned nBest = 0;
+    int nCancelled = 0;
+    int nNotCancelled = 0;
+
+    uint8_t index = 0;
+    for (auto mu = muons.begin(); mu != muons.end(); ++mu, ++index) {
+      inputs[index] = mu;
+      // reset from previous sort stage
+      (*mu)->setHwWins(0);
+      if ((*mu)->hwCancelBit() == 1) {
+        ++nCancelled;
+        continue;
+      }
+      ++nNotCancelled;
+
+      // the muons come in the index order, so the muon goes after all muons with the same or higher rank
+      int rank = (*mu)->hwRank();
+      unsigned pos = nBest;
+      while (pos > 0 && best[pos - 1].rank < rank) {
+        --pos;
+      }
+      if (pos >= nSurvivors) {
+        continue;
+      }
+      if (nBest < nSurvivors) {
+        ++nBest;
+      }
+      for (unsigned i = nBest - 1; i > pos; --i) {
+        best[i] = best[i - 1];
+      }
+      best[pos] = {rank, index};
+    }
+
+    GMTInternalMuonList sorted;
+    for (unsigned i = 0; i < nBest; ++i) {
+      auto mu = inputs[best[i].index];
+      // wins against all cancelled muons and all not cancelled muons after it in the order
+      (*mu)->setHwWins(nCancelled + nNotCancelled - 1 - i);
+      sorted.splice(sorted.end(), muons, mu);
+    }
+    // the cancelled muons and the ones without sufficient rank are destroyed with the rest of the list
+    muons.swap(sorted);
+  }
+
+  void MicroGMTSorter::sortMuons(const GMTPackedMuons& muons, GMTPackedMuonList& sortedMuons, unsigned nSurvivors) {
+    nSurvivors = std::min(nSurvivors, GMTPackedMuons::kMaxMuons);
+    // as above, but the index is the one of the muon in the muons
+    std::array<SortRecord, GMTPackedMuons::kMaxMuons> best;
+    unsigned nBest = 0;
+
+    for (unsigned index : sortedMuons) {
+      const GMTPackedMuon& mu = muons[index];
+      if (mu.hwCancelBit() == 1) {
+        continue;
+      }
+
+      int rank = mu.hwRank();
+      unsigned pos = nBest;
+      while (pos > 0 && best[pos - 1].rank < rank) {
+        --pos;
+      }
+      if (pos >= nSurvivors) {
+        continue;
+      }
+      if (nBest < nSurvivors) {
+        ++nBest;
+      }
+      for (unsigned i = nBest - 1; i > pos; --i) {
+        best[i] = best[i - 1];
+      }
+      best[pos] = {rank, static_cast<uint8_t>(index)};
+    }
+
+    sortedMuons.clear();
+    for (unsigned i = 0; i < nBest; ++i) {
+      sortedMuons.push_back(best[i].index);
+    }
+  }
+
+  void MicroGMTSorter::sortMuonsByWins(GMTInternalMuonList& muons, unsigned nSurvivors) {
+    GMTInternalMuonList::iterator mu1;
+    // reset from previous sort stage
+    for (mu1 = muons.begin(); mu1 != muons.end(); ++mu1) {
+      (*mu1)->setHwWins(0);
+    }
+
+    int nCancelled = 0;
+    for (mu1 = muons.begin(); mu1 != muons.end(); ++mu1) {
+      int mu1CancelBit = (*mu1)->hwCancelBit();
+      nCancelled += mu1CancelBit;
+      auto mu2 = mu1;
+      mu2++;
+      for (; mu2 != muons.end(); ++mu2) {
+        if (mu1CancelBit != 1 && (*mu2)->hwCancelBit() != 1) {
+          if ((*mu1)->hwRank() >= (*mu2)->hwRank()) {
+            (*mu1)->increaseWins();
+          } else {
+            (*mu2)->increaseWins();
+          }
+        } else if (mu1CancelBit != 1) {
+          (*mu1)->increaseWins();
+        } else if ((*mu2)->hwCancelBit() != 1) {
+          (*mu2)->increaseWins();
+        }
+      }
+    }
+
+    size_t nMuonsBefore = muons.size();
+    int minWins = nMuonsBefore - nSurvivors;
+
+    // remove all muons that were cancelled or that do not have sufficient rank
+    // (reduces the container size to nSurvivors)
+    muons.remove_if([&minWins](auto muon) { return ((muon->hwWins() < minWins) || (muon->hwCancelBit() == 1)); });
+    muons.sort([](const std::shared_ptr<GMTInternalMuon>& mu1, const std::shared_ptr<GMTInternalMuon>& mu2) {
+      return (mu1->hwWins() >= mu2->hwWins());
+    });
+  }
+}  // namespace l1t
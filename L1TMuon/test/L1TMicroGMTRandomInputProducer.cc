@@ -0,0 +1,222 @@
+/*
+ * L1TMicroGMTRandomInputProducer.cc
+ *
+ * Produces random uGMT inputs (the muons of all track finders and the calo tower sums) for the unit tests,
+ * so that the uGMT emulator can be run by the cmsRun without the EDM input file. The muons come in clusters
+ * of duplicates in the neighbouring wedges and track finders (also around the wrap-around of the wedges),
+ * with the qualities from a few values, so that the cancel-out, sorting and isolation have many candidates and ties.
+ * The random generator is seeded with the seed + edm::EventID::event(), so the inputs do not depend
+ * on the number of threads.
+ */
+
+#include "DataFormats/L1TMuon/interface/MuonCaloSum.h"
+#include "DataFormats/L1TMuon/interface/MuonCaloSumFwd.h"
+#include "DataFormats/L1TMuon/interface/RegionalMuonCand.h"
+#include "DataFormats/L1TMuon/interface/RegionalMuonCandFwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/EDPutToken.h"
+
+#include <algorithm>
+#include <array>
+#include <map>
+#include <random>
+#include <vector>
+
+using namespace l1t;
+
+class L1TMicroGMTRandomInputProducer : public edm::global::EDProducer<> {
+public:
+  explicit L1TMicroGMTRandomInputProducer(const edm::ParameterSet& iConfig);
+
+  void produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const override;
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+private:
+  ///the muons of one BX of each track finder, the index of the std::array is the tftype
+  typedef std::array<std::vector<RegionalMuonCand>, 5> BxMuons;
+
+  static unsigned nWedges(tftype tfType) { return tfType == tftype::bmtf ? 12 : 6; }
+
+  ///the wedge of the track finder containing the globalPhi
+  static unsigned wedgeOf(tftype tfType, int globalPhi);
+
+  void addCluster(BxMuons& bxMuons, std::mt19937& generator) const;
+
+  ///the muon is skipped if the wedge is already full (3 muons)
+  void addMuon(BxMuons& bxMuons, tftype tfType, unsigned wedge, int globalPhi, int eta, std::mt19937& generator) const;
+
+  const unsigned int seed;
+  const int bxMin;
+  const int bxMax;
+  const unsigned int maxClusters;
+
+  const edm::EDPutTokenT<RegionalMuonCandBxCollection> barrelPutToken;
+  const edm::EDPutTokenT<RegionalMuonCandBxCollection> overlapPutToken;
+  const edm::EDPutTokenT<RegionalMuonCandBxCollection> forwardPutToken;
+  const edm::EDPutTokenT<MuonCaloSumBxCollection> towerSumsPutToken;
+};
+
+L1TMicroGMTRandomInputProducer::L1TMicroGMTRandomInputProducer(const edm::ParameterSet& iConfig)
+    : seed(iConfig.getParameter<unsigned int>("seed")),
+      bxMin(iConfig.getParameter<int>("bxMin")),
+      bxMax(iConfig.getParameter<int>("bxMax")),
+      maxClusters(iConfig.getParameter<unsigned int>("maxClusters")),
+      barrelPutToken(produces<RegionalMuonCandBxCollection>("BarrelTFMuons")),
+      overlapPutToken(produces<RegionalMuonCandBxCollection>("OverlapTFMuons")),
+      forwardPutToken(produces<RegionalMuonCandBxCollection>("ForwardTFMuons")),
+      towerSumsPutToken(produces<MuonCaloSumBxCollection>("TriggerTowerSums")) {}
+
+unsigned L1TMicroGMTRandomInputProducer::wedgeOf(tftype tfType, int globalPhi) {
+  int wedgeWidth = 576 / nWedges(tfType);
+  //the global phi of the local phi 0 of the wedge 0: BMTF 552, OMTF and EMTF 24
+  int start = tfType == tftype::bmtf ? 552 : 24;
+  return ((globalPhi - start + 576) % 576) / wedgeWidth;
+}
+
+void L1TMicroGMTRandomInputProducer::addCluster(BxMuons& bxMuons, std::mt19937& generator) const {
+  std::uniform_int_distribution<int> spreadDist(-3, 3);
+
+  int absEta = generator() % 230;
+  bool positive = generator() % 2;
+  int globalPhi = generator() % 576;
+  //around the wrap-around of the wedges: BMTF wedges 11 | 0, OMTF and EMTF sectors 5 | 0
+  if (generator() % 4 == 0)
+    globalPhi = ((generator() % 2 ? 552 : 24) + spreadDist(generator) + 576) % 576;
+
+  std::vector<tftype> tfTypes;
+  if (absEta <= 100)
+    tfTypes.push_back(tftype::bmtf);
+  if (absEta >= 70 && absEta <= 130)
+    tfTypes.push_back(positive ? tftype::omtf_pos : tftype::omtf_neg);
+  if (absEta >= 100)
+    tfTypes.push_back(positive ? tftype::emtf_pos : tftype::emtf_neg);
+
+  for (auto tfType : tfTypes) {
+    unsigned nDuplicates = 1 + generator() % 3;
+    for (unsigned iDuplicate = 0; iDuplicate < nDuplicates; ++iDuplicate) {
+      int muonPhi = (globalPhi + spreadDist(generator) + 576) % 576;
+      int muonEta = std::max(absEta + spreadDist(generator), 1);
+      unsigned wedge = wedgeOf(tfType, muonPhi);
+      //the track finders send the muons also from the edge of the neighbouring wedge
+      if (generator() % 3 == 0)
+        wedge = (wedge + (generator() % 2 ? 1 : nWedges(tfType) - 1)) % nWedges(tfType);
+      addMuon(bxMuons, tfType, wedge, muonPhi, positive ? muonEta : -muonEta, generator);
+    }
+  }
+}
+
+void L1TMicroGMTRandomInputProducer::addMuon(
+    BxMuons& bxMuons, tftype tfType, unsigned wedge, int globalPhi, int eta, std::mt19937& generator) const {
+  auto& tfMuons = bxMuons[tfType];
+  if (std::count_if(tfMuons.begin(), tfMuons.end(), [&](const RegionalMuonCand& mu) {
+        return mu.processor() == (int)wedge;
+      }) == 3)
+    return;
+
+  //the local phi giving the globalPhi in this wedge, see the MicroGMTConfiguration::calcGlobalPhi
+  int wedgeStart = (tfType == tftype::bmtf ? (int)wedge * 48 + 552 : (int)wedge * 96 + 600) % 576;
+  int localPhi = (globalPhi - wedgeStart + 576) % 576;
+  if (localPhi >= 288)
+    localPhi -= 576;
+
+  RegionalMuonCand mu;
+  mu.setHwPt(1 + generator() % 511);
+  mu.setHwPtUnconstrained(generator() % 256);
+  mu.setHwDXY(generator() % 4);
+  mu.setHwEta(eta);
+  mu.setHwPhi(localPhi);
+  mu.setHwSign(generator() % 2);
+  mu.setHwSignValid(1);
+  //a few values, so that there are many ties
+  mu.setHwQual(4 * (1 + generator() % 3));
+  mu.setHwHF(generator() % 2);
+  mu.setTFIdentifiers(wedge, tfType);
+
+  std::map<int, int> trackAddress;
+  if (tfType == tftype::bmtf) {
+    //small ranges, so that the tracks often share the hits
+    const std::array<int, 8> stations = {{0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x8, 0xC}};
+    trackAddress[RegionalMuonCand::bmtfAddress::kWheelSide] = generator() % 2;
+    trackAddress[RegionalMuonCand::bmtfAddress::kWheelNum] = generator() % 3;
+    trackAddress[RegionalMuonCand::bmtfAddress::kStat1] = stations[generator() % stations.size()];
+    trackAddress[RegionalMuonCand::bmtfAddress::kStat2] = stations[generator() % stations.size()];
+    trackAddress[RegionalMuonCand::bmtfAddress::kStat3] = stations[generator() % stations.size()];
+    trackAddress[RegionalMuonCand::bmtfAddress::kStat4] = stations[generator() % stations.size()];
+  } else if (tfType == tftype::emtf_pos || tfType == tftype::emtf_neg) {
+    trackAddress[RegionalMuonCand::emtfAddress::kME1Seg] = generator() % 2;
+    trackAddress[RegionalMuonCand::emtfAddress::kME1Ch] = generator() % 6;
+    trackAddress[RegionalMuonCand::emtfAddress::kME2Seg] = generator() % 2;
+    trackAddress[RegionalMuonCand::emtfAddress::kME2Ch] = generator() % 5;
+    trackAddress[RegionalMuonCand::emtfAddress::kME3Seg] = generator() % 2;
+    trackAddress[RegionalMuonCand::emtfAddress::kME3Ch] = generator() % 5;
+    trackAddress[RegionalMuonCand::emtfAddress::kME4Seg] = generator() % 2;
+    trackAddress[RegionalMuonCand::emtfAddress::kME4Ch] = generator() % 5;
+  }
+  mu.setTrackAddress(trackAddress);
+
+  tfMuons.push_back(mu);
+}
+
+void L1TMicroGMTRandomInputProducer::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& iSetup) const {
+  std::mt19937 generator(seed + iEvent.id().event());
+
+  RegionalMuonCandBxCollection barrelMuons;
+  RegionalMuonCandBxCollection overlapMuons;
+  RegionalMuonCandBxCollection forwardMuons;
+  MuonCaloSumBxCollection towerSums;
+  barrelMuons.setBXRange(bxMin, bxMax);
+  overlapMuons.setBXRange(bxMin, bxMax);
+  forwardMuons.setBXRange(bxMin, bxMax);
+  towerSums.setBXRange(bxMin, bxMax);
+
+  for (int bx = bxMin; bx <= bxMax; ++bx) {
+    BxMuons bxMuons;
+    unsigned nClusters = generator() % (maxClusters + 1);
+    for (unsigned iCluster = 0; iCluster < nClusters; ++iCluster)
+      addCluster(bxMuons, generator);
+
+    //the muons in the order of the input links, as from the unpacker
+    auto compareLinks = [](const RegionalMuonCand& mu1, const RegionalMuonCand& mu2) {
+      return mu1.link() < mu2.link();
+    };
+    for (auto tfType : {tftype::bmtf, tftype::omtf_pos, tftype::omtf_neg, tftype::emtf_pos, tftype::emtf_neg})
+      std::stable_sort(bxMuons[tfType].begin(), bxMuons[tfType].end(), compareLinks);
+
+    for (const auto& mu : bxMuons[tftype::bmtf])
+      barrelMuons.push_back(bx, mu);
+    for (auto tfType : {tftype::omtf_pos, tftype::omtf_neg}) {
+      for (const auto& mu : bxMuons[tfType])
+        overlapMuons.push_back(bx, mu);
+    }
+    for (auto tfType : {tftype::emtf_pos, tftype::emtf_neg}) {
+      for (const auto& mu : bxMuons[tfType])
+        forwardMuons.push_back(bx, mu);
+    }
+
+    //28 eta x 36 phi towers, with the energies around the isolation thresholds
+    for (int i = 0; i < 1008; ++i)
+      towerSums.push_back(bx, MuonCaloSum(generator() % 32, i / 28, i % 28, i));
+  }
+
+  iEvent.emplace(barrelPutToken, std::move(barrelMuons));
+  iEvent.emplace(overlapPutToken, std::move(overlapMuons));
+  iEvent.emplace(forwardPutToken, std::move(forwardMuons));
+  iEvent.emplace(towerSumsPutToken, std::move(towerSums));
+}
+
+void L1TMicroGMTRandomInputProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<unsigned int>("seed", 12345);
+  desc.add<int>("bxMin", -2);
+  desc.add<int>("bxMax", 2);
+  desc.add<unsigned int>("maxClusters", 20)->setComment("the maximal number of the clusters of duplicates per BX");
+  descriptions.add("microGMTRandomInputs", desc);
+}
+
+DEFINE_FWK_MODULE(L1TMicroGMTRandomInputProducer);
@@ -0,0 +1,259 @@
+/*
+ * testMicroGMTCancelOutUnit.cpp
+ *
+ * Checks that the MicroGMTCancelOutUnit gives the same cancel bits on the GMTPackedMuons as on the GMTInternalWedges.
+ * The same synthetic muons of all track finders are filled into both, then the cancel-out is done in the order
+ * of the L1TMuonProducer, with the BMTF in the tracks and kftracks mode (there is no BMTF match quality LUT
+ * for the coordinate mode), the EMTF in the coordinate and tracks mode and the OMTF and overlaps in the coordinate
+ * mode. The muons come in clusters of duplicates in the neighbouring wedges and track finders, with the qualities
+ * from a few values (so that there are many ties), also around the wrap-around of the wedges.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "L1Trigger/L1TMuon/interface/GMTInternalMuon.h"
+#include "L1Trigger/L1TMuon/interface/GMTPackedMuon.h"
+#include "L1Trigger/L1TMuon/interface/L1TMuonGlobalParamsHelper.h"
+#include "L1Trigger/L1TMuon/interface/MicroGMTCancelOutUnit.h"
+#include "L1Trigger/L1TMuon/interface/MicroGMTConfiguration.h"
+#include "L1Trigger/L1TMuon/interface/MicroGMTLUTFactories.h"
+
+#include "DataFormats/L1TMuon/interface/RegionalMuonCand.h"
+
+#include <algorithm>
+#include <array>
+#include <deque>
+#include <map>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+  const unsigned fwVersion = 0x4010000;
+
+  ///the match quality LUTs computed from the parameters of the fakeGmtParams_cff (the LUT paths are empty there)
+  void fillMatchQualLUTs(L1TMuonGlobalParamsHelper& helper) {
+    using l1t::MicroGMTMatchQualLUTFactory;
+    helper.setFwVersion(fwVersion);
+    helper.setFwdPosSingleMatchQualLUT(
+        *MicroGMTMatchQualLUTFactory::create("", 0.05, 1, 1, 1, l1t::cancel_t::emtf_emtf_pos, fwVersion));
+    helper.setFwdNegSingleMatchQualLUT(
+        *MicroGMTMatchQualLUTFactory::create("", 0.05, 1, 1, 1, l1t::cancel_t::emtf_emtf_neg, fwVersion));
+    helper.setOvlPosSingleMatchQualLUT(
+        *MicroGMTMatchQualLUTFactory::create("", 0.05, 1, 1, 2, l1t::cancel_t::omtf_omtf_pos, fwVersion));
+    helper.setOvlNegSingleMatchQualLUT(
+        *MicroGMTMatchQualLUTFactory::create("", 0.05, 1, 1, 2, l1t::cancel_t::omtf_omtf_neg, fwVersion));
+    helper.setBOPosMatchQualLUT(
+        *MicroGMTMatchQualLUTFactory::create("", 0.15, 1, 1, 6, l1t::cancel_t::omtf_bmtf_pos, fwVersion));
+    helper.setBONegMatchQualLUT(
+        *MicroGMTMatchQualLUTFactory::create("", 0.15, 1, 1, 6, l1t::cancel_t::omtf_bmtf_neg, fwVersion));
+    helper.setFOPosMatchQualLUT(
+        *MicroGMTMatchQualLUTFactory::create("", 0.1, 1, 1, 1, l1t::cancel_t::omtf_emtf_pos, fwVersion));
+    helper.setFONegMatchQualLUT(
+        *MicroGMTMatchQualLUTFactory::create("", 0.1, 1, 1, 1, l1t::cancel_t::omtf_emtf_neg, fwVersion));
+  }
+
+  unsigned nWedges(l1t::tftype tfType) { return tfType == l1t::tftype::bmtf ? 12 : 6; }
+
+  ///the synthetic muons of one BX, as the GMTInternalWedges and as the GMTPackedMuons,
+  ///the internalMuons[i] corresponds to the packedMuons[i]
+  class TestEvent {
+  public:
+    TestEvent() {
+      for (auto tfType : tfTypes) {
+        for (unsigned wedge = 0; wedge < nWedges(tfType); ++wedge)
+          wedges[tfType][wedge];
+      }
+    }
+
+    ///returns false if the wedge is full (3 muons) or all GMTPackedMuons are used
+    bool addMuon(l1t::tftype tfType, unsigned wedge, int globalPhi, int eta, std::mt19937& generator) {
+      auto& wedgeMuons = wedges[tfType][wedge];
+      if (wedgeMuons.size() == 3 || packedMuons.size == l1t::GMTPackedMuons::kMaxMuons)
+        return false;
+
+      //the local phi giving the globalPhi in this wedge
+      int localPhi = (globalPhi - l1t::MicroGMTConfiguration::calcGlobalPhi(0, tfType, wedge) + 576) % 576;
+      if (localPhi >= 288)
+        localPhi -= 576;
+
+      //the GMTInternalMuon keeps a reference to the RegionalMuonCand
+      l1t::RegionalMuonCand& regional = regionalMuons.emplace_back();
+      regional.setHwPt(1 + generator() % 100);
+      regional.setHwEta(eta);
+      regional.setHwPhi(localPhi);
+      //a few values, so that there are many ties
+      regional.setHwQual(4 * (1 + generator() % 3));
+      regional.setHwHF(generator() % 2);
+      regional.setTFIdentifiers(wedge, tfType);
+
+      std::map<int, int> trackAddress;
+      if (tfType == l1t::tftype::bmtf) {
+        //small ranges, so that the tracks often share the hits
+        const std::array<int, 8> stations = {{0x0, 0x1, 0x2, 0x3, 0x4, 0x5, 0x8, 0xC}};
+        trackAddress[l1t::RegionalMuonCand::bmtfAddress::kWheelSide] = generator() % 2;
+        trackAddress[l1t::RegionalMuonCand::bmtfAddress::kWheelNum] = generator() % 3;
+        trackAddress[l1t::RegionalMuonCand::bmtfAddress::kStat1] = stations[generator() % stations.size()];
+        trackAddress[l1t::RegionalMuonCand::bmtfAddress::kStat2] = stations[generator() % stations.size()];
+        trackAddress[l1t::RegionalMuonCand::bmtfAddress::kStat3] = stations[generator() % stations.size()];
+        trackAddress[l1t::RegionalMuonCand::bmtfAddress::kStat4] = stations[generator() % stations.size()];
+      } else if (tfType == l1t::tftype::emtf_pos || tfType == l1t::tftype::emtf_neg) {
+        trackAddress[l1t::RegionalMuonCand::emtfAddress::kME1Seg] = generator() % 2;
+        trackAddress[l1t::RegionalMuonCand::emtfAddress::kME1Ch] = generator() % 6;
+        trackAddress[l1t::RegionalMuonCand::emtfAddress::kME2Seg] = generator() % 2;
+        trackAddress[l1t::RegionalMuonCand::emtfAddress::kME2Ch] = generator() % 5;
+        trackAddress[l1t::RegionalMuonCand::emtfAddress::kME3Seg] = generator() % 2;
+        trackAddress[l1t::RegionalMuonCand::emtfAddress::kME3Ch] = generator() % 5;
+        trackAddress[l1t::RegionalMuonCand::emtfAddress::kME4Seg] = generator() % 2;
+        trackAddress[l1t::RegionalMuonCand::emtfAddress::kME4Ch] = generator() % 5;
+      }
+      regional.setTrackAddress(trackAddress);
+
+      int gPhi = l1t::MicroGMTConfiguration::calcGlobalPhi(regional.hwPhi(), tfType, wedge);
+      unsigned index = packedMuons.size++;
+      auto internalMuon = std::make_shared<l1t::GMTInternalMuon>(regional, gPhi, index);
+      internalMuons.push_back(internalMuon);
+      wedgeMuons.push_back(internalMuon);
+
+      packedMuons[index].set(regional, gPhi, index);
+      lists[tfType].push_back(index);
+      return true;
+    }
+
+    ///the cancel-out in the order of the L1TMuonProducer::produceBx and produceBxPacked
+    void cancelOut(l1t::MicroGMTCancelOutUnit& unit, l1t::cancelmode bmtfMode, l1t::cancelmode emtfMode) {
+      using l1t::cancelmode;
+      using l1t::tftype;
+      unit.setCancelOutBits(wedges[tftype::bmtf], tftype::bmtf, bmtfMode);
+      unit.setCancelOutBits(wedges[tftype::omtf_pos], tftype::omtf_pos, cancelmode::coordinate);
+      unit.setCancelOutBits(wedges[tftype::omtf_neg], tftype::omtf_neg, cancelmode::coordinate);
+      unit.setCancelOutBits(wedges[tftype::emtf_pos], tftype::emtf_pos, emtfMode);
+      unit.setCancelOutBits(wedges[tftype::emtf_neg], tftype::emtf_neg, emtfMode);
+      unit.setCancelOutBitsOverlapBarrel(wedges[tftype::omtf_pos], wedges[tftype::bmtf], cancelmode::coordinate);
+      unit.setCancelOutBitsOverlapBarrel(wedges[tftype::omtf_neg], wedges[tftype::bmtf], cancelmode::coordinate);
+      unit.setCancelOutBitsOverlapEndcap(wedges[tftype::omtf_pos], wedges[tftype::emtf_pos], cancelmode::coordinate);
+      unit.setCancelOutBitsOverlapEndcap(wedges[tftype::omtf_neg], wedges[tftype::emtf_neg], cancelmode::coordinate);
+
+      unit.setCancelOutBits(packedMuons, lists[tftype::bmtf], tftype::bmtf, bmtfMode);
+      unit.setCancelOutBits(packedMuons, lists[tftype::omtf_pos], tftype::omtf_pos, cancelmode::coordinate);
+      unit.setCancelOutBits(packedMuons, lists[tftype::omtf_neg], tftype::omtf_neg, cancelmode::coordinate);
+      unit.setCancelOutBits(packedMuons, lists[tftype::emtf_pos], tftype::emtf_pos, emtfMode);
+      unit.setCancelOutBits(packedMuons, lists[tftype::emtf_neg], tftype::emtf_neg, emtfMode);
+      unit.setCancelOutBitsOverlapBarrel(
+          packedMuons, lists[tftype::omtf_pos], lists[tftype::bmtf], cancelmode::coordinate);
+      unit.setCancelOutBitsOverlapBarrel(
+          packedMuons, lists[tftype::omtf_neg], lists[tftype::bmtf], cancelmode::coordinate);
+      unit.setCancelOutBitsOverlapEndcap(
+          packedMuons, lists[tftype::omtf_pos], lists[tftype::emtf_pos], cancelmode::coordinate);
+      unit.setCancelOutBitsOverlapEndcap(
+          packedMuons, lists[tftype::omtf_neg], lists[tftype::emtf_neg], cancelmode::coordinate);
+    }
+
+    const std::array<l1t::tftype, 5> tfTypes = {{l1t::tftype::bmtf,
+                                                 l1t::tftype::omtf_pos,
+                                                 l1t::tftype::omtf_neg,
+                                                 l1t::tftype::emtf_pos,
+                                                 l1t::tftype::emtf_neg}};
+
+    std::deque<l1t::RegionalMuonCand> regionalMuons;
+    std::map<l1t::tftype, l1t::GMTInternalWedges> wedges;
+    std::vector<std::shared_ptr<l1t::GMTInternalMuon>> internalMuons;
+
+    l1t::GMTPackedMuons packedMuons{};
+    std::map<l1t::tftype, l1t::GMTPackedMuonList> lists;
+  };
+
+  ///the wedge of the track finder containing the globalPhi
+  unsigned wedgeOf(l1t::tftype tfType, int globalPhi) {
+    int wedgeWidth = 576 / nWedges(tfType);
+    int start = l1t::MicroGMTConfiguration::calcGlobalPhi(0, tfType, 0);
+    return ((globalPhi - start + 576) % 576) / wedgeWidth;
+  }
+
+  ///adds the clusters of duplicates: each in the track finders covering its eta, in the wedge containing its phi
+  ///and sometimes also in the neighbouring one, with a small spread of the eta and phi
+  void fillEvent(TestEvent& event, std::mt19937& generator) {
+    using l1t::tftype;
+    std::uniform_int_distribution<int> spreadDist(-3, 3);
+
+    unsigned nClusters = 1 + generator() % 20;
+    for (unsigned iCluster = 0; iCluster < nClusters; ++iCluster) {
+      int absEta = generator() % 240;
+      bool positive = generator() % 2;
+      int globalPhi = generator() % 576;
+      //around the wrap-around of the wedges: BMTF wedges 11 | 0, OMTF and EMTF sectors 5 | 0
+      if (generator() % 4 == 0)
+        globalPhi = ((generator() % 2 ? 552 : 24) + spreadDist(generator) + 576) % 576;
+
+      std::vector<tftype> tfTypes;
+      if (absEta <= 100)
+        tfTypes.push_back(tftype::bmtf);
+      if (absEta >= 70 && absEta <= 130)
+        tfTypes.push_back(positive ? tftype::omtf_pos : tftype::omtf_neg);
+      if (absEta >= 100)
+        tfTypes.push_back(positive ? tftype::emtf_pos : tftype::emtf_neg);
+
+      for (auto tfType : tfTypes) {
+        unsigned nDuplicates = 1 + generator() % 3;
+        for (unsigned iDuplicate = 0; iDuplicate < nDuplicates; ++iDuplicate) {
+          int muonPhi = (globalPhi + spreadDist(generator) + 576) % 576;
+          int muonEta = std::max(absEta + spreadDist(generator), 1);
+          unsigned wedge = wedgeOf(tfType, muonPhi);
+          //the track finders send the muons also from the edge of the neighbouring wedge
+          if (generator() % 3 == 0)
+            wedge = (wedge + (generator() % 2 ? 1 : nWedges(tfType) - 1)) % nWedges(tfType);
+          event.addMuon(tfType, wedge, muonPhi, positive ? muonEta : -muonEta, generator);
+        }
+      }
+    }
+  }
+}  // namespace
+
+TEST_CASE("cancel bits of the GMTPackedMuons are the same as of the GMTInternalWedges", "[MicroGMTCancelOutUnit]") {
+  L1TMuonGlobalParamsHelper helper;
+  fillMatchQualLUTs(helper);
+  l1t::MicroGMTCancelOutUnit unit;
+  unit.initialise(&helper);
+
+  const std::array<l1t::cancelmode, 2> bmtfModes = {{l1t::cancelmode::tracks, l1t::cancelmode::kftracks}};
+  const std::array<l1t::cancelmode, 2> emtfModes = {{l1t::cancelmode::coordinate, l1t::cancelmode::tracks}};
+
+  std::mt19937 generator(12345);
+  const unsigned nCases = 60000;
+
+  unsigned nDifferent = 0;
+  //the cancelled muons for each combination of the modes, to check that the cancel-out was really exercised
+  std::map<std::pair<int, int>, unsigned> nCancelled;
+  for (unsigned iCase = 0; iCase < nCases; ++iCase) {
+    l1t::cancelmode bmtfMode = bmtfModes[iCase % bmtfModes.size()];
+    l1t::cancelmode emtfMode = emtfModes[(iCase / bmtfModes.size()) % emtfModes.size()];
+
+    TestEvent event;
+    fillEvent(event, generator);
+    event.cancelOut(unit, bmtfMode, emtfMode);
+
+    for (unsigned index = 0; index < event.internalMuons.size(); ++index) {
+      const auto& internalMuon = *event.internalMuons[index];
+      nCancelled[std::make_pair(bmtfMode, emtfMode)] += internalMuon.hwCancelBit();
+      if (internalMuon.hwCancelBit() != event.packedMuons[index].hwCancelBit()) {
+        if (nDifferent++ < 10)
+          UNSCOPED_INFO("case " << iCase << " bmtfMode " << bmtfMode << " emtfMode " << emtfMode << " muon " << index
+                                << " tfType " << internalMuon.trackFinderType() << " wedge "
+                                << internalMuon.processor() << " eta " << internalMuon.hwEta() << " globalPhi "
+                                << internalMuon.hwGlobalPhi() << " qual " << internalMuon.hwQual() << ": cancel bit "
+                                << internalMuon.hwCancelBit() << ", packed "
+                                << event.packedMuons[index].hwCancelBit());
+      }
+    }
+  }
+  REQUIRE(nDifferent == 0);
+
+  for (auto bmtfMode : bmtfModes) {
+    for (auto emtfMode : emtfModes) {
+      INFO("bmtfMode " << bmtfMode << " emtfMode " << emtfMode);
+      REQUIRE(nCancelled[std::make_pair(bmtfMode, emtfMode)] > 0);
+    }
+  }
+}
@@ -0,0 +1,97 @@
+/*
+ * testMicroGMTLUT.cpp
+ *
+ * Checks that the MicroGMTLUT read from the text format and from the binary format (saveBinary) give the same
+ * data() and lookupPacked() for all addresses, also after the conversion back to the text format,
+ * and that loading an empty binary LUT empties the LUT loaded before.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "L1Trigger/L1TMuon/interface/MicroGMTLUT.h"
+
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace {
+  const unsigned addressWidth = 10;
+  const unsigned dataWidth = 6;
+
+  void writeTextLUT(const std::string& fileName, std::mt19937& generator) {
+    std::uniform_int_distribution<int> valueDist(0, (1 << dataWidth) - 1);
+    std::ofstream file(fileName);
+    file << "#<header> V1 " << addressWidth << " " << dataWidth << " </header>\n";
+    for (unsigned address = 0; address < (1u << addressWidth); ++address) {
+      file << address << " " << valueDist(generator) << "\n";
+    }
+  }
+
+  template <class SaveFunction>
+  void saveLUT(l1t::MicroGMTLUT& lut, const std::string& fileName, SaveFunction save) {
+    std::ofstream file(fileName, std::ios::out | std::ios::binary);
+    (lut.*save)(file);
+  }
+
+  ///the number of the addresses where the lut differs from the reference, in the data() or the lookupPacked()
+  unsigned compareLUTs(const l1t::MicroGMTLUT& reference, const l1t::MicroGMTLUT& lut, const std::string& name) {
+    unsigned nDifferent = 0;
+    for (unsigned address = 0; address < (1u << addressWidth); ++address) {
+      int expected = reference.data(address);
+      if (lut.data(address) != expected || lut.lookupPacked(address) != expected ||
+          reference.lookupPacked(address) != expected) {
+        if (nDifferent < 10)
+          UNSCOPED_INFO(name << " address " << address << ": expected " << expected << " data " << lut.data(address)
+                             << " lookupPacked " << lut.lookupPacked(address) << " reference lookupPacked "
+                             << reference.lookupPacked(address));
+        nDifferent++;
+      }
+    }
+    return nDifferent;
+  }
+}  // namespace
+
+TEST_CASE("MicroGMTLUT text and binary formats give the same LUT", "[MicroGMTLUT]") {
+  std::mt19937 generator(12345);
+  writeTextLUT("testMicroGMTLUT.txt", generator);
+
+  l1t::MicroGMTLUT textLUT;
+  REQUIRE(textLUT.loadFile("testMicroGMTLUT.txt") == l1t::LUT::SUCCESS);
+  REQUIRE(!l1t::MicroGMTLUT::isBinaryFile("testMicroGMTLUT.txt"));
+  REQUIRE(textLUT.nrBitsAddress() == addressWidth);
+  REQUIRE(textLUT.nrBitsData() == dataWidth);
+
+  saveLUT(textLUT, "testMicroGMTLUT.bin", &l1t::MicroGMTLUT::saveBinary);
+  REQUIRE(l1t::MicroGMTLUT::isBinaryFile("testMicroGMTLUT.bin"));
+  l1t::MicroGMTLUT binaryLUT;
+  REQUIRE(binaryLUT.loadFile("testMicroGMTLUT.bin") == l1t::LUT::SUCCESS);
+  REQUIRE(binaryLUT.nrBitsAddress() == addressWidth);
+  REQUIRE(binaryLUT.nrBitsData() == dataWidth);
+  REQUIRE(compareLUTs(textLUT, binaryLUT, "binary") == 0);
+
+  saveLUT(binaryLUT, "testMicroGMTLUT_fromBinary.txt", &l1t::MicroGMTLUT::save);
+  l1t::MicroGMTLUT textFromBinaryLUT;
+  REQUIRE(textFromBinaryLUT.loadFile("testMicroGMTLUT_fromBinary.txt") == l1t::LUT::SUCCESS);
+  REQUIRE(compareLUTs(textLUT, textFromBinaryLUT, "text from binary") == 0);
+}
+
+TEST_CASE("MicroGMTLUT loading an empty binary LUT empties the LUT", "[MicroGMTLUT]") {
+  l1t::MicroGMTLUT emptyLUT;
+  saveLUT(emptyLUT, "testMicroGMTLUT_empty.bin", &l1t::MicroGMTLUT::saveBinary);
+
+  std::mt19937 generator(54321);
+  writeTextLUT("testMicroGMTLUT.txt", generator);
+  l1t::MicroGMTLUT lut;
+  REQUIRE(lut.loadFile("testMicroGMTLUT.txt") == l1t::LUT::SUCCESS);
+  REQUIRE(!lut.empty());
+
+  REQUIRE(lut.loadFile("testMicroGMTLUT_empty.bin") == l1t::LUT::SUCCESS);
+  REQUIRE(lut.empty());
+  unsigned nNonZero = 0;
+  for (unsigned address = 0; address < (1u << addressWidth); ++address) {
+    if (lut.data(address) != 0 || lut.lookupPacked(address) != 0)
+      nNonZero++;
+  }
+  REQUIRE(nNonZero == 0);
+}
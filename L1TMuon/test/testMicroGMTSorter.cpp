@@ -0,0 +1,125 @@
+/*
+ * testMicroGMTSorter.cpp
+ *
+ * Checks that the MicroGMTSorter::sortMuons gives the same survivors, in the same order and with the same wins,
+ * as the pairwise comparison of the sortMuonsByWins, on random lists of muons with random ranks (including ties)
+ * and cancel bits, for 4 and 8 survivors and also above the kMaxInputs, where the sortMuons falls back
+ * to the sortMuonsByWins. The packed sortMuons must give the same survivors in the same order.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "L1Trigger/L1TMuon/interface/GMTInternalMuon.h"
+#include "L1Trigger/L1TMuon/interface/GMTPackedMuon.h"
+#include "L1Trigger/L1TMuon/interface/MicroGMTSorter.h"
+
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+  struct TestMuon {
+    int rank;
+    int cancelBit;
+  };
+
+  std::vector<TestMuon> randomMuons(std::mt19937& generator, unsigned nMuons) {
+    //a narrow rank range gives many ties
+    int maxRank = generator() % 2 ? 7 : 1023;
+    std::uniform_int_distribution<int> rankDist(0, maxRank);
+    std::vector<TestMuon> muons(nMuons);
+    for (auto& muon : muons) {
+      muon.rank = rankDist(generator);
+      muon.cancelBit = generator() % 4 == 0;
+    }
+    return muons;
+  }
+
+  ///the tfMuonIndex is the index of the muon in the testMuons
+  l1t::GMTInternalMuonList makeList(const std::vector<TestMuon>& testMuons) {
+    l1t::GMTInternalMuonList muons;
+    for (unsigned index = 0; index < testMuons.size(); ++index) {
+      auto muon = std::make_shared<l1t::GMTInternalMuon>(l1t::RegionalMuonCand(), 0, index);
+      muon->setHwRank(testMuons[index].rank);
+      muon->setHwCancelBit(testMuons[index].cancelBit);
+      muons.push_back(muon);
+    }
+    return muons;
+  }
+
+  ///returns 1 if the sortMuons gives different survivors or wins than the sortMuonsByWins
+  unsigned compareSorters(const std::vector<TestMuon>& testMuons, unsigned nSurvivors) {
+    l1t::GMTInternalMuonList reference = makeList(testMuons);
+    l1t::MicroGMTSorter::sortMuonsByWins(reference, nSurvivors);
+
+    l1t::GMTInternalMuonList sorted = makeList(testMuons);
+    l1t::MicroGMTSorter::sortMuons(sorted, nSurvivors);
+
+    bool different = sorted.size() != reference.size();
+    for (auto mu = sorted.begin(), refMu = reference.begin(); !different && mu != sorted.end(); ++mu, ++refMu) {
+      different = (*mu)->tfMuonIndex() != (*refMu)->tfMuonIndex() || (*mu)->hwWins() != (*refMu)->hwWins();
+    }
+
+    //the packed muons, above the kMaxMuons there is nothing to compare
+    if (testMuons.size() <= l1t::GMTPackedMuons::kMaxMuons) {
+      l1t::GMTPackedMuons packedMuons{};
+      l1t::GMTPackedMuonList packedSorted;
+      for (unsigned index = 0; index < testMuons.size(); ++index) {
+        packedMuons[index].setHwRank(testMuons[index].rank);
+        packedMuons[index].setHwCancelBit(testMuons[index].cancelBit);
+        packedSorted.push_back(index);
+      }
+      packedMuons.size = testMuons.size();
+      l1t::MicroGMTSorter::sortMuons(packedMuons, packedSorted, nSurvivors);
+
+      different |= packedSorted.size != reference.size();
+      auto refMu = reference.begin();
+      for (unsigned i = 0; !different && i < packedSorted.size; ++i, ++refMu) {
+        different = (int)packedSorted[i] != (*refMu)->tfMuonIndex();
+      }
+    }
+
+    if (different) {
+      UNSCOPED_INFO("nMuons " << testMuons.size() << " nSurvivors " << nSurvivors << ", sortMuons "
+                              << sorted.size() << " survivors, sortMuonsByWins " << reference.size());
+      for (unsigned index = 0; index < testMuons.size(); ++index)
+        UNSCOPED_INFO("  muon " << index << " rank " << testMuons[index].rank << " cancelBit "
+                                << testMuons[index].cancelBit);
+    }
+    return different;
+  }
+}  // namespace
+
+TEST_CASE("sortMuons gives the same survivors and wins as the sortMuonsByWins", "[MicroGMTSorter]") {
+  std::mt19937 generator(12345);
+  const unsigned nCases = 100000;
+
+  unsigned nDifferent = 0;
+  for (unsigned iCase = 0; iCase < nCases; ++iCase) {
+    unsigned nMuons = generator() % (l1t::MicroGMTSorter::kMaxInputs + 1);
+    unsigned nSurvivors = iCase % 2 ? 4 : 8;
+    std::vector<TestMuon> testMuons = randomMuons(generator, nMuons);
+    if (nDifferent < 10)
+      nDifferent += compareSorters(testMuons, nSurvivors);
+  }
+  REQUIRE(nDifferent == 0);
+}
+
+TEST_CASE("sortMuons above the kMaxInputs and kMaxSurvivors", "[MicroGMTSorter]") {
+  std::mt19937 generator(54321);
+  const unsigned nCases = 10000;
+
+  unsigned nDifferent = 0;
+  for (unsigned iCase = 0; iCase < nCases; ++iCase) {
+    unsigned nMuons = l1t::MicroGMTSorter::kMaxInputs + 1 + generator() % 72;
+    unsigned nSurvivors = iCase % 3 == 0 ? l1t::MicroGMTSorter::kMaxSurvivors + 1 + generator() % 8 : 8;
+    //above the kMaxSurvivors also the lists within the kMaxInputs fall back
+    if (iCase % 2)
+      nMuons = generator() % (l1t::MicroGMTSorter::kMaxInputs + 1);
+    std::vector<TestMuon> testMuons = randomMuons(generator, nMuons);
+    if (nDifferent < 10)
+      nDifferent += compareSorters(testMuons, nSurvivors);
+  }
+  REQUIRE(nDifferent == 0);
+}
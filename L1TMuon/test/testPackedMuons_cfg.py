@@ -0,0 +1,51 @@
+import FWCore.ParameterSet.Config as cms
+
+#runs the uGMT emulator on the random uGMT inputs of the L1TMicroGMTRandomInputProducer (all track finders and wedges,
+#clusters of duplicates also around the wrap-around of the wedges, many quality ties) with the comparePackedMuons,
+#i.e. the GMTInternalMuon and GMTPackedMuon versions are both run on every BX and their outputs compared,
+#for all combinations of the BMTF and EMTF cancel modes; the job fails at the end if any BX differs
+#no input file and no conditions from the DB are needed: the uGMT parameters are from the fakeGmtParams_cff
+process = cms.Process("L1TMuonPackedMuonsTest")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport.reportEvery = cms.untracked.int32(100)
+
+process.source = cms.Source("EmptySource")
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(500))
+
+process.load("L1Trigger.L1TMuon.fakeGmtParams_cff")
+
+process.microGMTRandomInputs = cms.EDProducer("L1TMicroGMTRandomInputProducer",
+    seed = cms.uint32(12345),
+    bxMin = cms.int32(-2),
+    bxMax = cms.int32(2),
+    maxClusters = cms.uint32(20)
+)
+
+#only the module, the simGmtStage2Digis_cfi also defines the O2O PoolDBESSource, not needed with the fake parameters
+from L1Trigger.L1TMuon.simGmtStage2Digis_cfi import simGmtStage2Digis
+
+gmtPackedMuonsTest = simGmtStage2Digis.clone(
+    barrelTFInput = cms.InputTag("microGMTRandomInputs", "BarrelTFMuons"),
+    overlapTFInput = cms.InputTag("microGMTRandomInputs", "OverlapTFMuons"),
+    forwardTFInput = cms.InputTag("microGMTRandomInputs", "ForwardTFMuons"),
+    triggerTowerInput = cms.InputTag("microGMTRandomInputs", "TriggerTowerSums"),
+    autoCancelMode = cms.bool(False),
+    comparePackedMuons = cms.untracked.bool(True)
+)
+
+process.L1TMuonPackedMuonsTestSeq = cms.Sequence(process.microGMTRandomInputs)
+for bmtfCancelMode in ["tracks", "kftracks"]:
+    for emtfCancelMode in ["coordinate", "tracks"]:
+        module = gmtPackedMuonsTest.clone(bmtfCancelMode = bmtfCancelMode, emtfCancelMode = emtfCancelMode)
+        setattr(process, "gmtPackedMuons" + bmtfCancelMode.capitalize() + emtfCancelMode.capitalize(), module)
+        process.L1TMuonPackedMuonsTestSeq += module
+
+#the GMTPackedMuon version producing the outputs, compared to the GMTInternalMuon one
+process.gmtPackedMuonsUsePacked = gmtPackedMuonsTest.clone(bmtfCancelMode = "kftracks",
+                                                           emtfCancelMode = "coordinate",
+                                                           usePackedMuons = cms.untracked.bool(True))
+process.L1TMuonPackedMuonsTestSeq += process.gmtPackedMuonsUsePacked
+
+process.L1TMuonPath = cms.Path(process.L1TMuonPackedMuonsTestSeq)
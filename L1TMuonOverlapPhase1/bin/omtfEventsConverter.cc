@@ -0,0 +1,41 @@
+/*
+ * omtfEventsConverter.cc
+ *
+ * Converts the events dumped by the BinaryEventWriter (XMLDumpFileName ending with ".bin") to the XML
+ * in the layout written by the XMLEventWriter, so the existing analysis scripts can read it.
+ *
+ * omtfEventsConverter <events.bin> <events.xml>
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/BinaryEventWriter.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <iostream>
+#include <string>
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cout << "usage:\n" << argv[0] << " <events.bin> <events.xml>" << std::endl;
+    return 2;
+  }
+
+  try {
+    boost::property_tree::ptree tree;
+    BinaryEventWriter::readToTree(argv[1], tree);
+
+    //the same settings as in the XMLEventWriter::endJob
+    boost::property_tree::write_xml(
+        argv[2], tree, std::locale(), boost::property_tree::xml_parser::xml_writer_make_settings<std::string>(' ', 2));
+
+    std::cout << "written " << tree.get_child("OMTF").count("Event") << " events to " << argv[2] << std::endl;
+  } catch (cms::Exception& e) {
+    std::cout << "omtfEventsConverter: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * omtfExtrapolFactorsConverter.cc
+ *
+ * Converts the DT phiB extrapolation factors XML (e.g. ExtrapolationFactors_withQAndEta.xml) to the binary file
+ * read by the ExtrapolFactorsTable, which can be given in the extrapolFactorsFile parameter instead of the XML.
+ * The binary file is read back and compared with the XML.
+ *
+ * omtfExtrapolFactorsConverter <factors.xml> <factors.bin>
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/ExtrapolFactorsTable.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <iostream>
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    std::cout << "usage:\n" << argv[0] << " <factors.xml> <factors.bin>" << std::endl;
+    return 2;
+  }
+
+  try {
+    ExtrapolFactorsTable xmlTable;
+    xmlTable.readXml(argv[1]);
+    xmlTable.writeBinary(argv[2]);
+
+    ExtrapolFactorsTable binaryTable;
+    binaryTable.readBinary(argv[2]);
+
+    if (xmlTable.getNRefLayers() != binaryTable.getNRefLayers() || xmlTable.getNLayers() != binaryTable.getNLayers() ||
+        xmlTable.getNKeys() != binaryTable.getNKeys() || xmlTable.getMultiplier() != binaryTable.getMultiplier()) {
+      std::cout << "omtfExtrapolFactorsConverter: the table read back has different sizes" << std::endl;
+      return 1;
+    }
+
+    for (unsigned int iRefLayer = 0; iRefLayer < xmlTable.getNRefLayers(); iRefLayer++) {
+      for (unsigned int iLayer = 0; iLayer < xmlTable.getNLayers(); iLayer++) {
+        for (unsigned int key = 0; key < xmlTable.getNKeys(); key++) {
+          if (xmlTable.factor(iRefLayer, iLayer, key) != binaryTable.factor(iRefLayer, iLayer, key)) {
+            std::cout << "omtfExtrapolFactorsConverter: the factors read back differ, iRefLayer " << iRefLayer
+                      << " iLayer " << iLayer << " key " << key << std::endl;
+            return 1;
+          }
+        }
+      }
+    }
+
+    std::cout << "written " << argv[2] << ", multiplier " << binaryTable.getMultiplier() << std::endl;
+  } catch (cms::Exception& e) {
+    std::cout << "omtfExtrapolFactorsConverter: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
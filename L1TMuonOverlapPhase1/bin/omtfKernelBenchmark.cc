@@ -0,0 +1,188 @@
+/*
+ * omtfKernelBenchmark.cc
+ *
+ * Micro-benchmark of the golden patterns processing: the virtual GoldenPatternBase::process1Layer1RefLayer and
+ * GoldenPatternBase::finalise (std::function) versus the GoldenPatternKernel<GoldenPattern> and the
+ * GoldenPatternResult::finaliseResults, for each finalizeFunction.
+ * The input are random stubs, the results of both versions are compared, returns 1 if they differ.
+ *
+ * omtfKernelBenchmark <config.xml> <patterns.xml> [nEvents]
+ * config.xml is the OMTF configuration (hwToLogicLayer_0x....xml).
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternKernel.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternResult.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigReader.h"
+
+#include "CondFormats/L1TObjects/interface/L1TMuonOverlapParams.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  struct Event {
+    unsigned int iRefLayer = 0;
+    MuonStubPtr refStub;
+    MuonStubPtrs2D layerStubs;  //[iLayer][iInput]
+  };
+
+  std::vector<Event> generateEvents(const OMTFConfiguration& omtfConfig, unsigned int nEvents) {
+    std::mt19937 generator(12345);
+    std::uniform_int_distribution<int> refPhiDist(-1000, 1000);
+    std::uniform_int_distribution<int> deltaPhiDist(-150, 150);
+    std::uniform_int_distribution<int> phiBDist(-100, 100);
+    std::uniform_int_distribution<int> occupancyDist(0, 3);
+
+    std::vector<Event> events(nEvents);
+    for (auto& event : events) {
+      event.iRefLayer = generator() % omtfConfig.nRefLayers();
+      int refPhi = refPhiDist(generator);
+      event.refStub = std::make_shared<MuonStub>(refPhi, phiBDist(generator));
+      event.refStub->qualityHw = 4;
+
+      event.layerStubs.assign(omtfConfig.nLayers(), MuonStubPtrs1D(omtfConfig.nInputs()));
+      for (auto& stubs : event.layerStubs) {
+        //on average less than one stub per input, as in the real events most of the inputs are empty
+        for (auto& stub : stubs) {
+          if (occupancyDist(generator) == 0) {
+            stub = std::make_shared<MuonStub>(refPhi + deltaPhiDist(generator), phiBDist(generator));
+            stub->qualityHw = generator() % 7;
+          }
+        }
+      }
+    }
+    return events;
+  }
+
+  ///the sum of the results of all events, to compare the virtual and kernel versions
+  struct Checksum {
+    double pdfSum = 0;
+    double pdfSumUpt = 0;
+    unsigned long firedLayerBits = 0;
+    unsigned long firedLayerCnt = 0;
+
+    void add(const GoldenPatternResult& result) {
+      pdfSum += result.getPdfSum();
+      pdfSumUpt += result.getPdfSumUpt();
+      firedLayerBits += result.getFiredLayerBits();
+      firedLayerCnt += result.getFiredLayerCnt();
+    }
+
+    bool operator==(const Checksum& o) const {
+      return pdfSum == o.pdfSum && pdfSumUpt == o.pdfSumUpt && firedLayerBits == o.firedLayerBits &&
+             firedLayerCnt == o.firedLayerCnt;
+    }
+  };
+
+  ///returns the time in seconds
+  template <bool useKernel>
+  double run(const OMTFConfiguration& omtfConfig,
+             GoldenPatternVec<GoldenPattern>& gps,
+             const std::vector<Event>& events,
+             GoldenPatternResult::FinaliseResults finaliseResults,
+             Checksum& checksum) {
+    const unsigned int procIndx = 0;
+    const unsigned int iRefHit = 0;
+    const std::vector<int> extrapolatedPhi(omtfConfig.nInputs(), 0);
+
+    std::chrono::duration<double> elapsed(0);
+    for (auto& event : events) {
+      for (auto& gp : gps) {
+        for (auto& result : gp->getResults()[procIndx])
+          result.reset();
+      }
+
+      auto start = std::chrono::steady_clock::now();
+      for (unsigned int iLayer = 0; iLayer < omtfConfig.nLayers(); ++iLayer) {
+        MuonStubPtrsView layerStubs(event.layerStubs[iLayer]);
+        for (auto& gp : gps) {
+          StubResult stubResult;
+          if (useKernel)
+            stubResult = GoldenPatternKernel<GoldenPattern>::process1Layer1RefLayer(
+                *gp, event.iRefLayer, iLayer, layerStubs, extrapolatedPhi, event.refStub);
+          else
+            stubResult = gp->process1Layer1RefLayer(event.iRefLayer, iLayer, layerStubs, extrapolatedPhi, event.refStub);
+          gp->getResults()[procIndx][iRefHit].setStubResult(iLayer, stubResult);
+        }
+      }
+
+      for (auto& gp : gps) {
+        gp->getResults()[procIndx][iRefHit].set(event.iRefLayer, 0, 0, event.refStub->phiHw);
+        if (useKernel) {
+          auto gpResults = gp->getResults()[procIndx];
+          finaliseResults(&(gpResults[0]), gpResults.size());
+        } else
+          gp->finalise(procIndx);
+      }
+      elapsed += std::chrono::steady_clock::now() - start;
+
+      for (auto& gp : gps)
+        checksum.add(gp->getResults()[procIndx][iRefHit]);
+    }
+    return elapsed.count();
+  }
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 3 && argc != 4) {
+    std::cout << "usage:\n" << argv[0] << " <config.xml> <patterns.xml> [nEvents]" << std::endl;
+    return 2;
+  }
+
+  try {
+    L1TMuonOverlapParams omtfParams;
+    XMLConfigReader configReader;
+    configReader.setConfigFile(argv[1]);
+    configReader.readConfig(&omtfParams);
+
+    OMTFConfiguration omtfConfig;
+    omtfConfig.configure(&omtfParams);
+
+    XMLConfigReader reader;
+    GoldenPatternVec<GoldenPattern> gps = reader.readPatterns<GoldenPattern>(omtfParams, argv[2], false);
+
+    unsigned int nEvents = argc == 4 ? std::atoi(argv[3]) : 10000;
+    std::vector<Event> events = generateEvents(omtfConfig, nEvents);
+
+    std::cout << "patterns " << gps.size() << " events " << nEvents << std::endl;
+    std::cout << "finalizeFunction   virtual [ns/event]   kernel [ns/event]   speedup" << std::endl;
+
+    bool allSame = true;
+    for (int finalizeFunction : {0, 1, 2, 3, 5, 6, 7, 8, 9, 10}) {
+      omtfConfig.setGoldenPatternResultFinalizeFunction(finalizeFunction);
+      //initialises the results (and their finalise std::function) with the finalizeFunction
+      for (auto& gp : gps)
+        gp->setConfig(&omtfConfig);
+
+      GoldenPatternResult::FinaliseResults finaliseResults = GoldenPatternResult::getFinaliseResults(finalizeFunction);
+
+      //warm up
+      Checksum checksumWarmUp;
+      run<false>(omtfConfig, gps, events, finaliseResults, checksumWarmUp);
+
+      Checksum checksumVirtual, checksumKernel;
+      double timeVirtual = run<false>(omtfConfig, gps, events, finaliseResults, checksumVirtual);
+      double timeKernel = run<true>(omtfConfig, gps, events, finaliseResults, checksumKernel);
+
+      bool same = checksumVirtual == checksumKernel;
+      allSame &= same;
+
+      std::cout << std::setw(16) << finalizeFunction << std::setw(21) << std::fixed << std::setprecision(1)
+                << timeVirtual / nEvents * 1e9 << std::setw(20) << timeKernel / nEvents * 1e9 << std::setw(10)
+                << std::setprecision(2) << timeVirtual / timeKernel << (same ? "" : "   RESULTS DIFFER") << std::endl;
+    }
+
+    return allSame ? 0 : 1;
+  } catch (cms::Exception& e) {
+    std::cout << "omtfKernelBenchmark: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -0,0 +1,42 @@
+/*
+ * omtfMergePatternStat.cc
+ *
+ * Adds the partial statistics written by the PatternGenerator (patternGen or 2DHists with the partialStatFile)
+ * of the jobs processing the parts of a sample. The merged file can be given to the patternGenFromPartialStat
+ * (partialStatFiles), so the merging can be done in steps, e.g. when there are many jobs.
+ *
+ * omtfMergePatternStat <merged.bin> <partial1.bin> [partial2.bin ...]
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternsStatFile.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <iostream>
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    std::cout << "usage:\n" << argv[0] << " <merged.bin> <partial1.bin> [partial2.bin ...]" << std::endl;
+    return 2;
+  }
+
+  try {
+    GoldenPatternsStatFile mergedStat;
+    unsigned long eventCnt = 0;
+    for (int iFile = 2; iFile < argc; iFile++) {
+      GoldenPatternsStatFile partialStat(argv[iFile]);
+      for (auto& patternStat : partialStat.getPatterns())
+        eventCnt += patternStat.record.eventCnt;
+      mergedStat.add(partialStat);
+    }
+
+    mergedStat.write(argv[1]);
+    std::cout << "merged " << argc - 2 << " files, " << mergedStat.getPatterns().size() << " patterns, " << eventCnt
+              << " events, written to " << argv[1] << std::endl;
+  } catch (cms::Exception& e) {
+    std::cout << "omtfMergePatternStat: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,98 @@
+/*
+ * omtfPatternStatCheck.cc
+ *
+ * Checks that the sparse storage of the GoldenPatternWithStat statistics gives the same values as the dense one:
+ * the same random counts (a narrow band of phiDist vs phiB, as the muons fill in the 2DHists mode) are added
+ * to two patterns, one with the dense and one with the sparse storage, then all bins and the sums used
+ * by the PatternGenerator::upadatePdfs (the norm and the meanDistPhi of each layer and ref layer) are compared.
+ * The pdfs are computed only from these values, so they are then identical.
+ * Prints the memory used by both storages, returns 1 if any value differs.
+ *
+ * omtfPatternStatCheck [statBins (default 1024)] [nEntries]
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternWithStat.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+
+namespace {
+  const unsigned int nLayers = 18;
+  const unsigned int nRefLayers = 8;
+  const unsigned int nPdfAddrBits = 7;
+  const unsigned int pdfBinsCnt = 1024;
+
+  ///returns the time in seconds
+  double fill(GoldenPatternWithStat& gp, unsigned int statBins, unsigned int nEntries) {
+    std::mt19937 generator(12345);
+    std::normal_distribution<double> phiBDist(0, statBins / 16.);
+    std::normal_distribution<double> phiDistDist(0, 20);
+    std::uniform_int_distribution<unsigned int> layerDist(0, nLayers - 1);
+    std::uniform_int_distribution<unsigned int> refLayerDist(0, nRefLayers - 1);
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0; i < nEntries; i++) {
+      unsigned int iLayer = layerDist(generator);
+      unsigned int iRefLayer = refLayerDist(generator);
+      double phiB = statBins > 1 ? phiBDist(generator) : 0;
+      //phiDist correlated with the phiB, as for the bending
+      int iBin1 = std::lround(pdfBinsCnt / 2 + phiB / 2 + phiDistDist(generator));
+      int iBin2 = std::lround(statBins / 2 + phiB);
+      if (iBin1 < 0 || iBin1 >= (int)pdfBinsCnt || iBin2 < 0 || iBin2 >= (int)statBins)
+        iBin1 = iBin2 = 0;  //as the no hit
+      gp.updateStat(iLayer, iRefLayer, iBin1, iBin2, 1);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  }
+}  // namespace
+
+int main(int argc, char** argv) {
+  unsigned int statBins = argc > 1 ? std::atoi(argv[1]) : 1024;
+  unsigned int nEntries = argc > 2 ? std::atoi(argv[2]) : 10000000;
+
+  Key key(0, 10, 1, 0);
+  GoldenPatternWithStat gpDense(key, nLayers, nRefLayers, nPdfAddrBits);
+  GoldenPatternWithStat gpSparse(key, nLayers, nRefLayers, nPdfAddrBits);
+  gpDense.iniStatisitics(pdfBinsCnt, statBins, GoldenPatternWithStat::StatArrayType::Storage::dense);
+  gpSparse.iniStatisitics(pdfBinsCnt, statBins, GoldenPatternWithStat::StatArrayType::Storage::sparse);
+
+  double timeDense = fill(gpDense, statBins, nEntries);
+  double timeSparse = fill(gpSparse, statBins, nEntries);
+
+  auto& statDense = gpDense.getStatistics();
+  auto& statSparse = gpSparse.getStatistics();
+
+  unsigned long differentBins = 0;
+  unsigned long differentSums = 0;
+  for (unsigned int iLayer = 0; iLayer < nLayers; ++iLayer) {
+    for (unsigned int iRefLayer = 0; iRefLayer < nRefLayers; ++iRefLayer) {
+      for (unsigned int iBin2 = 0; iBin2 < statBins; ++iBin2) {
+        double normDense = 0, normSparse = 0;
+        double meanDense = 0, meanSparse = 0;
+        for (unsigned int iBin1 = 0; iBin1 < pdfBinsCnt; ++iBin1) {
+          int valDense = statDense[iLayer][iRefLayer][iBin1][iBin2];
+          int valSparse = statSparse[iLayer][iRefLayer][iBin1][iBin2];
+          if (valDense != valSparse)
+            differentBins++;
+          normDense += valDense;
+          normSparse += valSparse;
+          meanDense += iBin1 * valDense;
+          meanSparse += iBin1 * valSparse;
+        }
+        if (normDense != normSparse || meanDense != meanSparse)
+          differentSums++;
+      }
+    }
+  }
+
+  std::cout << "statistics [" << nLayers << "][" << nRefLayers << "][" << pdfBinsCnt << "][" << statBins << "], "
+            << nEntries << " entries" << std::endl;
+  std::cout << "dense:  " << statDense.allocatedBytes() / 1024 << " kB, fill " << timeDense << " s" << std::endl;
+  std::cout << "sparse: " << statSparse.allocatedBytes() / 1024 << " kB, fill " << timeSparse << " s" << std::endl;
+  std::cout << "different bins " << differentBins << ", different sums " << differentSums << std::endl;
+
+  return (differentBins || differentSums) ? 1 : 0;
+}
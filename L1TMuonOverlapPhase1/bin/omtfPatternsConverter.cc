@@ -0,0 +1,166 @@
+/*
+ * omtfPatternsConverter.cc
+ *
+ * Converts the OMTF golden patterns between the XML and the binary (GoldenPatternsBinaryFile) format.
+ *
+ * omtfPatternsConverter <config.xml> <patterns.xml> <patterns.bin>    - XML to binary
+ * omtfPatternsConverter <config.xml> <patterns.bin> <patterns.xml>    - binary to XML (with the XMLConfigWriter)
+ * omtfPatternsConverter --check <config.xml> <patterns.xml> <tmpDir>  - round trip XML -> binary -> XML,
+ *                                                                       returns 1 if the patterns are not identical
+ * config.xml is the OMTF configuration (hwToLogicLayer_0x....xml) giving the nLayers, nRefLayers and nPdfAddrBits.
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternsBinaryFile.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigReader.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigWriter.h"
+
+#include "CondFormats/L1TObjects/interface/L1TMuonOverlapParams.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace {
+  typedef GoldenPatternVec<GoldenPatternWithThresh> GPs;
+
+  GPs readPatterns(const L1TMuonOverlapParams& omtfParams, const std::string& fileName, bool buildEmptyPatterns) {
+    auto start = std::chrono::steady_clock::now();
+
+    XMLConfigReader reader;
+    GPs gps = reader.readPatterns<GoldenPatternWithThresh>(omtfParams, fileName, buildEmptyPatterns);
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "read " << gps.size() << " patterns from " << fileName << " in " << elapsed.count() << " s"
+              << std::endl;
+    return gps;
+  }
+
+  void writeXml(const OMTFConfiguration& omtfConfig, const GPs& gps, const std::string& fileName) {
+    bool hasThresholds = false;
+    for (auto& gp : gps) {
+      for (unsigned int iRefLayer = 0; iRefLayer < omtfConfig.nRefLayers(); ++iRefLayer)
+        hasThresholds |= (gp->getThreshold(iRefLayer) != 0);
+    }
+
+    //meanDistPhi1 is always written, so that nothing is lost
+    XMLConfigWriter xmlWriter(&omtfConfig, hasThresholds, true);
+    xmlWriter.writeGPs(gps, fileName);
+    std::cout << "written " << gps.size() << " patterns to " << fileName << std::endl;
+  }
+
+  ///the eta code is not compared if compareEta is false, as the XMLConfigWriter does not write it
+  unsigned int comparePatterns(
+      const OMTFConfiguration& omtfConfig, const GPs& gpsA, const GPs& gpsB, bool compareEta, const std::string& what) {
+    if (gpsA.size() != gpsB.size()) {
+      std::cout << what << ": different number of patterns " << gpsA.size() << " " << gpsB.size() << std::endl;
+      return 1;
+    }
+
+    unsigned int diffCnt = 0;
+    for (unsigned int iGP = 0; iGP < gpsA.size(); ++iGP) {
+      auto& gpA = gpsA[iGP];
+      auto& gpB = gpsB[iGP];
+      const Key& keyA = gpA->key();
+      const Key& keyB = gpB->key();
+      if (keyA.thePt != keyB.thePt || keyA.theCharge != keyB.theCharge || keyA.theNumber != keyB.theNumber ||
+          (keyA.thePt && (keyA.theGroup != keyB.theGroup || keyA.theIndexInGroup != keyB.theIndexInGroup)) ||
+          (compareEta && keyA.theEtaCode != keyB.theEtaCode)) {
+        std::cout << what << ": different keys: " << keyA << " " << keyB << std::endl;
+        diffCnt++;
+        continue;
+      }
+
+      for (unsigned int iRefLayer = 0; iRefLayer < omtfConfig.nRefLayers(); ++iRefLayer) {
+        if (gpA->getThreshold(iRefLayer) != gpB->getThreshold(iRefLayer)) {
+          std::cout << what << ": " << keyA << " different threshold, iRefLayer " << iRefLayer << std::endl;
+          diffCnt++;
+        }
+      }
+
+      for (unsigned int iLayer = 0; iLayer < omtfConfig.nLayers(); ++iLayer) {
+        for (unsigned int iRefLayer = 0; iRefLayer < omtfConfig.nRefLayers(); ++iRefLayer) {
+          bool same = gpA->getMeanDistPhi()[iLayer][iRefLayer][0] == gpB->getMeanDistPhi()[iLayer][iRefLayer][0] &&
+                      gpA->getMeanDistPhi()[iLayer][iRefLayer][1] == gpB->getMeanDistPhi()[iLayer][iRefLayer][1] &&
+                      gpA->getDistPhiBitShift(iLayer, iRefLayer) == gpB->getDistPhiBitShift(iLayer, iRefLayer);
+
+          for (unsigned int iBin = 0; iBin < omtfConfig.nPdfBins(); ++iBin)
+            same &= (gpA->pdfValue(iLayer, iRefLayer, iBin) == gpB->pdfValue(iLayer, iRefLayer, iBin));
+
+          if (!same) {
+            std::cout << what << ": " << keyA << " different meanDistPhi, distPhiBitShift or pdf, iLayer " << iLayer
+                      << " iRefLayer " << iRefLayer << std::endl;
+            diffCnt++;
+          }
+        }
+      }
+    }
+    return diffCnt;
+  }
+
+  int roundTripCheck(const L1TMuonOverlapParams& omtfParams,
+                     const OMTFConfiguration& omtfConfig,
+                     const std::string& xmlFile,
+                     const std::string& tmpDir) {
+    const std::string binaryFile = tmpDir + "/omtfPatternsRoundTrip.bin";
+    const std::string xmlFileOut = tmpDir + "/omtfPatternsRoundTrip.xml";
+
+    //all patterns, including the empty ones, must survive the XML -> binary conversion
+    GPs gpsXml = readPatterns(omtfParams, xmlFile, true);
+    GoldenPatternsBinaryFile::write(gpsXml, &omtfConfig, binaryFile);
+    GPs gpsBinary = readPatterns(omtfParams, binaryFile, true);
+    unsigned int diffCnt = comparePatterns(omtfConfig, gpsXml, gpsBinary, true, "XML -> binary");
+
+    //the XMLConfigWriter writes only the non-empty patterns
+    GPs gpsXmlNonEmpty = readPatterns(omtfParams, xmlFile, false);
+    writeXml(omtfConfig, readPatterns(omtfParams, binaryFile, false), xmlFileOut);
+    GPs gpsXmlOut = readPatterns(omtfParams, xmlFileOut, false);
+    diffCnt += comparePatterns(omtfConfig, gpsXmlNonEmpty, gpsXmlOut, false, "binary -> XML");
+
+    std::cout << "round trip check " << (diffCnt ? "FAILED" : "OK") << ", differences: " << diffCnt << std::endl;
+    return diffCnt ? 1 : 0;
+  }
+}  // namespace
+
+int main(int argc, char** argv) {
+  bool check = argc == 5 && std::string(argv[1]) == "--check";
+  if (argc != 4 && !check) {
+    std::cout << "usage:\n"
+              << argv[0] << " <config.xml> <patterns.xml> <patterns.bin>\n"
+              << argv[0] << " <config.xml> <patterns.bin> <patterns.xml>\n"
+              << argv[0] << " --check <config.xml> <patterns.xml> <tmpDir>" << std::endl;
+    return 2;
+  }
+
+  try {
+    int iArg = check ? 2 : 1;
+    L1TMuonOverlapParams omtfParams;
+    XMLConfigReader configReader;
+    configReader.setConfigFile(argv[iArg]);
+    configReader.readConfig(&omtfParams);
+
+    OMTFConfiguration omtfConfig;
+    omtfConfig.configure(&omtfParams);
+
+    const std::string inFile = argv[iArg + 1];
+    const std::string outFile = argv[iArg + 2];
+
+    if (check)
+      return roundTripCheck(omtfParams, omtfConfig, inFile, outFile);
+
+    if (GoldenPatternsBinaryFile::isBinaryFile(inFile)) {
+      //the XMLConfigWriter needs the patterns groups without the empty patterns
+      writeXml(omtfConfig, readPatterns(omtfParams, inFile, false), outFile);
+    } else {
+      GoldenPatternsBinaryFile::write(readPatterns(omtfParams, inFile, true), &omtfConfig, outFile);
+      std::cout << "written binary patterns to " << outFile << std::endl;
+    }
+  } catch (cms::Exception& e) {
+    std::cout << "omtfPatternsConverter: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,237 @@
+/*
+ * omtfProcessorBenchmark.cc
+ *
+ * Benchmark of the OMTFProcessor<GoldenPattern> without the cmsRun: replays the processor inputs dumped
+ * by the OMTFinputSnapshotWriter (inputSnapshotsFileName parameter of the simOmtfDigis) and reports the events/s
+ * and the time of each stage of the OMTFProcessor::run (processInput, sortResults, ghostBust, getFinalcandidates).
+ * If built with -DOMTF_BENCHMARK_COUNT_ALLOCATIONS (e.g. scram b USER_CXXFLAGS=-DOMTF_BENCHMARK_COUNT_ALLOCATIONS),
+ * the global operator new is replaced to count also the memory allocations of each stage.
+ * The final candidates are compared with the recorded ones, returns 1 if they differ, so the configuration
+ * and patterns must be the same as in the job which recorded the inputs.
+ *
+ * omtfProcessorBenchmark <config.xml> <patterns.xml> <inputSnapshots.bin> [nRepeats] [name=value ...]
+ * config.xml is the OMTF configuration (hwToLogicLayer_0x....xml), the patterns can be the binary file (omtfPatternsConverter).
+ * The name=value are added to the edm::ParameterSet given to the OMTFConfiguration::configureFromEdmParameterSet
+ * and the OMTFProcessor, as in the simOmtfDigis, e.g. goldenPatternResultFinalizeFunction=3 or
+ * ghostBusterType=GhostBusterPreferRefDt; true/false values are bool, the integer values are int, the rest is string.
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinputSnapshotWriter.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessingContext.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessor.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigReader.h"
+
+#include "CondFormats/L1TObjects/interface/L1TMuonOverlapParams.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace {
+  std::atomic<unsigned long> allocationCnt(0);
+
+#ifdef OMTF_BENCHMARK_COUNT_ALLOCATIONS
+  const bool countAllocations = true;
+#else
+  const bool countAllocations = false;
+#endif
+}  // namespace
+
+#ifdef OMTF_BENCHMARK_COUNT_ALLOCATIONS
+//counting all allocations of the process, the benchmark is single threaded
+void* operator new(std::size_t size) {
+  allocationCnt.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = std::malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) { return operator new(size); }
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr) noexcept { std::free(ptr); }
+
+void operator delete(void* ptr, std::size_t) noexcept { std::free(ptr); }
+
+void operator delete[](void* ptr, std::size_t) noexcept { std::free(ptr); }
+#endif
+
+namespace {
+  enum Stage { processInput, sortResults, ghostBust, getFinalcandidates, stagesCnt };
+
+  const std::array<const char*, stagesCnt> stageNames = {
+      {"processInput", "sortResults", "ghostBust", "getFinalcandidates"}};
+
+  struct StageStat {
+    std::chrono::duration<double> time{0};
+    unsigned long allocations = 0;
+  };
+
+  ///measures the time and the allocations from the construction to the stop()
+  class StageTimer {
+  public:
+    StageTimer(StageStat& stat)
+        : stat(stat), allocationsStart(allocationCnt.load()), start(std::chrono::steady_clock::now()) {}
+
+    void stop() {
+      stat.time += std::chrono::steady_clock::now() - start;
+      stat.allocations += allocationCnt.load() - allocationsStart;
+    }
+
+  private:
+    StageStat& stat;
+    unsigned long allocationsStart;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  void addParameter(edm::ParameterSet& edmCfg, const std::string& nameValue) {
+    auto eqPos = nameValue.find('=');
+    if (eqPos == std::string::npos || eqPos == 0)
+      throw cms::Exception("omtfProcessorBenchmark: wrong parameter " + nameValue + ", should be name=value");
+
+    std::string name = nameValue.substr(0, eqPos);
+    std::string value = nameValue.substr(eqPos + 1);
+    if (value == "true" || value == "false") {
+      edmCfg.addParameter<bool>(name, value == "true");
+      return;
+    }
+
+    char* end = nullptr;
+    long intValue = std::strtol(value.c_str(), &end, 0);
+    if (!value.empty() && *end == '\0')
+      edmCfg.addParameter<int>(name, intValue);
+    else
+      edmCfg.addParameter<std::string>(name, value);
+  }
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 4) {
+    std::cout << "usage:\n"
+              << argv[0] << " <config.xml> <patterns.xml> <inputSnapshots.bin> [nRepeats] [name=value ...]" << std::endl;
+    return 2;
+  }
+
+  try {
+    unsigned int nRepeats = 10;
+    edm::ParameterSet edmCfg;
+    for (int iArg = 4; iArg < argc; iArg++) {
+      std::string arg = argv[iArg];
+      if (iArg == 4 && arg.find('=') == std::string::npos)
+        nRepeats = std::atoi(argv[iArg]);
+      else
+        addParameter(edmCfg, arg);
+    }
+
+    L1TMuonOverlapParams omtfParams;
+    XMLConfigReader configReader;
+    configReader.setConfigFile(argv[1]);
+    configReader.readConfig(&omtfParams);
+
+    OMTFConfiguration omtfConfig;
+    omtfConfig.configure(&omtfParams);
+    omtfConfig.configureFromEdmParameterSet(edmCfg);
+
+    XMLConfigReader reader;
+    OMTFProcessor<GoldenPattern> omtfProc(
+        &omtfConfig, edmCfg, reader.readPatterns<GoldenPattern>(omtfParams, argv[2], false));
+
+    std::vector<OMTFinputSnapshotWriter::Snapshot> snapshots =
+        OMTFinputSnapshotWriter::readSnapshots(argv[3], &omtfConfig);
+
+    unsigned int nEvents = 0;
+    for (unsigned int iSnapshot = 0; iSnapshot < snapshots.size(); iSnapshot++) {
+      if (iSnapshot == 0 || snapshots[iSnapshot].iEvent != snapshots[iSnapshot - 1].iEvent)
+        nEvents++;
+    }
+
+    std::cout << "processor inputs " << snapshots.size() << " events " << nEvents << " repeats " << nRepeats
+              << std::endl;
+    if (snapshots.empty() || nRepeats == 0)
+      return 0;
+
+    std::unique_ptr<OMTFProcessingContext> context = omtfProc.makeProcessingContext();
+    std::vector<std::unique_ptr<IOMTFEmulationObserver> > observers;
+
+    std::array<StageStat, stagesCnt> stageStats;
+    unsigned long differentCandidates = 0;
+
+    //the first repeat is the warm up, it is not included in the timing, but the candidates are compared
+    for (unsigned int iRepeat = 0; iRepeat <= nRepeats; iRepeat++) {
+      std::array<StageStat, stagesCnt> repeatStats;
+      for (unsigned int iSnapshot = 0; iSnapshot < snapshots.size(); iSnapshot++) {
+        auto& snapshot = snapshots[iSnapshot];
+
+        StageTimer processInputTimer(repeatStats[processInput]);
+        omtfProc.processInput(*context, snapshot.iProcessor, snapshot.mtfType, *snapshot.input, observers);
+        processInputTimer.stop();
+
+        StageTimer sortResultsTimer(repeatStats[sortResults]);
+        omtfProc.sortResults(*context, snapshot.iProcessor, snapshot.mtfType);
+        sortResultsTimer.stop();
+
+        StageTimer ghostBustTimer(repeatStats[ghostBust]);
+        omtfProc.ghostBust(*context);
+        ghostBustTimer.stop();
+
+        StageTimer getFinalcandidatesTimer(repeatStats[getFinalcandidates]);
+        std::vector<l1t::RegionalMuonCand> candMuons =
+            omtfProc.getFinalcandidates(snapshot.iProcessor, snapshot.mtfType, context->getGbCands());
+        getFinalcandidatesTimer.stop();
+
+        if (iRepeat == 0) {
+          bool same = candMuons.size() == snapshot.candidates.size();
+          for (unsigned int iCand = 0; same && iCand < candMuons.size(); iCand++)
+            same = OMTFinputSnapshotWriter::makeCandidateRecord(candMuons[iCand]) == snapshot.candidates[iCand];
+          if (!same)
+            differentCandidates++;
+        }
+      }
+
+      if (iRepeat > 0) {
+        for (unsigned int iStage = 0; iStage < stagesCnt; iStage++) {
+          stageStats[iStage].time += repeatStats[iStage].time;
+          stageStats[iStage].allocations += repeatStats[iStage].allocations;
+        }
+      }
+    }
+
+    double totalTime = 0;
+    for (auto& stageStat : stageStats)
+      totalTime += stageStat.time.count();
+
+    double nInputs = (double)snapshots.size() * nRepeats;
+    std::cout << "stage                  [ns/input]   [%]" << (countAllocations ? "   allocations/input" : "")
+              << std::endl;
+    for (unsigned int iStage = 0; iStage < stagesCnt; iStage++) {
+      std::cout << std::left << std::setw(20) << stageNames[iStage] << std::right << std::fixed << std::setw(13)
+                << std::setprecision(1) << stageStats[iStage].time.count() / nInputs * 1e9 << std::setw(6)
+                << std::setprecision(1) << stageStats[iStage].time.count() / totalTime * 100;
+      if (countAllocations)
+        std::cout << std::setw(20) << std::setprecision(2) << stageStats[iStage].allocations / nInputs;
+      std::cout << std::endl;
+    }
+    std::cout << "events/s " << std::setprecision(0) << nEvents * nRepeats / totalTime << std::endl;
+
+    if (differentCandidates) {
+      std::cout << "the candidates differ from the recorded ones for " << differentCandidates << " of "
+                << snapshots.size() << " processor inputs" << std::endl;
+      return 1;
+    }
+    return 0;
+  } catch (cms::Exception& e) {
+    std::cout << "omtfProcessorBenchmark: " << e.what() << std::endl;
+    return 1;
+  }
+}
@@ -9,7 +9,10 @@
 #include "Geometry/Records/interface/MuonGeometryRecord.h"
 #include "FWCore/Framework/interface/ESWatcher.h"
 
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace edm {
   class EventSetup;
@@ -18,6 +21,7 @@ namespace edm {
 class RPCGeometry;
 class CSCGeometry;
 class CSCLayer;
+class CSCChamber;
 class DTGeometry;
 
 class L1MuDTChambPhDigi;
@@ -100,6 +104,30 @@ protected:
   ///Check orientation of strips in given CSC chamber
   virtual bool isCSCCounterClockwise(const CSCLayer* layer) const;
 
+  ///parameters of the CSC chamber needed to convert the half strip to phi, depend only on the geometry
+  struct CscChamberPhiParams {
+    int order = 1;  //+1 if the phi grows with the strip number, -1 otherwise
+    double stripPhiPitch = 0;
+    double phiHalfStrip0 = 0;
+  };
+
+  virtual CscChamberPhiParams computeCscChamberPhiParams(const CSCChamber* chamber) const;
+
+  ///if useCache is false, or the chamber is not in the cache, the params are taken directly from the geometry
+  CscChamberPhiParams getCscChamberPhiParams(const CSCDetId& chamberId, bool useCache = true) const;
+
+  int getProcessorPhiCsc(int phiZero, const CSCDetId& csc, int halfStrip, bool useCache = true) const;
+
+  ///global phi [-pi, pi] of the centre of the RPC strip,
+  ///if useCache is false, or the roll is not in the cache, it is taken directly from the geometry
+  double getRpcStripPhi(const RPCDetId& rollId, unsigned int strip, bool useCache = true) const;
+
+  ///fills the cscChamberPhiParams and rpcStripPhi for all chambers and rolls, called when the geometry is changed
+  virtual void buildGeometryCache();
+
+  ///throws cms::Exception if any cached value is different than the one obtained directly from the geometry
+  virtual void validateGeometryCache() const;
+
   ///Find BTI group
   virtual const int findBTIgroup(const L1MuDTChambPhDigi& aDigi, const L1MuDTChambThContainer* dtThDigis);
 
@@ -111,6 +139,13 @@ protected:
 
   edm::ESWatcher<MuonGeometryRecord> muonGeometryRecordWatcher;
 
+  ///the geometry-derived values cached by the buildGeometryCache, such that the per digi conversion needs no geometry calls
+  ///key - CSC chamber rawId
+  std::unordered_map<uint32_t, CscChamberPhiParams> cscChamberPhiParams;
+
+  ///key - RPC roll rawId, value - phi of the strip centre, indexed with the strip number (starting from 1, index 0 not used)
+  std::unordered_map<uint32_t, std::vector<double> > rpcStripPhi;
+
   const ProcConfigurationBase* config = nullptr;
   ///Number of phi bins along 2Pi.
   unsigned int nPhiBins = 0;
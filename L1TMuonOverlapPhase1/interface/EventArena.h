@@ -0,0 +1,126 @@
+/*
+ * EventArena.h
+ *
+ *      EventArena - per event storage of the objects created during the event processing (MuonStubs, AlgoMuons)
+ */
+
+#ifndef L1T_OmtfP1_EVENTARENA_H_
+#define L1T_OmtfP1_EVENTARENA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+/*
+ * The objects are allocated in one contiguous buffer, by bumping the offset (thread safe, lock free),
+ * the memory is not given back one by one, but all at once in the reset(), which should be called at the beginning of the event.
+ * The objects are created with the makeShared, so they can still be used as the std::shared_ptr by the rest of the code,
+ * but the malloc/free for each stub/candidate is avoided.
+ * If some objects from the previous event are still alive (e.g. kept by an observer), the reset() does not rewind the buffer,
+ * but starts a new one, and the old one is freed when the last object is destroyed.
+ * If the buffer is full, the objects are allocated on the heap.
+ */
+class EventArena {
+public:
+  class Buffer {
+  public:
+    explicit Buffer(std::size_t capacity) : data(new char[capacity]), capacity(capacity) {}
+
+    ///returns nullptr if there is no space in the buffer
+    void* allocate(std::size_t bytes, std::size_t alignment) {
+      std::size_t start = 0;
+      std::size_t offset = used.load(std::memory_order_relaxed);
+      do {
+        start = (offset + alignment - 1) & ~(alignment - 1);
+        if (start + bytes > capacity)
+          return nullptr;
+      } while (!used.compare_exchange_weak(offset, start + bytes, std::memory_order_relaxed));
+      return data.get() + start;
+    }
+
+    bool owns(const void* ptr) const {
+      return static_cast<const char*>(ptr) >= data.get() && static_cast<const char*>(ptr) < data.get() + capacity;
+    }
+
+    void rewind() { used.store(0, std::memory_order_relaxed); }
+
+    std::size_t getUsed() const { return used.load(std::memory_order_relaxed); }
+
+  private:
+    std::unique_ptr<char[]> data;
+    const std::size_t capacity;
+    std::atomic<std::size_t> used{0};
+  };
+
+  ///the allocator used by the std::allocate_shared, keeps the buffer alive as long as the object exists
+  template <class T>
+  class Allocator {
+  public:
+    typedef T value_type;
+
+    explicit Allocator(const std::shared_ptr<Buffer>& buffer) : buffer(buffer) {}
+
+    template <class U>
+    Allocator(const Allocator<U>& other) : buffer(other.buffer) {}
+
+    T* allocate(std::size_t n) {
+      void* ptr = buffer->allocate(n * sizeof(T), alignof(T));
+      if (ptr == nullptr)
+        ptr = ::operator new(n * sizeof(T));
+      return static_cast<T*>(ptr);
+    }
+
+    ///the memory from the buffer is reclaimed all at once in the EventArena::reset()
+    void deallocate(T* ptr, std::size_t) {
+      if (!buffer->owns(ptr))
+        ::operator delete(ptr);
+    }
+
+    template <class U>
+    bool operator==(const Allocator<U>& other) const {
+      return buffer == other.buffer;
+    }
+
+    template <class U>
+    bool operator!=(const Allocator<U>& other) const {
+      return buffer != other.buffer;
+    }
+
+  private:
+    std::shared_ptr<Buffer> buffer;
+
+    template <class U>
+    friend class Allocator;
+  };
+
+  explicit EventArena(std::size_t capacity = defaultCapacity)
+      : capacity(capacity), buffer(std::make_shared<Buffer>(capacity)) {}
+
+  ///not thread safe, should be called at the beginning of the event, when nothing is allocated concurrently
+  void reset();
+
+  ///thread safe
+  template <class T, class... Args>
+  std::shared_ptr<T> makeShared(Args&&... args) {
+    return std::allocate_shared<T>(Allocator<T>(buffer), std::forward<Args>(args)...);
+  }
+
+  static const std::size_t defaultCapacity = 1 << 19;
+
+private:
+  const std::size_t capacity;
+
+  std::shared_ptr<Buffer> buffer;
+};
+
+///creates the object in the arena, or on the heap if the arena is nullptr
+template <class T, class... Args>
+std::shared_ptr<T> makeSharedInArena(EventArena* arena, Args&&... args) {
+  if (arena)
+    return arena->makeShared<T>(std::forward<Args>(args)...);
+  return std::make_shared<T>(std::forward<Args>(args)...);
+}
+
+#endif /* L1T_OmtfP1_EVENTARENA_H_ */
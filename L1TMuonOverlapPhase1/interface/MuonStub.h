@@ -10,6 +10,8 @@
 #ifndef L1T_OmtfP1_MUONSTUB_H_
 #define L1T_OmtfP1_MUONSTUB_H_
 
+#include <algorithm>
+#include <cstddef>
 #include <vector>
 #include <memory>
 
@@ -66,4 +68,34 @@ typedef std::shared_ptr<MuonStub> MuonStubPtr;
 typedef std::vector<MuonStubPtr> MuonStubPtrs1D;
 typedef std::vector<MuonStubPtrs1D> MuonStubPtrs2D;
 
+///non-owning view of the consecutive inputs [iFirstInput, iFirstInput + nInputs) of one layer of the MuonStubPtrs2D,
+///it does not copy the shared_ptrs, so it is valid only as long as the viewed MuonStubPtrs1D is not modified
+class MuonStubPtrsView {
+public:
+  MuonStubPtrsView() {}
+
+  ///the range is clipped to the size of the layerStubs
+  MuonStubPtrsView(const MuonStubPtrs1D& layerStubs, unsigned int iFirstInput, std::size_t nInputs)
+      : first(layerStubs.data() + std::min<std::size_t>(iFirstInput, layerStubs.size())),
+        count(std::min<std::size_t>(std::size_t(iFirstInput) + nInputs, layerStubs.size()) -
+              std::min<std::size_t>(iFirstInput, layerStubs.size())) {}
+
+  ///view of all inputs of the layer
+  MuonStubPtrsView(const MuonStubPtrs1D& layerStubs) : first(layerStubs.data()), count(layerStubs.size()) {}
+
+  std::size_t size() const { return count; }
+
+  bool empty() const { return count == 0; }
+
+  const MuonStubPtr& operator[](std::size_t iStub) const { return first[iStub]; }
+
+  const MuonStubPtr* begin() const { return first; }
+
+  const MuonStubPtr* end() const { return first + count; }
+
+private:
+  const MuonStubPtr* first = nullptr;
+  std::size_t count = 0;
+};
+
 #endif /* L1T_OmtfP1_MUONSTUB_H_ */
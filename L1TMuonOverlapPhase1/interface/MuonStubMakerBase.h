@@ -12,10 +12,13 @@
 #include "DataFormats/RPCDigi/interface/RPCDigiCollection.h"
 #include "FWCore/Framework/interface/Event.h"
 #include "FWCore/Utilities/interface/EDGetToken.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/EventArena.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/MuonStub.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/RpcClusterization.h"
+#include <array>
 #include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 class ProcConfigurationBase;
@@ -31,14 +34,62 @@ struct MuStubsInputTokens {
   edm::EDGetTokenT<RPCDigiCollection> inputTokenRPC;
 };
 
+/*
+ * Flat table of the digi indices split per (processor, side, bx).
+ * It is filled once per event (in the MuonStubMakerBase::loadAndFilterDigis), such that the makeStubs called for
+ * every processor loops only over the digis accepted by this processor, instead of scanning and filtering the whole digi collection.
+ * A digi from the overlap region of two neighboring sectors goes to the buckets of both processors.
+ * Within a bucket the indices are in the order of the digi collection, so the stubs are added in the same order as without the bucketing.
+ */
+class DigiBuckets {
+public:
+  ///only the OMTF sides are bucketed, for other tftypes get() returns nullptr
+  static constexpr std::array<l1t::tftype, 2> sides = {{l1t::tftype::omtf_pos, l1t::tftype::omtf_neg}};
+
+  ///clears the buckets, the allocated memory is kept for the next event. nProcessors = 0 disables the bucketing
+  void reset(unsigned int nProcessors, int bxFrom, int bxTo);
+
+  bool isActive() const { return nProcessors > 0; }
+
+  void add(unsigned int iProcessor, l1t::tftype procTyp, int bx, unsigned int digiIndex) {
+    int iBucket = bucketIndex(iProcessor, procTyp, bx);
+    if (iBucket >= 0)
+      buckets[iBucket].push_back(digiIndex);
+  }
+
+  ///returns nullptr if the given (iProcessor, procTyp, bx) is not covered by the buckets,
+  ///or if bxFrom != bxTo, then the caller should scan the whole collection
+  const std::vector<unsigned int>* get(unsigned int iProcessor, l1t::tftype procTyp, int bxFrom, int bxTo) const;
+
+private:
+  ///returns -1 if the (iProcessor, procTyp, bx) is out of the bucketed range
+  int bucketIndex(unsigned int iProcessor, l1t::tftype procTyp, int bx) const;
+
+  unsigned int nProcessors = 0;
+  int bxFrom = 0;
+  int bxTo = 0;
+
+  std::vector<std::vector<unsigned int> > buckets;
+};
+
 class DigiToStubsConverterBase {
 public:
   virtual ~DigiToStubsConverterBase(){};
 
   virtual void loadDigis(const edm::Event& event) = 0;
 
+  ///splits the loaded digis into the DigiBuckets, called once per event after the loadDigis
+  ///by default does nothing, then the makeStubs should scan the whole digi collection
+  virtual void bucketDigis(unsigned int nProcessors, int bxFrom, int bxTo) {}
+
   virtual void makeStubs(
       MuonStubPtrs2D& muonStubsInLayers, unsigned int iProcessor, l1t::tftype procTyp, int bxFrom, int bxTo) = 0;
+
+  ///the MuonStubs are created in this arena, if nullptr - on the heap
+  void setStubsArena(EventArena* stubsArena) { this->stubsArena = stubsArena; }
+
+protected:
+  EventArena* stubsArena = nullptr;
 };
 
 class DtDigiToStubsConverter : public DigiToStubsConverterBase {
@@ -53,6 +104,8 @@ public:
 
   void loadDigis(const edm::Event& event) override;
 
+  void bucketDigis(unsigned int nProcessors, int bxFrom, int bxTo) override;
+
   void makeStubs(
       MuonStubPtrs2D& muonStubsInLayers, unsigned int iProcessor, l1t::tftype procTyp, int bxFrom, int bxTo) override;
 
@@ -80,6 +133,9 @@ protected:
 
   edm::Handle<L1MuDTChambPhContainer> dtPhDigis;
   edm::Handle<L1MuDTChambThContainer> dtThDigis;
+
+  //indices in the dtPhDigis->getContainer()
+  DigiBuckets digiBuckets;
 };
 
 class CscDigiToStubsConverter : public DigiToStubsConverterBase {
@@ -94,6 +150,8 @@ public:
 
   void loadDigis(const edm::Event& event) override { event.getByToken(inputTokenCsc, cscDigis); }
 
+  void bucketDigis(unsigned int nProcessors, int bxFrom, int bxTo) override;
+
   void makeStubs(
       MuonStubPtrs2D& muonStubsInLayers, unsigned int iProcessor, l1t::tftype procTyp, int bxFrom, int bxTo) override;
 
@@ -113,6 +171,12 @@ protected:
 
   edm::EDGetTokenT<CSCCorrelatedLCTDigiCollection> inputTokenCsc;
   edm::Handle<CSCCorrelatedLCTDigiCollection> cscDigis;
+
+  //rawId and digi, in the order of the cscDigis, filled in the bucketDigis
+  std::vector<std::pair<unsigned int, const CSCCorrelatedLCTDigi*> > cscDigisFlat;
+
+  //indices in the cscDigisFlat
+  DigiBuckets digiBuckets;
 };
 
 class RpcDigiToStubsConverter : public DigiToStubsConverterBase {
@@ -128,6 +192,8 @@ public:
 
   void loadDigis(const edm::Event& event) override { event.getByToken(inputTokenRpc, rpcDigis); }
 
+  void bucketDigis(unsigned int nProcessors, int bxFrom, int bxTo) override;
+
   void makeStubs(
       MuonStubPtrs2D& muonStubsInLayers, unsigned int iProcessor, l1t::tftype procTyp, int bxFrom, int bxTo) override;
 
@@ -140,6 +206,14 @@ public:
   virtual bool acceptDigi(const RPCDetId& rpcDetId, unsigned int iProcessor, l1t::tftype procType) { return true; }
 
 protected:
+  void makeRollStubs(MuonStubPtrs2D& muonStubsInLayers,
+                     const RPCDetId& roll,
+                     const RPCDigiCollection::Range& rollDigis,
+                     unsigned int iProcessor,
+                     l1t::tftype procTyp,
+                     int bxFrom,
+                     int bxTo);
+
   const ProcConfigurationBase* config;
 
   bool mergePhiAndTheta = true;
@@ -148,6 +222,12 @@ protected:
   edm::Handle<RPCDigiCollection> rpcDigis;
 
   const RpcClusterization* rpcClusterization;
+
+  //rolls with digis, in the order of the rpcDigis, filled in the bucketDigis
+  std::vector<std::pair<RPCDetId, RPCDigiCollection::Range> > rpcRolls;
+
+  //indices in the rpcRolls, a roll is put to the bucket of a given bx if it has at least one digi in this bx
+  DigiBuckets digiBuckets;
 };
 
 //forward declaration - MuonGeometryTokens is defined and used in the AngleConverterBase
@@ -163,7 +243,8 @@ public:
                           const edm::EventSetup& es,
                           const MuonGeometryTokens& muonGeometryTokens);
 
-  void loadAndFilterDigis(const edm::Event& event);
+  ///loads the digis and splits them into the per (processor, side, bx) buckets for the bxFrom - bxTo range
+  void loadAndFilterDigis(const edm::Event& event, int bxFrom = 0, int bxTo = 0);
 
   ///Method translating trigger digis into input matrix with global phi coordinates, fills the muonStubsInLayers
   void buildInputForProcessor(
@@ -175,6 +256,12 @@ protected:
   std::vector<std::unique_ptr<DigiToStubsConverterBase> > digiToStubsConverters;
 
   RpcClusterization rpcClusterization;
+
+  //number of processors per side for which the digis are bucketed in the loadAndFilterDigis, 0 means no bucketing
+  unsigned int nProcessors = 0;
+
+  //storage of the MuonStubs of the current event, reset in the loadAndFilterDigis
+  EventArena stubsArena;
 };
 
 #endif
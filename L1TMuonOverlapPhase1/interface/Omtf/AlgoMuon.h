@@ -18,6 +18,13 @@ public:
         m_bx(bx),
         m_rhitNumb(refHitNumber) {}
 
+  ///sets the candidate as the constructor above, but reuses the memory of this object (e.g. the stubResults),
+  ///used for the candidates kept in the OMTFProcessingContext
+  void assign(const GoldenPatternResult& gpResult, GoldenPatternBase* gp, unsigned int refHitNumber, int bx = 0);
+
+  ///as the default constructor, i.e. no candidate, but with the refHitNumber
+  void assignEmpty(unsigned int refHitNumber);
+
   GoldenPatternBase* getGoldenPatern() const { return goldenPatern; }
 
   ~AlgoMuon() override {}
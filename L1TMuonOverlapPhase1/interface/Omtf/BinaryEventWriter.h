@@ -0,0 +1,169 @@
+/*
+ * BinaryEventWriter.h
+ *
+ *      Streaming alternative to the XMLEventWriter
+ */
+
+#ifndef L1T_OmtfP1_BINARYEVENTWRITER_H_
+#define L1T_OmtfP1_BINARYEVENTWRITER_H_
+
+#include "DataFormats/L1TMuon/interface/RegionalMuonCand.h"
+#include "DataFormats/L1TMuon/interface/RegionalMuonCandFwd.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/AlgoMuon.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/BinaryFileHeader.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternResult.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/IOMTFEmulationObserver.h"
+
+#include <boost/property_tree/ptree.hpp>
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Writes the same content as the XMLEventWriter (the hits, AlgoMuons and final candidates of the processors
+ * with a candidate), but the records are appended to a buffer
+ * and written to the file as the events come, nothing is kept in memory, so there is no limit on the number of events.
+ * It is used instead of the XMLEventWriter if the XMLDumpFileName ends with ".bin".
+ * The omtfEventsConverter converts the file to the XML in the XMLEventWriter layout.
+ *
+ * The file layout (native byte order, see the BinaryFileHeader):
+ * FileHeader, then the records, each is the RecordHeader followed by the payload of the RecordHeader::size bytes:
+ * EVENT      - EventRecord, starts a new event
+ * PROCESSOR  - ProcessorRecord, starts a new processor in the last event,
+ *              the records below belong to the last processor
+ * PROC_DATA  - key, then the ptree given to the addProcesorData (see writeTree), written only if the ptree is not empty;
+ *              the OMTFProcessor does not build the extrapolatedPhi data for the binary file
+ * HIT        - HitRecord
+ * ALGO_MUON  - AlgoMuonRecord
+ * CAND_MUON  - CandMuonRecord
+ * The records of unknown type are skipped by the reader.
+ */
+class BinaryEventWriter : public IOMTFEmulationObserver {
+public:
+  static constexpr BinaryFileHeader::Magic magic = {'O', 'M', 'T', 'F', 'E', 'V', 'B', '\0'};
+
+  //to be incremented if the layout is changed
+  static const uint32_t version = 1;
+
+  struct FileHeader {
+    BinaryFileHeader fileType;
+    uint32_t pdfValueSize;  //sizeof(PdfValueType)
+    uint32_t patternsVersion;
+  };
+
+  enum RecordType : uint32_t { EVENT = 1, PROCESSOR = 2, PROC_DATA = 3, HIT = 4, ALGO_MUON = 5, CAND_MUON = 6 };
+
+  struct RecordHeader {
+    uint32_t type;
+    uint32_t size;
+  };
+
+  struct EventRecord {
+    uint32_t iEvent;
+    uint32_t iBx;
+  };
+
+  struct ProcessorRecord {
+    uint32_t iProcessor;
+    int32_t endcap;  //-1, +1, or 0 for the barrel
+  };
+
+  struct HitRecord {
+    uint32_t iLayer;
+    uint32_t iInput;
+    int32_t iPhi;
+    uint32_t iEta;
+  };
+
+  struct AlgoMuonRecord {
+    PdfValueType disc;
+    PdfValueType pdfSum;
+    PdfValueType pdfSumUpt;
+    int32_t charge;
+    uint32_t etaCode;
+    uint32_t iRefHit;
+    int32_t iRefLayer;
+    uint32_t firedLayerBits;
+    int32_t nHits;
+    uint32_t patNum;
+    int32_t phiCode;
+    int32_t phiRHit;
+    int32_t ptCode;
+  };
+
+  struct CandMuonRecord {
+    int32_t hwEta;
+    int32_t hwPhi;
+    int32_t hwPt;
+    int32_t hwQual;
+    int32_t hwSign;
+    int32_t hwSignValid;
+    int32_t hwTrackAddress;
+    int32_t link;
+    int32_t processor;
+    int32_t trackFinderType;
+  };
+
+  BinaryEventWriter(const OMTFConfiguration* aOMTFConfig, std::string fName);
+
+  ~BinaryEventWriter() override;
+
+  void observeProcesorBegin(unsigned int iProcessor, l1t::tftype mtfType) override;
+
+  void addProcesorData(std::string key, boost::property_tree::ptree& procDataTree) override;
+
+  void observeProcesorEmulation(unsigned int iProcessor,
+                                l1t::tftype mtfType,
+                                const std::shared_ptr<OMTFinput>& input,
+                                const AlgoMuons& algoCandidates,
+                                const AlgoMuons& gbCandidates,
+                                const std::vector<l1t::RegionalMuonCand>& candMuons) override;
+
+  void observeEventBegin(const edm::Event& iEvent) override;
+
+  void endJob() override;
+
+  ///reads the file written by the BinaryEventWriter into the tree with the same layout as the one written
+  ///by the XMLEventWriter, throws cms::Exception if the file is not valid
+  static void readToTree(const std::string& fileName, boost::property_tree::ptree& tree);
+
+private:
+  template <class Record>
+  static void appendRecord(std::vector<char>& buffer, RecordType type, const Record& record) {
+    RecordHeader recordHeader{type, sizeof(Record)};
+    append(buffer, recordHeader);
+    append(buffer, record);
+  }
+
+  template <class T>
+  static void append(std::vector<char>& buffer, const T& value) {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+  }
+
+  static void appendString(std::vector<char>& buffer, const std::string& str);
+
+  ///the key, the data and recursively the children of the tree
+  static void appendTree(std::vector<char>& buffer, const std::string& key, const boost::property_tree::ptree& tree);
+
+  ///writes the buffer to the file if it is bigger than the flushSize, or always if force is true
+  void flush(bool force);
+
+  static const std::size_t flushSize = 1 << 20;
+
+  const OMTFConfiguration* omtfConfig;
+
+  std::string fName;
+
+  std::ofstream outFile;
+
+  std::vector<char> buffer;
+
+  //the PROC_DATA records of the current processor, added to the buffer only if the processor has candidates
+  std::vector<char> procDataBuffer;
+};
+
+#endif /* L1T_OmtfP1_BINARYEVENTWRITER_H_ */
@@ -0,0 +1,39 @@
+/*
+ * BinaryFileHeader.h
+ *
+ *      Beginning of all binary files of the OMTF emulator
+ */
+
+#ifndef L1T_OmtfP1_BINARYFILEHEADER_H_
+#define L1T_OmtfP1_BINARYFILEHEADER_H_
+
+#include <cstdint>
+#include <string>
+
+/*
+ * The first member of the header of the GoldenPatternsBinaryFile, GoldenPatternsStatFile, BinaryEventWriter,
+ * OMTFinputSnapshotWriter and ExtrapolFactorsTable files: the magic identifying the type of the file,
+ * the version of its layout and the byteOrderMark.
+ * The files are written in the native byte order, the byteOrderMark read on a machine with the other
+ * byte order is different than the nativeByteOrderMark, so such file is rejected.
+ */
+struct BinaryFileHeader {
+  typedef char Magic[8];
+
+  static const uint32_t nativeByteOrderMark = 0x01020304;
+
+  Magic magic;
+  uint32_t version;
+  uint32_t byteOrderMark;
+
+  ///the header of the file with the given magic and version
+  static BinaryFileHeader make(const Magic& magic, uint32_t version);
+
+  ///empty if the header has the given magic and version and the native byte order, otherwise the description of the error
+  std::string check(const Magic& magic, uint32_t version) const;
+
+  ///true if the file starts with the magic
+  static bool fileStartsWith(const std::string& fileName, const Magic& magic);
+};
+
+#endif /* L1T_OmtfP1_BINARYFILEHEADER_H_ */
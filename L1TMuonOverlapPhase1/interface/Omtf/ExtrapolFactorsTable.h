@@ -0,0 +1,102 @@
+/*
+ * ExtrapolFactorsTable.h
+ *
+ *      Fixed point factors of the DT phiB extrapolation, see OMTFProcessor::extrapolateDtPhiBFP
+ */
+
+#ifndef L1T_OmtfP1_EXTRAPOLFACTORSTABLE_H_
+#define L1T_OmtfP1_EXTRAPOLFACTORSTABLE_H_
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/BinaryFileHeader.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * The factors [refLayer][targetLayer][key] of the ExtrapolationFactors XML (written by the
+ * OMTFProcessor::saveExtrapolFactors) in one dense array, the key is the stub quality, the eta2Bits of the stub eta,
+ * or 0, depending on the target layer. The factors not present in the XML are 0.
+ * The extrapolated phi is factor * refPhiB / multiplier, as in the firmware, the multiplier is a power of 2 (128),
+ * then the division is done with the shift (rounding towards 0 as the integer division).
+ *
+ * The binary file layout (native byte order, see the BinaryFileHeader):
+ * Header, then int32_t factors[nRefLayers][nLayers][nKeys]
+ * The binary file is recognised by the magic, so it can be given instead of the XML, see the omtfExtrapolFactorsConverter.
+ */
+class ExtrapolFactorsTable {
+public:
+  static constexpr BinaryFileHeader::Magic magic = {'O', 'M', 'T', 'F', 'E', 'X', 'F', '\0'};
+
+  //to be incremented if the layout is changed
+  static const uint32_t version = 1;
+
+  ///the default of the extrapolFactorsFile parameter (FileInPath)
+  static constexpr const char* defaultFile =
+      "L1Trigger/L1TMuon/data/omtf_config/ExtrapolationFactors_ExtraplMB1nadMB2DTQual_ValueP1Scale_t20.xml";
+
+  //the limits of the sizes of the table, the files with larger ref layers, layers or keys are rejected;
+  //the key is at most the 9 bits of the OMTFConfiguration::eta2Bits
+  static const unsigned int maxRefLayers = 2;
+  static const unsigned int maxLayers = 32;
+  static const unsigned int maxKeys = 1 << 9;
+
+  struct Header {
+    BinaryFileHeader fileType;
+    int32_t multiplier;
+    uint32_t nRefLayers;
+    uint32_t nLayers;
+    uint32_t nKeys;
+  };
+
+  ///reads the XML or the binary file (if it starts with the magic), throws cms::Exception if the file is not valid
+  void read(const std::string& fileName);
+
+  void readXml(const std::string& fileName);
+
+  void readBinary(const std::string& fileName);
+
+  void writeBinary(const std::string& fileName) const;
+
+  static bool isBinaryFile(const std::string& fileName) { return BinaryFileHeader::fileStartsWith(fileName, magic); }
+
+  ///0 if the factor was not given in the file
+  int factor(unsigned int iRefLayer, unsigned int iLayer, unsigned int key) const {
+    if (iRefLayer >= nRefLayers || iLayer >= nLayers || key >= nKeys)
+      return 0;
+    return factors[(iRefLayer * nLayers + iLayer) * nKeys + key];
+  }
+
+  ///factor * refPhiB / multiplier
+  int extrapolate(unsigned int iRefLayer, unsigned int iLayer, unsigned int key, int refPhiB) const {
+    int product = factor(iRefLayer, iLayer, key) * refPhiB;
+    if (multiplierShift < 0)
+      return product / multiplier;
+    return product >= 0 ? (product >> multiplierShift) : -((-product) >> multiplierShift);
+  }
+
+  int getMultiplier() const { return multiplier; }
+
+  unsigned int getNRefLayers() const { return nRefLayers; }
+  unsigned int getNLayers() const { return nLayers; }
+  unsigned int getNKeys() const { return nKeys; }
+
+  bool empty() const { return factors.empty(); }
+
+private:
+  ///sets the sizes and the multiplier, the factors are set to 0, throws cms::Exception if the sizes exceed the limits
+  void init(int multiplier, unsigned int nRefLayers, unsigned int nLayers, unsigned int nKeys);
+
+  int multiplier = 128;
+
+  ///log2 of the multiplier, -1 if it is not a power of 2
+  int multiplierShift = 7;
+
+  unsigned int nRefLayers = 0;
+  unsigned int nLayers = 0;
+  unsigned int nKeys = 0;
+
+  std::vector<int32_t> factors;
+};
+
+#endif /* L1T_OmtfP1_EXTRAPOLFACTORSTABLE_H_ */
@@ -7,6 +7,7 @@
 #include <vector>
 #include <ostream>
 
+#include <array>
 #include <map>
 #include <set>
 
@@ -20,6 +21,26 @@ public:
   GhostBuster(const OMTFConfiguration* omtfConfig) : omtfConfig(omtfConfig){};
 
   ~GhostBuster() override{};
+
+  ///the candidates are taken in the order of decreasing goodness, a candidate is rejected if its phi is closer
+  ///than gmtPhiVetoWindow to any already selected one; at most maxSelectedCands are selected
   AlgoMuons select(AlgoMuons refHitCands, int charge = 0) override;
+
+  void select(std::vector<AlgoMuon>& refHitCands, std::vector<AlgoMuon>& selectedCands, int charge = 0) override;
+
+  static const unsigned int maxSelectedCands = 3;
+
+  ///maximal number of candidates given to the select, i.e. the number of refHits
+  static const unsigned int maxCands = 128;
+
+  ///veto window 5 degree in GMT scale is 5/360*576=8 units
+  static const int gmtPhiVetoWindow = 8;
+
+private:
+  ///the selection common for both select(), the cands must be already sorted with the decreasing goodness,
+  ///returns the number of the selected candidates, selected[i] is the index of the selected candidate in the cands
+  unsigned int selectSorted(const AlgoMuon* const* cands,
+                            unsigned int nCands,
+                            std::array<unsigned int, maxSelectedCands>& selected) const;
 };
 #endif
@@ -4,6 +4,8 @@
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/AlgoMuon.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/IGhostBuster.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include <array>
+#include <functional>
 #include <vector>
 #include <ostream>
 
@@ -13,14 +15,45 @@
 #include <memory>
 
 class GhostBusterPreferRefDt : public IGhostBuster {
+public:
+  ///returns true if the candidate a is worse than b
+  typedef bool (*CompareFunction)(const OMTFConfiguration* omtfConfig, const AlgoMuon* a, const AlgoMuon* b);
+
 private:
   const OMTFConfiguration* omtfConfig;
 
+  ///selected in the constructor according to the omtfConfig->getGhostBusterType()
+  CompareFunction compare = nullptr;
+
 public:
-  GhostBusterPreferRefDt(const OMTFConfiguration* omtfConfig) : omtfConfig(omtfConfig){};
+  GhostBusterPreferRefDt(const OMTFConfiguration* omtfConfig);
 
   ~GhostBusterPreferRefDt() override{};
 
   AlgoMuons select(AlgoMuons refHitCands, int charge = 0) override;
+
+  void select(std::vector<AlgoMuon>& refHitCands, std::vector<AlgoMuon>& selectedCands, int charge = 0) override;
+
+  ///candidates closer in phi than gmtPhiVetoWindow are ghosts, 5 degree in GMT scale is 5/360*576=8 units
+  static const int gmtPhiVetoWindow = 8;
+
+  static const unsigned int maxSelectedCands = 3;
+
+  ///maximal number of candidates given to the select, i.e. the number of refHits
+  static const unsigned int maxCands = 128;
+
+private:
+  struct SelectedCand {
+    unsigned int iMu = 0;
+    int fixedEta = 0;
+  };
+
+  ///the ghost busting common for both select(), the muonsIN must be already sorted with the compare (the best first),
+  ///the killed muons are marked with the AlgoMuon::kill() and the onKill(iMu1, iMu2) is called (if not empty)
+  ///for every muon iMu2 killed by the iMu1; returns the number of the selected muons
+  unsigned int selectSorted(AlgoMuon* const* muonsIN,
+                            unsigned int nMuons,
+                            const std::function<void(unsigned int, unsigned int)>& onKill,
+                            std::array<SelectedCand, maxSelectedCands>& selected) const;
 };
 #endif
@@ -45,7 +45,12 @@ public:
 
   virtual void setPdf(pdfArrayType& aPdf) { pdfAllRef = aPdf; }
 
-  int meanDistPhiValue(unsigned int iLayer, unsigned int iRefLayer, int refLayerPhiB = 0) const override;
+  //defined here, so that it can be inlined in the GoldenPatternKernel
+  int meanDistPhiValue(unsigned int iLayer, unsigned int iRefLayer, int refLayerPhiB = 0) const override {
+    //assumes that the meanDistPhi[1] is float alpha from the fit to the phiB-phi distribution multiplied by 2^myOmtfConfig->nPdfAddrBits()
+    return (((meanDistPhi[iLayer][iRefLayer][1] * refLayerPhiB) >> myOmtfConfig->nPdfAddrBits()) +
+            meanDistPhi[iLayer][iRefLayer][0]);
+  }
 
   PdfValueType pdfValue(unsigned int iLayer,
                         unsigned int iRefLayer,
@@ -0,0 +1,83 @@
+#ifndef L1T_OmtfP1_GOLDENPATTERNBANK_H_
+#define L1T_OmtfP1_GOLDENPATTERNBANK_H_
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/MuonStub.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessingContext.h"
+
+#include <vector>
+
+/*
+ * Copy of the meanDistPhi, distPhiBitShift and pdf of all GoldenPatterns in the structure-of-arrays layout,
+ * the pdf is kept as [refLayer][layer][pdfBin][pattern], the other arrays as [refLayer][layer][pattern].
+ * The pattern index is the fastest, so a stub is evaluated with all patterns at once
+ * (with the AVX2 instructions if the code is compiled with them, including the gather of the pdf values),
+ * giving exactly the same StubResult
+ * as the GoldenPatternBase::process1Layer1RefLayer called for every pattern separately.
+ * The bank is a snapshot, it must be rebuilt if the patterns are modified.
+ */
+class GoldenPatternBank {
+public:
+  //the stack buffers in process1Layer1RefLayer are allocated for that many patterns
+  static const unsigned int maxPatterns = 256;
+
+  GoldenPatternBank(const OMTFConfiguration* omtfConfig, const GoldenPatternVec<GoldenPattern>& gps);
+
+  unsigned int nPatterns() const { return patternsCnt; }
+
+  ///the equivalent of the GoldenPatternBase::process1Layer1RefLayer for all patterns,
+  ///the StubResult of the pattern iGP is stored in context.getResults(iGP)[procIndx][iRefHit]; empty patterns are skipped
+  void process1Layer1RefLayer(OMTFProcessingContext& context,
+                              unsigned int procIndx,
+                              unsigned int iRefHit,
+                              unsigned int iRefLayer,
+                              unsigned int iLayer,
+                              const MuonStubPtrsView& layerStubs,
+                              const std::vector<int>& extrapolatedPhi,
+                              const MuonStubPtr& refStub) const;
+
+private:
+  ///updates phiDistMin and selectedStub of all patterns with the stub iStub, phiDistBase = hitPhi - extrapolatedPhi - phiRefHit
+  void processStub(int phiDistBase,
+                   int iStub,
+                   unsigned int offset,
+                   const int* phiMean,
+                   int* phiDistMin,
+                   int* selectedStub) const;
+
+  ///reads the pdf values of all patterns for the selected stubs (with the AVX2 gather if available),
+  ///pdfVals is 0 for the patterns without stub (or the no-hit value from the bin 0) and with the phiDist outside the pdf
+  void lookUpPdfValues(unsigned int pdfOffset,
+                       const int* phiDistMin,
+                       const int* selectedStub,
+                       PdfValueType* pdfVals) const;
+
+  const OMTFConfiguration* omtfConfig;
+
+  unsigned int patternsCnt = 0;
+
+  ///patternsCnt rounded up to the multiple of the SIMD width, the padding patterns are empty
+  unsigned int patternsCntPadded = 0;
+
+  unsigned int nLayers = 0;
+
+  unsigned int nPdfBins = 0;
+
+  int nPdfAddrBits = 0;
+
+  int nPhiBins = 0;
+
+  ///[refLayer][layer][pattern]
+  std::vector<int> meanDistPhi0;
+  std::vector<int> meanDistPhi1;
+  std::vector<int> distPhiBitShift;
+
+  ///[refLayer][layer][pdfBin][pattern]
+  std::vector<PdfValueType> pdf;
+
+  ///[pattern], true for the patterns with thePt == 0 (and for the padding)
+  std::vector<bool> emptyPattern;
+};
+
+#endif /* L1T_OmtfP1_GOLDENPATTERNBANK_H_ */
@@ -101,9 +101,9 @@ public:
   ///Method should be thread safe
   virtual StubResult process1Layer1RefLayer(unsigned int iRefLayer,
                                             unsigned int iLayer,
-                                            MuonStubPtrs1D layerStubs,
+                                            const MuonStubPtrsView& layerStubs,
                                             const std::vector<int>& extrapolatedPhi,
-                                            const MuonStubPtr& refStub);
+                                            const MuonStubPtr& refStub) const;
 
   ///Propagate phi from given reference layer to MB2 or ME2
   ///ME2 is used if eta of reference hit is larger than 1.1
@@ -112,8 +112,14 @@ public:
 
   resultsArrayType& getResults() { return results; }
 
+  ///resizes the results to [processorCnt][nTestRefHits] and initialises them with the omtfConfig
+  static void initResults(resultsArrayType& results, const OMTFConfiguration* omtfConfig);
+
   ///last step of the event processing, before sorting and ghost busting
-  virtual void finalise(unsigned int procIndx);
+  virtual void finalise(unsigned int procIndx) { finalise(results, procIndx); }
+
+  ///as above, but for the results kept outside of the pattern, e.g. in the OMTFProcessingContext
+  virtual void finalise(resultsArrayType& gpResults, unsigned int procIndx) const;
 
 protected:
   ///Pattern kinematic identification (iEta,iPt,iCharge)
@@ -0,0 +1,147 @@
+/*
+ * GoldenPatternKernel.h
+ *
+ *      The GoldenPatternBase::process1Layer1RefLayer with the pattern type resolved at compile time
+ */
+
+#ifndef L1T_OmtfP1_GOLDENPATTERNKERNEL_H_
+#define L1T_OmtfP1_GOLDENPATTERNKERNEL_H_
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/MuonStub.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/StubResult.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternBase.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+
+#include <cstdlib>
+#include <type_traits>
+#include <vector>
+
+/*
+ * The GoldenPatternBase::process1Layer1RefLayer calls the virtual meanDistPhiValue, pdfValue and getDistPhiBitShift
+ * of the pattern for every stub. Here the GoldenPatternType is the template parameter and these methods (and the
+ * OMTFConfiguration ones) are called with the qualified names, i.e. not virtually, so the whole stubs loop is inlined.
+ * With the GoldenPatternType = GoldenPatternBase the calls remain virtual, this is the implementation
+ * of the GoldenPatternBase::process1Layer1RefLayer, so both give the same results by construction.
+ * The kernel is correct only for the patterns which dynamic type is exactly the GoldenPatternType,
+ * the OMTFProcessor checks it before selecting the kernel.
+ * The finalise variant resolved at compile time is the GoldenPatternResult::finaliseResults.
+ */
+template <class GoldenPatternType>
+class GoldenPatternKernel {
+public:
+  typedef StubResult (*Process1Layer1RefLayer)(const GoldenPatternType& gp,
+                                               unsigned int iRefLayer,
+                                               unsigned int iLayer,
+                                               const MuonStubPtrsView& layerStubs,
+                                               const std::vector<int>& extrapolatedPhi,
+                                               const MuonStubPtr& refStub);
+
+  static constexpr bool isVirtual = std::is_same<GoldenPatternType, GoldenPatternBase>::value;
+
+  static int meanDistPhiValue(const GoldenPatternType& gp, unsigned int iLayer, unsigned int iRefLayer, int refPhiB) {
+    if constexpr (isVirtual)
+      return gp.meanDistPhiValue(iLayer, iRefLayer, refPhiB);
+    else
+      return gp.GoldenPatternType::meanDistPhiValue(iLayer, iRefLayer, refPhiB);
+  }
+
+  static PdfValueType pdfValue(const GoldenPatternType& gp, unsigned int iLayer, unsigned int iRefLayer, int iBin) {
+    if constexpr (isVirtual)
+      return gp.pdfValue(iLayer, iRefLayer, iBin);
+    else
+      return gp.GoldenPatternType::pdfValue(iLayer, iRefLayer, iBin);
+  }
+
+  static int getDistPhiBitShift(const GoldenPatternType& gp, unsigned int iLayer, unsigned int iRefLayer) {
+    if constexpr (isVirtual)
+      return gp.getDistPhiBitShift(iLayer, iRefLayer);
+    else
+      return gp.GoldenPatternType::getDistPhiBitShift(iLayer, iRefLayer);
+  }
+
+  ///Process single measurement layer with a single ref layer, see GoldenPatternBase::process1Layer1RefLayer
+  static StubResult process1Layer1RefLayer(const GoldenPatternType& gp,
+                                           unsigned int iRefLayer,
+                                           unsigned int iLayer,
+                                           const MuonStubPtrsView& layerStubs,
+                                           const std::vector<int>& extrapolatedPhi,
+                                           const MuonStubPtr& refStub) {
+    const OMTFConfiguration* omtfConfig = gp.getConfig();
+
+    const int nPhiBins = omtfConfig->OMTFConfiguration::nPhiBins();
+    const int nPdfAddrBits = omtfConfig->nPdfAddrBits();
+    const bool bendingLayer = omtfConfig->OMTFConfiguration::isBendingLayer(iLayer);
+    const int distPhiBitShift = getDistPhiBitShift(gp, iLayer, iRefLayer);
+
+    int phiMean = meanDistPhiValue(gp, iLayer, iRefLayer, refStub->phiBHw);
+    int phiDistMin = nPhiBins;  //"infinite" value for the beginning
+
+    ///Select hit closest to the mean of probability
+    ///distribution in given layer
+    const MuonStubPtr* selectedStub = nullptr;
+
+    //phi ref hit for the bending layer set to 0, since it should not be included in the phiDist
+    int phiRefHit = (refStub && !bendingLayer) ? refStub->phiHw : 0;
+
+    for (unsigned int iStub = 0; iStub < layerStubs.size(); iStub++) {
+      auto& stub = layerStubs[iStub];
+      if (!stub)  //empty pointer
+        continue;
+
+      //rejecting phiB of the low quality DT stubs is done in the OMTFInputMaker
+      int hitPhi = bendingLayer ? stub->phiBHw : stub->phiHw;
+
+      if (hitPhi >= nPhiBins)
+        continue;
+
+      int phiDist = omtfConfig->OMTFConfiguration::foldPhi(hitPhi - extrapolatedPhi[iStub] - phiMean - phiRefHit);
+
+      //firmware works on the sign-value, shift must be done on abs(phiDist)
+      int sign = phiDist < 0 ? -1 : 1;
+      phiDist = std::abs(phiDist) >> distPhiBitShift;
+      phiDist *= sign;
+
+      if (std::abs(phiDist) < std::abs(phiDistMin)) {
+        phiDistMin = phiDist;
+        selectedStub = &stub;
+      }
+    }
+
+    if (!selectedStub) {
+      if (omtfConfig->isNoHitValueInPdf()) {
+        PdfValueType pdfVal = pdfValue(gp, iLayer, iRefLayer, 0);
+        return StubResult(pdfVal, false, nPhiBins, iLayer, MuonStubPtr());
+      } else {
+        return StubResult(0, false, nPhiBins, iLayer, MuonStubPtr());  //2018 version
+      }
+    }
+
+    int pdfMiddle = 1 << (nPdfAddrBits - 1);
+
+    ///Check if phiDistMin is within pdf range -63 +63
+    ///in firmware here the arithmetic "value and sign" is used, therefore the range is -63 +63, and not -64 +63
+    if (std::abs(phiDistMin) > pdfMiddle - 1) {
+      return StubResult(0, false, phiDistMin + pdfMiddle, iLayer, *selectedStub);
+    }
+
+    ///Shift phidist, so 0 is at the middle of the range
+    phiDistMin += pdfMiddle;
+    PdfValueType pdfVal = pdfValue(gp, iLayer, iRefLayer, phiDistMin);
+    if (pdfVal <= 0) {
+      return StubResult(0, false, phiDistMin, iLayer, *selectedStub);
+    }
+    return StubResult(pdfVal, true, phiDistMin, iLayer, *selectedStub);
+  }
+
+  ///calls the virtual GoldenPatternBase::process1Layer1RefLayer, for the patterns of the type different than GoldenPatternType
+  static StubResult process1Layer1RefLayerVirtual(const GoldenPatternType& gp,
+                                                  unsigned int iRefLayer,
+                                                  unsigned int iLayer,
+                                                  const MuonStubPtrsView& layerStubs,
+                                                  const std::vector<int>& extrapolatedPhi,
+                                                  const MuonStubPtr& refStub) {
+    return gp.process1Layer1RefLayer(iRefLayer, iLayer, layerStubs, extrapolatedPhi, refStub);
+  }
+};
+
+#endif /* L1T_OmtfP1_GOLDENPATTERNKERNEL_H_ */
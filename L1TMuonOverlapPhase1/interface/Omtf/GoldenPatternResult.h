@@ -130,6 +130,17 @@ public:
   void finalise10();
   //bool empty() const;
 
+  typedef void (*FinaliseResults)(GoldenPatternResult* results, unsigned int count);
+
+  ///calls finaliseX (X = finalizeFunction) for results[0 ... count-1], the X is resolved at compile time,
+  ///so the finalise std::function of each result is not used
+  template <int finalizeFunction>
+  static void finaliseResults(GoldenPatternResult* results, unsigned int count);
+
+  ///the finaliseResults instantiation for the given finalizeFunction (selected as in the init()),
+  ///the instantiations exist only in the GoldenPatternResult.cc, so they must be obtained with this method
+  static FinaliseResults getFinaliseResults(int finalizeFunction);
+
   friend std::ostream& operator<<(std::ostream& out, const GoldenPatternResult& aResult);
 
   double getGpProbability1() const { return gpProbability1; }
@@ -0,0 +1,190 @@
+/*
+ * GoldenPatternStatistics.h
+ *
+ *      Storage of the GoldenPatternWithStat statistics, dense or sparse
+ */
+
+#ifndef L1T_OmtfP1_GOLDENPATTERNSTATISTICS_H_
+#define L1T_OmtfP1_GOLDENPATTERNSTATISTICS_H_
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+/*
+ * The statistics [iLayer][iRefLayer][iBin1][iBin2] (iBin1 is the phiDist bin, iBin2 is the phiB bin in the 2DHists mode,
+ * or 0), accessed like the boost::multi_array<int, 4> used before, i.e. statistics[iLayer][iRefLayer][iBin1][iBin2]
+ * and the size() of each level, but read only - the counts are added with the add().
+ *
+ * Storage::dense - one contiguous array, as the multi_array.
+ * Storage::sparse - the [iBin1][iBin2] plane of each (iLayer, iRefLayer) is divided into tiles of tileSize x tileSize
+ * bins (or less if the extent is smaller), a tile is allocated when the first count is added to it, the bins of the
+ * not allocated tiles are 0. In the 2DHists mode (1024 x 1024 bins) the dense storage needs 4 MB per
+ * (iLayer, iRefLayer) for each pattern, while the muons of a given pattern fill only a narrow band of the phiDist vs phiB,
+ * so most of the tiles are never allocated.
+ * The values read are the same for both storages.
+ */
+class GoldenPatternStatistics {
+public:
+  typedef int ValueType;
+
+  enum class Storage { dense, sparse };
+
+  static constexpr unsigned int tileSize = 64;
+
+  class BinView {
+  public:
+    BinView(const GoldenPatternStatistics& stat, unsigned int iLayer, unsigned int iRefLayer, unsigned int iBin1)
+        : stat(stat), iLayer(iLayer), iRefLayer(iRefLayer), iBin1(iBin1) {}
+
+    unsigned int size() const { return stat.extents[3]; }
+
+    ValueType operator[](unsigned int iBin2) const { return stat.get(iLayer, iRefLayer, iBin1, iBin2); }
+
+  private:
+    const GoldenPatternStatistics& stat;
+    unsigned int iLayer, iRefLayer, iBin1;
+  };
+
+  class RefLayerView {
+  public:
+    RefLayerView(const GoldenPatternStatistics& stat, unsigned int iLayer, unsigned int iRefLayer)
+        : stat(stat), iLayer(iLayer), iRefLayer(iRefLayer) {}
+
+    unsigned int size() const { return stat.extents[2]; }
+
+    BinView operator[](unsigned int iBin1) const { return BinView(stat, iLayer, iRefLayer, iBin1); }
+
+  private:
+    const GoldenPatternStatistics& stat;
+    unsigned int iLayer, iRefLayer;
+  };
+
+  class LayerView {
+  public:
+    LayerView(const GoldenPatternStatistics& stat, unsigned int iLayer) : stat(stat), iLayer(iLayer) {}
+
+    unsigned int size() const { return stat.extents[1]; }
+
+    RefLayerView operator[](unsigned int iRefLayer) const { return RefLayerView(stat, iLayer, iRefLayer); }
+
+  private:
+    const GoldenPatternStatistics& stat;
+    unsigned int iLayer;
+  };
+
+  GoldenPatternStatistics() {}
+
+  GoldenPatternStatistics(unsigned int nLayers,
+                          unsigned int nRefLayers,
+                          unsigned int nBins1,
+                          unsigned int nBins2,
+                          Storage storage = Storage::dense) {
+    resize(nLayers, nRefLayers, nBins1, nBins2, storage);
+  }
+
+  ///sets the extents and the storage, all counts are set to 0
+  void resize(unsigned int nLayers, unsigned int nRefLayers, unsigned int nBins1, unsigned int nBins2, Storage storage);
+
+  ValueType get(unsigned int iLayer, unsigned int iRefLayer, unsigned int iBin1, unsigned int iBin2) const {
+    if (storage == Storage::dense)
+      return denseValues[denseIndex(iLayer, iRefLayer, iBin1, iBin2)];
+
+    const std::vector<ValueType>& tile = tiles[tileIndex(iLayer, iRefLayer, iBin1, iBin2)];
+    if (tile.empty())
+      return 0;
+    return tile[inTileIndex(iBin1, iBin2)];
+  }
+
+  ///value is double for the compatibility with the GoldenPatternWithStat::updateStat, the sum is truncated to the ValueType,
+  ///adding 0 does nothing, i.e. does not allocate a tile
+  void add(unsigned int iLayer, unsigned int iRefLayer, unsigned int iBin1, unsigned int iBin2, double value) {
+    if (value == 0)
+      return;
+
+    if (storage == Storage::dense) {
+      ValueType& bin = denseValues[denseIndex(iLayer, iRefLayer, iBin1, iBin2)];
+      bin += value;
+      return;
+    }
+
+    std::vector<ValueType>& tile = tiles[tileIndex(iLayer, iRefLayer, iBin1, iBin2)];
+    if (tile.empty())
+      tile.resize(tileSize1 * tileSize2, 0);
+    tile[inTileIndex(iBin1, iBin2)] += value;
+  }
+
+  ///calls function(iLayer, iRefLayer, iBin1, iBin2, value) for all bins with a non-zero value,
+  ///for the sparse storage only the allocated tiles are visited, so the order of the bins is not defined
+  template <typename Function>
+  void forEachNonZero(Function function) const {
+    if (storage == Storage::dense) {
+      std::size_t index = 0;
+      for (unsigned int iLayer = 0; iLayer < extents[0]; ++iLayer)
+        for (unsigned int iRefLayer = 0; iRefLayer < extents[1]; ++iRefLayer)
+          for (unsigned int iBin1 = 0; iBin1 < extents[2]; ++iBin1)
+            for (unsigned int iBin2 = 0; iBin2 < extents[3]; ++iBin2, ++index) {
+              if (denseValues[index] != 0)
+                function(iLayer, iRefLayer, iBin1, iBin2, denseValues[index]);
+            }
+      return;
+    }
+
+    std::size_t iTile = 0;
+    for (unsigned int iLayer = 0; iLayer < extents[0]; ++iLayer)
+      for (unsigned int iRefLayer = 0; iRefLayer < extents[1]; ++iRefLayer)
+        for (unsigned int iTile1 = 0; iTile1 < nTiles1; ++iTile1)
+          for (unsigned int iTile2 = 0; iTile2 < nTiles2; ++iTile2, ++iTile) {
+            const std::vector<ValueType>& tile = tiles[iTile];
+            for (unsigned int i = 0; i < tile.size(); ++i) {
+              if (tile[i] == 0)
+                continue;
+              //the last tiles are not full if the extents are not multiples of the tile size
+              unsigned int iBin1 = iTile1 * tileSize1 + i / tileSize2;
+              unsigned int iBin2 = iTile2 * tileSize2 + i % tileSize2;
+              function(iLayer, iRefLayer, iBin1, iBin2, tile[i]);
+            }
+          }
+  }
+
+  LayerView operator[](unsigned int iLayer) const { return LayerView(*this, iLayer); }
+
+  unsigned int size() const { return extents[0]; }
+
+  ///[nLayers, nRefLayers, nBins1, nBins2]
+  const std::array<unsigned int, 4>& shape() const { return extents; }
+
+  std::size_t num_elements() const { return (std::size_t)extents[0] * extents[1] * extents[2] * extents[3]; }
+
+  Storage getStorage() const { return storage; }
+
+  ///memory used by the counts, for the sparse storage only the allocated tiles
+  std::size_t allocatedBytes() const;
+
+private:
+  std::size_t denseIndex(unsigned int iLayer, unsigned int iRefLayer, unsigned int iBin1, unsigned int iBin2) const {
+    return ((std::size_t(iLayer) * extents[1] + iRefLayer) * extents[2] + iBin1) * extents[3] + iBin2;
+  }
+
+  std::size_t tileIndex(unsigned int iLayer, unsigned int iRefLayer, unsigned int iBin1, unsigned int iBin2) const {
+    return ((std::size_t(iLayer) * extents[1] + iRefLayer) * nTiles1 + iBin1 / tileSize1) * nTiles2 + iBin2 / tileSize2;
+  }
+
+  unsigned int inTileIndex(unsigned int iBin1, unsigned int iBin2) const {
+    return (iBin1 % tileSize1) * tileSize2 + iBin2 % tileSize2;
+  }
+
+  std::array<unsigned int, 4> extents = {{0, 0, 0, 0}};
+
+  Storage storage = Storage::dense;
+
+  std::vector<ValueType> denseValues;
+
+  unsigned int tileSize1 = 1, tileSize2 = 1;
+  unsigned int nTiles1 = 0, nTiles2 = 0;
+
+  //[iLayer][iRefLayer][iTile1][iTile2], empty if not allocated
+  std::vector<std::vector<ValueType> > tiles;
+};
+
+#endif /* L1T_OmtfP1_GOLDENPATTERNSTATISTICS_H_ */
@@ -2,6 +2,7 @@
 #define L1T_OmtfP1_GoldenPatternWithStat_H
 
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternStatistics.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinput.h"
 #include <vector>
 
@@ -14,7 +15,7 @@ class OMTFConfiguration;
 class GoldenPatternWithStat : public GoldenPatternWithThresh {
 public:
   static const unsigned int STAT_BINS = 1;  //TODO change value if needed
-  typedef boost::multi_array<int, 4> StatArrayType;
+  typedef GoldenPatternStatistics StatArrayType;
 
   GoldenPatternWithStat(const Key& aKey, unsigned int nLayers, unsigned int nRefLayers, unsigned int nPdfAddrBits);
 
@@ -30,8 +31,11 @@ public:
   friend class PatternOptimizerBase;
   friend class PatternGenerator;
 
-  void iniStatisitics(unsigned int pdfBinsCnt, unsigned int statBins) {
-    statistics.resize(boost::extents[pdfAllRef.size()][pdfAllRef[0].size()][pdfBinsCnt][statBins]);
+  ///the sparse storage should be used if the statBins is big (the 2DHists), see GoldenPatternStatistics
+  void iniStatisitics(unsigned int pdfBinsCnt,
+                      unsigned int statBins,
+                      StatArrayType::Storage storage = StatArrayType::Storage::dense) {
+    statistics.resize(pdfAllRef.size(), pdfAllRef[0].size(), pdfBinsCnt, statBins, storage);
   }
 
   const StatArrayType& getStatistics() const { return statistics; }
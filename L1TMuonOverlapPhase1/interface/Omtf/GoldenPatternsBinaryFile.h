@@ -0,0 +1,139 @@
+/*
+ * GoldenPatternsBinaryFile.h
+ *
+ *      Binary, memory mapped, alternative to the patterns XML files
+ */
+
+#ifndef L1T_OmtfP1_GOLDENPATTERNSBINARYFILE_H_
+#define L1T_OmtfP1_GOLDENPATTERNSBINARYFILE_H_
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/BinaryFileHeader.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternBase.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class L1TMuonOverlapParams;
+
+/*
+ * The file layout (native byte order, see the BinaryFileHeader):
+ * Header, then at the offsets given in the header, each aligned to 64 bytes:
+ * KeyRecord      keys[nPatterns]
+ * PdfValueType   thresholds[nPatterns][nRefLayers]                  (only if hasThresholds)
+ * int16_t        meanDistPhi[nPatterns][nLayers][nRefLayers][2]
+ * int16_t        distPhiBitShift[nPatterns][nLayers][nRefLayers]
+ * PdfValueType   pdf[nPatterns][nLayers][nRefLayers][1 << nPdfAddrBits]
+ * The file is mmap-ed and the arrays are accessed in place by the accessors below, without any text parsing,
+ * but the buildPatterns copies the values element by element into the GoldenPatterns.
+ * The patterns with thePt = 0 (empty) are stored as well, so the file can replace the XML also in the XMLConfigReader::readLUTs.
+ * The XMLConfigReader::readPatterns reads the binary file if it starts with the magic, so the binary file can be given
+ * in the patternsXMLFile(s) parameter instead of the XML.
+ */
+class GoldenPatternsBinaryFile {
+public:
+  static constexpr BinaryFileHeader::Magic magic = {'O', 'M', 'T', 'F', 'G', 'P', 'B', '\0'};
+
+  //to be incremented if the layout is changed
+  static const uint32_t version = 1;
+
+  struct Header {
+    BinaryFileHeader fileType;
+    uint32_t headerSize;  //sizeof(Header)
+    uint32_t pdfValueSize;  //sizeof(PdfValueType)
+
+    uint32_t nPatterns;
+    //number of the pattern groups (GP elements in the XML)
+    uint32_t nGroups;
+    uint32_t nLayers;
+    uint32_t nRefLayers;
+    uint32_t nPdfAddrBits;
+    uint32_t hasThresholds;
+
+    //hardware pt range covered by the non-empty patterns
+    uint32_t ptHwMin;
+    uint32_t ptHwMax;
+
+    uint64_t keysOffset;
+    uint64_t thresholdsOffset;
+    uint64_t meanDistPhiOffset;
+    uint64_t distPhiBitShiftOffset;
+    uint64_t pdfOffset;
+    uint64_t fileSize;
+  };
+
+  struct KeyRecord {
+    int32_t etaCode;
+    uint32_t pt;
+    int32_t charge;
+    uint32_t group;
+    uint32_t indexInGroup;
+  };
+
+  ///maps the file, throws cms::Exception if it is not a valid patterns file
+  explicit GoldenPatternsBinaryFile(const std::string& fileName);
+
+  ~GoldenPatternsBinaryFile();
+
+  GoldenPatternsBinaryFile(const GoldenPatternsBinaryFile&) = delete;
+  GoldenPatternsBinaryFile& operator=(const GoldenPatternsBinaryFile&) = delete;
+
+  ///true if the file starts with the magic, i.e. it is not an XML
+  static bool isBinaryFile(const std::string& fileName) { return BinaryFileHeader::fileStartsWith(fileName, magic); }
+
+  const Header& header() const { return *reinterpret_cast<const Header*>(data); }
+
+  const KeyRecord& key(unsigned int iGP) const { return array<KeyRecord>(header().keysOffset)[iGP]; }
+
+  ///[iRefLayer], nullptr if the file has no thresholds
+  const PdfValueType* thresholds(unsigned int iGP) const;
+
+  ///[iLayer][iRefLayer][2]
+  const int16_t* meanDistPhi(unsigned int iGP) const {
+    return array<int16_t>(header().meanDistPhiOffset) + iGP * header().nLayers * header().nRefLayers * 2;
+  }
+
+  ///[iLayer][iRefLayer]
+  const int16_t* distPhiBitShift(unsigned int iGP) const {
+    return array<int16_t>(header().distPhiBitShiftOffset) + iGP * header().nLayers * header().nRefLayers;
+  }
+
+  ///[iLayer][iRefLayer][iBin]
+  const PdfValueType* pdf(unsigned int iGP) const {
+    return array<PdfValueType>(header().pdfOffset) +
+           iGP * header().nLayers * header().nRefLayers * (1 << header().nPdfAddrBits);
+  }
+
+  /*
+   * builds the patterns in the same way as the XMLConfigReader::buildGP,
+   * the patterns are numbered starting from firstNumber, and the groups are shifted by the firstGroup
+   * throws if the nLayers, nRefLayers or nPdfAddrBits of the file are different than in the aConfig
+   */
+  template <class GoldenPatternType>
+  GoldenPatternVec<GoldenPatternType> buildPatterns(const L1TMuonOverlapParams& aConfig,
+                                                    bool buildEmptyPatterns,
+                                                    unsigned int firstNumber = 0,
+                                                    unsigned int firstGroup = 0) const;
+
+  ///the gps must be GoldenPatterns (or derived), as for the XMLConfigWriter::writeGPs,
+  ///the thresholds are written if the gps are GoldenPatternWithThresh with at least one non-zero threshold
+  template <class GoldenPatternType>
+  static void write(const GoldenPatternVec<GoldenPatternType>& gps,
+                    const OMTFConfiguration* omtfConfig,
+                    const std::string& fileName);
+
+private:
+  template <class T>
+  const T* array(uint64_t offset) const {
+    return reinterpret_cast<const T*>(data + offset);
+  }
+
+  std::string fileName;
+
+  const char* data = nullptr;
+
+  std::size_t size = 0;
+};
+
+#endif /* L1T_OmtfP1_GOLDENPATTERNSBINARYFILE_H_ */
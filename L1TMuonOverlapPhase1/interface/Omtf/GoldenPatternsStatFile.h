@@ -0,0 +1,91 @@
+/*
+ * GoldenPatternsStatFile.h
+ *
+ *      Partial statistics of the pattern generation, to be merged from many jobs
+ */
+
+#ifndef L1T_OmtfP1_GOLDENPATTERNSSTATFILE_H_
+#define L1T_OmtfP1_GOLDENPATTERNSSTATFILE_H_
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/BinaryFileHeader.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternWithStat.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/*
+ * The statistics of all patterns (GoldenPatternWithStat::statistics) and the number of events used for each pattern
+ * (PatternGenerator::eventCntPerGp), i.e. everything the PatternGenerator::upadatePdfs needs.
+ * The statistics are the integer counts, so the merged (added) statistics of the jobs processing the parts
+ * of a sample are exactly the same as the statistics of a single job processing the whole sample.
+ *
+ * Only the non-zero bins of the statistics are kept, as the BinCount with the index of the bin in the dense
+ * StatValueType[extents[0]][extents[1]][extents[2]][extents[3]], sorted by the index, both in the memory and in the file,
+ * as in the 2DHists mode (1024 x 1024 bins per layer and ref layer) the dense statistics would be GBs.
+ *
+ * The file layout (native byte order, see the BinaryFileHeader):
+ * Header, then for each pattern: PatternRecord, followed by the PatternRecord::nBins BinCounts.
+ */
+class GoldenPatternsStatFile {
+public:
+  static constexpr BinaryFileHeader::Magic magic = {'O', 'M', 'T', 'F', 'G', 'P', 'S', '\0'};
+
+  //to be incremented if the layout is changed
+  static const uint32_t version = 2;
+
+  typedef GoldenPatternWithStat::StatArrayType::ValueType StatValueType;
+
+  struct Header {
+    BinaryFileHeader fileType;
+    uint32_t statValueSize;  //sizeof(StatValueType)
+    uint32_t nPatterns;
+  };
+
+  struct PatternRecord {
+    uint32_t number;
+    uint32_t pt;
+    int32_t charge;
+    uint32_t eventCnt;
+    uint32_t extents[4];  //[iLayer][iRefLayer][iBin][what]
+    uint32_t nBins;       //number of the non-zero bins
+  };
+
+  struct BinCount {
+    uint32_t index;  //((iLayer * extents[1] + iRefLayer) * extents[2] + iBin) * extents[3] + what
+    StatValueType count;
+  };
+
+  struct PatternStat {
+    PatternRecord record;
+    std::vector<BinCount> statistics;  //the non-zero bins, sorted by the index
+  };
+
+  ///empty, the first add() takes the patterns of the added statistics
+  GoldenPatternsStatFile() {}
+
+  ///copies the statistics of the gps, eventCntPerGp[iGP] corresponds to gps[iGP]
+  GoldenPatternsStatFile(const GoldenPatternVec<GoldenPatternWithStat>& gps,
+                         const std::vector<unsigned int>& eventCntPerGp);
+
+  ///reads the file, throws cms::Exception if it is not a valid statistics file
+  explicit GoldenPatternsStatFile(const std::string& fileName);
+
+  void write(const std::string& fileName) const;
+
+  ///adds the statistics and eventCnt of the other,
+  ///throws cms::Exception if the patterns or the sizes of their statistics are different
+  void add(const GoldenPatternsStatFile& other);
+
+  ///adds the statistics to the gps and the eventCnt to the eventCntPerGp, the empty patterns (thePt == 0) are skipped.
+  ///If the extents of the statistics of a gp are different than in the file, the gp statistics are resized
+  ///(they should be empty then, i.e. as after the GoldenPatternWithStat::iniStatisitics), keeping their storage
+  void addTo(GoldenPatternVec<GoldenPatternWithStat>& gps, std::vector<unsigned int>& eventCntPerGp) const;
+
+  const std::vector<PatternStat>& getPatterns() const { return patterns; }
+
+private:
+  std::vector<PatternStat> patterns;
+};
+
+#endif /* L1T_OmtfP1_GOLDENPATTERNSSTATFILE_H_ */
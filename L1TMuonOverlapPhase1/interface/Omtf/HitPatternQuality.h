@@ -0,0 +1,88 @@
+/*
+ * HitPatternQuality.h
+ *
+ *      Quality of the OMTF candidates as a function of the fired layers (hit pattern) and eta, for a given fwVersion
+ */
+
+#ifndef L1T_OmtfP1_HITPATTERNQUALITY_H_
+#define L1T_OmtfP1_HITPATTERNQUALITY_H_
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <vector>
+
+namespace edm {
+  class ParameterSet;
+};
+
+/*
+ * The quality is given by the list of rules, a rule sets the quality of the candidates with one of its hit patterns
+ * (or with any hit pattern if the firedLayerBits is empty) and with the given |etaHw| (or with any eta),
+ * it is applied only for the fwVersion in [fwVersionMin, fwVersionMax].
+ * The rules are applied in the order, i.e. the later rule overwrites the quality set by the former ones.
+ * The rules of the configured fwVersion are compiled in the constructor into the tables
+ * [firedLayerBits] -> quality, one for the candidates with any eta and one for each |etaHw| appearing in the rules,
+ * so getting the quality of the candidate is a single lookup.
+ * The default rules (as in the firmware) can be extended with the hitPatternQualityRules from the python config,
+ * these rules are applied after the default ones, e.g.
+ * hitPatternQualityRules = cms.VPSet(
+ *   cms.PSet(fwVersionMin = cms.uint32(9), quality = cms.uint32(1), firedLayerBits = cms.vstring("000000110000000011") )
+ * )
+ * The firedLayerBits are given as the binary strings, the layer 0 is the rightmost bit.
+ */
+class HitPatternQuality {
+public:
+  static const int anyEta = -1;
+
+  struct Rule {
+    unsigned int fwVersionMin = 0;
+    unsigned int fwVersionMax = std::numeric_limits<unsigned int>::max();
+
+    //|etaHw| of the candidate, anyEta - the rule is applied for all eta
+    int absEtaHw = anyEta;
+
+    unsigned int quality = 0;
+
+    //empty - the rule is applied for all hit patterns
+    std::vector<unsigned int> firedLayerBits;
+  };
+
+  ///the hitPatternQualityRules from the edmCfg (if present) are applied after the default rules
+  HitPatternQuality(const OMTFConfiguration* omtfConfig, const edm::ParameterSet& edmCfg);
+
+  HitPatternQuality(const OMTFConfiguration* omtfConfig, const std::vector<Rule>& rules);
+
+  unsigned int getQuality(unsigned int firedLayerBits, int etaHw) const {
+    auto etaTable = etaTables.find(std::abs(etaHw));
+    if (etaTable != etaTables.end())
+      return etaTable->second[firedLayerBits];
+    return table[firedLayerBits];
+  }
+
+  ///the rules implemented in the firmware up to the fwVersion 8
+  static std::vector<Rule> defaultRules();
+
+  static std::vector<Rule> rulesFromParameterSet(const edm::ParameterSet& edmCfg);
+
+  ///the hit patterns giving the quality 4 (instead of 12) up to the fwVersion 6
+  static const std::vector<unsigned int>& invalidHitPatternsFw6();
+
+private:
+  void build(const std::vector<Rule>& rules);
+
+  const OMTFConfiguration* omtfConfig;
+
+  static const unsigned int defaultQuality = 12;
+
+  //[firedLayerBits]
+  std::vector<uint8_t> table;
+
+  //[|etaHw|][firedLayerBits]
+  std::map<int, std::vector<uint8_t> > etaTables;
+};
+
+#endif /* L1T_OmtfP1_HITPATTERNQUALITY_H_ */
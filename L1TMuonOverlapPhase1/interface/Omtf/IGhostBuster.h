@@ -10,11 +10,35 @@
 
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/AlgoMuon.h"
 
+#include <memory>
+#include <vector>
+
 class IGhostBuster {
 public:
   virtual ~IGhostBuster() {}
 
   virtual AlgoMuons select(AlgoMuons refHitCands, int charge = 0) = 0;
+
+  ///as above, but on the candidates kept by value (in the OMTFProcessingContext), so no shared_ptr is created:
+  ///the order of the refHitCands is not changed, the killed ones are marked with the AlgoMuon::kill()
+  ///(the getKilledMuons() is not filled), the selected candidates are assigned to the selectedCands.
+  ///The default implementation copies the candidates to the AlgoMuons and calls the select above
+  virtual void select(std::vector<AlgoMuon>& refHitCands, std::vector<AlgoMuon>& selectedCands, int charge = 0) {
+    AlgoMuons algoMuons;
+    for (auto& refHitCand : refHitCands)
+      algoMuons.emplace_back(std::make_shared<AlgoMuon>(refHitCand));
+
+    AlgoMuons selected = select(algoMuons, charge);
+
+    for (unsigned int iCand = 0; iCand < refHitCands.size(); iCand++) {
+      if (algoMuons[iCand]->isKilled())
+        refHitCands[iCand].kill();
+    }
+
+    selectedCands.clear();
+    for (auto& selectedCand : selected)
+      selectedCands.push_back(*selectedCand);
+  }
 };
 
 #endif /* L1T_OmtfP1_IGHOSTBUSTER_H_ */
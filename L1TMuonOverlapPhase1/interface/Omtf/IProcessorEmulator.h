@@ -12,6 +12,7 @@
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternResult.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/IOMTFEmulationObserver.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinput.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessingContext.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFSorter.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinputMaker.h"
 
@@ -43,6 +44,21 @@ public:
                                                  OMTFinputMaker* inputMaker,
                                                  std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) = 0;
 
+  ///as above, but the results of the golden patterns are kept in the context and not in the patterns,
+  ///so the run() can be called concurrently as long as every thread uses its own context and observers
+  virtual std::vector<l1t::RegionalMuonCand> run(OMTFProcessingContext& context,
+                                                 unsigned int iProcessor,
+                                                 l1t::tftype mtfType,
+                                                 int bx,
+                                                 OMTFinputMaker* inputMaker,
+                                                 std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) = 0;
+
+  ///creates a context with its own results, suitable for the patterns of this processor
+  virtual std::unique_ptr<OMTFProcessingContext> makeProcessingContext() const = 0;
+
+  ///true if the run() can be called concurrently for different processors (with separate observers vectors)
+  virtual bool canRunInParallel() const { return false; }
+
   virtual void printInfo() const = 0;
 };
 
@@ -1,6 +1,9 @@
 #ifndef L1T_OmtfP1_OMTFConfiguration_H
 #define L1T_OmtfP1_OMTFConfiguration_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <map>
 #include <set>
 #include <vector>
@@ -55,12 +58,21 @@ public:
   typedef std::vector<vector1D_pair> vector2D_pair;
   typedef std::vector<vector2D_pair> vector3D_pair;
 
+  ///inputs of the layer iLayer connected to the given processor and logic region,
+  ///for the bending layers the stubs are taken from the stubLayer = iLayer - 1
+  struct LayerInputs {
+    unsigned int stubLayer = 0;
+    unsigned int iFirstInput = 0;
+    //can be larger than the number of the inputs in the layer, see the OMTFConfiguration::configure
+    std::size_t nInputs = 0;
+  };
+
   typedef std::vector<int> vector1D;
   typedef std::vector<vector1D> vector2D;
   typedef std::vector<vector2D> vector3D;
   typedef std::vector<vector3D> vector4D;
 
-  OMTFConfiguration() { ; };
+  OMTFConfiguration() { resetLayerTables(); };
 
   virtual void configure(const L1TMuonOverlapParams* omtfParams);
 
@@ -117,6 +129,25 @@ public:
   const std::set<int>& getBendingLayers() const { return bendingLayers; }
   const std::vector<int>& getRefToLogicNumber() const { return refToLogicNumber; }
 
+  ///the hwNumber (as given by the getLayerNumber) is at most 2011 (CSC ME1/2)
+  static const unsigned int hwLayerNumbersCnt = 2048;
+
+  static const unsigned int maxLayers = 64;
+
+  ///array equivalents of the getHwToLogicLayer(), getLogicToHwLayer() and getLogicToLogic(),
+  ///return -1 if there is no mapping
+  int getLogicLayer(unsigned int hwNumber) const {
+    return hwNumber < hwLayerNumbersCnt ? hwToLogicLayerTable[hwNumber] : -1;
+  }
+
+  int getHwLayer(unsigned int iLogicLayer) const {
+    return iLogicLayer < maxLayers ? logicToHwLayerTable[iLogicLayer] : -1;
+  }
+
+  int getConnectedLayer(unsigned int iLogicLayer) const {
+    return iLogicLayer < maxLayers ? logicToLogicTable[iLogicLayer] : -1;
+  }
+
   const std::vector<unsigned int>& getBarrelMin() const { return barrelMin; }
   const std::vector<unsigned int>& getBarrelMax() const { return barrelMax; }
   const std::vector<unsigned int>& getEndcap10DegMin() const { return endcap10DegMin; }
@@ -132,6 +163,11 @@ public:
 
   const vector3D_pair& getConnections() const { return connections; };
 
+  ///the connections with the bending layers resolved, precomputed in the configure()
+  const LayerInputs& getLayerInputs(unsigned int iProcessor, unsigned int iRegion, unsigned int iLayer) const {
+    return layerInputs[(iProcessor * nLogicRegions() + iRegion) * nLayers() + iLayer];
+  }
+
   vector4D& getMeasurements4D() { return measurements4D; }
   vector4D& getMeasurements4Dref() { return measurements4Dref; }
 
@@ -186,8 +222,7 @@ public:
     return ((mtfType - l1t::tftype::omtf_neg) * rawParams.nProcessors() + iProcessor);
   };
 
-  //TODO implement more efficient
-  bool isBendingLayer(unsigned int iLayer) const override { return getBendingLayers().count(iLayer); }
+  bool isBendingLayer(unsigned int iLayer) const override { return iLayer < maxLayers && bendingLayersTable[iLayer]; }
 
   ///pattern pt range in Gev
   struct PatternPt {
@@ -294,6 +329,17 @@ private:
   std::set<int> bendingLayers;
   std::vector<int> refToLogicNumber;
 
+  ///the maps above as the arrays, filled in the configure()
+  std::array<int8_t, hwLayerNumbersCnt> hwToLogicLayerTable;
+  std::array<int16_t, maxLayers> logicToHwLayerTable;
+  std::array<int8_t, maxLayers> logicToLogicTable;
+  std::array<bool, maxLayers> bendingLayersTable;
+
+  void resetLayerTables();
+
+  ///fills the layer tables from the maps, throws cms::Exception if a layer number does not fit into the tables
+  void buildLayerTables();
+
   ///Starting and final sectors connected to
   ///processors.
   ///Index: processor number
@@ -328,6 +374,9 @@ private:
   ///Map of connections
   vector3D_pair connections;
 
+  ///[iProcessor][iRegion][iLayer] flattened
+  std::vector<LayerInputs> layerInputs;
+
   ///4D matrices used during creation of the connections tables.
   vector4D measurements4D;
   vector4D measurements4Dref;
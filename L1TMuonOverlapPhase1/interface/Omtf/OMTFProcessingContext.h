@@ -0,0 +1,98 @@
+#ifndef L1T_OmtfP1_OMTFPROCESSINGCONTEXT_H_
+#define L1T_OmtfP1_OMTFPROCESSINGCONTEXT_H_
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/AlgoMuon.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternBase.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+
+#include <memory>
+#include <vector>
+
+/*
+ * Mutable state of the OMTFProcessor event processing: the GoldenPatternResults of all golden patterns,
+ * indexed [iGP][procIndx][iRefHit], where iGP is the position of the pattern in the processor's pattern vector,
+ * and the candidates built from them by the sorter and the ghost buster, kept by value and reused in every event.
+ * The processor itself (patterns, configuration, extrapolation factors, sorter, ghost buster) is not modified
+ * by the event processing, so it can be shared between the edm streams, each stream having its own context.
+ */
+class OMTFProcessingContext {
+public:
+  typedef GoldenPatternBase::resultsArrayType resultsArrayType;
+
+  ///the best patterns for one refHit, updated by the sorter while the results are finalised (fused sorting),
+  ///the values of the best results are cached, so the results need not be accessed for the comparison
+  struct RefHitBestCandidate {
+    //index of the pattern with the best result, -1 if there is no candidate
+    int iGP = -1;
+    unsigned int firedLayerCnt = 0;
+    PdfValueType pdfSum = 0;
+
+    //index of the pattern with the best unconstrained pt result, -1 if there is no candidate
+    int iGpUpt = -1;
+    unsigned int uptFiredLayerCnt = 0;
+    PdfValueType pdfSumUpt = 0;
+  };
+
+  ///the context refers to the results kept inside the golden patterns (the OMTFProcessor has one such context
+  ///per procIndx), so the observers (e.g. the PatternGenerator) can still access them with the GoldenPatternBase::getResults()
+  template <class GoldenPatternType>
+  explicit OMTFProcessingContext(const GoldenPatternVec<GoldenPatternType>& gps) {
+    gpResults.reserve(gps.size());
+    for (auto& gp : gps)
+      gpResults.push_back(&(gp->getResults()));
+  }
+
+  ///the context owns the results for nPatterns golden patterns
+  OMTFProcessingContext(const OMTFConfiguration* omtfConfig, unsigned int nPatterns);
+
+  resultsArrayType& getResults(unsigned int iGP) { return *(gpResults[iGP]); }
+
+  const resultsArrayType& getResults(unsigned int iGP) const { return *(gpResults[iGP]); }
+
+  unsigned int size() const { return gpResults.size(); }
+
+  ///the candidates [iRefHit] filled by the SorterBase::sortResults, the ghost buster marks the killed ones
+  std::vector<AlgoMuon>& getRefHitCands() { return refHitCands; }
+
+  const std::vector<AlgoMuon>& getRefHitCands() const { return refHitCands; }
+
+  ///the candidates selected by the IGhostBuster::select from the getRefHitCands()
+  std::vector<AlgoMuon>& getGbCands() { return gbCands; }
+
+  const std::vector<AlgoMuon>& getGbCands() const { return gbCands; }
+
+  ///starts the fused sorting for the procIndx: resets the best candidates of all nRefHits
+  void resetBestCandidates(unsigned int procIndx, unsigned int nRefHits) {
+    bestCandidatesProcIndx = procIndx;
+    bestCandidates.assign(nRefHits, RefHitBestCandidate());
+  }
+
+  ///marks the best candidates as not valid, i.e. the sorter must scan the results
+  void clearBestCandidates() { bestCandidatesProcIndx = -1; }
+
+  ///true if the best candidates were filled by the fused sorting for the procIndx
+  bool hasBestCandidates(unsigned int procIndx) const { return bestCandidatesProcIndx == (int)procIndx; }
+
+  RefHitBestCandidate& getBestCandidate(unsigned int iRefHit) { return bestCandidates[iRefHit]; }
+
+  const RefHitBestCandidate& getBestCandidate(unsigned int iRefHit) const { return bestCandidates[iRefHit]; }
+
+private:
+  //GoldenPatternResult::finalise captures the this pointer, so the results must not be moved after the init,
+  //therefore each results array is allocated separately
+  std::vector<std::unique_ptr<resultsArrayType> > ownedResults;
+
+  std::vector<resultsArrayType*> gpResults;
+
+  //the AlgoMuons are assigned in place (AlgoMuon::assign), so after the first events no memory is allocated
+  std::vector<AlgoMuon> refHitCands;
+
+  std::vector<AlgoMuon> gbCands;
+
+  //[iRefHit], valid only for the bestCandidatesProcIndx
+  std::vector<RefHitBestCandidate> bestCandidates;
+
+  int bestCandidatesProcIndx = -1;
+};
+
+#endif /* L1T_OmtfP1_OMTFPROCESSINGCONTEXT_H_ */
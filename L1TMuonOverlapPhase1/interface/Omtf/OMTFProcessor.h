@@ -2,8 +2,11 @@
 #define L1T_OmtfP1_OMTFProcessor_H
 
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/AlgoMuon.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/ExtrapolFactorsTable.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternKernel.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternResult.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/HitPatternQuality.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/IGhostBuster.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/IProcessorEmulator.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
@@ -47,6 +50,11 @@ public:
                 edm::EventSetup const& evSetup,
                 GoldenPatternVec<GoldenPatternType>&& gps);
 
+  ///for the standalone tools (e.g. the omtfProcessorBenchmark), the EventSetup is not used by the processor
+  OMTFProcessor(OMTFConfiguration* omtfConfig,
+                const edm::ParameterSet& edmCfg,
+                GoldenPatternVec<GoldenPatternType>&& gps);
+
   ~OMTFProcessor() override;
 
   ///Fill GP vec with patterns from CondFormats object
@@ -71,17 +79,34 @@ public:
   void processInput(unsigned int iProcessor, l1t::tftype mtfType, const OMTFinput& aInput,
       std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) override;
 
+  ///as above, the results are stored in the context
+  void processInput(OMTFProcessingContext& context, unsigned int iProcessor, l1t::tftype mtfType, const OMTFinput& aInput,
+      std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers);
+
   AlgoMuons sortResults(unsigned int iProcessor, l1t::tftype mtfType, int charge = 0) override;
 
+  ///as above, the candidates are built in the context.getRefHitCands()
+  void sortResults(OMTFProcessingContext& context, unsigned int iProcessor, l1t::tftype mtfType, int charge = 0);
+
   AlgoMuons ghostBust(AlgoMuons refHitCands, int charge = 0) override {
     return ghostBuster->select(refHitCands, charge);
   }
 
+  ///as above, on the context.getRefHitCands(), the selected candidates are put to the context.getGbCands()
+  void ghostBust(OMTFProcessingContext& context, int charge = 0) {
+    ghostBuster->select(context.getRefHitCands(), context.getGbCands(), charge);
+  }
+
   //convert algo muon to outgoing Candidates
   std::vector<l1t::RegionalMuonCand> getFinalcandidates(unsigned int iProcessor,
                                                         l1t::tftype mtfType,
                                                         const AlgoMuons& algoCands) override;
 
+  ///as above, for the candidates kept in the context, i.e. the context.getGbCands()
+  std::vector<l1t::RegionalMuonCand> getFinalcandidates(unsigned int iProcessor,
+                                                        l1t::tftype mtfType,
+                                                        const std::vector<AlgoMuon>& algoCands);
+
   ///allows to use other sorter implementation than the default one
   virtual void setSorter(SorterBase<GoldenPatternType>* sorter) { this->sorter.reset(sorter); }
 
@@ -96,22 +121,79 @@ public:
                                          OMTFinputMaker* inputMaker,
                                          std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) override;
 
+  std::vector<l1t::RegionalMuonCand> run(OMTFProcessingContext& context,
+                                         unsigned int iProcessor,
+                                         l1t::tftype mtfType,
+                                         int bx,
+                                         OMTFinputMaker* inputMaker,
+                                         std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) override;
+
+  std::unique_ptr<OMTFProcessingContext> makeProcessingContext() const override {
+    return std::make_unique<OMTFProcessingContext>(this->myOmtfConfig, this->theGPs.size());
+  }
+
+  ///the results of the golden patterns are kept separately for each processor, so the run() for different processors
+  ///can be executed in parallel, but the ptAssignment (e.g. neural network) may keep its intermediate results in the members
+  bool canRunInParallel() const override { return ptAssignment == nullptr || ptAssignment->isReentrant(); }
+
   void printInfo() const override;
 
   void saveExtrapolFactors();
-  void loadExtrapolFactors();
+
+  ///reads the extrapolFactorsTable from the XML or binary file, see ExtrapolFactorsTable
+  void loadExtrapolFactors(const std::string& filename);
+
+protected:
+  ///processes the stubs of the iLayer with all patterns, for the ref hit iRefHit, the results are stored in the context
+  virtual void processLayer(OMTFProcessingContext& context,
+                            unsigned int procIndx,
+                            unsigned int iRefHit,
+                            unsigned int iRefLayer,
+                            unsigned int iLayer,
+                            const MuonStubPtrsView& layerStubs,
+                            const std::vector<int>& extrapolatedPhi,
+                            const MuonStubPtr& refStub);
 
 private:
-  virtual void init(const edm::ParameterSet& edmCfg, edm::EventSetup const& evSetup);
+  virtual void init(const edm::ParameterSet& edmCfg);
+
+  ///common for both getFinalcandidates, the AlgoMuonsType is AlgoMuons or std::vector<AlgoMuon>
+  template <class AlgoMuonsType>
+  std::vector<l1t::RegionalMuonCand> makeFinalcandidates(unsigned int iProcessor,
+                                                         l1t::tftype mtfType,
+                                                         const AlgoMuonsType& algoCands);
+
+  ///the contexts referring to the results kept in the golden patterns, used by the methods without the context argument,
+  ///one per procIndx, so the run() for different processors can still be executed in parallel,
+  ///and the best candidates selected in the processInput are still there for the sortResults
+  std::vector<std::unique_ptr<OMTFProcessingContext> > defaultContexts;
+
+  ///selects the process1Layer1RefLayerKernel and finaliseResultsKernel, called at the end of the init()
+  void selectKernels();
+
+  ///the GoldenPatternKernel<GoldenPatternType>::process1Layer1RefLayer if all patterns are exactly of the
+  ///GoldenPatternType, otherwise the one calling the virtual GoldenPatternBase::process1Layer1RefLayer
+  typename GoldenPatternKernel<GoldenPatternType>::Process1Layer1RefLayer process1Layer1RefLayerKernel = nullptr;
+
+  ///the GoldenPatternResult::finaliseResults for the configured finalizeFunction,
+  ///nullptr if the virtual GoldenPatternBase::finalise is to be used (patterns not exactly of the GoldenPatternType)
+  GoldenPatternResult::FinaliseResults finaliseResultsKernel = nullptr;
+
+  ///if true (default) and the sorter supports it, the best candidates are selected in the processInput,
+  ///just after the results of each pattern are finalised, see SorterBase::updateBestCandidates
+  bool fusedSorting = true;
 
   ///Check if the hit pattern of given OMTF candite is not on the list
   ///of invalid hit patterns. Invalid hit patterns provode very little
   ///to efficiency, but gives high contribution to rate.
-  ///Candidate with invalid hit patterns is assigned quality=0.
-  ///Currently the list of invalid patterns is hardcoded.
-  ///This has to be read from configuration.
+  ///Candidate with invalid hit patterns is assigned quality=4 (for the fwVersion <= 6).
+  ///The list is given by the HitPatternQuality::invalidHitPatternsFw6(),
+  ///the quality used in the getFinalcandidates comes from the hitPatternQuality.
   bool checkHitPatternValidity(unsigned int hits) override;
 
+  ///quality of the final candidates, built for the fwVersion in the init()
+  std::unique_ptr<HitPatternQuality> hitPatternQuality;
+
   std::unique_ptr<SorterBase<GoldenPatternType> > sorter;
 
   std::unique_ptr<IGhostBuster> ghostBuster;
@@ -124,9 +206,13 @@ private:
 
   int extrapolMultiplier =  128;
 
+  //filled by the floating point extrapolateDtPhiB, to be saved by the saveExtrapolFactors
   std::vector<std::vector<std::map<int, double> > > extrapolFactors; //[refLayer][targetLayer][etaCode]
   std::vector<std::vector<std::map<int, int> > > extrapolFactorsNorm;
 
+  //used by the extrapolateDtPhiBFP
+  ExtrapolFactorsTable extrapolFactorsTable;
+
 };
 
 #endif
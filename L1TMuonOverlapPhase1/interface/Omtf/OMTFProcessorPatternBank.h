@@ -0,0 +1,51 @@
+#ifndef L1T_OmtfP1_OMTFProcessorPatternBank_H
+#define L1T_OmtfP1_OMTFProcessorPatternBank_H
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternBank.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessor.h"
+
+#include <memory>
+
+/*
+ * OMTFProcessor in which the patterns are evaluated with the GoldenPatternBank, i.e. all patterns at once,
+ * instead of calling the GoldenPattern::process1Layer1RefLayer for every pattern (processorType "OMTFProcessorPatternBank").
+ * The results are the same as of the OMTFProcessor<GoldenPattern>.
+ * If patternBankValidation is true, the results are compared with the ones from the GoldenPattern::process1Layer1RefLayer
+ * and an exception is thrown if they are different.
+ */
+class OMTFProcessorPatternBank : public OMTFProcessor<GoldenPattern> {
+public:
+  OMTFProcessorPatternBank(OMTFConfiguration* omtfConfig,
+                           const edm::ParameterSet& edmCfg,
+                           edm::EventSetup const& evSetup,
+                           const L1TMuonOverlapParams* omtfPatterns);
+
+  OMTFProcessorPatternBank(OMTFConfiguration* omtfConfig,
+                           const edm::ParameterSet& edmCfg,
+                           edm::EventSetup const& evSetup,
+                           GoldenPatternVec<GoldenPattern>&& gps);
+
+  ~OMTFProcessorPatternBank() override {}
+
+  void printInfo() const override;
+
+protected:
+  void processLayer(OMTFProcessingContext& context,
+                    unsigned int procIndx,
+                    unsigned int iRefHit,
+                    unsigned int iRefLayer,
+                    unsigned int iLayer,
+                    const MuonStubPtrsView& layerStubs,
+                    const std::vector<int>& extrapolatedPhi,
+                    const MuonStubPtr& refStub) override;
+
+private:
+  void initPatternBank(const edm::ParameterSet& edmCfg);
+
+  std::unique_ptr<GoldenPatternBank> patternBank;
+
+  bool patternBankValidation = false;
+};
+
+#endif
@@ -60,12 +60,18 @@ public:
                             const edm::ESGetToken<Propagator, TrackingComponentsRecord>& propagatorEsToken);
 
 protected:
+  ///runs the omtf_pos and omtf_neg processors for a given bx as parallel tbb tasks,
+  ///the candidates are added to the collection and the observers are notified in the same order as in the serial mode
+  void runProcessorsInParallel(int bx, l1t::RegionalMuonCandBxCollection& candidates);
+
   edm::ParameterSet edmParameterSet;
 
   MuStubsInputTokens& muStubsInputTokens;
 
   int bxMin, bxMax;
 
+  bool processorsInParallel = false;
+
   ///OMTF objects
   unique_ptr<OMTFConfiguration> omtfConfig;
 
@@ -15,12 +15,35 @@ public:
   ///Select candidate with highest number of hit layers
   ///Then select a candidate with largest likelihood value and given charge
   ///as we allow two candidates with opposite charge from single 10deg region
-  AlgoMuons::value_type sortRefHitResults(unsigned int procIndx,
-                                          unsigned int iRefHit,
-                                          const GoldenPatternVec<GoldenPatternType>& gPatterns,
-                                          int charge = 0) override;
+  void sortRefHitResults(unsigned int procIndx,
+                         unsigned int iRefHit,
+                         const GoldenPatternVec<GoldenPatternType>& gPatterns,
+                         const OMTFProcessingContext& context,
+                         AlgoMuon& candidate,
+                         int charge = 0) override;
+
+  bool supportsFusedSorting() const override { return true; }
+
+  void updateBestCandidates(OMTFProcessingContext& context,
+                            unsigned int procIndx,
+                            unsigned int iGP,
+                            GoldenPatternType& gp) override;
+
+  void makeCandidate(unsigned int procIndx,
+                     unsigned int iRefHit,
+                     const GoldenPatternVec<GoldenPatternType>& gPatterns,
+                     const OMTFProcessingContext& context,
+                     const OMTFProcessingContext::RefHitBestCandidate& bestCandidate,
+                     AlgoMuon& candidate) override;
 
 private:
+  ///the selection of the best pattern, common for the sortRefHitResults and the fused sorting
+  void updateBestCandidate(OMTFProcessingContext::RefHitBestCandidate& bestCandidate,
+                           unsigned int iGP,
+                           GoldenPatternType& gp,
+                           const GoldenPatternResult& gpResult,
+                           int charge) const;
+
   int myType;
 };
 
@@ -112,11 +112,13 @@ public:
   ///returns the global phi in hardware scale (myOmtfConfig->nPhiBins() ) at which the scale starts for give processor
   static int getProcessorPhiZero(const OMTFConfiguration* config, unsigned int iProcessor);
 
+  ///the stub is created in the stubsArena, or on the heap if it is nullptr
   static void addStub(const OMTFConfiguration* config,
                       MuonStubPtrs2D& muonStubsInLayers,
                       unsigned int iLayer,
                       unsigned int iInput,
-                      MuonStub& stub);
+                      MuonStub& stub,
+                      EventArena* stubsArena = nullptr);
 
   ///Give input number for given processor, using
   ///the chamber sector number.
@@ -0,0 +1,126 @@
+/*
+ * OMTFinputSnapshotWriter.h
+ *
+ *      Dumps the OMTFinput of the processors, to be replayed offline, e.g. by the omtfProcessorBenchmark
+ */
+
+#ifndef L1T_OmtfP1_OMTFINPUTSNAPSHOTWRITER_H_
+#define L1T_OmtfP1_OMTFINPUTSNAPSHOTWRITER_H_
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/BinaryFileHeader.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/IOMTFEmulationObserver.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinput.h"
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Writes all stubs (all MuonStub fields) of the input of every processor with at least one stub, together with
+ * the final candidates produced from it, so the emulation of the recorded sample can be repeated without
+ * the cmsRun and the digis, and its output compared with the recorded one.
+ * It is added to the observers if the inputSnapshotsFileName parameter is given.
+ *
+ * The file layout (native byte order, see the BinaryFileHeader):
+ * FileHeader, then for each processor input: SnapshotRecord, StubRecord[nStubs], CandidateRecord[nCandidates]
+ */
+class OMTFinputSnapshotWriter : public IOMTFEmulationObserver {
+public:
+  static constexpr BinaryFileHeader::Magic magic = {'O', 'M', 'T', 'F', 'I', 'N', 'S', '\0'};
+
+  //to be incremented if the layout is changed
+  static const uint32_t version = 1;
+
+  struct FileHeader {
+    BinaryFileHeader fileType;
+    uint32_t nLayers;
+    uint32_t patternsVersion;
+  };
+
+  struct SnapshotRecord {
+    uint32_t iEvent;
+    uint32_t iProcessor;
+    int32_t mtfType;  //l1t::tftype
+    uint32_t nStubs;
+    uint32_t nCandidates;
+  };
+
+  struct StubRecord {
+    uint32_t iLayer;
+    uint32_t iInput;
+    int32_t type;
+    int32_t phiHw;
+    int32_t phiBHw;
+    int32_t etaHw;
+    int32_t etaSigmaHw;
+    int32_t qualityHw;
+    int32_t bx;
+    int32_t timing;
+    uint32_t logicLayer;
+    int32_t detId;
+  };
+
+  struct CandidateRecord {
+    int32_t hwPt;
+    int32_t hwPtUnconstrained;
+    int32_t hwPhi;
+    int32_t hwEta;
+    int32_t hwQual;
+    int32_t hwSign;
+    int32_t hwSignValid;
+
+    bool operator==(const CandidateRecord& o) const {
+      return hwPt == o.hwPt && hwPtUnconstrained == o.hwPtUnconstrained && hwPhi == o.hwPhi && hwEta == o.hwEta &&
+             hwQual == o.hwQual && hwSign == o.hwSign && hwSignValid == o.hwSignValid;
+    }
+  };
+
+  ///the input of one processor, read from the file
+  struct Snapshot {
+    unsigned int iEvent = 0;
+    unsigned int iProcessor = 0;
+    l1t::tftype mtfType = l1t::omtf_pos;
+    std::shared_ptr<OMTFinput> input;
+    std::vector<CandidateRecord> candidates;
+  };
+
+  OMTFinputSnapshotWriter(const OMTFConfiguration* omtfConfig, const std::string& fName);
+
+  ~OMTFinputSnapshotWriter() override;
+
+  void observeProcesorEmulation(unsigned int iProcessor,
+                                l1t::tftype mtfType,
+                                const std::shared_ptr<OMTFinput>& input,
+                                const AlgoMuons& algoCandidates,
+                                const AlgoMuons& gbCandidates,
+                                const std::vector<l1t::RegionalMuonCand>& candMuons) override;
+
+  void observeEventBegin(const edm::Event& iEvent) override;
+
+  void endJob() override;
+
+  static CandidateRecord makeCandidateRecord(const l1t::RegionalMuonCand& candMuon);
+
+  ///reads all snapshots from the file, the stubs are put in the OMTFinput at the recorded [iLayer][iInput],
+  ///throws cms::Exception if the file is not valid or the nLayers differs from the omtfConfig
+  static std::vector<Snapshot> readSnapshots(const std::string& fileName, const OMTFConfiguration* omtfConfig);
+
+private:
+  template <class T>
+  void write(const T& value) {
+    outFile.write(reinterpret_cast<const char*>(&value), sizeof(T));
+  }
+
+  const OMTFConfiguration* omtfConfig;
+
+  std::ofstream outFile;
+
+  unsigned int eventNum = 0;
+
+  std::vector<StubRecord> stubRecords;
+};
+
+#endif /* L1T_OmtfP1_OMTFINPUTSNAPSHOTWRITER_H_ */
@@ -58,10 +58,11 @@ protected:
 
   ///Remove hits whis are outside input range
   ///for given processor and cone
-  virtual MuonStubPtrs1D restrictInput(unsigned int iProcessor,
-                                       unsigned int iCone,
-                                       unsigned int iLayer,
-                                       const OMTFinput& input);
+  ///the returned view points to the stubs of the input, it does not copy them
+  virtual MuonStubPtrsView restrictInput(unsigned int iProcessor,
+                                          unsigned int iCone,
+                                          unsigned int iLayer,
+                                          const OMTFinput& input);
 
   std::vector<OMTFConfiguration::PatternPt> patternPts;
 };
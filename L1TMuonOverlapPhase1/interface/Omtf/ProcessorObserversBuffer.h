@@ -0,0 +1,53 @@
+#ifndef L1T_OmtfP1_PROCESSOROBSERVERSBUFFER_H_
+#define L1T_OmtfP1_PROCESSOROBSERVERSBUFFER_H_
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/IOMTFEmulationObserver.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+ * Collects the observer notifications of a single OMTFProcessor::run,
+ * when the processors are run in parallel (see OMTFReconstruction::runProcessorsInParallel).
+ * The real observers are not thread safe, so the notifications are replayed to them
+ * after all processors are finished, in the same order as in the serial execution.
+ */
+class ProcessorObserversBuffer : public IOMTFEmulationObserver {
+public:
+  ProcessorObserversBuffer() {}
+
+  ~ProcessorObserversBuffer() override {}
+
+  void observeProcesorBegin(unsigned int iProcessor, l1t::tftype mtfType) override;
+
+  void addProcesorData(std::string key, boost::property_tree::ptree& procDataTree) override;
+
+  void observeProcesorEmulation(unsigned int iProcessor,
+                                l1t::tftype mtfType,
+                                const std::shared_ptr<OMTFinput>& input,
+                                const AlgoMuons& algoCandidates,
+                                const AlgoMuons& gbCandidates,
+                                const std::vector<l1t::RegionalMuonCand>& candMuons) override;
+
+  void endJob() override {}
+
+  ///passes the collected notifications to the observers and clears the buffer
+  void replay(std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers);
+
+private:
+  unsigned int iProcessor = 0;
+  l1t::tftype mtfType = l1t::tftype::omtf_pos;
+
+  bool processorBegin = false;
+  std::vector<std::pair<std::string, boost::property_tree::ptree> > procData;
+
+  bool processorEmulation = false;
+  std::shared_ptr<OMTFinput> input;
+  AlgoMuons algoCandidates;
+  AlgoMuons gbCandidates;
+  std::vector<l1t::RegionalMuonCand> candMuons;
+};
+
+#endif /* L1T_OmtfP1_PROCESSOROBSERVERSBUFFER_H_ */
@@ -23,6 +23,9 @@ public:
   virtual std::vector<float> getPts(AlgoMuons::value_type& algoMuon,
       std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) = 0;
 
+  ///true if the getPts() does not modify the object, so it can be called concurrently for different processors
+  virtual bool isReentrant() const { return false; }
+
 protected:
   const OMTFConfiguration* omtfConfig = nullptr;
 };
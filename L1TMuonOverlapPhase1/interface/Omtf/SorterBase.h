@@ -10,6 +10,7 @@
 
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/AlgoMuon.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternResult.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessingContext.h"
 
 #include "DataFormats/L1TMuon/interface/RegionalMuonCand.h"
 #include "DataFormats/L1TMuon/interface/RegionalMuonCandFwd.h"
@@ -22,25 +23,61 @@ public:
   virtual ~SorterBase() {}
 
   //iProcessor - continuous processor index [0...11]
-  virtual AlgoMuons sortResults(unsigned int procIndx,
-                                const GoldenPatternVec<GoldenPatternType>& gPatterns,
-                                int charge = 0) {
-    AlgoMuons refHitCands;
-    //  for(auto itRefHit: procResults) refHitCands.push_back(sortRefHitResults(itRefHit,charge));
-    for (unsigned int iRefHit = 0; iRefHit < gPatterns.at(0)->getResults()[procIndx].size(); iRefHit++) {
-      refHitCands.emplace_back(sortRefHitResults(procIndx, iRefHit, gPatterns, charge));
+  //the results of the gPatterns are taken from the context, context.getResults(iGP) corresponds to gPatterns[iGP]
+  //the candidates are built in the context.getRefHitCands(), one for each refHit;
+  //if the best candidates were already selected during the finalise (fused sorting), they are used instead of scanning
+  //all results; the best candidates are collected only for charge = 0
+  virtual void sortResults(unsigned int procIndx,
+                           const GoldenPatternVec<GoldenPatternType>& gPatterns,
+                           OMTFProcessingContext& context,
+                           int charge = 0) {
+    std::vector<AlgoMuon>& refHitCands = context.getRefHitCands();
+    unsigned int nRefHits = context.getResults(0)[procIndx].size();
+    refHitCands.resize(nRefHits);
+
+    bool useBestCandidates = (charge == 0 && context.hasBestCandidates(procIndx));
+    for (unsigned int iRefHit = 0; iRefHit < nRefHits; iRefHit++) {
+      if (useBestCandidates)
+        makeCandidate(
+            procIndx, iRefHit, gPatterns, context, context.getBestCandidate(iRefHit), refHitCands[iRefHit]);
+      else
+        sortRefHitResults(procIndx, iRefHit, gPatterns, context, refHitCands[iRefHit], charge);
     }
-    return refHitCands;
   }
 
   ///Sort results from a single reference hit.
   ///Select candidate with highest number of hit layers
   ///Then select a candidate with largest likelihood value and given charge
   ///as we allow two candidates with opposite charge from single 10deg region
-  virtual AlgoMuons::value_type sortRefHitResults(unsigned int procIndx,
-                                                  unsigned int iRefHit,
-                                                  const GoldenPatternVec<GoldenPatternType>& gPatterns,
-                                                  int charge = 0) = 0;
+  ///the selected candidate is assigned to the candidate
+  virtual void sortRefHitResults(unsigned int procIndx,
+                                 unsigned int iRefHit,
+                                 const GoldenPatternVec<GoldenPatternType>& gPatterns,
+                                 const OMTFProcessingContext& context,
+                                 AlgoMuon& candidate,
+                                 int charge = 0) = 0;
+
+  ///true if the sorter implements the updateBestCandidates and makeCandidate, i.e. the OMTFProcessor can select
+  ///the best candidates while the results are finalised (fused sorting)
+  virtual bool supportsFusedSorting() const { return false; }
+
+  ///updates the context.getBestCandidate(iRefHit) for every iRefHit with the (already finalised) results
+  ///of the pattern iGP, must be called for the patterns in the order of increasing iGP,
+  ///so that the ties are resolved in the same way as in the sortRefHitResults
+  virtual void updateBestCandidates(OMTFProcessingContext& context,
+                                    unsigned int procIndx,
+                                    unsigned int iGP,
+                                    GoldenPatternType& gp) {}
+
+  ///assigns to the candidate the AlgoMuon built from the best candidate selected by the updateBestCandidates
+  virtual void makeCandidate(unsigned int procIndx,
+                             unsigned int iRefHit,
+                             const GoldenPatternVec<GoldenPatternType>& gPatterns,
+                             const OMTFProcessingContext& context,
+                             const OMTFProcessingContext::RefHitBestCandidate& bestCandidate,
+                             AlgoMuon& candidate) {
+    sortRefHitResults(procIndx, iRefHit, gPatterns, context, candidate);
+  }
 };
 
 #endif /* L1T_OmtfP1_SORTERBASE_H_ */
@@ -39,7 +39,15 @@ public:
   //returns address for the  pdf LUTs
   virtual unsigned int etaHwToEtaBin(int etaHw) const { return 0; }
 
-  virtual int foldPhi(int phi) const;
+  virtual int foldPhi(int phi) const {
+    int phiBins = nPhiBins();
+    if (phi > phiBins / 2)
+      return (phi - phiBins);
+    else if (phi < -phiBins / 2)
+      return (phi + phiBins);
+
+    return phi;
+  }
 
   virtual unsigned int nLayers() const = 0;
 
@@ -79,6 +87,12 @@ public:
     return this->fixCscGeometryOffset = fixCscGeometryOffset;
   }
 
+  virtual bool getAngleConverterCacheValidation() const { return angleConverterCacheValidation; }
+
+  virtual void setAngleConverterCacheValidation(bool angleConverterCacheValidation) {
+    this->angleConverterCacheValidation = angleConverterCacheValidation;
+  }
+
 private:
   int cscLctCentralBx_ = 8;  //CSCConstants::LCT_CENTRAL_BX;
 
@@ -94,6 +108,9 @@ private:
   int minDtPhiBQuality = 2;  //used on the top of the minDtPhiQuality
 
   bool fixCscGeometryOffset = false;
+
+  //if true, the AngleConverterBase compares the cached CSC and RPC phi with the one obtained directly from the geometry
+  bool angleConverterCacheValidation = false;
 };
 
 #endif /* L1T_OmtfP1_PROCCONFIGURATIONBASE_H_ */
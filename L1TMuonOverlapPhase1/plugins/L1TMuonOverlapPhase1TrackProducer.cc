@@ -1,6 +1,10 @@
 #include "L1TMuonOverlapPhase1TrackProducer.h"
 #include "FWCore/Utilities/interface/EDGetToken.h"
 #include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/ExtrapolFactorsTable.h"
 
 #include "SimDataFormats/Track/interface/SimTrackContainer.h"
 #include "SimDataFormats/Vertex/interface/SimVertexContainer.h"
@@ -89,5 +93,15 @@ void L1TMuonOverlapPhase1TrackProducer::produce(edm::Event& iEvent, const edm::E
 }
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
+void L1TMuonOverlapPhase1TrackProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  //only the parameters with a default are described, the others are optional (checked with the exists())
+  edm::ParameterSetDescription desc;
+  desc.add<edm::FileInPath>("extrapolFactorsFile", edm::FileInPath(ExtrapolFactorsTable::defaultFile))
+      ->setComment("the DT phiB extrapolation factors, XML or binary (omtfExtrapolFactorsConverter)");
+  desc.setAllowAnything();
+  descriptions.addDefault(desc);
+}
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
 #include "FWCore/Framework/interface/MakerMacros.h"
 DEFINE_FWK_MODULE(L1TMuonOverlapPhase1TrackProducer);
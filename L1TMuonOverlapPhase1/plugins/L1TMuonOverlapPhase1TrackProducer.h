@@ -18,10 +18,10 @@
 #include "DataFormats/RPCDigi/interface/RPCDigiCollection.h"
 
 /**
- * The OMTF emulator cannot be run in multiple threads, because GoldenPatternBase keeps GoldenPatternResult's
- * which are then used in the GoldenPatternBase::finalise called at the end of OMTFProcessor<GoldenPatternType>::processInput.
- * Also patterns generation relies on updating the statistics for the patterns
- * This can be fixed, but requires some work.
+ * In this producer the GoldenPatternResult's are kept in the GoldenPatternBase, as they are needed by the observers,
+ * and the patterns generation relies on updating the statistics for the patterns, so it cannot be run in multiple threads.
+ * For the multithreaded emulation (without the observers) use the L1TMuonOverlapPhase1TrackProducerGlobal,
+ * where the results are kept in the per-stream OMTFProcessingContext.
  */
 class L1TMuonOverlapPhase1TrackProducer : public edm::one::EDProducer<edm::one::WatchRuns> {
 public:
@@ -29,6 +29,8 @@ public:
 
   ~L1TMuonOverlapPhase1TrackProducer() override;
 
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
   void beginJob() override;
 
   void endJob() override;
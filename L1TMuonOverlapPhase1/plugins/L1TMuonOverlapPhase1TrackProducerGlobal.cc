@@ -0,0 +1,182 @@
+#include "L1TMuonOverlapPhase1TrackProducerGlobal.h"
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/ExtrapolFactorsTable.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessor.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessorPatternBank.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigReader.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include <memory>
+
+L1TMuonOverlapPhase1TrackProducerGlobal::L1TMuonOverlapPhase1TrackProducerGlobal(
+    const edm::ParameterSet& edmParameterSet)
+    : edmParameterSet(edmParameterSet),
+      muStubsInputTokens(
+          {consumes<L1MuDTChambPhContainer>(edmParameterSet.getParameter<edm::InputTag>("srcDTPh")),
+           consumes<L1MuDTChambThContainer>(edmParameterSet.getParameter<edm::InputTag>("srcDTTh")),
+           consumes<CSCCorrelatedLCTDigiCollection>(edmParameterSet.getParameter<edm::InputTag>("srcCSC")),
+           consumes<RPCDigiCollection>(edmParameterSet.getParameter<edm::InputTag>("srcRPC"))}),
+      omtfParamsEsToken(esConsumes<L1TMuonOverlapParams, L1TMuonOverlapParamsRcd, edm::Transition::BeginRun>()),
+      muonGeometryTokens({esConsumes<RPCGeometry, MuonGeometryRecord, edm::Transition::BeginRun>(),
+                          esConsumes<CSCGeometry, MuonGeometryRecord, edm::Transition::BeginRun>(),
+                          esConsumes<DTGeometry, MuonGeometryRecord, edm::Transition::BeginRun>()}) {
+  produces<l1t::RegionalMuonCandBxCollection>("OMTF");
+
+  bxMin = edmParameterSet.exists("bxMin") ? edmParameterSet.getParameter<int>("bxMin") : 0;
+  bxMax = edmParameterSet.exists("bxMax") ? edmParameterSet.getParameter<int>("bxMax") : 0;
+
+  if (edmParameterSet.exists("processorType"))
+    processorType = edmParameterSet.getParameter<std::string>("processorType");
+
+  std::string patternType = "GoldenPattern";
+  if (edmParameterSet.exists("patternType"))
+    patternType = edmParameterSet.getParameter<std::string>("patternType");
+
+  if ((processorType != "OMTFProcessor" && processorType != "OMTFProcessorPatternBank") ||
+      patternType != "GoldenPattern")
+    throw cms::Exception(
+        "L1TMuonOverlapPhase1TrackProducerGlobal: only the OMTFProcessor and OMTFProcessorPatternBank with "
+        "GoldenPattern are supported, use L1TMuonOverlapPhase1TrackProducer for processorType " +
+        processorType + " patternType " + patternType);
+
+  if (edmParameterSet.exists("patternsXMLFile")) {
+    patternsXMLFiles.push_back(edmParameterSet.getParameter<edm::FileInPath>("patternsXMLFile").fullPath());
+  } else if (edmParameterSet.exists("patternsXMLFiles")) {
+    for (const auto& it : edmParameterSet.getParameter<std::vector<edm::ParameterSet> >("patternsXMLFiles")) {
+      patternsXMLFiles.push_back(it.getParameter<edm::FileInPath>("patternsXMLFile").fullPath());
+    }
+  }
+
+  edm::LogVerbatim("OMTFReconstruction") << "L1TMuonOverlapPhase1TrackProducerGlobal: bxMin " << bxMin << " - bxMax "
+                                         << bxMax << " patternsXMLFiles " << patternsXMLFiles.size() << std::endl;
+}
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+L1TMuonOverlapPhase1TrackProducerGlobal::~L1TMuonOverlapPhase1TrackProducerGlobal() {}
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+std::shared_ptr<omtf::RunCache> L1TMuonOverlapPhase1TrackProducerGlobal::globalBeginRun(
+    edm::Run const& run, edm::EventSetup const& iSetup) const {
+  std::lock_guard<std::mutex> lock(runCacheMutex);
+
+  bool omtfParamsChanged = omtfParamsRecordWatcher.check(iSetup);
+  if (lastRunCache && !omtfParamsChanged) {
+    edm::LogVerbatim("OMTFReconstruction") << "L1TMuonOverlapPhase1TrackProducerGlobal::globalBeginRun " << run.id()
+                                           << " omtfParams not changed, using the processor of the previous run"
+                                           << std::endl;
+    return lastRunCache;
+  }
+
+  auto runCache = std::make_shared<omtf::RunCache>();
+
+  const L1TMuonOverlapParams& omtfParams = iSetup.getData(omtfParamsEsToken);
+
+  runCache->omtfConfig = std::make_unique<OMTFConfiguration>();
+  runCache->omtfConfig->configure(&omtfParams);
+  //the parameters can be overwritten from the python config
+  runCache->omtfConfig->configureFromEdmParameterSet(edmParameterSet);
+
+  if (patternsXMLFiles.empty()) {
+    if (processorType == "OMTFProcessorPatternBank")
+      runCache->omtfProc = std::make_unique<OMTFProcessorPatternBank>(
+          runCache->omtfConfig.get(), edmParameterSet, iSetup, &omtfParams);
+    else
+      runCache->omtfProc = std::make_unique<OMTFProcessor<GoldenPattern> >(
+          runCache->omtfConfig.get(), edmParameterSet, iSetup, &omtfParams);
+  } else {
+    XMLConfigReader xmlReader;
+    auto gps = xmlReader.readPatterns<GoldenPattern>(omtfParams, patternsXMLFiles, false);
+    if (processorType == "OMTFProcessorPatternBank")
+      runCache->omtfProc = std::make_unique<OMTFProcessorPatternBank>(
+          runCache->omtfConfig.get(), edmParameterSet, iSetup, std::move(gps));
+    else
+      runCache->omtfProc = std::make_unique<OMTFProcessor<GoldenPattern> >(
+          runCache->omtfConfig.get(), edmParameterSet, iSetup, std::move(gps));
+  }
+
+  edm::LogVerbatim("OMTFReconstruction") << "L1TMuonOverlapPhase1TrackProducerGlobal::globalBeginRun " << run.id()
+                                         << std::endl;
+  runCache->omtfProc->printInfo();
+
+  lastRunCache = runCache;
+  return runCache;
+}
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+std::unique_ptr<omtf::StreamCache> L1TMuonOverlapPhase1TrackProducerGlobal::beginStream(edm::StreamID) const {
+  auto streamCache = std::make_unique<omtf::StreamCache>();
+  streamCache->muStubsInputTokens = muStubsInputTokens;
+  return streamCache;
+}
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+void L1TMuonOverlapPhase1TrackProducerGlobal::streamBeginRun(edm::StreamID streamID,
+                                                             edm::Run const& run,
+                                                             edm::EventSetup const& iSetup) const {
+  const omtf::RunCache* runCache = this->runCache(run.index());
+  omtf::StreamCache* streamCache = this->streamCache(streamID);
+
+  streamCache->inputMaker = std::make_unique<OMTFinputMaker>(edmParameterSet,
+                                                             streamCache->muStubsInputTokens,
+                                                             runCache->omtfConfig.get(),
+                                                             std::make_unique<OmtfAngleConverter>());
+  streamCache->inputMaker->initialize(edmParameterSet, iSetup, muonGeometryTokens);
+
+  streamCache->processingContext = runCache->omtfProc->makeProcessingContext();
+}
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+void L1TMuonOverlapPhase1TrackProducerGlobal::produce(edm::StreamID streamID,
+                                                      edm::Event& iEvent,
+                                                      const edm::EventSetup& evSetup) const {
+  const omtf::RunCache* runCache = this->runCache(iEvent.getRun().index());
+  omtf::StreamCache* streamCache = this->streamCache(streamID);
+
+  streamCache->inputMaker->loadAndFilterDigis(iEvent, bxMin, bxMax);
+
+  std::unique_ptr<l1t::RegionalMuonCandBxCollection> candidates = std::make_unique<l1t::RegionalMuonCandBxCollection>();
+  candidates->setBXRange(bxMin, bxMax);
+
+  ///The order is important: first put omtf_pos candidates, then omtf_neg.
+  for (int bx = bxMin; bx <= bxMax; bx++) {
+    for (auto mtfType : {l1t::tftype::omtf_pos, l1t::tftype::omtf_neg}) {
+      for (unsigned int iProcessor = 0; iProcessor < runCache->omtfConfig->nProcessors(); ++iProcessor) {
+        std::vector<l1t::RegionalMuonCand> candMuons = runCache->omtfProc->run(*(streamCache->processingContext),
+                                                                               iProcessor,
+                                                                               mtfType,
+                                                                               bx,
+                                                                               streamCache->inputMaker.get(),
+                                                                               streamCache->observers);
+
+        //fill outgoing collection
+        for (auto& candMuon : candMuons) {
+          candidates->push_back(bx, candMuon);
+        }
+      }
+    }
+  }
+
+  iEvent.put(std::move(candidates), "OMTF");
+}
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+void L1TMuonOverlapPhase1TrackProducerGlobal::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  //only the parameters with a default are described, the others are optional (checked with the exists())
+  edm::ParameterSetDescription desc;
+  desc.add<edm::FileInPath>("extrapolFactorsFile", edm::FileInPath(ExtrapolFactorsTable::defaultFile))
+      ->setComment("the DT phiB extrapolation factors, XML or binary (omtfExtrapolFactorsConverter)");
+  desc.setAllowAnything();
+  descriptions.addDefault(desc);
+}
+/////////////////////////////////////////////////////
+/////////////////////////////////////////////////////
+#include "FWCore/Framework/interface/MakerMacros.h"
+DEFINE_FWK_MODULE(L1TMuonOverlapPhase1TrackProducerGlobal);
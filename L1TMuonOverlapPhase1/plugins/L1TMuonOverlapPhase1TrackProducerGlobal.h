@@ -0,0 +1,101 @@
+#ifndef L1T_OmtfP1_L1TMuonOverlapPhase1TrackProducerGlobal_H
+#define L1T_OmtfP1_L1TMuonOverlapPhase1TrackProducerGlobal_H
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/IOMTFEmulationObserver.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/IProcessorEmulator.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessingContext.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinputMaker.h"
+
+#include "CondFormats/DataRecord/interface/L1TMuonOverlapParamsRcd.h"
+#include "CondFormats/L1TObjects/interface/L1TMuonOverlapParams.h"
+
+#include "DataFormats/L1TMuon/interface/RegionalMuonCand.h"
+#include "DataFormats/L1TMuon/interface/RegionalMuonCandFwd.h"
+
+#include "FWCore/Framework/interface/Frameworkfwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/EventSetup.h"
+#include "FWCore/Framework/interface/ESWatcher.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/ESGetToken.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace omtf {
+  ///immutable per run state, shared by all streams
+  struct RunCache {
+    std::unique_ptr<OMTFConfiguration> omtfConfig;
+
+    std::unique_ptr<IProcessorEmulator> omtfProc;
+  };
+
+  ///mutable per stream state
+  struct StreamCache {
+    //copy of the module's tokens, the inputMaker keeps the references to them
+    MuStubsInputTokens muStubsInputTokens;
+
+    //re-created at every streamBeginRun, as it refers to the omtfConfig of the RunCache
+    std::unique_ptr<OMTFinputMaker> inputMaker;
+
+    std::unique_ptr<OMTFProcessingContext> processingContext;
+
+    //always empty, the observers (dumping, pattern generation) are not thread safe
+    std::vector<std::unique_ptr<IOMTFEmulationObserver> > observers;
+  };
+}  // namespace omtf
+
+/**
+ * Multithreaded version of the L1TMuonOverlapPhase1TrackProducer.
+ * The OMTFConfiguration and the OMTFProcessor with the patterns are shared by the streams, they are rebuilt at the
+ * beginning of a run only if the L1TMuonOverlapParamsRcd changed (as in the OMTFReconstruction), the GoldenPatternResults and the input digis are kept per stream.
+ * Only the OMTFProcessor<GoldenPattern> and OMTFProcessorPatternBank are supported, and the observers (XML dump, EventCapture, PatternGenerator, etc.)
+ * are not available - for them the L1TMuonOverlapPhase1TrackProducer should be used.
+ */
+class L1TMuonOverlapPhase1TrackProducerGlobal
+    : public edm::global::EDProducer<edm::RunCache<omtf::RunCache>, edm::StreamCache<omtf::StreamCache> > {
+public:
+  L1TMuonOverlapPhase1TrackProducerGlobal(const edm::ParameterSet&);
+
+  ~L1TMuonOverlapPhase1TrackProducerGlobal() override;
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+  std::shared_ptr<omtf::RunCache> globalBeginRun(edm::Run const& run, edm::EventSetup const& iSetup) const override;
+
+  void globalEndRun(edm::Run const& run, edm::EventSetup const& iSetup) const override{};
+
+  std::unique_ptr<omtf::StreamCache> beginStream(edm::StreamID) const override;
+
+  void streamBeginRun(edm::StreamID streamID, edm::Run const& run, edm::EventSetup const& iSetup) const override;
+
+  void produce(edm::StreamID streamID, edm::Event&, const edm::EventSetup&) const override;
+
+private:
+  edm::ParameterSet edmParameterSet;
+
+  MuStubsInputTokens muStubsInputTokens;
+
+  edm::ESGetToken<L1TMuonOverlapParams, L1TMuonOverlapParamsRcd> omtfParamsEsToken;
+
+  //needed for AngleConverterBase
+  MuonGeometryTokens muonGeometryTokens;
+
+  int bxMin = 0, bxMax = 0;
+
+  std::string processorType = "OMTFProcessor";
+
+  std::vector<std::string> patternsXMLFiles;
+
+  //the RunCache of the previous run, returned again by the globalBeginRun if the omtfParams did not change,
+  //so that the patterns are not read again for every run
+  mutable std::mutex runCacheMutex;
+  mutable edm::ESWatcher<L1TMuonOverlapParamsRcd> omtfParamsRecordWatcher;
+  mutable std::shared_ptr<omtf::RunCache> lastRunCache;
+};
+
+#endif
@@ -11,23 +11,45 @@ simOmtfDigis = cms.EDProducer("L1TMuonOverlapPhase1TrackProducer",
   #g4SimTrackSrc = cms.InputTag('g4SimHits'),                             
   dumpResultToXML = cms.bool(False),
   dumpDetailedResultToXML = cms.bool(False),
+  #if the file name ends with ".bin", the events are streamed to the binary file (BinaryEventWriter), which
+  #can be converted to the XML with the omtfEventsConverter
   XMLDumpFileName = cms.string("TestEvents.xml"),                                     
+  #the inputs of all processors are dumped to the file, to be replayed offline by the omtfProcessorBenchmark
+  #inputSnapshotsFileName = cms.string("OMTFinputSnapshots.bin"),
   dumpGPToXML = cms.bool(False),  
   readEventsFromXML = cms.bool(False),
   eventsXMLFiles = cms.vstring("TestEvents.xml"),
   dropRPCPrimitives = cms.bool(False),                                    
   dropDTPrimitives = cms.bool(False),                                    
   dropCSCPrimitives = cms.bool(False),
+  #"OMTFProcessorPatternBank" gives the same results as "OMTFProcessor", but evaluates all patterns at once
   processorType = cms.string("OMTFProcessor"),
   
+  #if True, the 12 processors are emulated in parallel tbb tasks, the output is the same as in the serial mode
+  processorsInParallel = cms.bool(False),
+
+  #if True, the CSC and RPC phi conversion values cached in the AngleConverterBase are checked against the geometry
+  #angleConverterCacheValidation = cms.bool(True),
+  
   #ghostBusterType = cms.string("GhostBusterPreferRefDt"),
   
+  #the patterns converted to the binary format with the omtfPatternsConverter can be given here instead of the xml,
+  #they are loaded much faster
   #patternsXMLFile = cms.FileInPath("L1Trigger/L1TMuon/data/omtf_config/Patterns_0x00020007.xml")
   #patternsXMLFile = cms.FileInPath("L1Trigger/L1TMuon/data/omtf_config/Patterns_0x0003.xml")                               
 
+  #rules for the candidate quality applied after the default ones (see HitPatternQuality.h), e.g. for a new fwVersion
+  #hitPatternQualityRules = cms.VPSet(
+  #  cms.PSet(fwVersionMin = cms.uint32(9), quality = cms.uint32(1), firedLayerBits = cms.vstring("000000110000000011"))
+  #),
+
   #if commented the default values are 0-0
   #-3 to 4 is the range of the OMTF DAQ readout, so should be used e.g. in the DQM data to emulator comparison
   bxMin = cms.int32(0),
   bxMax = cms.int32(0)
 )
 
+#multithreaded version of the emulator (edm::global module), the patterns and configuration are shared between the streams;
+#supports only the OMTFProcessor with GoldenPattern, without the observers (dumpResultToXML, eventCaptureDebug, etc.)
+simOmtfDigisGlobal = cms.EDProducer("L1TMuonOverlapPhase1TrackProducerGlobal",
+                                    **simOmtfDigis.parameters_())
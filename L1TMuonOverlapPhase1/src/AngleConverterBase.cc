@@ -14,8 +14,10 @@
 #include "DataFormats/L1DTTrackFinder/interface/L1MuDTChambThContainer.h"
 #include "DataFormats/RPCDigi/interface/RPCDigi.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include <cmath>
+#include <sstream>
 
 namespace {
   template <typename T>
@@ -47,13 +49,84 @@ AngleConverterBase::~AngleConverterBase() {}
 void AngleConverterBase::checkAndUpdateGeometry(const edm::EventSetup& es,
                                                 const ProcConfigurationBase* config,
                                                 const MuonGeometryTokens& muonGeometryTokens) {
+  this->config = config;
+  nPhiBins = config->nPhiBins();
+
   if (muonGeometryRecordWatcher.check(es)) {
     _georpc = es.getHandle(muonGeometryTokens.rpcGeometryEsToken);
     _geocsc = es.getHandle(muonGeometryTokens.cscGeometryEsToken);
     _geodt = es.getHandle(muonGeometryTokens.dtGeometryEsToken);
+
+    buildGeometryCache();
+    if (config->getAngleConverterCacheValidation())
+      validateGeometryCache();
   }
-  this->config = config;
-  nPhiBins = config->nPhiBins();
+}
+///////////////////////////////////////
+///////////////////////////////////////
+void AngleConverterBase::buildGeometryCache() {
+  cscChamberPhiParams.clear();
+  for (auto chamber : _geocsc->chambers()) {
+    cscChamberPhiParams[chamber->id().rawId()] = computeCscChamberPhiParams(chamber);
+  }
+
+  rpcStripPhi.clear();
+  for (auto roll : _georpc->rolls()) {
+    auto& stripsPhi = rpcStripPhi[roll->id().rawId()];
+    stripsPhi.resize(roll->nstrips() + 1, 0);
+    for (int strip = 1; strip <= roll->nstrips(); strip++)
+      stripsPhi[strip] = (roll->toGlobal(roll->centreOfStrip(strip))).phi();
+  }
+
+  edm::LogVerbatim("OMTFReconstruction") << "AngleConverterBase::buildGeometryCache: cached " << cscChamberPhiParams.size()
+                                         << " CSC chambers and " << rpcStripPhi.size() << " RPC rolls" << std::endl;
+}
+///////////////////////////////////////
+///////////////////////////////////////
+void AngleConverterBase::validateGeometryCache() const {
+  unsigned int checkedCnt = 0;
+  //phiZero = 0 is enough, as the phiZero is applied in the same way for the cached and not cached values
+  for (auto chamber : _geocsc->chambers()) {
+    const CSCDetId& cscId = chamber->id();
+    std::vector<int> halfStrips;
+    for (int halfStrip = 0; halfStrip < 2 * chamber->specs()->nStrips(); halfStrip++)
+      halfStrips.push_back(halfStrip);
+
+    //for the ME1/1 the half strips > 128 are converted with the ring 4 chamber (see getProcessorPhiCsc)
+    if (cscId.station() == 1 && cscId.ring() == 1) {
+      auto chamberME11a = _geocsc->chamber(CSCDetId(cscId.endcap(), cscId.station(), 4, cscId.chamber()));
+      for (int halfStrip = 129; chamberME11a && halfStrip < 128 + 2 * chamberME11a->specs()->nStrips(); halfStrip++)
+        halfStrips.push_back(halfStrip);
+    }
+
+    for (auto halfStrip : halfStrips) {
+      int cachedPhi = getProcessorPhiCsc(0, cscId, halfStrip, true);
+      int phi = getProcessorPhiCsc(0, cscId, halfStrip, false);
+      if (cachedPhi != phi) {
+        std::ostringstream ostr;
+        ostr << "AngleConverterBase::validateGeometryCache: CSC " << cscId << " halfStrip " << halfStrip
+             << " cached phi " << cachedPhi << " phi from geometry " << phi;
+        throw cms::Exception(ostr.str());
+      }
+      checkedCnt++;
+    }
+  }
+
+  for (auto roll : _georpc->rolls()) {
+    for (int strip = 1; strip <= roll->nstrips(); strip++) {
+      if (getRpcStripPhi(roll->id(), strip, true) != getRpcStripPhi(roll->id(), strip, false)) {
+        std::ostringstream ostr;
+        ostr << "AngleConverterBase::validateGeometryCache: RPC " << roll->id() << " strip " << strip
+             << " cached phi different than the phi from geometry";
+        throw cms::Exception(ostr.str());
+      }
+      checkedCnt++;
+    }
+  }
+
+  edm::LogVerbatim("OMTFReconstruction") << "AngleConverterBase::validateGeometryCache: " << checkedCnt
+                                         << " CSC half strips and RPC strips checked, all cached values are correct"
+                                         << std::endl;
 }
 ///////////////////////////////////////
 ///////////////////////////////////////
@@ -84,32 +157,56 @@ int AngleConverterBase::getProcessorPhi(int phiZero,
                                         l1t::tftype part,
                                         const CSCDetId& csc,
                                         const CSCCorrelatedLCTDigi& digi) const {
+  return getProcessorPhiCsc(phiZero, csc, digi.getStrip(), true);  // getStrip() returns halfStrip 0..159
+}
+///////////////////////////////////////
+///////////////////////////////////////
+AngleConverterBase::CscChamberPhiParams AngleConverterBase::computeCscChamberPhiParams(
+    const CSCChamber* chamber) const {
+  CscChamberPhiParams params;
+  const CSCChamberSpecs* cspec = chamber->specs();
+  const CSCLayer* layer = chamber->layer(3);
+  params.order = (layer->centerOfStrip(2).phi() - layer->centerOfStrip(1).phi() > 0) ? 1 : -1;
+  params.stripPhiPitch = cspec->stripPhiPitch();
+  params.phiHalfStrip0 = layer->centerOfStrip(1).phi() - params.order * params.stripPhiPitch / 4.;
+  return params;
+}
+///////////////////////////////////////
+///////////////////////////////////////
+AngleConverterBase::CscChamberPhiParams AngleConverterBase::getCscChamberPhiParams(const CSCDetId& chamberId,
+                                                                                   bool useCache) const {
+  if (useCache) {
+    auto it = cscChamberPhiParams.find(chamberId.rawId());
+    if (it != cscChamberPhiParams.end())
+      return it->second;
+  }
+  return computeCscChamberPhiParams(_geocsc->chamber(chamberId));
+}
+///////////////////////////////////////
+///////////////////////////////////////
+int AngleConverterBase::getProcessorPhiCsc(int phiZero, const CSCDetId& csc, int halfStrip, bool useCache) const {
   const double hsPhiPitch = 2 * M_PI / nPhiBins;
   //
   // get offset for each chamber.
-  // FIXME: These parameters depends on processor and chamber only so may be precomputed and put in map
+  // the geometry dependent parameters of the chamber are precomputed in the buildGeometryCache
   //
 
-  int halfStrip = digi.getStrip();  // returns halfStrip 0..159
-
-  const CSCChamber* chamber = _geocsc->chamber(csc);
+  CSCDetId chamberId = csc;
 
   //in the PhaseIITDRSpring19DR dataset (generated with CMSSW_10_6_1_patch2?), in case of the ME1/1 ring 4 (higher eta) the detId in the CSCCorrelatedLCTDigiCollection is ME1/1 ring 1 (instead ME1/1/4 as it was before),
   //and the digi.getStrip() is increased by 2*64 (i.e. number of half strips in the chamber roll)
   if (csc.station() == 1 && csc.ring() == 1 && halfStrip > 128) {
-    CSCDetId cscME11 = CSCDetId(csc.endcap(), csc.station(), 4, csc.chamber());  //changing ring  to 4
-    chamber = _geocsc->chamber(cscME11);
+    chamberId = CSCDetId(csc.endcap(), csc.station(), 4, csc.chamber());  //changing ring  to 4
   }
 
-  const CSCChamberSpecs* cspec = chamber->specs();
-  const CSCLayer* layer = chamber->layer(3);
-  int order = (layer->centerOfStrip(2).phi() - layer->centerOfStrip(1).phi() > 0) ? 1 : -1;
-  double stripPhiPitch = cspec->stripPhiPitch();
+  const CscChamberPhiParams params = getCscChamberPhiParams(chamberId, useCache);
+  const int order = params.order;
+  const double stripPhiPitch = params.stripPhiPitch;
   double scale = fabs(stripPhiPitch / hsPhiPitch / 2.);
   if (fabs(scale - 1.) < 0.0002)
     scale = 1.;
 
-  double phiHalfStrip0 = layer->centerOfStrip(1).phi() - order * stripPhiPitch / 4.;
+  const double phiHalfStrip0 = params.phiHalfStrip0;
 
   int offsetLoc = lround((phiHalfStrip0) / hsPhiPitch - phiZero);
   offsetLoc = config->foldPhi(offsetLoc);
@@ -165,8 +262,8 @@ int AngleConverterBase::getProcessorPhi(
   if (!roll)
     return dummy;
 
-  double stripPhi1 = (roll->toGlobal(roll->centreOfStrip((int)digi1))).phi();  // note [-pi,pi]
-  double stripPhi2 = (roll->toGlobal(roll->centreOfStrip((int)digi2))).phi();  // note [-pi,pi]
+  double stripPhi1 = getRpcStripPhi(rollId, digi1);  // note [-pi,pi]
+  double stripPhi2 = getRpcStripPhi(rollId, digi2);  // note [-pi,pi]
 
   // the case when the two strips are on different sides of phi = pi
   if (std::signbit(stripPhi1) != std::signbit(stripPhi2) && fabs(stripPhi1) > M_PI / 2.) {
@@ -202,7 +299,7 @@ int AngleConverterBase::getProcessorPhi(unsigned int iProcessor,
   double phi15deg = M_PI / 3. * (processor - 1) + M_PI / 12.;
   // "0" is 15degree moved cyclically to each processor, note [0,2pi]
 
-  double stripPhi = (roll->toGlobal(roll->centreOfStrip((int)digi))).phi();  // note [-pi,pi]
+  double stripPhi = getRpcStripPhi(rollId, digi);  // note [-pi,pi]
 
   // adjust [0,2pi] and [-pi,pi] to get deltaPhi difference properly
   switch (processor) {
@@ -226,6 +323,17 @@ int AngleConverterBase::getProcessorPhi(unsigned int iProcessor,
 }
 ///////////////////////////////////////
 ///////////////////////////////////////
+double AngleConverterBase::getRpcStripPhi(const RPCDetId& rollId, unsigned int strip, bool useCache) const {
+  if (useCache) {
+    auto it = rpcStripPhi.find(rollId.rawId());
+    if (it != rpcStripPhi.end() && strip > 0 && strip < it->second.size())
+      return it->second[strip];
+  }
+  const RPCRoll* roll = _georpc->roll(rollId);
+  return (roll->toGlobal(roll->centreOfStrip((int)strip))).phi();
+}
+///////////////////////////////////////
+///////////////////////////////////////
 EtaValue AngleConverterBase::getGlobalEtaDt(const DTChamberId& detId) const {
   Local2DPoint chamberMiddleLP(0, 0);
   GlobalPoint chamberMiddleGP = _geodt->chamber(detId)->toGlobal(chamberMiddleLP);
@@ -0,0 +1,14 @@
+/*
+ * EventArena.cc
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/EventArena.h"
+
+void EventArena::reset() {
+  //the objects allocated in the buffer keep a copy of the buffer shared_ptr in their allocator,
+  //so use_count() == 1 means that all of them are already destroyed
+  if (buffer.use_count() == 1)
+    buffer->rewind();
+  else
+    buffer = std::make_shared<Buffer>(capacity);
+}
@@ -13,26 +13,91 @@
 #include <iterator>
 #include <utility>
 
+/////////////////////////////////////
+void DigiBuckets::reset(unsigned int nProcessors, int bxFrom, int bxTo) {
+  this->nProcessors = nProcessors;
+  this->bxFrom = bxFrom;
+  this->bxTo = bxTo;
+
+  unsigned int bucketCnt = (bxTo >= bxFrom) ? sides.size() * nProcessors * (bxTo - bxFrom + 1) : 0;
+  buckets.resize(bucketCnt);
+  for (auto& bucket : buckets)
+    bucket.clear();
+}
+
+int DigiBuckets::bucketIndex(unsigned int iProcessor, l1t::tftype procTyp, int bx) const {
+  if (iProcessor >= nProcessors || bx < bxFrom || bx > bxTo)
+    return -1;
+
+  for (unsigned int iSide = 0; iSide < sides.size(); iSide++) {
+    if (sides[iSide] == procTyp)
+      return ((iSide * nProcessors) + iProcessor) * (bxTo - bxFrom + 1) + (bx - bxFrom);
+  }
+  return -1;
+}
+
+const std::vector<unsigned int>* DigiBuckets::get(unsigned int iProcessor,
+                                                  l1t::tftype procTyp,
+                                                  int bxFrom,
+                                                  int bxTo) const {
+  //the buckets keep the collection order only within one bx, so for a range of bx the whole collection must be scanned
+  if (bxFrom != bxTo)
+    return nullptr;
+
+  int iBucket = bucketIndex(iProcessor, procTyp, bxFrom);
+  if (iBucket < 0)
+    return nullptr;
+
+  return &(buckets[iBucket]);
+}
+
 /////////////////////////////////////
 void DtDigiToStubsConverter::loadDigis(const edm::Event& event) {
   event.getByToken(inputTokenDtPh, dtPhDigis);
   event.getByToken(inputTokenDtTh, dtThDigis);
 }
 
+void DtDigiToStubsConverter::bucketDigis(unsigned int nProcessors, int bxFrom, int bxTo) {
+  digiBuckets.reset(nProcessors, bxFrom, bxTo);
+  if (!dtPhDigis || !digiBuckets.isActive())
+    return;
+
+  const auto& digis = *dtPhDigis->getContainer();
+  for (unsigned int iDigi = 0; iDigi < digis.size(); iDigi++) {
+    const auto& digi = digis[iDigi];
+    if (digi.bxNum() < bxFrom || digi.bxNum() > bxTo)
+      continue;
+
+    DTChamberId detid(digi.whNum(), digi.stNum(), digi.scNum() + 1);
+    for (auto procTyp : DigiBuckets::sides) {
+      for (unsigned int iProcessor = 0; iProcessor < nProcessors; iProcessor++) {
+        if (acceptDigi(detid, iProcessor, procTyp))
+          digiBuckets.add(iProcessor, procTyp, digi.bxNum(), iDigi);
+      }
+    }
+  }
+}
+
 void DtDigiToStubsConverter::makeStubs(
     MuonStubPtrs2D& muonStubsInLayers, unsigned int iProcessor, l1t::tftype procTyp, int bxFrom, int bxTo) {
   if (!dtPhDigis)
     return;
 
-  for (const auto& digiIt : *dtPhDigis->getContainer()) {
-    DTChamberId detid(digiIt.whNum(), digiIt.stNum(), digiIt.scNum() + 1);
+  if (auto bucket = digiBuckets.get(iProcessor, procTyp, bxFrom, bxTo)) {
+    const auto& digis = *dtPhDigis->getContainer();
+    for (auto iDigi : *bucket)
+      addDTphiDigi(muonStubsInLayers, digis[iDigi], dtThDigis.product(), iProcessor, procTyp);
+  } else {
+    for (const auto& digiIt : *dtPhDigis->getContainer()) {
+      DTChamberId detid(digiIt.whNum(), digiIt.stNum(), digiIt.scNum() + 1);
 
-    ///Check it the data fits into given processor input range
-    if (!acceptDigi(detid, iProcessor, procTyp))
-      continue;
+      ///Check it the data fits into given processor input range
+      if (!acceptDigi(detid, iProcessor, procTyp))
+        continue;
 
-    if (digiIt.bxNum() >= bxFrom && digiIt.bxNum() <= bxTo)
-      addDTphiDigi(muonStubsInLayers, digiIt, dtThDigis.product(), iProcessor, procTyp);
+      if (digiIt.bxNum() >= bxFrom && digiIt.bxNum() <= bxTo)
+        addDTphiDigi(muonStubsInLayers, digiIt, dtThDigis.product(), iProcessor, procTyp);
+    }
   }
 
   if (!mergePhiAndTheta) {
@@ -47,11 +112,51 @@ void DtDigiToStubsConverter::makeStubs(
 ///////////////////////////////////////
 ///////////////////////////////////////
 
+void CscDigiToStubsConverter::bucketDigis(unsigned int nProcessors, int bxFrom, int bxTo) {
+  digiBuckets.reset(nProcessors, bxFrom, bxTo);
+  cscDigisFlat.clear();
+  if (!cscDigis || !digiBuckets.isActive())
+    return;
+
+  for (auto chamber = cscDigis->begin(); chamber != cscDigis->end(); ++chamber) {
+    unsigned int rawid = (*chamber).first;
+    CSCDetId csc(rawid);
+
+    //the acceptDigi is the same for all digis in the chamber, so it is checked only once
+    std::vector<std::pair<unsigned int, l1t::tftype> > acceptingProcessors;
+    for (auto procTyp : DigiBuckets::sides) {
+      for (unsigned int iProcessor = 0; iProcessor < nProcessors; iProcessor++) {
+        if (acceptDigi(csc, iProcessor, procTyp))
+          acceptingProcessors.emplace_back(iProcessor, procTyp);
+      }
+    }
+
+    if (acceptingProcessors.empty())
+      continue;
+
+    for (auto digi = (*chamber).second.first; digi != (*chamber).second.second; ++digi) {
+      int digiBx = digi->getBX() - config->cscLctCentralBx();
+      if (digiBx < bxFrom || digiBx > bxTo)
+        continue;
+
+      cscDigisFlat.emplace_back(rawid, &(*digi));
+      for (auto& acceptingProcessor : acceptingProcessors)
+        digiBuckets.add(acceptingProcessor.first, acceptingProcessor.second, digiBx, cscDigisFlat.size() - 1);
+    }
+  }
+}
+
 void CscDigiToStubsConverter::makeStubs(
     MuonStubPtrs2D& muonStubsInLayers, unsigned int iProcessor, l1t::tftype procTyp, int bxFrom, int bxTo) {
   if (!cscDigis)
     return;
 
+  if (auto bucket = digiBuckets.get(iProcessor, procTyp, bxFrom, bxTo)) {
+    for (auto iDigi : *bucket)
+      addCSCstubs(muonStubsInLayers, cscDigisFlat[iDigi].first, *(cscDigisFlat[iDigi].second), iProcessor, procTyp);
+    return;
+  }
+
   auto chamber = cscDigis->begin();
   auto chend = cscDigis->end();
   for (; chamber != chend; ++chamber) {
@@ -73,48 +178,98 @@ void CscDigiToStubsConverter::makeStubs(
   }
 }
 
+void RpcDigiToStubsConverter::bucketDigis(unsigned int nProcessors, int bxFrom, int bxTo) {
+  digiBuckets.reset(nProcessors, bxFrom, bxTo);
+  rpcRolls.clear();
+  if (!rpcDigis || !digiBuckets.isActive())
+    return;
+
+  for (auto rollDigis : *rpcDigis) {
+    const RPCDetId& roll = rollDigis.first;
+
+    unsigned int iRoll = rpcRolls.size();
+    bool rollAdded = false;
+    for (auto procTyp : DigiBuckets::sides) {
+      for (unsigned int iProcessor = 0; iProcessor < nProcessors; iProcessor++) {
+        if (!acceptDigi(roll, iProcessor, procTyp))
+          continue;
+
+        if (!rollAdded) {
+          rpcRolls.emplace_back(roll, rollDigis.second);
+          rollAdded = true;
+        }
+
+        for (int bx = bxFrom; bx <= bxTo; bx++) {
+          for (auto pDigi = rollDigis.second.first; pDigi != rollDigis.second.second; pDigi++) {
+            if (pDigi->bx() == bx) {
+              digiBuckets.add(iProcessor, procTyp, bx, iRoll);
+              break;
+            }
+          }
+        }
+      }
+    }
+  }
+}
+
+void RpcDigiToStubsConverter::makeRollStubs(MuonStubPtrs2D& muonStubsInLayers,
+                                            const RPCDetId& roll,
+                                            const RPCDigiCollection::Range& rollDigis,
+                                            unsigned int iProcessor,
+                                            l1t::tftype procTyp,
+                                            int bxFrom,
+                                            int bxTo) {
+  ///To find the clusters we have to copy the digis in chamber to sort them (not optimal).
+  //  for (auto tdigi = rollDigis.first; tdigi != rollDigis.second; tdigi++) { std::cout << "RPC DIGIS: " << roll.rawId()<< " "<<roll<<" digi: " << tdigi->strip() <<" bx: " << tdigi->bx() << std::endl; }
+  std::vector<RPCDigi> digisCopy;
+
+  for (auto pDigi = rollDigis.first; pDigi != rollDigis.second; pDigi++) {
+    if (pDigi->bx() >= bxFrom && pDigi->bx() <= bxTo) {
+      digisCopy.push_back(*pDigi);
+    }
+  }
+
+  std::vector<RpcCluster> clusters = rpcClusterization->getClusters(roll, digisCopy);
+
+  for (auto& cluster : clusters) {
+    addRPCstub(muonStubsInLayers, roll, cluster, iProcessor, procTyp);
+  }
+}
+
 void RpcDigiToStubsConverter::makeStubs(
     MuonStubPtrs2D& muonStubsInLayers, unsigned int iProcessor, l1t::tftype procTyp, int bxFrom, int bxTo) {
   if (!rpcDigis)
     return;
   //LogTrace("l1tOmtfEventPrint") << __FUNCTION__ << ":" << __LINE__ <<" RPC HITS, processor : " << iProcessor<<" "<<std::endl;
 
-  const RPCDigiCollection& rpcDigiCollection = *rpcDigis;
-  for (auto rollDigis : rpcDigiCollection) {
-    RPCDetId roll = rollDigis.first;
-
-    //debug
-    //if(roll.region() != 0  &&  abs(roll.station()) >= 3 && roll.ring() == 1 )
-    /*    {
-      //iRPC
-      for (auto pDigi=rollDigis.second.first; pDigi != rollDigis.second.second; pDigi++) {
-        LogTrace("l1tOmtfEventPrint")<<__FUNCTION__<<":"<<__LINE__<<" roll "<<roll
-            <<" strip "<<pDigi->strip()
-            <<" hasX "<<pDigi->hasX()<<" coordinateX "<<pDigi->coordinateX()<<" hasY "<<pDigi->hasY()<<" coordinateY "<<pDigi->coordinateY()
-            <<" bx "<<pDigi->bx()<<" time "<<pDigi->time()<<" irpc"<<std::endl;
-      }
-      //continue;
-    }*/
+  if (auto bucket = digiBuckets.get(iProcessor, procTyp, bxFrom, bxTo)) {
+    for (auto iRoll : *bucket)
+      makeRollStubs(
+          muonStubsInLayers, rpcRolls[iRoll].first, rpcRolls[iRoll].second, iProcessor, procTyp, bxFrom, bxTo);
+  } else {
+    const RPCDigiCollection& rpcDigiCollection = *rpcDigis;
+    for (auto rollDigis : rpcDigiCollection) {
+      RPCDetId roll = rollDigis.first;
 
-    //LogTrace("l1tOmtfEventPrint") << __FUNCTION__ << ":" << __LINE__ <<" roll "<<roll<<" "<<std::endl;
+      //debug
+      //if(roll.region() != 0  &&  abs(roll.station()) >= 3 && roll.ring() == 1 )
+      /*    {
+        //iRPC
+        for (auto pDigi=rollDigis.second.first; pDigi != rollDigis.second.second; pDigi++) {
+          LogTrace("l1tOmtfEventPrint")<<__FUNCTION__<<":"<<__LINE__<<" roll "<<roll
+              <<" strip "<<pDigi->strip()
+              <<" hasX "<<pDigi->hasX()<<" coordinateX "<<pDigi->coordinateX()<<" hasY "<<pDigi->hasY()<<" coordinateY "<<pDigi->coordinateY()
+              <<" bx "<<pDigi->bx()<<" time "<<pDigi->time()<<" irpc"<<std::endl;
+        }
+        //continue;
+      }*/
 
-    if (!acceptDigi(roll, iProcessor, procTyp))
-      continue;
-
-    ///To find the clusters we have to copy the digis in chamber to sort them (not optimal).
-    //  for (auto tdigi = rollDigis.second.first; tdigi != rollDigis.second.second; tdigi++) { std::cout << "RPC DIGIS: " << roll.rawId()<< " "<<roll<<" digi: " << tdigi->strip() <<" bx: " << tdigi->bx() << std::endl; }
-    std::vector<RPCDigi> digisCopy;
-
-    for (auto pDigi = rollDigis.second.first; pDigi != rollDigis.second.second; pDigi++) {
-      if (pDigi->bx() >= bxFrom && pDigi->bx() <= bxTo) {
-        digisCopy.push_back(*pDigi);
-      }
-    }
+      //LogTrace("l1tOmtfEventPrint") << __FUNCTION__ << ":" << __LINE__ <<" roll "<<roll<<" "<<std::endl;
 
-    std::vector<RpcCluster> clusters = rpcClusterization->getClusters(roll, digisCopy);
+      if (!acceptDigi(roll, iProcessor, procTyp))
+        continue;
 
-    for (auto& cluster : clusters) {
-      addRPCstub(muonStubsInLayers, roll, cluster, iProcessor, procTyp);
+      makeRollStubs(muonStubsInLayers, roll, rollDigis.second, iProcessor, procTyp, bxFrom, bxTo);
     }
   }
 
@@ -151,9 +306,15 @@ MuonStubMakerBase::~MuonStubMakerBase() {}
 ///////////////////////////////////////
 ///////////////////////////////////////
 
-void MuonStubMakerBase::loadAndFilterDigis(const edm::Event& event) {
-  for (auto& digiToStubsConverter : digiToStubsConverters)
+void MuonStubMakerBase::loadAndFilterDigis(const edm::Event& event, int bxFrom, int bxTo) {
+  //the stubs of the previous event are not needed any more (if they are, e.g. kept by an observer, the arena starts a new buffer)
+  stubsArena.reset();
+
+  for (auto& digiToStubsConverter : digiToStubsConverters) {
+    digiToStubsConverter->setStubsArena(&stubsArena);
     digiToStubsConverter->loadDigis(event);
+    digiToStubsConverter->bucketDigis(nProcessors, bxFrom, bxTo);
+  }
 }
 
 void MuonStubMakerBase::buildInputForProcessor(
@@ -5,6 +5,39 @@
 #include <bitset>
 #include <iostream>
 
+void AlgoMuon::assign(const GoldenPatternResult &gpResult,
+                      GoldenPatternBase *gp,
+                      unsigned int refHitNumber,
+                      int bx) {
+  //the firedLayerBitsInBx are not set by the AlgoMuon, so they are created only once
+  if (firedLayerBitsInBx.empty())
+    firedLayerBitsInBx.assign(gp->getConfig()->getBxToProcess(), boost::dynamic_bitset<>(gp->getConfig()->nLayers()));
+
+  this->gpResult = gpResult;
+  gpResultUpt.reset();
+  goldenPatern = gp;
+  goldenPaternUpt = nullptr;
+  m_bx = bx;
+  m_rhitNumb = refHitNumber;
+  killed = false;
+  killedMuons.clear();
+  ptNN = 0;
+  chargeNN = 0;
+}
+
+void AlgoMuon::assignEmpty(unsigned int refHitNumber) {
+  gpResult.reset();
+  gpResultUpt.reset();
+  goldenPatern = nullptr;
+  goldenPaternUpt = nullptr;
+  m_bx = 0;
+  m_rhitNumb = refHitNumber;
+  killed = false;
+  killedMuons.clear();
+  ptNN = 0;
+  chargeNN = 0;
+}
+
 bool AlgoMuon::isValid() const {
   return getPt() > 0;  //should this realy be pt or quality ?? FIXME
 }
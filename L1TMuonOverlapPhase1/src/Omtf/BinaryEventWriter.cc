@@ -0,0 +1,313 @@
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/BinaryEventWriter.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinput.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OmtfName.h"
+
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <bitset>
+#include <cstddef>
+#include <cstring>
+#include <iomanip>
+#include <sstream>
+
+BinaryEventWriter::BinaryEventWriter(const OMTFConfiguration* aOMTFConfig, std::string fName)
+    : omtfConfig(aOMTFConfig), fName(fName), outFile(fName, std::ios::binary | std::ios::trunc) {
+  if (!outFile)
+    throw cms::Exception("BinaryEventWriter: cannot open the file " + fName);
+
+  FileHeader fileHeader;
+  std::memset(&fileHeader, 0, sizeof(fileHeader));
+  fileHeader.fileType = BinaryFileHeader::make(magic, version);
+  fileHeader.pdfValueSize = sizeof(PdfValueType);
+  fileHeader.patternsVersion = aOMTFConfig->patternsVersion();
+  append(buffer, fileHeader);
+
+  buffer.reserve(flushSize * 2);
+}
+
+BinaryEventWriter::~BinaryEventWriter() { flush(true); }
+
+void BinaryEventWriter::flush(bool force) {
+  if (buffer.empty() || (!force && buffer.size() < flushSize))
+    return;
+
+  outFile.write(buffer.data(), buffer.size());
+  buffer.clear();
+  if (force)
+    outFile.flush();
+}
+
+void BinaryEventWriter::appendString(std::vector<char>& buffer, const std::string& str) {
+  append(buffer, (uint32_t)str.size());
+  buffer.insert(buffer.end(), str.begin(), str.end());
+}
+
+void BinaryEventWriter::appendTree(std::vector<char>& buffer,
+                                   const std::string& key,
+                                   const boost::property_tree::ptree& tree) {
+  appendString(buffer, key);
+  appendString(buffer, tree.data());
+  append(buffer, (uint32_t)tree.size());
+  for (auto& child : tree)
+    appendTree(buffer, child.first, child.second);
+}
+
+void BinaryEventWriter::observeProcesorBegin(unsigned int iProcessor, l1t::tftype mtfType) { procDataBuffer.clear(); }
+
+void BinaryEventWriter::addProcesorData(std::string key, boost::property_tree::ptree& procDataTree) {
+  //e.g. the extrapolation data, which are not built by the OMTFProcessor for the binary file
+  if (procDataTree.empty())
+    return;
+
+  std::size_t recordBegin = procDataBuffer.size();
+  append(procDataBuffer, RecordHeader{PROC_DATA, 0});
+  appendTree(procDataBuffer, key, procDataTree);
+
+  //the size of the payload is known only now
+  uint32_t size = procDataBuffer.size() - recordBegin - sizeof(RecordHeader);
+  std::memcpy(procDataBuffer.data() + recordBegin + offsetof(RecordHeader, size), &size, sizeof(size));
+}
+
+void BinaryEventWriter::observeProcesorEmulation(unsigned int iProcessor,
+                                                 l1t::tftype mtfType,
+                                                 const std::shared_ptr<OMTFinput>& input,
+                                                 const AlgoMuons& algoCandidates,
+                                                 const AlgoMuons& gbCandidates,
+                                                 const std::vector<l1t::RegionalMuonCand>& candMuons) {
+  //as in the XMLEventWriter, only the processors with a candidate are dumped
+  if (candMuons.empty())
+    return;
+
+  int endcap = (mtfType == l1t::omtf_neg) ? -1 : ((mtfType == l1t::omtf_pos) ? +1 : 0);
+  appendRecord(buffer, PROCESSOR, ProcessorRecord{iProcessor, endcap});
+
+  buffer.insert(buffer.end(), procDataBuffer.begin(), procDataBuffer.end());
+  procDataBuffer.clear();
+
+  for (unsigned int iLayer = 0; iLayer < omtfConfig->nLayers(); ++iLayer) {
+    for (unsigned int iHit = 0; iHit < input->getMuonStubs()[iLayer].size(); ++iHit) {
+      int hitPhi = input->getPhiHw(iLayer, iHit);
+      if (hitPhi >= (int)omtfConfig->nPhiBins())
+        continue;
+
+      appendRecord(
+          buffer,
+          HIT,
+          HitRecord{iLayer, iHit, hitPhi, OMTFConfiguration::eta2Bits(abs(input->getHitEta(iLayer, iHit)))});
+    }
+  }
+
+  for (auto& algoCand : algoCandidates) {
+    ///Dump only regions, where a candidate was found
+    if (algoCand->isValid()) {
+      AlgoMuonRecord record;
+      record.disc = algoCand->getDisc();
+      record.pdfSum = algoCand->getGpResult().getPdfSum();
+      record.pdfSumUpt = algoCand->getGpResultUpt().getPdfSumUpt();
+      record.charge = algoCand->getCharge();
+      record.etaCode = OMTFConfiguration::eta2Bits(abs(algoCand->getEtaHw()));
+      record.iRefHit = algoCand->getRefHitNumber();
+      record.iRefLayer = algoCand->getRefLayer();
+      record.firedLayerBits = algoCand->getFiredLayerBits();
+      record.nHits = algoCand->getQ();
+      record.patNum = algoCand->getHwPatternNumber();
+      record.phiCode = algoCand->getPhi();
+      record.phiRHit = algoCand->getPhiRHit();
+      record.ptCode = algoCand->getPt();
+      appendRecord(buffer, ALGO_MUON, record);
+    }
+  }
+
+  for (auto& candMuon : candMuons) {
+    CandMuonRecord record;
+    record.hwEta = candMuon.hwEta();
+    record.hwPhi = candMuon.hwPhi();
+    record.hwPt = candMuon.hwPt();
+    record.hwQual = candMuon.hwQual();
+    record.hwSign = candMuon.hwSign();
+    record.hwSignValid = candMuon.hwSignValid();
+    record.hwTrackAddress = candMuon.trackAddress().at(0);
+    record.link = candMuon.link();
+    record.processor = candMuon.processor();
+    record.trackFinderType = candMuon.trackFinderType();
+    appendRecord(buffer, CAND_MUON, record);
+  }
+
+  flush(false);
+}
+
+void BinaryEventWriter::observeEventBegin(const edm::Event& iEvent) {
+  unsigned int eventId = iEvent.id().event();
+  appendRecord(buffer, EVENT, EventRecord{eventId, 2 * eventId});
+}
+
+void BinaryEventWriter::endJob() { flush(true); }
+
+namespace {
+  ///reads the payload of one record
+  class RecordReader {
+  public:
+    RecordReader(const std::vector<char>& payload, const std::string& fileName)
+        : payload(payload), fileName(fileName) {}
+
+    template <class T>
+    T read() {
+      check(sizeof(T));
+      T value;
+      std::memcpy(&value, payload.data() + pos, sizeof(T));
+      pos += sizeof(T);
+      return value;
+    }
+
+    std::string readString() {
+      uint32_t size = read<uint32_t>();
+      check(size);
+      std::string str(payload.data() + pos, size);
+      pos += size;
+      return str;
+    }
+
+    ///adds the tree written by the BinaryEventWriter::appendTree as a child of the parent
+    void readTree(boost::property_tree::ptree& parent) {
+      std::string key = readString();
+      //push_back, as the add_child would split the key on the dots
+      auto& tree = parent.push_back(std::make_pair(key, boost::property_tree::ptree(readString())))->second;
+      uint32_t nChildren = read<uint32_t>();
+      for (uint32_t iChild = 0; iChild < nChildren; ++iChild)
+        readTree(tree);
+    }
+
+  private:
+    void check(std::size_t size) const {
+      if (pos + size > payload.size())
+        throw cms::Exception("BinaryEventWriter::readToTree: " + fileName + ": corrupted record");
+    }
+
+    const std::vector<char>& payload;
+    const std::string& fileName;
+    std::size_t pos = 0;
+  };
+}  // namespace
+
+void BinaryEventWriter::readToTree(const std::string& fileName, boost::property_tree::ptree& tree) {
+  std::ifstream inFile(fileName, std::ios::binary);
+  if (!inFile)
+    throw cms::Exception("BinaryEventWriter::readToTree: cannot open the file " + fileName);
+
+  FileHeader fileHeader;
+  inFile.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+  std::string error = inFile ? fileHeader.fileType.check(magic, version) : "wrong magic";
+  if (error.empty() && fileHeader.pdfValueSize != sizeof(PdfValueType))
+    error = "wrong pdf value size";
+  if (!error.empty())
+    throw cms::Exception("BinaryEventWriter::readToTree: " + fileName + ": " + error);
+
+  //as in the XMLEventWriter
+  std::ostringstream stringStr;
+  stringStr << "0x" << std::hex << std::setfill('0') << std::setw(4) << (fileHeader.patternsVersion & 0xFFFF);
+  tree.put("OMTF.<xmlattr>.version", stringStr.str());
+
+  boost::property_tree::ptree* bxTree = nullptr;
+  boost::property_tree::ptree* procTree = nullptr;
+
+  std::vector<char> payload;
+  RecordHeader recordHeader;
+  while (inFile.read(reinterpret_cast<char*>(&recordHeader), sizeof(recordHeader))) {
+    payload.resize(recordHeader.size);
+    if (!inFile.read(payload.data(), recordHeader.size))
+      throw cms::Exception("BinaryEventWriter::readToTree: " + fileName + ": truncated record");
+
+    RecordReader reader(payload, fileName);
+    if (recordHeader.type == EVENT) {
+      EventRecord record = reader.read<EventRecord>();
+      auto& eventTree = tree.add("OMTF.Event", "");
+      eventTree.add("<xmlattr>.iEvent", record.iEvent);
+
+      bxTree = &(eventTree.add("bx", ""));
+      bxTree->add("<xmlattr>.iBx", record.iBx);
+      procTree = nullptr;
+      continue;
+    }
+
+    if (!bxTree)
+      throw cms::Exception("BinaryEventWriter::readToTree: " + fileName + ": record before the first event");
+
+    if (recordHeader.type == PROCESSOR) {
+      ProcessorRecord record = reader.read<ProcessorRecord>();
+      procTree = &(bxTree->add("Processor", ""));
+
+      OmtfName board(record.iProcessor, record.endcap);
+      procTree->add("<xmlattr>.board", board.name());
+      procTree->add("<xmlattr>.iProcessor", record.iProcessor);
+
+      std::ostringstream positionStr;
+      positionStr << (board.position() == 1 ? "+" : "") << board.position();
+      procTree->add("<xmlattr>.position", positionStr.str());
+      continue;
+    }
+
+    if (!procTree)
+      throw cms::Exception("BinaryEventWriter::readToTree: " + fileName + ": record before the first processor");
+
+    if (recordHeader.type == PROC_DATA) {
+      reader.readTree(*procTree);
+    } else if (recordHeader.type == HIT) {
+      HitRecord record = reader.read<HitRecord>();
+      //the hits are written layer by layer, so the layer is the last child if it already exists
+      boost::property_tree::ptree* layerTree = nullptr;
+      if (!procTree->empty() && procTree->back().first == "Layer" &&
+          procTree->back().second.get<unsigned int>("<xmlattr>.iLayer") == record.iLayer)
+        layerTree = &(procTree->back().second);
+      else {
+        layerTree = &(procTree->add("Layer", ""));
+        layerTree->add("<xmlattr>.iLayer", record.iLayer);
+      }
+
+      auto& hitTree = layerTree->add("Hit", "");
+      hitTree.add("<xmlattr>.iEta", record.iEta);
+      hitTree.add("<xmlattr>.iInput", record.iInput);
+      hitTree.add("<xmlattr>.iPhi", record.iPhi);
+    } else if (recordHeader.type == ALGO_MUON) {
+      AlgoMuonRecord record = reader.read<AlgoMuonRecord>();
+      auto& algoMuonTree = procTree->add("AlgoMuon", "");
+      algoMuonTree.add("<xmlattr>.charge", (int)record.charge);
+      algoMuonTree.add("<xmlattr>.disc", record.disc);
+      algoMuonTree.add("<xmlattr>.pdfSum", record.pdfSum);
+      algoMuonTree.add("<xmlattr>.pdfSumUpt", record.pdfSumUpt);
+      algoMuonTree.add("<xmlattr>.etaCode", (unsigned int)record.etaCode);
+      algoMuonTree.add("<xmlattr>.iRefHit", (unsigned int)record.iRefHit);
+      algoMuonTree.add("<xmlattr>.iRefLayer", (int)record.iRefLayer);
+      algoMuonTree.add("<xmlattr>.layers", std::bitset<18>(record.firedLayerBits));
+      algoMuonTree.add("<xmlattr>.nHits", (int)record.nHits);
+      algoMuonTree.add("<xmlattr>.patNum", (unsigned int)record.patNum);
+      algoMuonTree.add("<xmlattr>.phiCode", (int)record.phiCode);
+      algoMuonTree.add("<xmlattr>.phiRHit", (int)record.phiRHit);
+      algoMuonTree.add("<xmlattr>.ptCode", (int)record.ptCode);
+    } else if (recordHeader.type == CAND_MUON) {
+      CandMuonRecord record = reader.read<CandMuonRecord>();
+      auto& candMuonTree = procTree->add("CandMuon", "");
+      candMuonTree.add("<xmlattr>.hwEta", (int)record.hwEta);
+      candMuonTree.add("<xmlattr>.hwPhi", (int)record.hwPhi);
+      candMuonTree.add("<xmlattr>.hwPt", (int)record.hwPt);
+      candMuonTree.add("<xmlattr>.hwQual", (int)record.hwQual);
+      candMuonTree.add("<xmlattr>.hwSign", (int)record.hwSign);
+      candMuonTree.add("<xmlattr>.hwSignValid", (int)record.hwSignValid);
+      candMuonTree.add("<xmlattr>.hwTrackAddress", std::bitset<29>(record.hwTrackAddress));
+      candMuonTree.add("<xmlattr>.link", (int)record.link);
+      candMuonTree.add("<xmlattr>.processor", (int)record.processor);
+
+      std::ostringstream stringStr;
+      if (record.trackFinderType == l1t::omtf_neg)
+        stringStr << "OMTF_NEG";
+      else if (record.trackFinderType == l1t::omtf_pos)
+        stringStr << "OMTF_POS";
+      else
+        stringStr << record.trackFinderType;
+      candMuonTree.add("<xmlattr>.trackFinderType", stringStr.str());
+    }
+    //the records of unknown type are skipped
+  }
+}
@@ -0,0 +1,29 @@
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/BinaryFileHeader.h"
+
+#include <cstring>
+#include <fstream>
+
+BinaryFileHeader BinaryFileHeader::make(const Magic& magic, uint32_t version) {
+  BinaryFileHeader header;
+  std::memcpy(header.magic, magic, sizeof(Magic));
+  header.version = version;
+  header.byteOrderMark = nativeByteOrderMark;
+  return header;
+}
+
+std::string BinaryFileHeader::check(const Magic& magic, uint32_t version) const {
+  if (std::memcmp(this->magic, magic, sizeof(Magic)) != 0)
+    return "wrong magic";
+  if (byteOrderMark != nativeByteOrderMark)
+    return "wrong byte order";
+  if (this->version != version)
+    return "unsupported version " + std::to_string(this->version);
+  return "";
+}
+
+bool BinaryFileHeader::fileStartsWith(const std::string& fileName, const Magic& magic) {
+  std::ifstream inFile(fileName, std::ios::binary);
+  Magic fileMagic = {};
+  inFile.read(fileMagic, sizeof(Magic));
+  return inFile && std::memcmp(fileMagic, magic, sizeof(Magic)) == 0;
+}
@@ -0,0 +1,126 @@
+/*
+ * ExtrapolFactorsTable.cc
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/ExtrapolFactorsTable.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+void ExtrapolFactorsTable::init(int multiplier, unsigned int nRefLayers, unsigned int nLayers, unsigned int nKeys) {
+  if (multiplier <= 0)
+    throw cms::Exception("ExtrapolFactorsTable: wrong multiplier " + std::to_string(multiplier));
+  if (nRefLayers > maxRefLayers || nLayers > maxLayers || nKeys > maxKeys)
+    throw cms::Exception("ExtrapolFactorsTable: the sizes nRefLayers " + std::to_string(nRefLayers) + " nLayers " +
+                         std::to_string(nLayers) + " nKeys " + std::to_string(nKeys) + " exceed the limits");
+
+  this->multiplier = multiplier;
+  multiplierShift = -1;
+  for (int shift = 0; shift < 31; shift++) {
+    if (multiplier == (1 << shift))
+      multiplierShift = shift;
+  }
+
+  this->nRefLayers = nRefLayers;
+  this->nLayers = nLayers;
+  this->nKeys = nKeys;
+  factors.assign((std::size_t)nRefLayers * nLayers * nKeys, 0);
+}
+
+void ExtrapolFactorsTable::read(const std::string& fileName) {
+  if (isBinaryFile(fileName))
+    readBinary(fileName);
+  else
+    readXml(fileName);
+}
+
+void ExtrapolFactorsTable::readXml(const std::string& fileName) {
+  boost::property_tree::ptree tree;
+  try {
+    boost::property_tree::read_xml(fileName, tree);
+  } catch (boost::property_tree::xml_parser_error& e) {
+    throw cms::Exception("ExtrapolFactorsTable: cannot read the file " + fileName + ": " + e.what());
+  }
+
+  struct Entry {
+    unsigned int iRefLayer, iLayer, key;
+    int value;
+  };
+  std::vector<Entry> entries;
+  unsigned int maxRefLayer = 0, maxLayer = 0, maxKey = 0;
+
+  auto& lutNodes = tree.get_child("ExtrapolationFactors");
+  for (auto& lutNode : lutNodes) {
+    if (lutNode.first != "Lut")
+      continue;
+
+    unsigned int iRefLayer = lutNode.second.get<unsigned int>("<xmlattr>.RefLayer");
+    unsigned int iLayer = lutNode.second.get<unsigned int>("<xmlattr>.Layer");
+    if (iRefLayer >= maxRefLayers || iLayer >= maxLayers)
+      throw cms::Exception("ExtrapolFactorsTable: " + fileName + ": RefLayer " + std::to_string(iRefLayer) + " or Layer " +
+                           std::to_string(iLayer) + " out of range");
+    maxRefLayer = std::max(maxRefLayer, iRefLayer);
+    maxLayer = std::max(maxLayer, iLayer);
+
+    for (auto& valueNode : lutNode.second) {
+      if (valueNode.first != "LutVal")
+        continue;
+      unsigned int key = valueNode.second.get<unsigned int>("<xmlattr>.key");
+      //the maxKey sizes the table
+      if (key >= maxKeys)
+        throw cms::Exception("ExtrapolFactorsTable: " + fileName + ": key " + std::to_string(key) + " out of range");
+      //the factors were kept as double and truncated to int when used, it gives the same values
+      int value = valueNode.second.get<float>("<xmlattr>.value");
+      maxKey = std::max(maxKey, key);
+      entries.push_back({iRefLayer, iLayer, key, value});
+    }
+  }
+
+  init(tree.get<int>("ExtrapolationFactors.<xmlattr>.multiplier"), maxRefLayer + 1, maxLayer + 1, maxKey + 1);
+  for (auto& entry : entries)
+    factors[(entry.iRefLayer * nLayers + entry.iLayer) * nKeys + entry.key] = entry.value;
+}
+
+void ExtrapolFactorsTable::readBinary(const std::string& fileName) {
+  std::ifstream inFile(fileName, std::ios::binary);
+  if (!inFile)
+    throw cms::Exception("ExtrapolFactorsTable: cannot open the file " + fileName);
+
+  Header header;
+  inFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+  std::string error = inFile ? header.fileType.check(magic, version) : "wrong magic";
+
+  if (error.empty()) {
+    init(header.multiplier, header.nRefLayers, header.nLayers, header.nKeys);
+    if (!inFile.read(reinterpret_cast<char*>(factors.data()), factors.size() * sizeof(int32_t)))
+      error = "truncated file";
+  }
+
+  if (!error.empty())
+    throw cms::Exception("ExtrapolFactorsTable: " + fileName + ": " + error);
+}
+
+void ExtrapolFactorsTable::writeBinary(const std::string& fileName) const {
+  std::ofstream outFile(fileName, std::ios::binary | std::ios::trunc);
+  if (!outFile)
+    throw cms::Exception("ExtrapolFactorsTable::writeBinary: cannot open the file " + fileName);
+
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  header.fileType = BinaryFileHeader::make(magic, version);
+  header.multiplier = multiplier;
+  header.nRefLayers = nRefLayers;
+  header.nLayers = nLayers;
+  header.nKeys = nKeys;
+  outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  outFile.write(reinterpret_cast<const char*>(factors.data()), factors.size() * sizeof(int32_t));
+
+  if (!outFile)
+    throw cms::Exception("ExtrapolFactorsTable::writeBinary: writing the file " + fileName + " failed");
+}
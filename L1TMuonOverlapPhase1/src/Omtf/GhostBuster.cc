@@ -2,11 +2,92 @@
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
+#include <algorithm>
+#include <iterator>
 #include <sstream>
 
+namespace {
+
+  const AlgoMuon& getAlgoMuon(const AlgoMuon& algoMuon) { return algoMuon; }
+
+  const AlgoMuon& getAlgoMuon(const AlgoMuons::value_type& algoMuon) { return *algoMuon; }
+
+  //the message is formatted only if it is printed
+  template <class Candidates>
+  void printCandidates(const Candidates& refHitCands, const Candidates& refHitCleanCands, int charge) {
+    if (!edm::isInfoEnabled())
+      return;
+
+    std::stringstream myStr;
+    bool hasCandidates = false;
+    for (unsigned int iRefHit = 0; iRefHit < refHitCands.size(); ++iRefHit) {
+      if (getAlgoMuon(refHitCands[iRefHit]).getQ()) {
+        hasCandidates = true;
+        break;
+      }
+    }
+    if (hasCandidates) {
+      for (unsigned int iRefHit = 0; iRefHit < refHitCands.size(); ++iRefHit) {
+        if (getAlgoMuon(refHitCands[iRefHit]).getQ())
+          myStr << "Ref hit: " << iRefHit << " " << getAlgoMuon(refHitCands[iRefHit]) << std::endl;
+      }
+      myStr << "Selected Candidates with charge: " << charge << std::endl;
+      for (unsigned int iCand = 0; iCand < refHitCleanCands.size(); ++iCand) {
+        myStr << "Cand: " << iCand << " " << getAlgoMuon(refHitCleanCands[iCand]) << std::endl;
+      }
+
+      edm::LogInfo("OMTF Sorter") << myStr.str();
+    }
+  }
+
+}  // namespace
+
+unsigned int GhostBuster::selectSorted(const AlgoMuon* const* cands,
+                                       unsigned int nCands,
+                                       std::array<unsigned int, maxSelectedCands>& selected) const {
+  //gmt phi of the already selected candidates, in the increasing order, so the new candidate must be compared
+  //only with its two neighbours in phi, as they are the closest ones
+  std::array<int, maxSelectedCands> selectedGmtPhi;
+  auto selectedBegin = selectedGmtPhi.begin();
+  auto selectedEnd = selectedGmtPhi.begin();
+
+  unsigned int nSelected = 0;
+  for (unsigned int iCand = 0; iCand < nCands; iCand++) {
+    const AlgoMuon* cand = cands[iCand];
+    if (cand->getQ() <= 0)
+      continue;
+
+    //do not accept candidates with similar phi (any charge combination)
+    //veto window 5deg(=half of logic cone)=5/360*5760=80"logic strips"
+    //veto window 5 degree in GMT scale is 5/360*576=8 units
+    //which one candidate is killed depends only on the order in the refHitCands (the one with smaller index is taken), and this order is assured by the sort above
+    //TODO here the candidate that is killed does not kill other candidates - check if the firmware does the same (KB)
+    int gmtPhi = omtfConfig->procPhiToGmtPhi(cand->getPhi());
+    auto next = std::upper_bound(selectedBegin, selectedEnd, gmtPhi);
+    bool isGhost = (next != selectedEnd && *next - gmtPhi < gmtPhiVetoWindow) ||
+                   (next != selectedBegin && gmtPhi - *(next - 1) < gmtPhiVetoWindow);
+    if (isGhost)
+      continue;
+
+    std::copy_backward(next, selectedEnd, selectedEnd + 1);
+    *next = gmtPhi;
+    ++selectedEnd;
+
+    selected[nSelected++] = iCand;
+
+    if (nSelected >= maxSelectedCands)
+      break;
+  }
+
+  return nSelected;
+}
+
 AlgoMuons GhostBuster::select(AlgoMuons refHitCands, int charge) {
   //edm::LogImportant("OMTFReconstruction")<<"calling "<<__PRETTY_FUNCTION__ <<std::endl;
+  if (refHitCands.size() > maxCands)
+    throw cms::Exception("GhostBuster::select: too many candidates: ") << refHitCands.size();
 
   AlgoMuons refHitCleanCands;
   // Sort candidates with decreased goodness,
@@ -16,50 +97,48 @@ AlgoMuons GhostBuster::select(AlgoMuons refHitCands, int charge) {
 
   std::sort(refHitCands.rbegin(), refHitCands.rend(), customLess);
 
-  for (AlgoMuons::iterator it1 = refHitCands.begin(); it1 != refHitCands.end(); ++it1) {
-    bool isGhost = false;
-    for (AlgoMuons::iterator it2 = refHitCleanCands.begin(); it2 != refHitCleanCands.end(); ++it2) {
-      //do not accept candidates with similar phi (any charge combination)
-      //veto window 5deg(=half of logic cone)=5/360*5760=80"logic strips"
-      //veto window 5 degree in GMT scale is 5/360*576=8 units
-      if (std::abs(omtfConfig->procPhiToGmtPhi((*it1)->getPhi()) - omtfConfig->procPhiToGmtPhi((*it2)->getPhi())) < 8) {
-        //      if(std::abs(it1->getPhi() - it2->getPhi())<5/360.0*nPhiBins){
-        isGhost = true;
-        break;
-        //which one candidate is killed depends only on the order in the refHitCands (the one with smaller index is taken), and this order is assured by the sort above
-        //TODO here the candidate that is killed does not kill other candidates - check if the firmware does the same (KB)
-      }
-    }
-    if ((*it1)->getQ() > 0 && !isGhost)
-      refHitCleanCands.emplace_back(new AlgoMuon(**it1));
+  std::array<const AlgoMuon*, maxCands> cands;
+  for (unsigned int iCand = 0; iCand < refHitCands.size(); iCand++)
+    cands[iCand] = refHitCands[iCand].get();
 
-    if (refHitCleanCands.size() >= 3)
-      break;
-  }
+  std::array<unsigned int, maxSelectedCands> selected;
+  unsigned int nSelected = selectSorted(cands.data(), refHitCands.size(), selected);
 
-  while (refHitCleanCands.size() < 3)
-    refHitCleanCands.emplace_back(new AlgoMuon());
+  for (unsigned int iSelected = 0; iSelected < nSelected; iSelected++)
+    refHitCleanCands.emplace_back(std::make_shared<AlgoMuon>(*refHitCands[selected[iSelected]]));
 
-  std::stringstream myStr;
-  bool hasCandidates = false;
-  for (unsigned int iRefHit = 0; iRefHit < refHitCands.size(); ++iRefHit) {
-    if (refHitCands[iRefHit]->getQ()) {
-      hasCandidates = true;
-      break;
-    }
-  }
-  for (unsigned int iRefHit = 0; iRefHit < refHitCands.size(); ++iRefHit) {
-    if (refHitCands[iRefHit]->getQ())
-      myStr << "Ref hit: " << iRefHit << " " << refHitCands[iRefHit] << std::endl;
-  }
-  myStr << "Selected Candidates with charge: " << charge << std::endl;
-  for (unsigned int iCand = 0; iCand < refHitCleanCands.size(); ++iCand) {
-    myStr << "Cand: " << iCand << " " << refHitCleanCands[iCand] << std::endl;
-  }
+  while (refHitCleanCands.size() < maxSelectedCands)
+    refHitCleanCands.emplace_back(std::make_shared<AlgoMuon>());
 
-  if (hasCandidates)
-    edm::LogInfo("OMTF Sorter") << myStr.str();
+  printCandidates(refHitCands, refHitCleanCands, charge);
 
   // update refHitCands with refHitCleanCands
   return refHitCleanCands;
 }
+
+void GhostBuster::select(std::vector<AlgoMuon>& refHitCands, std::vector<AlgoMuon>& selectedCands, int charge) {
+  if (refHitCands.size() > maxCands)
+    throw cms::Exception("GhostBuster::select: too many candidates: ") << refHitCands.size();
+
+  //the pointers are sorted, so the refHitCands stay in the order of the refHits
+  std::array<const AlgoMuon*, maxCands> cands;
+  for (unsigned int iCand = 0; iCand < refHitCands.size(); iCand++)
+    cands[iCand] = &refHitCands[iCand];
+
+  auto candsEnd = cands.begin() + refHitCands.size();
+  std::sort(std::make_reverse_iterator(candsEnd), cands.rend(), [](const AlgoMuon* a, const AlgoMuon* b) {
+    return (*a) < (*b);
+  });
+
+  std::array<unsigned int, maxSelectedCands> selected;
+  unsigned int nSelected = selectSorted(cands.data(), refHitCands.size(), selected);
+
+  selectedCands.resize(maxSelectedCands);
+  for (unsigned int iSelected = 0; iSelected < nSelected; iSelected++)
+    selectedCands[iSelected] = *cands[selected[iSelected]];
+
+  for (unsigned int iSelected = nSelected; iSelected < maxSelectedCands; iSelected++)
+    selectedCands[iSelected].assignEmpty(0);
+
+  printCandidates(refHitCands, selectedCands, charge);
+}
@@ -2,25 +2,16 @@
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
+#include <algorithm>
+#include <array>
+#include <iterator>
 #include <sstream>
 
 namespace {
 
-  struct AlgoMuonEtaFix {
-    AlgoMuonEtaFix(const AlgoMuonPtr& mu) : mu(mu), fixedEta(mu->getEtaHw()) {}
-    const AlgoMuonPtr mu;
-    unsigned int fixedEta;
-    const AlgoMuon* operator -> () {
-      return mu.get();
-    }
-  };
-
-}  // namespace
-
-AlgoMuons GhostBusterPreferRefDt::select(AlgoMuons muonsIN, int charge) {
-  // sorting within GB.
-  auto customLess = [&](const AlgoMuons::value_type& a, const AlgoMuons::value_type& b) -> bool {
+  bool customLess(const OMTFConfiguration* omtfConfig, const AlgoMuon* a, const AlgoMuon* b) {
     if (!a->isValid()) {
       return true;
     }
@@ -44,9 +35,9 @@ AlgoMuons GhostBusterPreferRefDt::select(AlgoMuons muonsIN, int charge) {
       return false;
     else
       return true;
-  };
+  }
 
-  auto customLessByFPLLH = [&](const AlgoMuons::value_type& a, const AlgoMuons::value_type& b) -> bool {
+  bool customLessByFPLLH(const OMTFConfiguration* omtfConfig, const AlgoMuon* a, const AlgoMuon* b) {
     if (!a->isValid()) {
       return true;
     }
@@ -67,9 +58,9 @@ AlgoMuons GhostBusterPreferRefDt::select(AlgoMuons muonsIN, int charge) {
       return false;
     else
       return true;
-  };
+  }
 
-  auto customLessByLLH = [&](const AlgoMuons::value_type& a, const AlgoMuons::value_type& b) -> bool {
+  bool customLessByLLH(const OMTFConfiguration* omtfConfig, const AlgoMuon* a, const AlgoMuon* b) {
     if (!a->isValid()) {
       return true;
     }
@@ -86,10 +77,10 @@ AlgoMuons GhostBusterPreferRefDt::select(AlgoMuons muonsIN, int charge) {
       return false;
     else
       return true;
-  };
+  }
 
-  auto customByRefLayer = [&](const AlgoMuons::value_type& a, const AlgoMuons::value_type& b)->bool {
-    if(!a->isValid()) {
+  bool customByRefLayer(const OMTFConfiguration* omtfConfig, const AlgoMuon* a, const AlgoMuon* b) {
+    if (!a->isValid()) {
       return true;
     }
     if (!b->isValid()) {
@@ -104,7 +95,7 @@ AlgoMuons GhostBusterPreferRefDt::select(AlgoMuons muonsIN, int charge) {
     }
     // if(a->getQ() > b->getQ())
     //   return false;
-    else if (aRefLayerLogicNum == bRefLayerLogicNum && a->getDisc() > b->getDisc()) //TODO how about getPdfSumUpt ????
+    else if (aRefLayerLogicNum == bRefLayerLogicNum && a->getDisc() > b->getDisc())  //TODO how about getPdfSumUpt ????
       return false;
     else if (aRefLayerLogicNum == bRefLayerLogicNum && a->getDisc() == b->getDisc() &&
              a->getPatternNumber() > b->getPatternNumber())
@@ -114,56 +105,144 @@ AlgoMuons GhostBusterPreferRefDt::select(AlgoMuons muonsIN, int charge) {
       return false;
     else
       return true;
-  };
+  }
+
+}  // namespace
 
+GhostBusterPreferRefDt::GhostBusterPreferRefDt(const OMTFConfiguration* omtfConfig) : omtfConfig(omtfConfig) {
   if (omtfConfig->getGhostBusterType() == "byLLH")
-    std::sort(muonsIN.rbegin(), muonsIN.rend(), customLessByLLH);
+    compare = customLessByLLH;
   else if (omtfConfig->getGhostBusterType() == "byFPLLH")
-    std::sort(muonsIN.rbegin(), muonsIN.rend(), customLessByFPLLH);
+    compare = customLessByFPLLH;
   else if (omtfConfig->getGhostBusterType() == "byRefLayer")
-    std::sort(muonsIN.rbegin(), muonsIN.rend(), customByRefLayer);
+    compare = customByRefLayer;
   else
-    std::sort(muonsIN.rbegin(), muonsIN.rend(), customLess);
+    compare = customLess;
+}
+
+unsigned int GhostBusterPreferRefDt::selectSorted(AlgoMuon* const* muonsIN,
+                                                  unsigned int nMuons,
+                                                  const std::function<void(unsigned int, unsigned int)>& onKill,
+                                                  std::array<SelectedCand, maxSelectedCands>& selected) const {
+  //the valid candidates ordered by the gmt phi (and by the index in the muonsIN for the same phi),
+  //so the candidates that can be killed by the given one are found with the binary search
+  struct PhiIndex {
+    int gmtPhi;
+    unsigned int iMu;
+    bool operator<(const PhiIndex& o) const { return gmtPhi < o.gmtPhi || (gmtPhi == o.gmtPhi && iMu < o.iMu); }
+  };
+  std::array<PhiIndex, maxCands> phiOrdered;
+  unsigned int nValid = 0;
+  for (unsigned int iMu = 0; iMu < nMuons; iMu++) {
+    if (muonsIN[iMu]->isValid())
+      phiOrdered[nValid++] = {omtfConfig->procPhiToGmtPhi(muonsIN[iMu]->getPhi()), iMu};
+  }
+  std::sort(phiOrdered.begin(), phiOrdered.begin() + nValid);
 
   // actual GhostBusting. Overwrite eta in case of no DT info.
-  std::vector<AlgoMuonEtaFix> refHitCleanCandsFixedEta;
+  unsigned int nSelected = 0;
 
-  for (unsigned int iMu1 = 0; iMu1 < muonsIN.size(); iMu1++) {
-    auto& muIN1 = muonsIN[iMu1];
+  std::array<unsigned int, maxCands> ghosts;
+  for (unsigned int iMu1 = 0; iMu1 < nMuons; iMu1++) {
+    AlgoMuon* muIN1 = muonsIN[iMu1];
     if (!muIN1->isValid() || muIN1->isKilled())
       continue;
 
-    refHitCleanCandsFixedEta.push_back(muIN1);
-    for (unsigned int iMu2 = iMu1+1; iMu2 < muonsIN.size(); iMu2++) {
-      auto& muIN2 = muonsIN[iMu2];
-      if (muIN2->isValid() &&
-          std::abs(omtfConfig->procPhiToGmtPhi(muIN1->getPhi()) - omtfConfig->procPhiToGmtPhi(muIN2->getPhi())) < 8) {
-        //the candidates are sorted, so only the  muIN2 can be killed, as it is "worse" than the muIN1
-        muonsIN[iMu2]->kill();
-        muonsIN[iMu1]->getKilledMuons().emplace_back(muIN2);
-
-        if ((omtfConfig->fwVersion() >= 6) &&
-            ((abs(muIN1->getEtaHw()) == 75 || abs(muIN1->getEtaHw()) == 79 || abs(muIN1->getEtaHw()) == 92)) &&
-            ((abs(muIN2->getEtaHw()) != 75 && abs(muIN2->getEtaHw()) != 79 && abs(muIN2->getEtaHw()) != 92))) {
-
-          refHitCleanCandsFixedEta.back().fixedEta = muIN2->getEtaHw();
+    //the candidates after the first maxSelectedCands are not selected, but they still kill the worse ones
+    SelectedCand* selectedCand = nullptr;
+    if (nSelected < maxSelectedCands) {
+      selectedCand = &selected[nSelected++];
+      selectedCand->iMu = iMu1;
+      selectedCand->fixedEta = muIN1->getEtaHw();
+    }
 
-        }
+    //the candidates in the phi window, the candidates are sorted, so only the ones after the muIN1 can be killed,
+    //as they are "worse" than the muIN1; they are killed in the order of the muonsIN
+    int gmtPhi1 = omtfConfig->procPhiToGmtPhi(muIN1->getPhi());
+    auto first = std::lower_bound(
+        phiOrdered.begin(), phiOrdered.begin() + nValid, PhiIndex{gmtPhi1 - gmtPhiVetoWindow + 1, 0});
+    unsigned int nGhosts = 0;
+    for (auto it = first; it != phiOrdered.begin() + nValid && it->gmtPhi < gmtPhi1 + gmtPhiVetoWindow; ++it) {
+      if (it->iMu > iMu1)
+        ghosts[nGhosts++] = it->iMu;
+    }
+    std::sort(ghosts.begin(), ghosts.begin() + nGhosts);
+
+    for (unsigned int iGhost = 0; iGhost < nGhosts; iGhost++) {
+      unsigned int iMu2 = ghosts[iGhost];
+      AlgoMuon* muIN2 = muonsIN[iMu2];
+      muIN2->kill();
+      if (onKill)
+        onKill(iMu1, iMu2);
+
+      if (selectedCand && (omtfConfig->fwVersion() >= 6) &&
+          ((abs(muIN1->getEtaHw()) == 75 || abs(muIN1->getEtaHw()) == 79 || abs(muIN1->getEtaHw()) == 92)) &&
+          ((abs(muIN2->getEtaHw()) != 75 && abs(muIN2->getEtaHw()) != 79 && abs(muIN2->getEtaHw()) != 92))) {
+        selectedCand->fixedEta = muIN2->getEtaHw();
       }
     }
   }
 
+  return nSelected;
+}
+
+AlgoMuons GhostBusterPreferRefDt::select(AlgoMuons muonsIN, int charge) {
+  if (muonsIN.size() > maxCands)
+    throw cms::Exception("GhostBusterPreferRefDt::select: too many candidates: ") << muonsIN.size();
+
+  // sorting within GB.
+  std::sort(muonsIN.rbegin(),
+            muonsIN.rend(),
+            [this](const AlgoMuons::value_type& a, const AlgoMuons::value_type& b) { return compare(omtfConfig, a.get(), b.get()); });
+
+  std::array<AlgoMuon*, maxCands> muons;
+  for (unsigned int iMu = 0; iMu < muonsIN.size(); iMu++)
+    muons[iMu] = muonsIN[iMu].get();
+
+  std::array<SelectedCand, maxSelectedCands> selected;
+  unsigned int nSelected =
+      selectSorted(muons.data(), muonsIN.size(), [&muonsIN](unsigned int iMu1, unsigned int iMu2) {
+        muonsIN[iMu1]->getKilledMuons().emplace_back(muonsIN[iMu2]);
+      }, selected);
+
   // fill outgoing collection
   AlgoMuons refHitCleanCands;
-  for (const auto& mu : refHitCleanCandsFixedEta) {
-    refHitCleanCands.emplace_back(new AlgoMuon( *(mu.mu) ));
-    refHitCleanCands.back()->setEta(mu.fixedEta);
-    if (refHitCleanCands.size() >= 3)
-      break;
+  for (unsigned int iSelected = 0; iSelected < nSelected; iSelected++) {
+    refHitCleanCands.emplace_back(std::make_shared<AlgoMuon>(*(muonsIN[selected[iSelected].iMu])));
+    refHitCleanCands.back()->setEta(selected[iSelected].fixedEta);
   }
 
-  while (refHitCleanCands.size() < 3)
-    refHitCleanCands.emplace_back(new AlgoMuon());
+  while (refHitCleanCands.size() < maxSelectedCands)
+    refHitCleanCands.emplace_back(std::make_shared<AlgoMuon>());
 
   return refHitCleanCands;
 }
+
+void GhostBusterPreferRefDt::select(std::vector<AlgoMuon>& refHitCands,
+                                    std::vector<AlgoMuon>& selectedCands,
+                                    int charge) {
+  if (refHitCands.size() > maxCands)
+    throw cms::Exception("GhostBusterPreferRefDt::select: too many candidates: ") << refHitCands.size();
+
+  //the pointers are sorted, so the refHitCands stay in the order of the refHits
+  std::array<AlgoMuon*, maxCands> muons;
+  for (unsigned int iMu = 0; iMu < refHitCands.size(); iMu++)
+    muons[iMu] = &refHitCands[iMu];
+
+  auto muonsEnd = muons.begin() + refHitCands.size();
+  std::sort(std::make_reverse_iterator(muonsEnd), muons.rend(), [this](const AlgoMuon* a, const AlgoMuon* b) {
+    return compare(omtfConfig, a, b);
+  });
+
+  std::array<SelectedCand, maxSelectedCands> selected;
+  unsigned int nSelected = selectSorted(muons.data(), refHitCands.size(), nullptr, selected);
+
+  selectedCands.resize(maxSelectedCands);
+  for (unsigned int iSelected = 0; iSelected < nSelected; iSelected++) {
+    selectedCands[iSelected] = *(muons[selected[iSelected].iMu]);
+    selectedCands[iSelected].setEta(selected[iSelected].fixedEta);
+  }
+
+  for (unsigned int iSelected = nSelected; iSelected < maxSelectedCands; iSelected++)
+    selectedCands[iSelected].assignEmpty(0);
+}
@@ -6,13 +6,6 @@
 #include <cmath>
 #include <iomanip>
 
-int GoldenPattern::meanDistPhiValue(unsigned int iLayer, unsigned int iRefLayer, int refLayerPhiB) const {
-  //return meanDistPhi[iLayer][iRefLayer][0];
-  return (((meanDistPhi[iLayer][iRefLayer][1] * refLayerPhiB) >> myOmtfConfig->nPdfAddrBits()) +
-          meanDistPhi[iLayer][iRefLayer][0]);
-  //assumes that the meanDistPhi[1] is float alpha from the fit to the phiB-phi distribution multiplied by 2^myOmtfConfig->nPdfAddrBits()
-}
-
 ////////////////////////////////////////////////////
 ////////////////////////////////////////////////////
 int GoldenPattern::propagateRefPhi(int phiRef, int etaRef, unsigned int iRefLayer) {
@@ -0,0 +1,229 @@
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternBank.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstdlib>
+#include <string>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace {
+#if defined(__AVX2__)
+  const unsigned int simdWidth = 8;
+#else
+  const unsigned int simdWidth = 1;
+#endif
+}  // namespace
+
+GoldenPatternBank::GoldenPatternBank(const OMTFConfiguration* omtfConfig, const GoldenPatternVec<GoldenPattern>& gps)
+    : omtfConfig(omtfConfig),
+      patternsCnt(gps.size()),
+      patternsCntPadded((gps.size() + simdWidth - 1) / simdWidth * simdWidth),
+      nLayers(omtfConfig->nLayers()),
+      nPdfBins(omtfConfig->nPdfBins()),
+      nPdfAddrBits(omtfConfig->nPdfAddrBits()),
+      nPhiBins(omtfConfig->nPhiBins()) {
+  if (patternsCntPadded > maxPatterns)
+    throw cms::Exception("GoldenPatternBank: too many patterns: " + std::to_string(patternsCnt));
+
+  unsigned int nRefLayers = omtfConfig->nRefLayers();
+
+  meanDistPhi0.assign(nRefLayers * nLayers * patternsCntPadded, 0);
+  meanDistPhi1.assign(nRefLayers * nLayers * patternsCntPadded, 0);
+  distPhiBitShift.assign(nRefLayers * nLayers * patternsCntPadded, 0);
+  pdf.assign(nRefLayers * nLayers * nPdfBins * patternsCntPadded, 0);
+  emptyPattern.assign(patternsCntPadded, true);
+
+  for (unsigned int iGP = 0; iGP < gps.size(); ++iGP) {
+    auto& gp = gps[iGP];
+    emptyPattern[iGP] = (gp->key().thePt == 0);
+
+    for (unsigned int iRefLayer = 0; iRefLayer < nRefLayers; ++iRefLayer) {
+      for (unsigned int iLayer = 0; iLayer < nLayers; ++iLayer) {
+        unsigned int offset = (iRefLayer * nLayers + iLayer) * patternsCntPadded + iGP;
+        meanDistPhi0[offset] = gp->getMeanDistPhi()[iLayer][iRefLayer][0];
+        meanDistPhi1[offset] = gp->getMeanDistPhi()[iLayer][iRefLayer][1];
+        distPhiBitShift[offset] = gp->getDistPhiBitShift(iLayer, iRefLayer);
+
+        for (unsigned int iBin = 0; iBin < nPdfBins; ++iBin) {
+          pdf[((iRefLayer * nLayers + iLayer) * nPdfBins + iBin) * patternsCntPadded + iGP] =
+              gp->pdfValue(iLayer, iRefLayer, iBin);
+        }
+      }
+    }
+  }
+}
+
+void GoldenPatternBank::processStub(
+    int phiDistBase, int iStub, unsigned int offset, const int* phiMean, int* phiDistMin, int* selectedStub) const {
+#if defined(__AVX2__)
+  const __m256i vBase = _mm256_set1_epi32(phiDistBase);
+  const __m256i vPhiBins = _mm256_set1_epi32(nPhiBins);
+  const __m256i vHalfPhiBins = _mm256_set1_epi32(nPhiBins / 2);
+  const __m256i vMinusHalfPhiBins = _mm256_set1_epi32(-(nPhiBins / 2));
+  const __m256i vStub = _mm256_set1_epi32(iStub);
+
+  for (unsigned int iGP = 0; iGP < patternsCntPadded; iGP += simdWidth) {
+    __m256i phiDist = _mm256_sub_epi32(vBase, _mm256_load_si256(reinterpret_cast<const __m256i*>(phiMean + iGP)));
+
+    //foldPhi
+    phiDist = _mm256_sub_epi32(phiDist, _mm256_and_si256(_mm256_cmpgt_epi32(phiDist, vHalfPhiBins), vPhiBins));
+    phiDist = _mm256_add_epi32(phiDist, _mm256_and_si256(_mm256_cmpgt_epi32(vMinusHalfPhiBins, phiDist), vPhiBins));
+
+    //firmware works on the sign-value, shift must be done on abs(phiDist)
+    __m256i absPhiDist = _mm256_srlv_epi32(
+        _mm256_abs_epi32(phiDist),
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(distPhiBitShift.data() + offset + iGP)));
+    phiDist = _mm256_sign_epi32(absPhiDist, phiDist);
+
+    __m256i vPhiDistMin = _mm256_load_si256(reinterpret_cast<const __m256i*>(phiDistMin + iGP));
+    __m256i closer = _mm256_cmpgt_epi32(_mm256_abs_epi32(vPhiDistMin), absPhiDist);
+
+    _mm256_store_si256(reinterpret_cast<__m256i*>(phiDistMin + iGP), _mm256_blendv_epi8(vPhiDistMin, phiDist, closer));
+    _mm256_store_si256(
+        reinterpret_cast<__m256i*>(selectedStub + iGP),
+        _mm256_blendv_epi8(_mm256_load_si256(reinterpret_cast<const __m256i*>(selectedStub + iGP)), vStub, closer));
+  }
+#else
+  for (unsigned int iGP = 0; iGP < patternsCntPadded; ++iGP) {
+    int phiDist = phiDistBase - phiMean[iGP];
+    if (phiDist > nPhiBins / 2)
+      phiDist -= nPhiBins;
+    else if (phiDist < -nPhiBins / 2)
+      phiDist += nPhiBins;
+
+    //firmware works on the sign-value, shift must be done on abs(phiDist)
+    int sign = phiDist < 0 ? -1 : 1;
+    phiDist = (std::abs(phiDist) >> distPhiBitShift[offset + iGP]) * sign;
+
+    if (std::abs(phiDist) < std::abs(phiDistMin[iGP])) {
+      phiDistMin[iGP] = phiDist;
+      selectedStub[iGP] = iStub;
+    }
+  }
+#endif
+}
+
+void GoldenPatternBank::lookUpPdfValues(unsigned int pdfOffset,
+                                        const int* phiDistMin,
+                                        const int* selectedStub,
+                                        PdfValueType* pdfVals) const {
+  const int pdfMiddle = 1 << (nPdfAddrBits - 1);
+  const bool noHitValueInPdf = omtfConfig->isNoHitValueInPdf();
+
+#if defined(__AVX2__)
+  static_assert(sizeof(PdfValueType) == sizeof(float), "the pdf gather assumes 32 bit PdfValueType");
+
+  const float* pdfLayer = reinterpret_cast<const float*>(pdf.data() + pdfOffset);
+  const __m256i vPdfMiddle = _mm256_set1_epi32(pdfMiddle);
+  const __m256i vPatternsCntPadded = _mm256_set1_epi32(patternsCntPadded);
+  const __m256i vNoStub = _mm256_set1_epi32(-1);
+  const __m256i vNoHitValueInPdf = _mm256_set1_epi32(noHitValueInPdf ? -1 : 0);
+  const __m256i vLanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+
+  for (unsigned int iGP = 0; iGP < patternsCntPadded; iGP += simdWidth) {
+    __m256i vPhiDistMin = _mm256_load_si256(reinterpret_cast<const __m256i*>(phiDistMin + iGP));
+    __m256i noStub =
+        _mm256_cmpeq_epi32(_mm256_load_si256(reinterpret_cast<const __m256i*>(selectedStub + iGP)), vNoStub);
+
+    //the pdf is read for the stubs with abs(phiDist) <= pdfMiddle - 1, and from the bin 0 for the no-hit value
+    __m256i inPdfRange = _mm256_andnot_si256(noStub, _mm256_cmpgt_epi32(vPdfMiddle, _mm256_abs_epi32(vPhiDistMin)));
+    __m256i readMask = _mm256_or_si256(inPdfRange, _mm256_and_si256(noStub, vNoHitValueInPdf));
+
+    __m256i pdfBin = _mm256_andnot_si256(noStub, _mm256_add_epi32(vPhiDistMin, vPdfMiddle));
+    __m256i index = _mm256_add_epi32(_mm256_mullo_epi32(pdfBin, vPatternsCntPadded),
+                                     _mm256_add_epi32(vLanes, _mm256_set1_epi32(iGP)));
+
+    //the masked-out lanes are not read, so the index out of the pdf range does not matter for them
+    __m256 vPdfVals =
+        _mm256_mask_i32gather_ps(_mm256_setzero_ps(), pdfLayer, index, _mm256_castsi256_ps(readMask), sizeof(float));
+    _mm256_store_ps(reinterpret_cast<float*>(pdfVals + iGP), vPdfVals);
+  }
+#else
+  for (unsigned int iGP = 0; iGP < patternsCnt; ++iGP) {
+    if (selectedStub[iGP] < 0)
+      pdfVals[iGP] = noHitValueInPdf ? pdf[pdfOffset + iGP] : 0;
+    else if (std::abs(phiDistMin[iGP]) > pdfMiddle - 1)
+      pdfVals[iGP] = 0;
+    else
+      pdfVals[iGP] = pdf[pdfOffset + (phiDistMin[iGP] + pdfMiddle) * patternsCntPadded + iGP];
+  }
+#endif
+}
+
+void GoldenPatternBank::process1Layer1RefLayer(OMTFProcessingContext& context,
+                                               unsigned int procIndx,
+                                               unsigned int iRefHit,
+                                               unsigned int iRefLayer,
+                                               unsigned int iLayer,
+                                               const MuonStubPtrsView& layerStubs,
+                                               const std::vector<int>& extrapolatedPhi,
+                                               const MuonStubPtr& refStub) const {
+  const unsigned int offset = (iRefLayer * nLayers + iLayer) * patternsCntPadded;
+  const unsigned int pdfOffset = (iRefLayer * nLayers + iLayer) * nPdfBins * patternsCntPadded;
+
+  alignas(32) int phiMean[maxPatterns];
+  alignas(32) int phiDistMin[maxPatterns];
+  alignas(32) int selectedStub[maxPatterns];
+
+  const int refPhiB = refStub->phiBHw;
+  for (unsigned int iGP = 0; iGP < patternsCntPadded; ++iGP) {
+    //as in the GoldenPattern::meanDistPhiValue
+    phiMean[iGP] = ((meanDistPhi1[offset + iGP] * refPhiB) >> nPdfAddrBits) + meanDistPhi0[offset + iGP];
+    phiDistMin[iGP] = nPhiBins;  //"infinite" value for the beginning
+    selectedStub[iGP] = -1;
+  }
+
+  const bool bendingLayer = omtfConfig->isBendingLayer(iLayer);
+
+  //phi ref hit for the bending layer set to 0, since it should not be included in the phiDist
+  int phiRefHit = (refStub && !bendingLayer) ? refStub->phiHw : 0;
+
+  for (unsigned int iStub = 0; iStub < layerStubs.size(); iStub++) {
+    auto& stub = layerStubs[iStub];
+    if (!stub)  //empty pointer
+      continue;
+
+    //rejecting phiB of the low quality DT stubs is done in the OMTFInputMaker
+    int hitPhi = bendingLayer ? stub->phiBHw : stub->phiHw;
+
+    if (hitPhi >= nPhiBins)
+      continue;
+
+    processStub(hitPhi - extrapolatedPhi[iStub] - phiRefHit, iStub, offset, phiMean, phiDistMin, selectedStub);
+  }
+
+  alignas(32) PdfValueType pdfVals[maxPatterns];
+  lookUpPdfValues(pdfOffset, phiDistMin, selectedStub, pdfVals);
+
+  const int pdfMiddle = 1 << (nPdfAddrBits - 1);
+
+  for (unsigned int iGP = 0; iGP < patternsCnt; ++iGP) {
+    if (emptyPattern[iGP])
+      continue;
+
+    auto& gpResult = context.getResults(iGP)[procIndx][iRefHit];
+
+    if (selectedStub[iGP] < 0) {
+      StubResult stubResult(pdfVals[iGP], false, nPhiBins, iLayer, MuonStubPtr());
+      gpResult.setStubResult(iLayer, stubResult);
+      continue;
+    }
+
+    const MuonStubPtr& stub = layerStubs[selectedStub[iGP]];
+
+    ///in firmware here the arithmetic "value and sign" is used, therefore the range is -63 +63, and not -64 +63
+    if (std::abs(phiDistMin[iGP]) > pdfMiddle - 1) {
+      StubResult stubResult(0, false, phiDistMin[iGP] + pdfMiddle, iLayer, stub);
+      gpResult.setStubResult(iLayer, stubResult);
+      continue;
+    }
+
+    int pdfBin = phiDistMin[iGP] + pdfMiddle;
+    PdfValueType pdfVal = pdfVals[iGP];
+    StubResult stubResult(pdfVal > 0 ? pdfVal : 0, pdfVal > 0, pdfBin, iLayer, stub);
+    gpResult.setStubResult(iLayer, stubResult);
+  }
+}
@@ -2,6 +2,7 @@
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include <iostream>
 #include <ostream>
@@ -10,6 +11,16 @@
 
 ////////////////////////////////////////////
 ////////////////////////////////////////////
+namespace {
+  //the getLogicToLogic().at() threw for a layer without the connected layer,
+  //the getConnectedLayer() returns -1 then, which would be an invalid shift in the firedLayerBits
+  unsigned int getConnectedLayer(const OMTFConfiguration* omtfConfig, unsigned int iLogicLayer) {
+    int connectedLayer = omtfConfig->getConnectedLayer(iLogicLayer);
+    if (connectedLayer < 0)
+      throw cms::Exception("GoldenPatternResult: no connected layer for the logic layer ") << iLogicLayer;
+    return connectedLayer;
+  }
+}  // namespace
 
 ////////////////////////////////////////////
 ////////////////////////////////////////////
@@ -109,7 +120,7 @@ void GoldenPatternResult::reset() {
 //default version
 void GoldenPatternResult::finalise0() {
   for (unsigned int iLogicLayer = 0; iLogicLayer < stubResults.size(); ++iLogicLayer) {
-    unsigned int connectedLayer = omtfConfig->getLogicToLogic().at(iLogicLayer);
+    unsigned int connectedLayer = getConnectedLayer(omtfConfig, iLogicLayer);
     //here we require that in case of the DT layers, both phi and phiB is fired
     if (firedLayerBits & (1 << connectedLayer)) {
       if (firedLayerBits & (1 << iLogicLayer)) {
@@ -117,7 +128,7 @@ void GoldenPatternResult::finalise0() {
         pdfSum += stubResults[iLogicLayer].getPdfVal();
 
         if (omtfConfig->fwVersion() <= 4) {
-          if (!omtfConfig->getBendingLayers().count(iLogicLayer))
+          if (!omtfConfig->isBendingLayer(iLogicLayer))
             //in DT case, the phi and phiB layers are threaded as one, so the firedLayerCnt is increased only for the phi layer
             firedLayerCnt++;
         } else
@@ -156,14 +167,14 @@ void GoldenPatternResult::finalise2() {
   pdfSum = 1.;
   firedLayerCnt = 0;
   for (unsigned int iLogicLayer = 0; iLogicLayer < stubResults.size(); ++iLogicLayer) {
-    unsigned int connectedLayer = omtfConfig->getLogicToLogic().at(iLogicLayer);
+    unsigned int connectedLayer = getConnectedLayer(omtfConfig, iLogicLayer);
     //here we require that in case of the DT layers, both phi and phiB is fired
     if (firedLayerBits & (1 << connectedLayer)) {
       //now in the GoldenPattern::process1Layer1RefLayer the pdf bin 0 is returned when the layer is not fired, so this is 'if' is to assured that this pdf val is not added here
       if (firedLayerBits & (1 << iLogicLayer)) {
         pdfSum *= stubResults[iLogicLayer].getPdfVal();
         //in DT case, the phi and phiB layers are threaded as one, so the firedLayerCnt is increased only for the phi layer
-        if (!omtfConfig->getBendingLayers().count(iLogicLayer))
+        if (!omtfConfig->isBendingLayer(iLogicLayer))
           firedLayerCnt++;
       }
     } else {
@@ -199,7 +210,7 @@ void GoldenPatternResult::finalise3() {
 
 void GoldenPatternResult::finalise5() {
   for (unsigned int iLogicLayer = 0; iLogicLayer < stubResults.size(); ++iLogicLayer) {
-    unsigned int connectedLayer = omtfConfig->getLogicToLogic().at(iLogicLayer);
+    unsigned int connectedLayer = getConnectedLayer(omtfConfig, iLogicLayer);
 
     if (omtfConfig->isBendingLayer(iLogicLayer)) {  //the DT phiB layer is counted only when the phi layer is fired
       if ((firedLayerBits & (1 << iLogicLayer)) && (firedLayerBits & (1 << connectedLayer))) {
@@ -222,7 +233,7 @@ void GoldenPatternResult::finalise5() {
 
 void GoldenPatternResult::finalise6() {
   for (unsigned int iLogicLayer = 0; iLogicLayer < stubResults.size(); ++iLogicLayer) {
-    unsigned int connectedLayer = omtfConfig->getLogicToLogic().at(iLogicLayer);
+    unsigned int connectedLayer = getConnectedLayer(omtfConfig, iLogicLayer);
 
     if (omtfConfig->isBendingLayer(iLogicLayer)) {  //the DT phiB layer is counted only when the phi layer is fired
       if ((firedLayerBits & (1 << iLogicLayer)) && (firedLayerBits & (1 << connectedLayer)) &&
@@ -260,7 +271,7 @@ void GoldenPatternResult::finalise8() {
   for (unsigned int iLogicLayer = 0; iLogicLayer < stubResults.size(); ++iLogicLayer) {
     pdfSum += stubResults[iLogicLayer].getPdfVal();  //pdfSum is counted always
 
-    unsigned int connectedLayer = omtfConfig->getLogicToLogic().at(iLogicLayer);
+    unsigned int connectedLayer = getConnectedLayer(omtfConfig, iLogicLayer);
     if (omtfConfig->isBendingLayer(iLogicLayer)) {  //the DT phiB layer is counted only when the phi layer is fired
       if ((firedLayerBits & (1 << iLogicLayer)) && (firedLayerBits & (1 << connectedLayer))) {
         // && (stubResults[iLogicLayer].getMuonStub()->qualityHw >= 4) this is not needed, as the rejecting the low quality phiB hits is on the input of the algorithm
@@ -281,7 +292,7 @@ void GoldenPatternResult::finalise8() {
 
 void GoldenPatternResult::finalise9() {
   for (unsigned int iLogicLayer = 0; iLogicLayer < stubResults.size(); ++iLogicLayer) {
-    unsigned int connectedLayer = omtfConfig->getLogicToLogic().at(iLogicLayer);
+    unsigned int connectedLayer = getConnectedLayer(omtfConfig, iLogicLayer);
 
     if (omtfConfig->isBendingLayer(iLogicLayer)) {  //the DT phiB layer is counted only when the phi layer is fired
       if (firedLayerBits & (1 << iLogicLayer)) {
@@ -321,7 +332,7 @@ void GoldenPatternResult::finalise9() {
 
 void GoldenPatternResult::finalise10() {
   for (unsigned int iLogicLayer = 0; iLogicLayer < stubResults.size(); ++iLogicLayer) {
-    unsigned int connectedLayer = omtfConfig->getLogicToLogic().at(iLogicLayer);
+    unsigned int connectedLayer = getConnectedLayer(omtfConfig, iLogicLayer);
 
     if (omtfConfig->isBendingLayer(iLogicLayer)) {  //the DT phiB layer is counted only when the phi layer is fired
       if (firedLayerBits & (1 << iLogicLayer)) {
@@ -370,6 +381,61 @@ void GoldenPatternResult::finalise10() {
   //by default result becomes valid here, but can be overwritten later
 }
 
+////////////////////////////////////////////
+////////////////////////////////////////////
+template <int finalizeFunction>
+void GoldenPatternResult::finaliseResults(GoldenPatternResult* results, unsigned int count) {
+  //the finaliseX are defined in this file, so they can be inlined here
+  for (unsigned int iResult = 0; iResult < count; ++iResult) {
+    GoldenPatternResult& result = results[iResult];
+    if constexpr (finalizeFunction == 1)
+      result.finalise1();
+    else if constexpr (finalizeFunction == 2)
+      result.finalise2();
+    else if constexpr (finalizeFunction == 3)
+      result.finalise3();
+    else if constexpr (finalizeFunction == 5)
+      result.finalise5();
+    else if constexpr (finalizeFunction == 6)
+      result.finalise6();
+    else if constexpr (finalizeFunction == 7)
+      result.finalise7();
+    else if constexpr (finalizeFunction == 8)
+      result.finalise8();
+    else if constexpr (finalizeFunction == 9)
+      result.finalise9();
+    else if constexpr (finalizeFunction == 10)
+      result.finalise10();
+    else
+      result.finalise0();
+  }
+}
+
+GoldenPatternResult::FinaliseResults GoldenPatternResult::getFinaliseResults(int finalizeFunction) {
+  switch (finalizeFunction) {
+    case 1:
+      return &finaliseResults<1>;
+    case 2:
+      return &finaliseResults<2>;
+    case 3:
+      return &finaliseResults<3>;
+    case 5:
+      return &finaliseResults<5>;
+    case 6:
+      return &finaliseResults<6>;
+    case 7:
+      return &finaliseResults<7>;
+    case 8:
+      return &finaliseResults<8>;
+    case 9:
+      return &finaliseResults<9>;
+    case 10:
+      return &finaliseResults<10>;
+    default:
+      return &finaliseResults<0>;
+  }
+}
+
 ////////////////////////////////////////////
 ////////////////////////////////////////////
 std::ostream& operator<<(std::ostream& out, const GoldenPatternResult& gpResult) {
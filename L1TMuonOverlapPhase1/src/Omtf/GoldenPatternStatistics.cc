@@ -0,0 +1,39 @@
+/*
+ * GoldenPatternStatistics.cc
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternStatistics.h"
+
+#include <algorithm>
+
+void GoldenPatternStatistics::resize(
+    unsigned int nLayers, unsigned int nRefLayers, unsigned int nBins1, unsigned int nBins2, Storage storage) {
+  extents = {{nLayers, nRefLayers, nBins1, nBins2}};
+  this->storage = storage;
+
+  denseValues.clear();
+  denseValues.shrink_to_fit();
+  tiles.clear();
+  tiles.shrink_to_fit();
+
+  if (storage == Storage::dense) {
+    denseValues.assign(num_elements(), 0);
+    return;
+  }
+
+  tileSize1 = std::max(1u, std::min(tileSize, nBins1));
+  tileSize2 = std::max(1u, std::min(tileSize, nBins2));
+  nTiles1 = (nBins1 + tileSize1 - 1) / tileSize1;
+  nTiles2 = (nBins2 + tileSize2 - 1) / tileSize2;
+  tiles.resize((std::size_t)nLayers * nRefLayers * nTiles1 * nTiles2);
+}
+
+std::size_t GoldenPatternStatistics::allocatedBytes() const {
+  if (storage == Storage::dense)
+    return denseValues.size() * sizeof(ValueType);
+
+  std::size_t bytes = tiles.size() * sizeof(std::vector<ValueType>);
+  for (auto& tile : tiles)
+    bytes += tile.size() * sizeof(ValueType);
+  return bytes;
+}
@@ -0,0 +1,262 @@
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternsBinaryFile.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternWithStat.h"
+
+#include "CondFormats/L1TObjects/interface/L1TMuonOverlapParams.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+  uint64_t align64(uint64_t offset) { return (offset + 63) & ~uint64_t(63); }
+}  // namespace
+
+GoldenPatternsBinaryFile::GoldenPatternsBinaryFile(const std::string& fileName) : fileName(fileName) {
+  int fd = open(fileName.c_str(), O_RDONLY);
+  if (fd < 0)
+    throw cms::Exception("GoldenPatternsBinaryFile: cannot open the file " + fileName);
+
+  struct stat fileStat;
+  if (fstat(fd, &fileStat) != 0 || fileStat.st_size < (off_t)sizeof(Header)) {
+    close(fd);
+    throw cms::Exception("GoldenPatternsBinaryFile: the file " + fileName + " is too short");
+  }
+  size = fileStat.st_size;
+
+  void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  //the mapping is kept after closing the file descriptor
+  close(fd);
+  if (mapped == MAP_FAILED)
+    throw cms::Exception("GoldenPatternsBinaryFile: mmap failed for the file " + fileName);
+  data = static_cast<const char*>(mapped);
+
+  const Header& head = header();
+  std::string error = head.fileType.check(magic, version);
+  if (error.empty()) {
+    if (head.headerSize != sizeof(Header) || head.pdfValueSize != sizeof(PdfValueType))
+      error = "wrong header or pdf value size";
+    else if (head.fileSize != size)
+      error = "wrong file size";
+    else if (head.pdfOffset + (uint64_t)head.nPatterns * head.nLayers * head.nRefLayers *
+                                  (1 << head.nPdfAddrBits) * sizeof(PdfValueType) >
+             size)
+      error = "the arrays exceed the file size";
+    else if (head.keysOffset + (uint64_t)head.nPatterns * sizeof(KeyRecord) > size)
+      error = "the keys exceed the file size";
+    else if (head.nGroups > head.nPatterns)
+      error = "nGroups " + std::to_string(head.nGroups) + " larger than nPatterns";
+  }
+
+  //the groups are used to number the groups of the next files in the XMLConfigReader::readPatterns
+  for (unsigned int iGP = 0; error.empty() && iGP < head.nPatterns; ++iGP) {
+    if (key(iGP).group >= head.nGroups)
+      error = "pattern " + std::to_string(iGP) + " group " + std::to_string(key(iGP).group) + " not below nGroups " +
+              std::to_string(head.nGroups);
+  }
+
+  if (!error.empty()) {
+    munmap(const_cast<char*>(data), size);
+    throw cms::Exception("GoldenPatternsBinaryFile: " + fileName + ": " + error);
+  }
+}
+
+GoldenPatternsBinaryFile::~GoldenPatternsBinaryFile() {
+  if (data)
+    munmap(const_cast<char*>(data), size);
+}
+
+const PdfValueType* GoldenPatternsBinaryFile::thresholds(unsigned int iGP) const {
+  if (!header().hasThresholds)
+    return nullptr;
+  return array<PdfValueType>(header().thresholdsOffset) + iGP * header().nRefLayers;
+}
+
+template <class GoldenPatternType>
+GoldenPatternVec<GoldenPatternType> GoldenPatternsBinaryFile::buildPatterns(const L1TMuonOverlapParams& aConfig,
+                                                                            bool buildEmptyPatterns,
+                                                                            unsigned int firstNumber,
+                                                                            unsigned int firstGroup) const {
+  const Header& head = header();
+  if (head.nLayers != (unsigned int)aConfig.nLayers() || head.nRefLayers != (unsigned int)aConfig.nRefLayers() ||
+      head.nPdfAddrBits != (unsigned int)aConfig.nPdfAddrBits())
+    throw cms::Exception("GoldenPatternsBinaryFile::buildPatterns: " + fileName +
+                         ": nLayers, nRefLayers or nPdfAddrBits different than in the L1TMuonOverlapParams");
+
+  const unsigned int nPdfBins = 1 << head.nPdfAddrBits;
+
+  GoldenPatternVec<GoldenPatternType> aGPs;
+  unsigned int iGPNumber = firstNumber;
+  for (unsigned int iGP = 0; iGP < head.nPatterns; ++iGP) {
+    const KeyRecord& keyRecord = key(iGP);
+    if (keyRecord.pt == 0) {  ///empty GP, as in the XMLConfigReader::buildGP
+      if (buildEmptyPatterns) {
+        Key aKey(keyRecord.etaCode, keyRecord.pt, keyRecord.charge, iGPNumber++);
+        aGPs.emplace_back(
+            std::make_unique<GoldenPatternType>(aKey, head.nLayers, head.nRefLayers, head.nPdfAddrBits));
+      }
+      continue;
+    }
+
+    Key aKey(keyRecord.etaCode, keyRecord.pt, keyRecord.charge, iGPNumber++);
+    aKey.theGroup = firstGroup + keyRecord.group;
+    aKey.theIndexInGroup = keyRecord.indexInGroup;
+    auto aGP = std::make_unique<GoldenPatternType>(aKey, head.nLayers, head.nRefLayers, head.nPdfAddrBits);
+
+    const PdfValueType* gpThresholds = thresholds(iGP);
+    if (gpThresholds && dynamic_cast<GoldenPatternWithThresh*>(aGP.get())) {
+      std::vector<PdfValueType> thresholdsVec(gpThresholds, gpThresholds + head.nRefLayers);
+      dynamic_cast<GoldenPatternWithThresh*>(aGP.get())->setThresholds(thresholdsVec);
+    }
+
+    const int16_t* gpMeanDistPhi = meanDistPhi(iGP);
+    const int16_t* gpDistPhiBitShift = distPhiBitShift(iGP);
+    const PdfValueType* gpPdf = pdf(iGP);
+    for (unsigned int iLayer = 0; iLayer < head.nLayers; ++iLayer) {
+      for (unsigned int iRefLayer = 0; iRefLayer < head.nRefLayers; ++iRefLayer) {
+        unsigned int index = iLayer * head.nRefLayers + iRefLayer;
+        aGP->setMeanDistPhiValue(gpMeanDistPhi[index * 2], iLayer, iRefLayer, 0);
+        aGP->setMeanDistPhiValue(gpMeanDistPhi[index * 2 + 1], iLayer, iRefLayer, 1);
+        aGP->setDistPhiBitShift(gpDistPhiBitShift[index], iLayer, iRefLayer);
+
+        for (unsigned int iBin = 0; iBin < nPdfBins; ++iBin)
+          aGP->setPdfValue(gpPdf[index * nPdfBins + iBin], iLayer, iRefLayer, iBin);
+      }
+    }
+
+    aGPs.emplace_back(std::move(aGP));
+  }
+
+  return aGPs;
+}
+
+template <class GoldenPatternType>
+void GoldenPatternsBinaryFile::write(const GoldenPatternVec<GoldenPatternType>& gps,
+                                     const OMTFConfiguration* omtfConfig,
+                                     const std::string& fileName) {
+  Header head;
+  std::memset(&head, 0, sizeof(head));
+  head.fileType = BinaryFileHeader::make(magic, version);
+  head.headerSize = sizeof(Header);
+  head.pdfValueSize = sizeof(PdfValueType);
+
+  head.nPatterns = gps.size();
+  head.nLayers = omtfConfig->nLayers();
+  head.nRefLayers = omtfConfig->nRefLayers();
+  head.nPdfAddrBits = omtfConfig->nPdfAddrBits();
+  //the thresholds are stored only if the patterns have them and they are not all 0
+  for (auto& gp : gps) {
+    auto gpWithThresh = dynamic_cast<const GoldenPatternWithThresh*>(gp.get());
+    for (unsigned int iRefLayer = 0; gpWithThresh && iRefLayer < head.nRefLayers; ++iRefLayer) {
+      if (gpWithThresh->getThreshold(iRefLayer) != 0)
+        head.hasThresholds = 1;
+    }
+  }
+  head.ptHwMin = 0;
+  head.ptHwMax = 0;
+
+  const unsigned int nPdfBins = 1 << head.nPdfAddrBits;
+  const unsigned int nLayerRefLayer = head.nLayers * head.nRefLayers;
+
+  std::vector<KeyRecord> keys(head.nPatterns);
+  std::vector<PdfValueType> thresholds(head.hasThresholds ? head.nPatterns * head.nRefLayers : 0, 0);
+  std::vector<int16_t> meanDistPhi(head.nPatterns * nLayerRefLayer * 2, 0);
+  std::vector<int16_t> distPhiBitShift(head.nPatterns * nLayerRefLayer, 0);
+  std::vector<PdfValueType> pdf(head.nPatterns * nLayerRefLayer * nPdfBins, 0);
+
+  for (unsigned int iGP = 0; iGP < gps.size(); ++iGP) {
+    const GoldenPattern* gp = dynamic_cast<const GoldenPattern*>(gps[iGP].get());
+    if (!gp)
+      throw cms::Exception("GoldenPatternsBinaryFile::write: the gps are not GoldenPatterns");
+
+    const Key& aKey = gps[iGP]->key();
+    keys[iGP] = {aKey.theEtaCode, aKey.thePt, aKey.theCharge, aKey.theGroup, aKey.theIndexInGroup};
+    //every group has at least one pattern, a larger group is e.g. the setGroup(-1)
+    if (aKey.theGroup >= gps.size())
+      throw cms::Exception("GoldenPatternsBinaryFile::write: pattern " + std::to_string(iGP) + " group " +
+                           std::to_string(aKey.theGroup) + " out of range, the number of patterns is " +
+                           std::to_string(gps.size()));
+    head.nGroups = std::max(head.nGroups, aKey.theGroup + 1);
+    if (aKey.thePt) {
+      head.ptHwMin = head.ptHwMin ? std::min(head.ptHwMin, aKey.thePt) : aKey.thePt;
+      head.ptHwMax = std::max(head.ptHwMax, aKey.thePt);
+    }
+
+    if (head.hasThresholds) {
+      auto gpWithThresh = dynamic_cast<const GoldenPatternWithThresh*>(gp);
+      for (unsigned int iRefLayer = 0; gpWithThresh && iRefLayer < head.nRefLayers; ++iRefLayer)
+        thresholds[iGP * head.nRefLayers + iRefLayer] = gpWithThresh->getThreshold(iRefLayer);
+    }
+
+    for (unsigned int iLayer = 0; iLayer < head.nLayers; ++iLayer) {
+      for (unsigned int iRefLayer = 0; iRefLayer < head.nRefLayers; ++iRefLayer) {
+        unsigned int index = iGP * nLayerRefLayer + iLayer * head.nRefLayers + iRefLayer;
+        meanDistPhi[index * 2] = gp->getMeanDistPhi()[iLayer][iRefLayer][0];
+        meanDistPhi[index * 2 + 1] = gp->getMeanDistPhi()[iLayer][iRefLayer][1];
+        distPhiBitShift[index] = gp->getDistPhiBitShift(iLayer, iRefLayer);
+
+        for (unsigned int iBin = 0; iBin < nPdfBins; ++iBin)
+          pdf[index * nPdfBins + iBin] = gp->pdfValue(iLayer, iRefLayer, iBin);
+      }
+    }
+  }
+
+  head.keysOffset = align64(sizeof(Header));
+  head.thresholdsOffset = align64(head.keysOffset + keys.size() * sizeof(KeyRecord));
+  head.meanDistPhiOffset = align64(head.thresholdsOffset + thresholds.size() * sizeof(PdfValueType));
+  head.distPhiBitShiftOffset = align64(head.meanDistPhiOffset + meanDistPhi.size() * sizeof(int16_t));
+  head.pdfOffset = align64(head.distPhiBitShiftOffset + distPhiBitShift.size() * sizeof(int16_t));
+  head.fileSize = head.pdfOffset + pdf.size() * sizeof(PdfValueType);
+
+  std::ofstream outFile(fileName, std::ios::binary | std::ios::trunc);
+  if (!outFile)
+    throw cms::Exception("GoldenPatternsBinaryFile::write: cannot open the file " + fileName);
+
+  auto writeAt = [&](uint64_t offset, const void* src, std::size_t bytes) {
+    //zero padding up to the offset
+    static const char zeros[64] = {};
+    outFile.write(zeros, offset - outFile.tellp());
+    outFile.write(static_cast<const char*>(src), bytes);
+  };
+
+  outFile.write(reinterpret_cast<const char*>(&head), sizeof(head));
+  writeAt(head.keysOffset, keys.data(), keys.size() * sizeof(KeyRecord));
+  writeAt(head.thresholdsOffset, thresholds.data(), thresholds.size() * sizeof(PdfValueType));
+  writeAt(head.meanDistPhiOffset, meanDistPhi.data(), meanDistPhi.size() * sizeof(int16_t));
+  writeAt(head.distPhiBitShiftOffset, distPhiBitShift.data(), distPhiBitShift.size() * sizeof(int16_t));
+  writeAt(head.pdfOffset, pdf.data(), pdf.size() * sizeof(PdfValueType));
+
+  if (!outFile)
+    throw cms::Exception("GoldenPatternsBinaryFile::write: writing to the file " + fileName + " failed");
+}
+
+template GoldenPatternVec<GoldenPattern> GoldenPatternsBinaryFile::buildPatterns<GoldenPattern>(
+    const L1TMuonOverlapParams& aConfig, bool buildEmptyPatterns, unsigned int firstNumber, unsigned int firstGroup)
+    const;
+
+template GoldenPatternVec<GoldenPatternWithStat> GoldenPatternsBinaryFile::buildPatterns<GoldenPatternWithStat>(
+    const L1TMuonOverlapParams& aConfig, bool buildEmptyPatterns, unsigned int firstNumber, unsigned int firstGroup)
+    const;
+
+template GoldenPatternVec<GoldenPatternWithThresh> GoldenPatternsBinaryFile::buildPatterns<GoldenPatternWithThresh>(
+    const L1TMuonOverlapParams& aConfig, bool buildEmptyPatterns, unsigned int firstNumber, unsigned int firstGroup)
+    const;
+
+template void GoldenPatternsBinaryFile::write(const GoldenPatternVec<GoldenPattern>& gps,
+                                              const OMTFConfiguration* omtfConfig,
+                                              const std::string& fileName);
+
+template void GoldenPatternsBinaryFile::write(const GoldenPatternVec<GoldenPatternWithStat>& gps,
+                                              const OMTFConfiguration* omtfConfig,
+                                              const std::string& fileName);
+
+template void GoldenPatternsBinaryFile::write(const GoldenPatternVec<GoldenPatternWithThresh>& gps,
+                                              const OMTFConfiguration* omtfConfig,
+                                              const std::string& fileName);
@@ -0,0 +1,197 @@
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternsStatFile.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace {
+  std::size_t statSize(const GoldenPatternsStatFile::PatternRecord& record) {
+    return (std::size_t)record.extents[0] * record.extents[1] * record.extents[2] * record.extents[3];
+  }
+}  // namespace
+
+GoldenPatternsStatFile::GoldenPatternsStatFile(const GoldenPatternVec<GoldenPatternWithStat>& gps,
+                                               const std::vector<unsigned int>& eventCntPerGp) {
+  if (eventCntPerGp.size() != gps.size())
+    throw cms::Exception("GoldenPatternsStatFile: eventCntPerGp.size() different than gps.size()");
+
+  for (unsigned int iGP = 0; iGP < gps.size(); ++iGP) {
+    const Key& aKey = gps[iGP]->key();
+    const GoldenPatternWithStat::StatArrayType& statistics = gps[iGP]->getStatistics();
+
+    PatternStat patternStat;
+    patternStat.record = {aKey.theNumber, aKey.thePt, aKey.theCharge, eventCntPerGp[iGP], {}, 0};
+    for (unsigned int iDim = 0; iDim < 4; ++iDim)
+      patternStat.record.extents[iDim] = statistics.shape()[iDim];
+    if (statSize(patternStat.record) > std::numeric_limits<uint32_t>::max())
+      throw cms::Exception("GoldenPatternsStatFile: too many statistics bins, iGP " + std::to_string(iGP));
+
+    const uint32_t* extents = patternStat.record.extents;
+    statistics.forEachNonZero(
+        [&](unsigned int iLayer, unsigned int iRefLayer, unsigned int iBin, unsigned int what, StatValueType count) {
+          uint32_t index = ((iLayer * extents[1] + iRefLayer) * extents[2] + iBin) * extents[3] + what;
+          patternStat.statistics.push_back({index, count});
+        });
+    //the sparse storage gives the bins in the order of the tiles
+    std::sort(patternStat.statistics.begin(),
+              patternStat.statistics.end(),
+              [](const BinCount& a, const BinCount& b) { return a.index < b.index; });
+    patternStat.record.nBins = patternStat.statistics.size();
+
+    patterns.emplace_back(std::move(patternStat));
+  }
+}
+
+GoldenPatternsStatFile::GoldenPatternsStatFile(const std::string& fileName) {
+  std::ifstream inFile(fileName, std::ios::binary);
+  if (!inFile)
+    throw cms::Exception("GoldenPatternsStatFile: cannot open the file " + fileName);
+
+  Header header;
+  inFile.read(reinterpret_cast<char*>(&header), sizeof(header));
+  std::string error = inFile ? header.fileType.check(magic, version) : "wrong magic";
+  if (error.empty() && header.statValueSize != sizeof(StatValueType))
+    error = "wrong statistics value size";
+
+  for (unsigned int iGP = 0; error.empty() && iGP < header.nPatterns; ++iGP) {
+    PatternStat patternStat;
+    if (!inFile.read(reinterpret_cast<char*>(&patternStat.record), sizeof(PatternRecord))) {
+      error = "truncated file";
+      break;
+    }
+
+    if (patternStat.record.nBins > statSize(patternStat.record)) {
+      error = "nBins bigger than the statistics size";
+      break;
+    }
+
+    patternStat.statistics.resize(patternStat.record.nBins);
+    if (!inFile.read(reinterpret_cast<char*>(patternStat.statistics.data()),
+                     patternStat.statistics.size() * sizeof(BinCount))) {
+      error = "truncated file";
+      break;
+    }
+
+    //the addTo relies on the indices being in the statistics range, the add on their order
+    for (unsigned int iBin = 0; error.empty() && iBin < patternStat.statistics.size(); ++iBin) {
+      if (patternStat.statistics[iBin].index >= statSize(patternStat.record) ||
+          (iBin > 0 && patternStat.statistics[iBin].index <= patternStat.statistics[iBin - 1].index))
+        error = "wrong bin index in the pattern " + std::to_string(iGP);
+    }
+
+    patterns.emplace_back(std::move(patternStat));
+  }
+
+  if (!error.empty())
+    throw cms::Exception("GoldenPatternsStatFile: " + fileName + ": " + error);
+}
+
+void GoldenPatternsStatFile::write(const std::string& fileName) const {
+  std::ofstream outFile(fileName, std::ios::binary | std::ios::trunc);
+  if (!outFile)
+    throw cms::Exception("GoldenPatternsStatFile::write: cannot open the file " + fileName);
+
+  Header header;
+  std::memset(&header, 0, sizeof(header));
+  header.fileType = BinaryFileHeader::make(magic, version);
+  header.statValueSize = sizeof(StatValueType);
+  header.nPatterns = patterns.size();
+  outFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  for (auto& patternStat : patterns) {
+    outFile.write(reinterpret_cast<const char*>(&patternStat.record), sizeof(PatternRecord));
+    outFile.write(reinterpret_cast<const char*>(patternStat.statistics.data()),
+                  patternStat.statistics.size() * sizeof(BinCount));
+  }
+
+  if (!outFile)
+    throw cms::Exception("GoldenPatternsStatFile::write: writing the file " + fileName + " failed");
+}
+
+void GoldenPatternsStatFile::add(const GoldenPatternsStatFile& other) {
+  if (patterns.empty()) {
+    patterns = other.patterns;
+    return;
+  }
+
+  if (patterns.size() != other.patterns.size())
+    throw cms::Exception("GoldenPatternsStatFile::add: different number of patterns");
+
+  for (unsigned int iGP = 0; iGP < patterns.size(); ++iGP) {
+    PatternStat& patternStat = patterns[iGP];
+    const PatternStat& otherStat = other.patterns[iGP];
+    if (patternStat.record.number != otherStat.record.number || patternStat.record.pt != otherStat.record.pt ||
+        patternStat.record.charge != otherStat.record.charge ||
+        !std::equal(patternStat.record.extents, patternStat.record.extents + 4, otherStat.record.extents))
+      throw cms::Exception("GoldenPatternsStatFile::add: different pattern or statistics size, iGP " +
+                           std::to_string(iGP));
+
+    patternStat.record.eventCnt += otherStat.record.eventCnt;
+
+    //merging of the two sorted lists, the counts of the same bin are added
+    std::vector<BinCount> merged;
+    merged.reserve(patternStat.statistics.size() + otherStat.statistics.size());
+    auto it = patternStat.statistics.begin();
+    auto otherIt = otherStat.statistics.begin();
+    while (it != patternStat.statistics.end() || otherIt != otherStat.statistics.end()) {
+      BinCount binCount;
+      if (otherIt == otherStat.statistics.end() || (it != patternStat.statistics.end() && it->index < otherIt->index))
+        binCount = *(it++);
+      else if (it == patternStat.statistics.end() || otherIt->index < it->index)
+        binCount = *(otherIt++);
+      else {
+        binCount = {it->index, it->count + otherIt->count};
+        ++it;
+        ++otherIt;
+      }
+
+      if (binCount.count != 0)
+        merged.push_back(binCount);
+    }
+    patternStat.statistics = std::move(merged);
+    patternStat.record.nBins = patternStat.statistics.size();
+  }
+}
+
+void GoldenPatternsStatFile::addTo(GoldenPatternVec<GoldenPatternWithStat>& gps,
+                                   std::vector<unsigned int>& eventCntPerGp) const {
+  if (patterns.size() != gps.size() || eventCntPerGp.size() != gps.size())
+    throw cms::Exception("GoldenPatternsStatFile::addTo: different number of patterns");
+
+  for (unsigned int iGP = 0; iGP < gps.size(); ++iGP) {
+    const PatternStat& patternStat = patterns[iGP];
+    const Key& aKey = gps[iGP]->key();
+    if (patternStat.record.number != aKey.theNumber || patternStat.record.pt != aKey.thePt ||
+        patternStat.record.charge != aKey.theCharge)
+      throw cms::Exception("GoldenPatternsStatFile::addTo: different pattern, iGP " + std::to_string(iGP));
+
+    eventCntPerGp[iGP] += patternStat.record.eventCnt;
+
+    if (aKey.thePt == 0)
+      continue;
+
+    const uint32_t* extents = patternStat.record.extents;
+    const GoldenPatternWithStat::StatArrayType& statistics = gps[iGP]->getStatistics();
+    if (statistics.shape()[0] != extents[0] || statistics.shape()[1] != extents[1])
+      throw cms::Exception("GoldenPatternsStatFile::addTo: different nLayers or nRefLayers, iGP " +
+                           std::to_string(iGP));
+
+    if (statistics.shape()[2] != extents[2] || statistics.shape()[3] != extents[3])
+      gps[iGP]->iniStatisitics(extents[2], extents[3], statistics.getStorage());
+
+    //only the non-zero bins, so the sparse gp statistics allocate only the filled tiles
+    for (auto& binCount : patternStat.statistics) {
+      uint32_t index = binCount.index;
+      unsigned int what = index % extents[3];
+      index /= extents[3];
+      unsigned int iBin = index % extents[2];
+      index /= extents[2];
+      unsigned int iRefLayer = index % extents[1];
+      unsigned int iLayer = index / extents[1];
+      gps[iGP]->updateStat(iLayer, iRefLayer, iBin, what, binCount.count);
+    }
+  }
+}
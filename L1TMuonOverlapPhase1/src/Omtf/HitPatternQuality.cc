@@ -0,0 +1,219 @@
+/*
+ * HitPatternQuality.cc
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/HitPatternQuality.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <algorithm>
+#include <string>
+
+namespace {
+  std::vector<unsigned int> toFiredLayerBits(const std::vector<std::string>& hitPatterns) {
+    std::vector<unsigned int> firedLayerBits;
+    for (auto& hitPattern : hitPatterns) {
+      if (hitPattern.empty() || hitPattern.find_first_not_of("01") != std::string::npos)
+        throw cms::Exception("HitPatternQuality: wrong hit pattern " + hitPattern + ", should be a binary string");
+      firedLayerBits.push_back(std::stoul(hitPattern, nullptr, 2));
+    }
+    return firedLayerBits;
+  }
+
+  HitPatternQuality::Rule makeRule(unsigned int fwVersionMin,
+                                   unsigned int fwVersionMax,
+                                   int absEtaHw,
+                                   unsigned int quality,
+                                   const std::vector<std::string>& hitPatterns) {
+    HitPatternQuality::Rule rule;
+    rule.fwVersionMin = fwVersionMin;
+    rule.fwVersionMax = fwVersionMax;
+    rule.absEtaHw = absEtaHw;
+    rule.quality = quality;
+    rule.firedLayerBits = toFiredLayerBits(hitPatterns);
+    return rule;
+  }
+}  // namespace
+
+HitPatternQuality::HitPatternQuality(const OMTFConfiguration* omtfConfig, const edm::ParameterSet& edmCfg)
+    : omtfConfig(omtfConfig) {
+  std::vector<Rule> rules = defaultRules();
+  std::vector<Rule> configRules = rulesFromParameterSet(edmCfg);
+  rules.insert(rules.end(), configRules.begin(), configRules.end());
+  build(rules);
+
+  edm::LogVerbatim("OMTFReconstruction") << "HitPatternQuality: fwVersion " << omtfConfig->fwVersion() << ", "
+                                         << rules.size() << " rules, of them " << configRules.size()
+                                         << " from the hitPatternQualityRules, " << etaTables.size()
+                                         << " eta dependent tables" << std::endl;
+}
+
+HitPatternQuality::HitPatternQuality(const OMTFConfiguration* omtfConfig, const std::vector<Rule>& rules)
+    : omtfConfig(omtfConfig) {
+  build(rules);
+}
+
+void HitPatternQuality::build(const std::vector<Rule>& rules) {
+  const unsigned int nHitPatterns = 1 << omtfConfig->nLayers();
+  const unsigned int fwVersion = omtfConfig->fwVersion();
+
+  auto isActive = [&](const Rule& rule) { return fwVersion >= rule.fwVersionMin && fwVersion <= rule.fwVersionMax; };
+
+  for (auto& rule : rules) {
+    if (rule.quality > std::numeric_limits<uint8_t>::max())
+      throw cms::Exception("HitPatternQuality: wrong quality " + std::to_string(rule.quality));
+    for (auto firedLayerBits : rule.firedLayerBits) {
+      if (firedLayerBits >= nHitPatterns)
+        throw cms::Exception("HitPatternQuality: hit pattern " + std::to_string(firedLayerBits) +
+                             " has more bits than the nLayers " + std::to_string(omtfConfig->nLayers()));
+    }
+  }
+
+  //the eta dependent tables start from the same rules as the table for any eta
+  std::vector<int> etas;
+  for (auto& rule : rules) {
+    if (isActive(rule) && rule.absEtaHw != anyEta && etaTables.count(rule.absEtaHw) == 0) {
+      etaTables[rule.absEtaHw];
+      etas.push_back(rule.absEtaHw);
+    }
+  }
+
+  auto fill = [&](std::vector<uint8_t>& aTable, int absEtaHw) {
+    aTable.assign(nHitPatterns, defaultQuality);
+    for (auto& rule : rules) {
+      if (!isActive(rule) || (rule.absEtaHw != anyEta && rule.absEtaHw != absEtaHw))
+        continue;
+
+      if (rule.firedLayerBits.empty())
+        std::fill(aTable.begin(), aTable.end(), rule.quality);
+      else
+        for (auto firedLayerBits : rule.firedLayerBits)
+          aTable[firedLayerBits] = rule.quality;
+    }
+  };
+
+  fill(table, anyEta);
+  for (auto absEtaHw : etas)
+    fill(etaTables[absEtaHw], absEtaHw);
+}
+
+std::vector<HitPatternQuality::Rule> HitPatternQuality::rulesFromParameterSet(const edm::ParameterSet& edmCfg) {
+  std::vector<Rule> rules;
+  if (!edmCfg.exists("hitPatternQualityRules"))
+    return rules;
+
+  for (auto& ruleCfg : edmCfg.getParameter<std::vector<edm::ParameterSet> >("hitPatternQualityRules")) {
+    Rule rule;
+    if (ruleCfg.exists("fwVersionMin"))
+      rule.fwVersionMin = ruleCfg.getParameter<unsigned int>("fwVersionMin");
+    if (ruleCfg.exists("fwVersionMax"))
+      rule.fwVersionMax = ruleCfg.getParameter<unsigned int>("fwVersionMax");
+    if (ruleCfg.exists("absEtaHw"))
+      rule.absEtaHw = ruleCfg.getParameter<int>("absEtaHw");
+    rule.quality = ruleCfg.getParameter<unsigned int>("quality");
+    if (ruleCfg.exists("firedLayerBits"))
+      rule.firedLayerBits = toFiredLayerBits(ruleCfg.getParameter<std::vector<std::string> >("firedLayerBits"));
+    rules.push_back(rule);
+  }
+  return rules;
+}
+
+const std::vector<unsigned int>& HitPatternQuality::invalidHitPatternsFw6() {
+  ///the list is hardcoded as in the firmware
+  static const std::vector<unsigned int> invalidHitPatterns = {
+      99840, 34304, 3075, 36928, 12300, 98816, 98944, 33408, 66688, 66176, 7171, 20528, 33856, 35840, 4156, 34880};
+
+  /*
+99840 01100001 1000 000000      011000011000000000
+34304 00100001 1000 000000      001000011000000000
+ 3075 00000011 0000 000011      000000110000000011
+36928 00100100 0001 000000      001001000001000000
+12300 00001100 0000 001100      000011000000001100
+98816 01100000 1000 000000      011000001000000000
+98944 01100000 1010 000000      011000001010000000
+33408 00100000 1010 000000      001000001010000000
+66688 01000001 0010 000000      010000010010000000
+66176 01000000 1010 000000      010000001010000000
+ 7171 00000111 0000 000011      000001110000000011
+20528 00010100 0000 110000      000101000000110000
+33856 00100001 0001 000000      001000010001000000
+35840 00100011 0000 000000      001000110000000000
+ 4156 00000100 0000 111100      000001000000111100
+34880 00100010 0001 000000      001000100001000000
+   */
+  return invalidHitPatterns;
+}
+
+std::vector<HitPatternQuality::Rule> HitPatternQuality::defaultRules() {
+  const unsigned int anyFw = std::numeric_limits<unsigned int>::max();
+
+  std::vector<Rule> rules;
+
+  Rule invalidHitPatterns;
+  invalidHitPatterns.fwVersionMax = 6;
+  invalidHitPatterns.quality = 4;
+  invalidHitPatterns.firedLayerBits = invalidHitPatternsFw6();
+  rules.push_back(invalidHitPatterns);
+
+  //115 is eta 1.25                               rrrrrrrrccccdddddd
+  const std::vector<std::string> eta115HitPatterns = {
+      "100000001110000000", "000000001110000000", "100000000110000000", "100000001100000000",
+      "100000001010000000"};
+  rules.push_back(makeRule(0, 6, 115, 4, eta115HitPatterns));
+  rules.push_back(makeRule(7, anyFw, 115, 1, eta115HitPatterns));
+
+  rules.push_back(makeRule(5,
+                           6,
+                           anyEta,
+                           1,
+                           {
+                               "000000010000000011", "000000100000000011", "000001000000000011", "000010000000000011",
+                               "000100000000000011", "001000000000000011", "010000000000000011", "100000000000000011",
+                               "000000010000001100", "000000100000001100", "000001000000001100", "000010000000001100",
+                               "000100000000001100", "001000000000001100", "010000000000001100", "100000000000001100",
+                               "000000010000110000", "000000100000110000", "000001000000110000", "000010000000110000",
+                               "000100000000110000", "001000000000110000", "010000000000110000", "100000000000110000"}));
+
+  //TODO fix the fwVersion, rrrrrrrrccccdddddd
+  //the quality 1 has a priority over the quality 8, so its rule goes after
+  rules.push_back(makeRule(8,
+                           anyFw,
+                           anyEta,
+                           8,
+                           {
+                               "000000010000000101", "000000010001000001", "000000011000000001", "000000011000000011",
+                               "000000011100000001", "000000100000000011", "000000100001000100", "000000100100000001",
+                               "000000110100000001", "000000111000000000", "000000111000000001", "000000111000000011",
+                               "000001000001000100", "000001010000000001", "000001010000000011", "000001010000000100",
+                               "000001100000000001", "000001100000000100", "000001100000000111", "000001100001000000",
+                               "000001110000000100", "000001110000000101", "000010000000000101", "000010010000000001",
+                               "000010010000000100", "000010010000000101", "000010100000000001", "000010100000000101",
+                               "000011110000000100", "000011110000000101", "000101000000010101", "001000010000000001",
+                               "001000011000000000", "001000011000000001", "001000100000000001", "001000110000000000",
+                               "001001000000000100", "001001100000000100", "001010000000000100", "010000000010000001",
+                               "010000000011000100", "010000010000000001", "010000100000000001", "100000011000000000",
+                               "000000110000000001", "000000010000000011", "000000110000000011", "000011000000001100",
+                               "000011000000000100", "000000010010000001", "000010000000001100", "001001000001000100",
+                               "000001100000000101", "000000100000000101", "000001100000000011", "000001110000000111",
+                               "001000110001000001", "000001110000000011", "001000000001000100", "000000110001000001",
+                               "000001000000000101", "001010000001000000", "001100000001000000", "100000010000000001",
+                               "010000010010000000", "000010100000001100", "001000110000000011", "000001000000001100",
+                               "000000000000111101", "000001100000110001", "000100000000010100", "001000100000000011",
+                               "001000110000000001", "010000100010000001", "000100000000110000"}));
+
+  rules.push_back(makeRule(8,
+                           anyFw,
+                           anyEta,
+                           1,
+                           {
+                               "000000110000000011", "000000100000000011", "000000010000000011", "000000110000000001",
+                               "000001000000001100", "000011000000001100", "000010000000001100", "000011000000000100",
+                               "000000011000000001", "001000010000000001"}));
+
+  //changed from 4 on request from HI
+  rules.push_back(makeRule(0, anyFw, 121, 0, {}));
+
+  return rules;
+}
@@ -51,6 +51,47 @@ void OMTFConfiguration::initCounterMatrices() {
 }
 ///////////////////////////////////////////////
 ///////////////////////////////////////////////
+void OMTFConfiguration::resetLayerTables() {
+  hwToLogicLayerTable.fill(-1);
+  logicToHwLayerTable.fill(-1);
+  logicToLogicTable.fill(-1);
+  bendingLayersTable.fill(false);
+}
+///////////////////////////////////////////////
+///////////////////////////////////////////////
+void OMTFConfiguration::buildLayerTables() {
+  resetLayerTables();
+
+  for (const auto& [hwNumber, logicLayer] : hwToLogicLayer) {
+    if (hwNumber < 0 || hwNumber >= (int)hwLayerNumbersCnt || logicLayer < 0 || logicLayer >= (int)maxLayers)
+      throw cms::Exception("OMTFConfiguration::buildLayerTables: hwNumber ")
+          << hwNumber << " or logicLayer " << logicLayer << " does not fit into the layer tables";
+    hwToLogicLayerTable[hwNumber] = logicLayer;
+  }
+
+  for (const auto& [logicLayer, hwNumber] : logicToHwLayer) {
+    if (logicLayer < 0 || logicLayer >= (int)maxLayers)
+      throw cms::Exception("OMTFConfiguration::buildLayerTables: logicLayer ")
+          << logicLayer << " does not fit into the layer tables";
+    logicToHwLayerTable[logicLayer] = hwNumber;
+  }
+
+  for (const auto& [logicLayer, connectedLayer] : logicToLogic) {
+    if (logicLayer < 0 || logicLayer >= (int)maxLayers || connectedLayer < -1 || connectedLayer >= (int)maxLayers)
+      throw cms::Exception("OMTFConfiguration::buildLayerTables: logicLayer ")
+          << logicLayer << " connectedToLayer " << connectedLayer << " does not fit into the layer tables";
+    logicToLogicTable[logicLayer] = connectedLayer;
+  }
+
+  for (auto logicLayer : bendingLayers) {
+    if (logicLayer < 0 || logicLayer >= (int)maxLayers)
+      throw cms::Exception("OMTFConfiguration::buildLayerTables: bending layer ")
+          << logicLayer << " does not fit into the layer tables";
+    bendingLayersTable[logicLayer] = true;
+  }
+}
+///////////////////////////////////////////////
+///////////////////////////////////////////////
 void OMTFConfiguration::configure(const L1TMuonOverlapParams *omtfParams) {
   rawParams = *omtfParams;
 
@@ -85,6 +126,7 @@ void OMTFConfiguration::configure(const L1TMuonOverlapParams *omtfParams) {
     if (aNode.bendingLayer)
       bendingLayers.insert(aNode.logicNumber);
   }
+  buildLayerTables();
   /////
   refToLogicNumber.resize(nRefLayers());
 
@@ -152,6 +194,22 @@ void OMTFConfiguration::configure(const L1TMuonOverlapParams *omtfParams) {
     }
   }
 
+  layerInputs.assign(nProcessors() * nLogicRegions() * nLayers(), LayerInputs());
+  for (unsigned int iProcessor = 0; iProcessor < nProcessors(); ++iProcessor) {
+    for (unsigned int iLogicRegion = 0; iLogicRegion < nLogicRegions(); ++iLogicRegion) {
+      for (unsigned int iLayer = 0; iLayer < nLayers(); ++iLayer) {
+        auto& aLayerInputs = layerInputs[(iProcessor * nLogicRegions() + iLogicRegion) * nLayers() + iLayer];
+        aLayerInputs.stubLayer = isBendingLayer(iLayer) ? iLayer - 1 : iLayer;
+        aLayerInputs.iFirstInput = connections[iProcessor][iLogicRegion][iLayer].first;
+        //the inputs [iFirstInput, iLastInput] as they were selected in the ProcessorBase::restrictInput,
+        //the iLastInput is unsigned, so for the 0 inputs starting from 0 it wraps and all inputs of the layer are used
+        unsigned int iLastInput = aLayerInputs.iFirstInput + connections[iProcessor][iLogicRegion][iLayer].second - 1;
+        aLayerInputs.nInputs =
+            iLastInput >= aLayerInputs.iFirstInput ? std::size_t(iLastInput) - aLayerInputs.iFirstInput + 1 : 0;
+      }
+    }
+  }
+
   initCounterMatrices();
 
   pdfBins = (1 << rawParams.nPdfAddrBits());
@@ -249,6 +307,14 @@ void OMTFConfiguration::configureFromEdmParameterSet(const edm::ParameterSet &ed
       else
         dumpResultToXML = false;
   }
+
+  //the XMLDumpFileName ending with ".bin" means the BinaryEventWriter, which does not record the processor data
+  //(e.g. the extrapolatedPhi), so they are not built
+  if (dumpResultToXML && edmParameterSet.exists("XMLDumpFileName")) {
+    std::string dumpFileName = edmParameterSet.getParameter<std::string>("XMLDumpFileName");
+    if (dumpFileName.size() > 4 && dumpFileName.compare(dumpFileName.size() - 4, 4, ".bin") == 0)
+      dumpResultToXML = false;
+  }
 }
 
 ///////////////////////////////////////////////
@@ -0,0 +1,12 @@
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessingContext.h"
+
+OMTFProcessingContext::OMTFProcessingContext(const OMTFConfiguration* omtfConfig, unsigned int nPatterns) {
+  ownedResults.reserve(nPatterns);
+  gpResults.reserve(nPatterns);
+  for (unsigned int iGP = 0; iGP < nPatterns; iGP++) {
+    ownedResults.emplace_back(std::make_unique<resultsArrayType>(
+        boost::extents[omtfConfig->processorCnt()][omtfConfig->nTestRefHits()]));
+    GoldenPatternBase::initResults(*ownedResults.back(), omtfConfig);
+    gpResults.push_back(ownedResults.back().get());
+  }
+}
@@ -16,7 +16,9 @@
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/StubResult.h"
 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
 
+#include <algorithm>
 #include <bitset>
 #include <cmath>
 #include <cstdlib>
@@ -24,11 +26,29 @@
 #include <iomanip>
 #include <map>
 #include <string>
+#include <typeinfo>
 #include <vector>
 
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 
+namespace {
+
+  ///the copies of the candidates kept in the context, for the ptAssignment, observers and the IProcessorEmulator interface
+  AlgoMuons makeAlgoMuons(const std::vector<AlgoMuon>& cands) {
+    AlgoMuons algoMuons;
+    algoMuons.reserve(cands.size());
+    for (auto& cand : cands)
+      algoMuons.emplace_back(std::make_shared<AlgoMuon>(cand));
+    return algoMuons;
+  }
+
+  const AlgoMuon* getAlgoMuonPtr(const AlgoMuon& algoMuon) { return &algoMuon; }
+
+  const AlgoMuon* getAlgoMuonPtr(const AlgoMuons::value_type& algoMuon) { return algoMuon.get(); }
+
+}  // namespace
+
 ///////////////////////////////////////////////
 ///////////////////////////////////////////////
 template <class GoldenPatternType>
@@ -37,7 +57,7 @@ OMTFProcessor<GoldenPatternType>::OMTFProcessor(OMTFConfiguration* omtfConfig,
                                                 edm::EventSetup const& evSetup,
                                                 const L1TMuonOverlapParams* omtfPatterns)
     : ProcessorBase<GoldenPatternType>(omtfConfig, omtfPatterns) {
-  init(edmCfg, evSetup);
+  init(edmCfg);
 };
 
 template <class GoldenPatternType>
@@ -46,7 +66,15 @@ OMTFProcessor<GoldenPatternType>::OMTFProcessor(OMTFConfiguration* omtfConfig,
                                                 edm::EventSetup const& evSetup,
                                                 GoldenPatternVec<GoldenPatternType>&& gps)
     : ProcessorBase<GoldenPatternType>(omtfConfig, std::forward<GoldenPatternVec<GoldenPatternType> >(gps)) {
-  init(edmCfg, evSetup);
+  init(edmCfg);
+};
+
+template <class GoldenPatternType>
+OMTFProcessor<GoldenPatternType>::OMTFProcessor(OMTFConfiguration* omtfConfig,
+                                                const edm::ParameterSet& edmCfg,
+                                                GoldenPatternVec<GoldenPatternType>&& gps)
+    : ProcessorBase<GoldenPatternType>(omtfConfig, std::forward<GoldenPatternVec<GoldenPatternType> >(gps)) {
+  init(edmCfg);
 };
 
 template <class GoldenPatternType>
@@ -55,7 +83,7 @@ OMTFProcessor<GoldenPatternType>::~OMTFProcessor() {
 }
 
 template <class GoldenPatternType>
-void OMTFProcessor<GoldenPatternType>::init(const edm::ParameterSet& edmCfg, edm::EventSetup const& evSetup) {
+void OMTFProcessor<GoldenPatternType>::init(const edm::ParameterSet& edmCfg) {
   setSorter(new OMTFSorter<GoldenPatternType>(this->myOmtfConfig->getSorterType()));
   //initialize with the default sorter
 
@@ -72,23 +100,80 @@ void OMTFProcessor<GoldenPatternType>::init(const edm::ParameterSet& edmCfg, edm
 
   edm::LogVerbatim("OMTFReconstruction") << "fwVersion 0x" << hex << this->myOmtfConfig->fwVersion() << std::endl;
 
+  hitPatternQuality = std::make_unique<HitPatternQuality>(this->myOmtfConfig, edmCfg);
+
   useStubQualInExtr = true;
   useEndcapStubsRInExtr = true;
 
   extrapolFactors.resize(2, std::vector<std::map<int, double> >(this->myOmtfConfig->nLayers()));
   extrapolFactorsNorm.resize(2, std::vector<std::map<int, int> >(this->myOmtfConfig->nLayers()));
 
-  if(this->myOmtfConfig->getUsePhiBExtrapolationMB1() || this->myOmtfConfig->getUsePhiBExtrapolationMB2() )
-    loadExtrapolFactors();
+  if(this->myOmtfConfig->getUsePhiBExtrapolationMB1() || this->myOmtfConfig->getUsePhiBExtrapolationMB2() ) {
+    //the XML or the binary file made from it by the omtfExtrapolFactorsConverter,
+    //the producers set the default in their fillDescriptions
+    edm::FileInPath extrapolFactorsFile(ExtrapolFactorsTable::defaultFile);
+    if(edmCfg.exists("extrapolFactorsFile"))
+      extrapolFactorsFile = edmCfg.getParameter<edm::FileInPath>("extrapolFactorsFile");
+
+    loadExtrapolFactors(extrapolFactorsFile.fullPath());
+  }
+
+  //the best candidates are selected already when the results of each pattern are finalised (see processInput),
+  //instead of scanning all results in the sortResults; the output is the same
+  fusedSorting = edmCfg.exists("fusedSorting") ? edmCfg.getParameter<bool>("fusedSorting") : true;
+  edm::LogVerbatim("OMTFReconstruction") << "OMTFProcessor: fusedSorting " << fusedSorting << std::endl;
+
+  selectKernels();
+
+  for (unsigned int procIndx = 0; procIndx < this->myOmtfConfig->processorCnt(); procIndx++)
+    defaultContexts.emplace_back(std::make_unique<OMTFProcessingContext>(this->theGPs));
+}
+
+template <class GoldenPatternType>
+void OMTFProcessor<GoldenPatternType>::selectKernels() {
+  //the kernels call the GoldenPatternType methods non-virtually, so they can be used only if no pattern
+  //is of a type derived from the GoldenPatternType
+  bool exactPatternType = true;
+  for (auto& gp : this->theGPs) {
+    if (typeid(*gp) != typeid(GoldenPatternType))
+      exactPatternType = false;
+  }
+
+  if (exactPatternType) {
+    process1Layer1RefLayerKernel = &GoldenPatternKernel<GoldenPatternType>::process1Layer1RefLayer;
+    finaliseResultsKernel =
+        GoldenPatternResult::getFinaliseResults(this->myOmtfConfig->getGoldenPatternResultFinalizeFunction());
+  } else {
+    process1Layer1RefLayerKernel = &GoldenPatternKernel<GoldenPatternType>::process1Layer1RefLayerVirtual;
+    finaliseResultsKernel = nullptr;
+  }
+
+  edm::LogVerbatim("OMTFReconstruction") << "OMTFProcessor: golden patterns kernel "
+                                         << (exactPatternType ? "devirtualized" : "virtual") << ", finalizeFunction "
+                                         << this->myOmtfConfig->getGoldenPatternResultFinalizeFunction() << std::endl;
 }
 
 template <class GoldenPatternType>
 std::vector<l1t::RegionalMuonCand> OMTFProcessor<GoldenPatternType>::getFinalcandidates(unsigned int iProcessor,
                                                                                         l1t::tftype mtfType,
                                                                                         const AlgoMuons& algoCands) {
+  return makeFinalcandidates(iProcessor, mtfType, algoCands);
+}
+
+template <class GoldenPatternType>
+std::vector<l1t::RegionalMuonCand> OMTFProcessor<GoldenPatternType>::getFinalcandidates(
+    unsigned int iProcessor, l1t::tftype mtfType, const std::vector<AlgoMuon>& algoCands) {
+  return makeFinalcandidates(iProcessor, mtfType, algoCands);
+}
+
+template <class GoldenPatternType>
+template <class AlgoMuonsType>
+std::vector<l1t::RegionalMuonCand> OMTFProcessor<GoldenPatternType>::makeFinalcandidates(
+    unsigned int iProcessor, l1t::tftype mtfType, const AlgoMuonsType& algoCands) {
   std::vector<l1t::RegionalMuonCand> result;
 
-  for (auto& myCand : algoCands) {
+  for (auto& algoCand : algoCands) {
+    const AlgoMuon* myCand = getAlgoMuonPtr(algoCand);
     l1t::RegionalMuonCand candidate;
 
     if(ptAssignment) {
@@ -116,142 +201,7 @@ std::vector<l1t::RegionalMuonCand> OMTFProcessor<GoldenPatternType>::getFinalcan
     else
       candidate.setHwPtUnconstrained(0);
 
-    unsigned int quality = 12;
-    if (this->myOmtfConfig->fwVersion() <= 6)
-      quality = checkHitPatternValidity(myCand->getFiredLayerBits()) ? 0 | (1 << 2) | (1 << 3) : 0 | (1 << 2); //12 : 4
-
-    if (abs(myCand->getEtaHw()) == 115 && //115 is eta 1.25                         rrrrrrrrccccdddddd
-        (static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("100000001110000000").to_ulong() ||
-         static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000001110000000").to_ulong() ||
-         static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("100000000110000000").to_ulong() ||
-         static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("100000001100000000").to_ulong() ||
-         static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("100000001010000000").to_ulong())) {
-      if (this->myOmtfConfig->fwVersion() <= 6)
-        quality = 4;
-      else
-        quality = 1;
-    }
-
-    if (this->myOmtfConfig->fwVersion() >= 5 && this->myOmtfConfig->fwVersion() <= 6) {
-      if (static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000010000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000100000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001000000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010000000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000100000000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000000000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("010000000000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("100000000000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000010000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000100000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000100000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("010000000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("100000000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000010000110000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000100000110000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001000000110000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010000000110000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000100000000110000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000000000110000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("010000000000110000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("100000000000110000").to_ulong())
-        quality = 1;
-    } else if (this->myOmtfConfig->fwVersion() >= 8) {  //TODO fix the fwVersion     rrrrrrrrccccdddddd
-      if (static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000110000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000100000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000010000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000110000000001").to_ulong() ||
-
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000011000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000011000000000100").to_ulong() ||
-
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000011000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000010000000001").to_ulong())
-        quality = 1;
-      else if (
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000010000000101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000010001000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000011000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000011000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000011100000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000100000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000100001000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000100100000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000110100000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000111000000000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000111000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000111000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001000001000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001010000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001010000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001010000000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001100000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001100000000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001100000000111").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001100001000000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001110000000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001110000000101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010000000000101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010010000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010010000000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010010000000101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010100000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010100000000101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000011110000000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000011110000000101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000101000000010101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000010000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000011000000000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000011000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000100000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000110000000000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001001000000000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001001100000000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001010000000000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("010000000010000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("010000000011000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("010000010000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("010000100000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("100000011000000000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000110000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000010000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000110000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000011000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000011000000000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000010010000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001001000001000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001100000000101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000100000000101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001100000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001110000000111").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000110001000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001110000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000000001000100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000110001000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001000000000101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001010000001000000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001100000001000000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("100000010000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("010000010010000000").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000010100000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000110000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001000000001100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000000000000111101").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000001100000110001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000100000000010100").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000100000000011").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("001000110000000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("010000100010000001").to_ulong() ||
-          static_cast<unsigned int>(myCand->getFiredLayerBits()) == std::bitset<18>("000100000000110000").to_ulong())
-        quality = 8;
-    }  //  if (abs(myCand->getEta()) == 121) quality = 4;
-    if (abs(myCand->getEtaHw()) == 121)
-      quality = 0;  // changed from 4 on request from HI
+    unsigned int quality = hitPatternQuality->getQuality(myCand->getFiredLayerBits(), myCand->getEtaHw());
 
     candidate.setHwQual(quality);
 
@@ -275,41 +225,26 @@ std::vector<l1t::RegionalMuonCand> OMTFProcessor<GoldenPatternType>::getFinalcan
 ///////////////////////////////////////////////////////
 template <class GoldenPatternType>
 bool OMTFProcessor<GoldenPatternType>::checkHitPatternValidity(unsigned int hits) {
-  ///FIXME: read the list from configuration so this can be controlled at runtime.
-  std::vector<unsigned int> badPatterns = {
-      99840, 34304, 3075, 36928, 12300, 98816, 98944, 33408, 66688, 66176, 7171, 20528, 33856, 35840, 4156, 34880};
-
-  /*
-99840 01100001 1000 000000      011000011000000000
-34304 00100001 1000 000000      001000011000000000
- 3075 00000011 0000 000011      000000110000000011
-36928 00100100 0001 000000      001001000001000000
-12300 00001100 0000 001100      000011000000001100
-98816 01100000 1000 000000      011000001000000000
-98944 01100000 1010 000000      011000001010000000
-33408 00100000 1010 000000      001000001010000000
-66688 01000001 0010 000000      010000010010000000
-66176 01000000 1010 000000      010000001010000000
- 7171 00000111 0000 000011      000001110000000011
-20528 00010100 0000 110000      000101000000110000
-33856 00100001 0001 000000      001000010001000000
-35840 00100011 0000 000000      001000110000000000
- 4156 00000100 0000 111100      000001000000111100
-34880 00100010 0001 000000      001000100001000000
-   */
-  for (auto aHitPattern : badPatterns) {
-    if (hits == aHitPattern)
-      return false;
-  }
-
-  return true;
+  auto& invalidHitPatterns = HitPatternQuality::invalidHitPatternsFw6();
+  return std::find(invalidHitPatterns.begin(), invalidHitPatterns.end(), hits) == invalidHitPatterns.end();
 }
 ///////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////
 template <class GoldenPatternType>
 AlgoMuons OMTFProcessor<GoldenPatternType>::sortResults(unsigned int iProcessor, l1t::tftype mtfType, int charge) {
   unsigned int procIndx = this->myOmtfConfig->getProcIndx(iProcessor, mtfType);
-  return sorter->sortResults(procIndx, this->getPatterns(), charge);
+  OMTFProcessingContext& context = *(defaultContexts[procIndx]);
+  sortResults(context, iProcessor, mtfType, charge);
+  return makeAlgoMuons(context.getRefHitCands());
+}
+
+template <class GoldenPatternType>
+void OMTFProcessor<GoldenPatternType>::sortResults(OMTFProcessingContext& context,
+                                                   unsigned int iProcessor,
+                                                   l1t::tftype mtfType,
+                                                   int charge) {
+  unsigned int procIndx = this->myOmtfConfig->getProcIndx(iProcessor, mtfType);
+  sorter->sortResults(procIndx, this->theGPs, context, charge);
 }
 
 template <class GoldenPatternType>
@@ -441,13 +376,16 @@ int OMTFProcessor<GoldenPatternType>::extrapolateDtPhiBFP(const int& refLogicLay
   double hsPhiPitch = 2 * M_PI / omtfConfig->nPhiBins(); //rad/halfStrip
 
   int reflLayerIndex = refLogicLayer == 0 ? 0 : 1;
-  int extrFactor = 0;
+
+  //the extrapolFactorsTable is only read here, so this method can be called from many threads in parallel
+  //the key of the factor, -1 (i.e. no factor) for the layers without the factors
+  int key = -1;
 
   if(targetLayer ==  0 || targetLayer ==  2 || targetLayer ==  4) {
     if(useStubQualInExtr)
-      extrFactor = extrapolFactors[reflLayerIndex][targetLayer][targetStubQuality];
+      key = targetStubQuality;
     else
-      extrFactor = extrapolFactors[reflLayerIndex][targetLayer][0];
+      key = 0;
   }
   else if(targetLayer ==  1 || targetLayer ==  3 || targetLayer ==  5) {
     int deltaPhi = targetStubPhi - refPhi; //[halfStrip]
@@ -457,18 +395,20 @@ int OMTFProcessor<GoldenPatternType>::extrapolateDtPhiBFP(const int& refLogicLay
     //LogTrace("l1tOmtfEventPrint") <<__FUNCTION__<<":"<<__LINE__<<" deltaPhi "<<deltaPhi<<" phiExtr "<<phiExtr<<std::endl;
   }
   else if(targetLayer >= 10 && targetLayer <= 14) {
-    extrFactor = extrapolFactors[reflLayerIndex][targetLayer][0];
+    key = 0;
   }
   else if( (targetLayer >= 6 && targetLayer <= 9) || (targetLayer >= 15 && targetLayer <= 17) ) {
     if(useEndcapStubsRInExtr) {
-      extrFactor = extrapolFactors[reflLayerIndex][targetLayer][OMTFConfiguration::eta2Bits(abs(targetStubEta))];
+      key = OMTFConfiguration::eta2Bits(abs(targetStubEta));
     }
     else {
-      extrFactor = extrapolFactors[reflLayerIndex][targetLayer][0];
+      key = 0;
     }
   }
 
-  phiExtr = extrFactor * refPhiB / extrapolMultiplier;
+  //for the key = -1 the factor is 0
+  int extrFactor = extrapolFactorsTable.factor(reflLayerIndex, targetLayer, key);
+  phiExtr = extrapolFactorsTable.extrapolate(reflLayerIndex, targetLayer, key, refPhiB);
 
   LogTrace("l1tOmtfEventPrint")<<"\n"<<__FUNCTION__<<":"<<__LINE__<<" refLogicLayer "<<refLogicLayer <<" targetLayer "<<targetLayer<<std::endl;
   LogTrace("l1tOmtfEventPrint")<<"refPhi "<<refPhi<<" refPhiB "<<refPhiB<<" targetStubPhi "<<targetStubPhi<<" targetStubQuality "<<targetStubQuality
@@ -490,14 +430,31 @@ void OMTFProcessor<GoldenPatternType>::processInput(unsigned int iProcessor,
                                                     const OMTFinput& aInput,
                                                     std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) {
   unsigned int procIndx = this->myOmtfConfig->getProcIndx(iProcessor, mtfType);
-  for (auto& itGP : this->theGPs) {
-    for (auto& result : itGP->getResults()[procIndx]) {
+  processInput(*(defaultContexts[procIndx]), iProcessor, mtfType, aInput, observers);
+}
+
+template <class GoldenPatternType>
+void OMTFProcessor<GoldenPatternType>::processInput(OMTFProcessingContext& context,
+                                                    unsigned int iProcessor,
+                                                    l1t::tftype mtfType,
+                                                    const OMTFinput& aInput,
+                                                    std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) {
+  unsigned int procIndx = this->myOmtfConfig->getProcIndx(iProcessor, mtfType);
+  for (unsigned int iGP = 0; iGP < this->theGPs.size(); ++iGP) {
+    for (auto& result : context.getResults(iGP)[procIndx]) {
       result.reset();
     }
   }
 
   LogTrace("l1tOmtfEventPrint")<<__FUNCTION__<<"\n"<<__LINE__<<" iProcessor "<<iProcessor<<" mtfType "<<mtfType<<" procIndx "<<procIndx<<" ----------------------"<<std::endl;
 
+  //the sorter may be changed with setSorter after the init
+  bool fused = fusedSorting && sorter->supportsFusedSorting();
+  if (fused)
+    context.resetBestCandidates(procIndx, context.getResults(0)[procIndx].size());
+  else
+    context.clearBestCandidates();
+
   //////////////////////////////////////
   //////////////////////////////////////
   std::bitset<128> refHitsBits = aInput.getRefHits(iProcessor);
@@ -536,7 +493,7 @@ void OMTFProcessor<GoldenPatternType>::processInput(unsigned int iProcessor,
 
       unsigned int iRegion = aRefHitDef.iRegion;
 
-      MuonStubPtrs1D restrictedLayerStubs = this->restrictInput(iProcessor, iRegion, iLayer, aInput);
+      MuonStubPtrsView restrictedLayerStubs = this->restrictInput(iProcessor, iRegion, iLayer, aInput);
 
       //LogTrace("l1tOmtfEventPrint")<<__FUNCTION__<<" "<<__LINE__<<" iLayer "<<iLayer<<" iRefLayer "<<aRefHitDef.iRefLayer<<" hits.size "<<restrictedLayerHits.size()<<std::endl;
       //LogTrace("l1tOmtfEventPrint")<<"iLayer "<<iLayer<<" refHitNum "<<myOmtfConfig->nTestRefHits()-nTestedRefHits-1<<" iRefHit "<<iRefHit;
@@ -571,16 +528,8 @@ void OMTFProcessor<GoldenPatternType>::processInput(unsigned int iProcessor,
         }
       }
 
-      for (auto& itGP : this->theGPs) {
-        if (itGP->key().thePt == 0)  //empty pattern
-          continue;
-
-        StubResult stubResult =
-            itGP->process1Layer1RefLayer(aRefHitDef.iRefLayer, iLayer, restrictedLayerStubs, extrapolatedPhi, refStub);
-
-        //LogTrace("l1tOmtfEventPrint")<<__FUNCTION__<<":"<<__LINE__<<" layerResult: valid"<<layerResult.valid<<" pdfVal "<<layerResult.pdfVal<<std::endl;
-        itGP->getResults()[procIndx][iRefHit].setStubResult(iLayer, stubResult);
-      }
+      processLayer(
+          context, procIndx, iRefHit, aRefHitDef.iRefLayer, iLayer, restrictedLayerStubs, extrapolatedPhi, refStub);
     }
   }
 
@@ -604,20 +553,28 @@ void OMTFProcessor<GoldenPatternType>::processInput(unsigned int iProcessor,
       phiExtrp = extrapolateDtPhiBFP(aRefHitDef.iRefLayer, phiRef, refStub->phiBHw, 2, 0, 6, 0, 0, this->myOmtfConfig);
     }
 
-    for (auto& itGP : this->theGPs) {
+    for (unsigned int iGP = 0; iGP < this->theGPs.size(); ++iGP) {
+      auto& itGP = this->theGPs[iGP];
       if (itGP->key().thePt == 0)  //empty pattern
         continue;
 
       int phiRefSt2 = itGP->propagateRefPhi(phiRef + phiExtrp, etaRef, aRefHitDef.iRefLayer);
-      itGP->getResults()[procIndx][iRefHit].set(aRefHitDef.iRefLayer, phiRefSt2, etaRef, phiRef);
+      context.getResults(iGP)[procIndx][iRefHit].set(aRefHitDef.iRefLayer, phiRefSt2, etaRef, phiRef);
     }
   }
 
   //////////////////////////////////////
   //////////////////////////////////////
   {
-    for (auto& itGP : this->theGPs) {
-      itGP->finalise(procIndx);
+    for (unsigned int iGP = 0; iGP < this->theGPs.size(); ++iGP) {
+      if (finaliseResultsKernel) {
+        auto gpResults = context.getResults(iGP)[procIndx];
+        finaliseResultsKernel(&(gpResults[0]), gpResults.size());
+      } else
+        this->theGPs[iGP]->finalise(context.getResults(iGP), procIndx);
+
+      if (fused)
+        sorter->updateBestCandidates(context, procIndx, iGP, *(this->theGPs[iGP]));
       //debug
       /*for(unsigned int iRefHit = 0; iRefHit < itGP->getResults()[procIndx].size(); ++iRefHit) {
         if(itGP->getResults()[procIndx][iRefHit].isValid()) {
@@ -634,9 +591,43 @@ void OMTFProcessor<GoldenPatternType>::processInput(unsigned int iProcessor,
 }
 ///////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////
+template <class GoldenPatternType>
+void OMTFProcessor<GoldenPatternType>::processLayer(OMTFProcessingContext& context,
+                                                    unsigned int procIndx,
+                                                    unsigned int iRefHit,
+                                                    unsigned int iRefLayer,
+                                                    unsigned int iLayer,
+                                                    const MuonStubPtrsView& layerStubs,
+                                                    const std::vector<int>& extrapolatedPhi,
+                                                    const MuonStubPtr& refStub) {
+  for (unsigned int iGP = 0; iGP < this->theGPs.size(); ++iGP) {
+    auto& itGP = this->theGPs[iGP];
+    if (itGP->key().thePt == 0)  //empty pattern
+      continue;
+
+    StubResult stubResult = process1Layer1RefLayerKernel(*itGP, iRefLayer, iLayer, layerStubs, extrapolatedPhi, refStub);
+
+    //LogTrace("l1tOmtfEventPrint")<<__FUNCTION__<<":"<<__LINE__<<" layerResult: valid"<<layerResult.valid<<" pdfVal "<<layerResult.pdfVal<<std::endl;
+    context.getResults(iGP)[procIndx][iRefHit].setStubResult(iLayer, stubResult);
+  }
+}
+///////////////////////////////////////////////////////
+///////////////////////////////////////////////////////
+
+template <class GoldenPatternType>
+std::vector<l1t::RegionalMuonCand> OMTFProcessor<GoldenPatternType>::run(
+    unsigned int iProcessor,
+    l1t::tftype mtfType,
+    int bx,
+    OMTFinputMaker* inputMaker,
+    std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) {
+  unsigned int procIndx = this->myOmtfConfig->getProcIndx(iProcessor, mtfType);
+  return run(*(defaultContexts[procIndx]), iProcessor, mtfType, bx, inputMaker, observers);
+}
 
 template <class GoldenPatternType>
 std::vector<l1t::RegionalMuonCand> OMTFProcessor<GoldenPatternType>::run(
+    OMTFProcessingContext& context,
     unsigned int iProcessor,
     l1t::tftype mtfType,
     int bx,
@@ -653,10 +644,19 @@ std::vector<l1t::RegionalMuonCand> OMTFProcessor<GoldenPatternType>::run(
   inputMaker->buildInputForProcessor(input->getMuonStubs(), iProcessor, mtfType, bx, bx);
 
   //LogTrace("l1tOmtfEventPrint")<<"buildInputForProce "; t.report();
-  processInput(iProcessor, mtfType, *(input.get()), observers);
+  processInput(context, iProcessor, mtfType, *(input.get()), observers);
 
   //LogTrace("l1tOmtfEventPrint")<<"processInput       "; t.report();
-  AlgoMuons algoCandidates = sortResults(iProcessor, mtfType);
+  sortResults(context, iProcessor, mtfType);
+
+  //the candidates stay in the context, the AlgoMuons (shared_ptr) are made only for the ptAssignment and the observers,
+  //as they may keep the candidates after the run() is finished
+  if (ptAssignment == nullptr && observers.empty()) {
+    ghostBust(context);
+    return getFinalcandidates(iProcessor, mtfType, context.getGbCands());
+  }
+
+  AlgoMuons algoCandidates = makeAlgoMuons(context.getRefHitCands());
 
   if (ptAssignment) {
     for (auto& myCand : algoCandidates) {
@@ -740,38 +740,12 @@ void OMTFProcessor<GoldenPatternType>::saveExtrapolFactors() {
 }
 
 template <class GoldenPatternType>
-void OMTFProcessor<GoldenPatternType>::loadExtrapolFactors() {
-  boost::property_tree::ptree tree;
-  std::string filename = "ExtrapolationFactors_simple.xml";
-  if(useStubQualInExtr)
-    filename = "ExtrapolationFactors_withQAndEta.xml";
-
-  boost::property_tree::read_xml(filename, tree);
-
-  extrapolMultiplier = tree.get<int>("ExtrapolationFactors.<xmlattr>.multiplier");
-  edm::LogVerbatim("OMTFReconstruction")<<"extrapolMultiplier "<<extrapolMultiplier<<std::endl;
-
-  auto& lutNodes = tree.get_child("ExtrapolationFactors");
-  for (boost::property_tree::ptree::value_type& lutNode : lutNodes) {
-    if (lutNode.first == "Lut") {
-      int iRefLayer = lutNode.second.get<int>("<xmlattr>.RefLayer");
-      int iLayer = lutNode.second.get<int>("<xmlattr>.Layer");
-      std::string keyType = lutNode.second.get<std::string>("<xmlattr>.KeyType");
-
-      edm::LogVerbatim("OMTFReconstruction")<<"iRefLayer "<<iRefLayer<<" iLayer "<<iLayer<<" keyType "<<keyType<<std::endl;
-
-      auto& valueNodes = lutNode.second;
-      for (boost::property_tree::ptree::value_type& valueNode : valueNodes) {
-          if (valueNode.first == "LutVal") {
-            int key = valueNode.second.get<int>("<xmlattr>.key");
-            float value = valueNode.second.get<float>("<xmlattr>.value");
-            extrapolFactors.at(iRefLayer).at(iLayer)[key] = value;
-            edm::LogVerbatim("OMTFReconstruction")<<"key "<<key<<" value "<<value<<std::endl;
-          }
-      }
+void OMTFProcessor<GoldenPatternType>::loadExtrapolFactors(const std::string& filename) {
+  extrapolFactorsTable.read(filename);
 
-    }
-  }
+  extrapolMultiplier = extrapolFactorsTable.getMultiplier();
+  edm::LogVerbatim("OMTFReconstruction") << "extrapolFactors read from " << filename << ", extrapolMultiplier "
+                                         << extrapolMultiplier << std::endl;
 }
 
 /////////////////////////////////////////////////////////
@@ -0,0 +1,74 @@
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessorPatternBank.h"
+
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <sstream>
+
+OMTFProcessorPatternBank::OMTFProcessorPatternBank(OMTFConfiguration* omtfConfig,
+                                                   const edm::ParameterSet& edmCfg,
+                                                   edm::EventSetup const& evSetup,
+                                                   const L1TMuonOverlapParams* omtfPatterns)
+    : OMTFProcessor<GoldenPattern>(omtfConfig, edmCfg, evSetup, omtfPatterns) {
+  initPatternBank(edmCfg);
+}
+
+OMTFProcessorPatternBank::OMTFProcessorPatternBank(OMTFConfiguration* omtfConfig,
+                                                   const edm::ParameterSet& edmCfg,
+                                                   edm::EventSetup const& evSetup,
+                                                   GoldenPatternVec<GoldenPattern>&& gps)
+    : OMTFProcessor<GoldenPattern>(omtfConfig, edmCfg, evSetup, std::move(gps)) {
+  initPatternBank(edmCfg);
+}
+
+void OMTFProcessorPatternBank::initPatternBank(const edm::ParameterSet& edmCfg) {
+  patternBank = std::make_unique<GoldenPatternBank>(this->myOmtfConfig, this->theGPs);
+
+  if (edmCfg.exists("patternBankValidation"))
+    patternBankValidation = edmCfg.getParameter<bool>("patternBankValidation");
+
+  edm::LogVerbatim("OMTFReconstruction") << "OMTFProcessorPatternBank: " << patternBank->nPatterns()
+                                         << " patterns in the bank, patternBankValidation " << patternBankValidation
+                                         << std::endl;
+}
+
+void OMTFProcessorPatternBank::processLayer(OMTFProcessingContext& context,
+                                            unsigned int procIndx,
+                                            unsigned int iRefHit,
+                                            unsigned int iRefLayer,
+                                            unsigned int iLayer,
+                                            const MuonStubPtrsView& layerStubs,
+                                            const std::vector<int>& extrapolatedPhi,
+                                            const MuonStubPtr& refStub) {
+  patternBank->process1Layer1RefLayer(
+      context, procIndx, iRefHit, iRefLayer, iLayer, layerStubs, extrapolatedPhi, refStub);
+
+  if (!patternBankValidation)
+    return;
+
+  for (unsigned int iGP = 0; iGP < this->theGPs.size(); ++iGP) {
+    auto& itGP = this->theGPs[iGP];
+    if (itGP->key().thePt == 0)  //empty pattern
+      continue;
+
+    StubResult expected = itGP->process1Layer1RefLayer(iRefLayer, iLayer, layerStubs, extrapolatedPhi, refStub);
+    const StubResult& result = context.getResults(iGP)[procIndx][iRefHit].getStubResults()[iLayer];
+
+    //the pdfVal is compared bitwise on purpose, both paths must read the same value from the pattern
+    if (result.getPdfVal() != expected.getPdfVal() || result.getValid() != expected.getValid() ||
+        result.getPdfBin() != expected.getPdfBin() || result.getMuonStub() != expected.getMuonStub()) {
+      std::ostringstream ostr;
+      ostr << "OMTFProcessorPatternBank: result different than from the GoldenPattern " << itGP->key()
+           << " iRefLayer " << iRefLayer << " iLayer " << iLayer << ": pdfVal " << result.getPdfVal() << " vs "
+           << expected.getPdfVal() << ", valid " << result.getValid() << " vs " << expected.getValid() << ", pdfBin "
+           << result.getPdfBin() << " vs " << expected.getPdfBin();
+      throw cms::Exception(ostr.str());
+    }
+  }
+}
+
+void OMTFProcessorPatternBank::printInfo() const {
+  edm::LogVerbatim("OMTFReconstruction") << __PRETTY_FUNCTION__ << std::endl;
+
+  OMTFProcessor<GoldenPattern>::printInfo();
+}
@@ -1,7 +1,11 @@
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/BinaryEventWriter.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternWithStat.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessorPatternBank.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFReconstruction.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinputSnapshotWriter.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/ProcessorBase.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/ProcessorObserversBuffer.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigReader.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLEventWriter.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/ProcConfigurationBase.h"
@@ -23,7 +27,10 @@
 #include <iostream>
 #include <memory>
 #include <string>
+#include <utility>
 #include <vector>
+
+#include "tbb/task_group.h"
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
 OMTFReconstruction::OMTFReconstruction(const edm::ParameterSet& parameterSet, MuStubsInputTokens& muStubsInputTokens)
@@ -37,6 +44,11 @@ OMTFReconstruction::OMTFReconstruction(const edm::ParameterSet& parameterSet, Mu
 
   edm::LogVerbatim("OMTFReconstruction") << "running emulation for the bxMin " << bxMin << " - bxMax " << bxMax
                                          << std::endl;
+
+  if (edmParameterSet.exists("processorsInParallel"))
+    processorsInParallel = edmParameterSet.getParameter<bool>("processorsInParallel");
+
+  edm::LogVerbatim("OMTFReconstruction") << "processorsInParallel " << processorsInParallel << std::endl;
 }
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
@@ -102,6 +114,10 @@ void OMTFReconstruction::beginRun(edm::Run const& run,
           omtfProc = std::make_unique<OMTFProcessor<GoldenPattern> >(
               omtfConfig.get(), edmParameterSet, eventSetup, omtfParams);
           omtfProc->printInfo();
+        } else if (processorType == "OMTFProcessorPatternBank") {
+          omtfProc =
+              std::make_unique<OMTFProcessorPatternBank>(omtfConfig.get(), edmParameterSet, eventSetup, omtfParams);
+          omtfProc->printInfo();
         }
       }
     }
@@ -140,6 +156,16 @@ void OMTFReconstruction::beginRun(edm::Run const& run,
         } else {  //in principle should not happen
           throw cms::Exception("OMTFReconstruction::beginRun: omtfParams is nullptr");
         }
+      } else if (processorType == "OMTFProcessorPatternBank") {
+        if (omtfParams) {
+          omtfProc = std::make_unique<OMTFProcessorPatternBank>(
+              omtfConfig.get(),
+              edmParameterSet,
+              eventSetup,
+              xmlReader.readPatterns<GoldenPattern>(*omtfParams, patternsXMLFiles, false));
+        } else {  //in principle should not happen
+          throw cms::Exception("OMTFReconstruction::beginRun: omtfParams is nullptr");
+        }
       }
 
       edm::LogVerbatim("OMTFReconstruction") << "OMTFProcessor constructed. processorType " << processorType
@@ -183,9 +209,20 @@ void OMTFReconstruction::addObservers(
 
   //omtfConfig is created at constructor, and is not re-created at the the start of the run, so this is OK
   if (edmParameterSet.exists("dumpResultToXML")) {
-    if (edmParameterSet.getParameter<bool>("dumpResultToXML"))
-      observers.emplace_back(std::make_unique<XMLEventWriter>(
-          omtfConfig.get(), edmParameterSet.getParameter<std::string>("XMLDumpFileName")));
+    if (edmParameterSet.getParameter<bool>("dumpResultToXML")) {
+      std::string dumpFileName = edmParameterSet.getParameter<std::string>("XMLDumpFileName");
+      //the binary file is streamed, the XMLEventWriter keeps the whole tree in memory until the endJob
+      if (dumpFileName.size() > 4 && dumpFileName.compare(dumpFileName.size() - 4, 4, ".bin") == 0)
+        observers.emplace_back(std::make_unique<BinaryEventWriter>(omtfConfig.get(), dumpFileName));
+      else
+        observers.emplace_back(std::make_unique<XMLEventWriter>(omtfConfig.get(), dumpFileName));
+    }
+  }
+
+  //the inputs of the processors, to be replayed by the omtfProcessorBenchmark
+  if (edmParameterSet.exists("inputSnapshotsFileName")) {
+    observers.emplace_back(std::make_unique<OMTFinputSnapshotWriter>(
+        omtfConfig.get(), edmParameterSet.getParameter<std::string>("inputSnapshotsFileName")));
   }
 
   CandidateSimMuonMatcher* candidateSimMuonMatcher = nullptr;
@@ -242,7 +279,7 @@ void OMTFReconstruction::addObservers(
 std::unique_ptr<l1t::RegionalMuonCandBxCollection> OMTFReconstruction::reconstruct(const edm::Event& iEvent,
                                                                                    const edm::EventSetup& evSetup) {
   LogTrace("l1tOmtfEventPrint") << "\n" << __FUNCTION__ << ":" << __LINE__ << " iEvent " << iEvent.id().event() << endl;
-  inputMaker->loadAndFilterDigis(iEvent);
+  inputMaker->loadAndFilterDigis(iEvent, bxMin, bxMax);
 
   for (auto& obs : observers) {
     obs->observeEventBegin(iEvent);
@@ -253,6 +290,11 @@ std::unique_ptr<l1t::RegionalMuonCandBxCollection> OMTFReconstruction::reconstru
 
   ///The order is important: first put omtf_pos candidates, then omtf_neg.
   for (int bx = bxMin; bx <= bxMax; bx++) {
+    if (processorsInParallel && omtfProc->canRunInParallel()) {
+      runProcessorsInParallel(bx, *candidates);
+      continue;
+    }
+
     for (unsigned int iProcessor = 0; iProcessor < omtfConfig->nProcessors(); ++iProcessor) {
       std::vector<l1t::RegionalMuonCand> candMuons =
           omtfProc->run(iProcessor, l1t::tftype::omtf_pos, bx, inputMaker.get(), observers);
@@ -285,3 +327,38 @@ std::unique_ptr<l1t::RegionalMuonCandBxCollection> OMTFReconstruction::reconstru
 
 /////////////////////////////////////////////////////
 /////////////////////////////////////////////////////
+void OMTFReconstruction::runProcessorsInParallel(int bx, l1t::RegionalMuonCandBxCollection& candidates) {
+  ///The order is important: first omtf_pos, then omtf_neg, as in the serial mode
+  std::vector<std::pair<unsigned int, l1t::tftype> > processors;
+  for (auto mtfType : {l1t::tftype::omtf_pos, l1t::tftype::omtf_neg}) {
+    for (unsigned int iProcessor = 0; iProcessor < omtfConfig->nProcessors(); ++iProcessor)
+      processors.emplace_back(iProcessor, mtfType);
+  }
+
+  //each processor gets its own output and its own observer, which collects the notifications
+  std::vector<std::vector<l1t::RegionalMuonCand> > procCandMuons(processors.size());
+  std::vector<std::vector<std::unique_ptr<IOMTFEmulationObserver> > > procObservers(processors.size());
+  if (!observers.empty()) {
+    for (auto& procObserver : procObservers)
+      procObserver.emplace_back(std::make_unique<ProcessorObserversBuffer>());
+  }
+
+  tbb::task_group taskGroup;
+  for (unsigned int iTask = 0; iTask < processors.size(); ++iTask) {
+    taskGroup.run([this, bx, iTask, &processors, &procCandMuons, &procObservers]() {
+      procCandMuons[iTask] = omtfProc->run(
+          processors[iTask].first, processors[iTask].second, bx, inputMaker.get(), procObservers[iTask]);
+    });
+  }
+  taskGroup.wait();
+
+  //deterministic merge, in the order of the processors
+  for (unsigned int iTask = 0; iTask < processors.size(); ++iTask) {
+    for (auto& procObserver : procObservers[iTask])
+      static_cast<ProcessorObserversBuffer*>(procObserver.get())->replay(observers);
+
+    for (auto& candMuon : procCandMuons[iTask]) {
+      candidates.push_back(bx, candMuon);
+    }
+  }
+}
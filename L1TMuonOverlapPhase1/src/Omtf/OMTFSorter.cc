@@ -15,70 +15,105 @@
 ///////////////////////////////////////////////////////
 ///////////////////////////////////////////////////////
 template <class GoldenPatternType>
-AlgoMuons::value_type OMTFSorter<GoldenPatternType>::sortRefHitResults(
-    unsigned int procIndx, unsigned int iRefHit, const GoldenPatternVec<GoldenPatternType>& gPatterns, int charge) {
-  GoldenPatternType* bestGP = nullptr;  //the GoldenPattern with the best result for this iRefHit
-  //std::cout <<" ====== sortRefHitResults: " << std::endl;
-
-  GoldenPatternType* bestGpUpt = nullptr;
-
-  for (auto& itGP : gPatterns) {
-    if (!itGP->getResults()[procIndx][iRefHit].isValid())
-      continue;
-
-    if (charge != 0 && itGP->key().theCharge != charge)
-      continue;  //charge==0 means ignore charge
-
-    ///Accept only candidates with >2 hits
-    if (itGP->getResults()[procIndx][iRefHit].getFiredLayerCnt() < 3)  //TODO - move 3 to the configuration??
-      continue;
-
-    if (bestGP == nullptr) {
-      bestGP = itGP.get();
-    } else if (myType == 0 && itGP->getResults()[procIndx][iRefHit].getFiredLayerCnt() >
-                                  bestGP->getResults()[procIndx][iRefHit].getFiredLayerCnt()) {
-      bestGP = itGP.get();
-    } else if (myType == 1 || (itGP->getResults()[procIndx][iRefHit].getFiredLayerCnt() ==
-                               bestGP->getResults()[procIndx][iRefHit].getFiredLayerCnt())) {
-      if (itGP->getResults()[procIndx][iRefHit].getPdfSum() > bestGP->getResults()[procIndx][iRefHit].getPdfSum()) {
-        //if the PdfWeigtSum is equal, we take the GP with the lower number, i.e. lower pt = check if this is ok for physics FIXME (KB)
-        bestGP = itGP.get();
-      }
-    }
+void OMTFSorter<GoldenPatternType>::updateBestCandidate(OMTFProcessingContext::RefHitBestCandidate& bestCandidate,
+                                                        unsigned int iGP,
+                                                        GoldenPatternType& gp,
+                                                        const GoldenPatternResult& gpResult,
+                                                        int charge) const {
+  if (!gpResult.isValid())
+    return;
 
+  if (charge != 0 && gp.key().theCharge != charge)
+    return;  //charge==0 means ignore charge
 
-    if (bestGpUpt == nullptr) {
-      if(itGP->getResults()[procIndx][iRefHit].getPdfSumUpt() > 0)
-        bestGpUpt = itGP.get();
-    } else if (myType == 0 && itGP->getResults()[procIndx][iRefHit].getFiredLayerCnt() >
-                              bestGpUpt->getResults()[procIndx][iRefHit].getFiredLayerCnt()) {
-      bestGpUpt = itGP.get();
-    } else if (myType == 1 || (itGP->getResults()[procIndx][iRefHit].getFiredLayerCnt() ==
-                               bestGpUpt->getResults()[procIndx][iRefHit].getFiredLayerCnt())) {
-      if (itGP->getResults()[procIndx][iRefHit].getPdfSumUpt() > bestGpUpt->getResults()[procIndx][iRefHit].getPdfSumUpt()) {
-        //if the PdfWeigtSum is equal, we take the GP with the lower number, i.e. lower pt = check if this is ok for physics FIXME (KB)
-        bestGpUpt = itGP.get();
-      }
-    }
+  ///Accept only candidates with >2 hits
+  unsigned int firedLayerCnt = gpResult.getFiredLayerCnt();
+  if (firedLayerCnt < 3)  //TODO - move 3 to the configuration??
+    return;
+
+  PdfValueType pdfSum = gpResult.getPdfSum();
+  bool takeGp = false;
+  if (bestCandidate.iGP < 0) {
+    takeGp = true;
+  } else if (myType == 0 && firedLayerCnt > bestCandidate.firedLayerCnt) {
+    takeGp = true;
+  } else if (myType == 1 || (firedLayerCnt == bestCandidate.firedLayerCnt)) {
+    //if the PdfWeigtSum is equal, we take the GP with the lower number, i.e. lower pt = check if this is ok for physics FIXME (KB)
+    takeGp = pdfSum > bestCandidate.pdfSum;
+  }
+
+  if (takeGp) {
+    bestCandidate.iGP = iGP;
+    bestCandidate.firedLayerCnt = firedLayerCnt;
+    bestCandidate.pdfSum = pdfSum;
+  }
 
-//    LogTrace("OMTFReconstruction")<<"OMTFSorter::sortRefHitResults() " << itGP->key()<<" getFiredLayer "<< itGP->getResults()[procIndx][iRefHit].getFiredLayerCnt()
-//    <<" PdfSum "<< itGP->getResults()[procIndx][iRefHit].getPdfSum()
-//    <<" PdfSumUpt "<< itGP->getResults()[procIndx][iRefHit].getPdfSumUpt()<< std::endl;
+  PdfValueType pdfSumUpt = gpResult.getPdfSumUpt();
+  bool takeGpUpt = false;
+  if (bestCandidate.iGpUpt < 0) {
+    takeGpUpt = pdfSumUpt > 0;
+  } else if (myType == 0 && firedLayerCnt > bestCandidate.uptFiredLayerCnt) {
+    takeGpUpt = true;
+  } else if (myType == 1 || (firedLayerCnt == bestCandidate.uptFiredLayerCnt)) {
+    takeGpUpt = pdfSumUpt > bestCandidate.pdfSumUpt;
   }
-  if (bestGP) {
-    AlgoMuons::value_type candidate(new AlgoMuon(bestGP->getResults()[procIndx][iRefHit], bestGP, iRefHit));
 
-    if(bestGpUpt) {
-      candidate->setGpResultUpt(bestGpUpt->getResults()[procIndx][iRefHit]);
-      candidate->setGoldenPaternUpt(bestGpUpt);
+  if (takeGpUpt) {
+    bestCandidate.iGpUpt = iGP;
+    bestCandidate.uptFiredLayerCnt = firedLayerCnt;
+    bestCandidate.pdfSumUpt = pdfSumUpt;
+  }
+
+  //    LogTrace("OMTFReconstruction")<<"OMTFSorter::sortRefHitResults() " << gp.key()<<" getFiredLayer "<< firedLayerCnt
+  //    <<" PdfSum "<< pdfSum
+  //    <<" PdfSumUpt "<< pdfSumUpt<< std::endl;
+}
+
+template <class GoldenPatternType>
+void OMTFSorter<GoldenPatternType>::sortRefHitResults(unsigned int procIndx,
+                                                      unsigned int iRefHit,
+                                                      const GoldenPatternVec<GoldenPatternType>& gPatterns,
+                                                      const OMTFProcessingContext& context,
+                                                      AlgoMuon& candidate,
+                                                      int charge) {
+  OMTFProcessingContext::RefHitBestCandidate bestCandidate;
+  for (unsigned int iGP = 0; iGP < gPatterns.size(); ++iGP) {
+    updateBestCandidate(bestCandidate, iGP, *gPatterns[iGP], context.getResults(iGP)[procIndx][iRefHit], charge);
+  }
+
+  makeCandidate(procIndx, iRefHit, gPatterns, context, bestCandidate, candidate);
+}
+
+template <class GoldenPatternType>
+void OMTFSorter<GoldenPatternType>::updateBestCandidates(OMTFProcessingContext& context,
+                                                         unsigned int procIndx,
+                                                         unsigned int iGP,
+                                                         GoldenPatternType& gp) {
+  auto gpResults = context.getResults(iGP)[procIndx];
+  for (unsigned int iRefHit = 0; iRefHit < gpResults.size(); ++iRefHit) {
+    updateBestCandidate(context.getBestCandidate(iRefHit), iGP, gp, gpResults[iRefHit], 0);
+  }
+}
+
+template <class GoldenPatternType>
+void OMTFSorter<GoldenPatternType>::makeCandidate(unsigned int procIndx,
+                                                  unsigned int iRefHit,
+                                                  const GoldenPatternVec<GoldenPatternType>& gPatterns,
+                                                  const OMTFProcessingContext& context,
+                                                  const OMTFProcessingContext::RefHitBestCandidate& bestCandidate,
+                                                  AlgoMuon& candidate) {
+  if (bestCandidate.iGP >= 0) {
+    candidate.assign(
+        context.getResults(bestCandidate.iGP)[procIndx][iRefHit], gPatterns[bestCandidate.iGP].get(), iRefHit);
+
+    if (bestCandidate.iGpUpt >= 0) {
+      candidate.setGpResultUpt(context.getResults(bestCandidate.iGpUpt)[procIndx][iRefHit]);
+      candidate.setGoldenPaternUpt(gPatterns[bestCandidate.iGpUpt].get());
     }
 
-    //std::cout<<__FUNCTION__<<" line "<<__LINE__ <<" return: " << *candidate << std::endl;
-    return candidate;
+    //std::cout<<__FUNCTION__<<" line "<<__LINE__ <<" return: " << candidate << std::endl;
   } else {
-    AlgoMuons::value_type candidate(new AlgoMuon());
-    candidate->setRefHitNumber(iRefHit);
-    return candidate;
+    candidate.assignEmpty(iRefHit);
   }
 }
 
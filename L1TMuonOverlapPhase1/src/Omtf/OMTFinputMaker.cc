@@ -12,6 +12,7 @@
 #include "DataFormats/MuonDetId/interface/RPCDetId.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include <map>
 #include <sstream>
@@ -37,12 +38,11 @@ void DtDigiToStubsConverterOmtf::addDTphiDigi(MuonStubPtrs2D& muonStubsInLayers,
   if (digi.code() == 7 || digi.code() < config->getMinDtPhiQuality())
     return;
 
-  unsigned int hwNumber = config->getLayerNumber(detid.rawId());
-  if (config->getHwToLogicLayer().find(hwNumber) == config->getHwToLogicLayer().end())
+  int logicLayer = config->getLogicLayer(config->getLayerNumber(detid.rawId()));
+  if (logicLayer < 0)
     return;
 
-  auto iter = config->getHwToLogicLayer().find(hwNumber);
-  unsigned int iLayer = iter->second;
+  unsigned int iLayer = logicLayer;
   unsigned int iInput = OMTFinputMaker::getInputNumber(config, detid.rawId(), iProcessor, procTyp);
   //MuonStub& stub = muonStubsInLayers[iLayer][iInput];
   MuonStub stub;
@@ -65,7 +65,7 @@ void DtDigiToStubsConverterOmtf::addDTphiDigi(MuonStubPtrs2D& muonStubsInLayers,
   stub.logicLayer = iLayer;
   stub.detId = detid;
 
-  OMTFinputMaker::addStub(config, muonStubsInLayers, iLayer, iInput, stub);
+  OMTFinputMaker::addStub(config, muonStubsInLayers, iLayer, iInput, stub, stubsArena);
 }
 
 void DtDigiToStubsConverterOmtf::addDTetaStubs(MuonStubPtrs2D& muonStubsInLayers,
@@ -86,11 +86,11 @@ void CscDigiToStubsConverterOmtf::addCSCstubs(MuonStubPtrs2D& muonStubsInLayers,
                                               const CSCCorrelatedLCTDigi& digi,
                                               unsigned int iProcessor,
                                               l1t::tftype procTyp) {
-  unsigned int hwNumber = config->getLayerNumber(rawid);
-  if (config->getHwToLogicLayer().find(hwNumber) == config->getHwToLogicLayer().end())
+  int logicLayer = config->getLogicLayer(config->getLayerNumber(rawid));
+  if (logicLayer < 0)
     return;
 
-  unsigned int iLayer = config->getHwToLogicLayer().at(hwNumber);
+  unsigned int iLayer = logicLayer;
   unsigned int iInput = OMTFinputMaker::getInputNumber(config, rawid, iProcessor, procTyp);
 
   float r = 0;
@@ -110,7 +110,7 @@ void CscDigiToStubsConverterOmtf::addCSCstubs(MuonStubPtrs2D& muonStubsInLayers,
   stub.logicLayer = iLayer;
   stub.detId = rawid;
 
-  OMTFinputMaker::addStub(config, muonStubsInLayers, iLayer, iInput, stub);
+  OMTFinputMaker::addStub(config, muonStubsInLayers, iLayer, iInput, stub, stubsArena);
   ///Accept CSC digis only up to eta=1.26.
   ///The nominal OMTF range is up to 1.24, but cutting at 1.24
   ///kill efficiency at the edge. 1.26 is one eta bin above nominal.
@@ -157,7 +157,11 @@ void RpcDigiToStubsConverterOmtf::addRPCstub(MuonStubPtrs2D& muonStubsInLayers,
   unsigned int rawid = roll.rawId();
 
   unsigned int hwNumber = config->getLayerNumber(rawid);
-  unsigned int iLayer = config->getHwToLogicLayer().at(hwNumber);
+  int logicLayer = config->getLogicLayer(hwNumber);
+  if (logicLayer < 0)
+    throw cms::Exception("RpcDigiToStubsConverterOmtf::addRPCstub: no logic layer for the hwNumber ") << hwNumber;
+
+  unsigned int iLayer = logicLayer;
   unsigned int iInput = OMTFinputMaker::getInputNumber(config, rawid, iProcessor, procTyp);
 
   //LogTrace("l1tOmtfEventPrint")<<"ADDING HIT: iLayer = " << iLayer << " iInput: " << iInput << " iPhi: " << iPhi << std::endl;
@@ -199,21 +203,21 @@ void RpcDigiToStubsConverterOmtf::addRPCstub(MuonStubPtrs2D& muonStubsInLayers,
       if (muonStubsInLayers[iLayer][iInput]) {
         muonStubsInLayers[iLayer][iInput]->type = MuonStub::RPC_DROPPED;
 
-        muonStubsInLayers[iLayer][iInput + 1] = std::make_shared<MuonStub>(stub);
+        muonStubsInLayers[iLayer][iInput + 1] = makeSharedInArena<MuonStub>(stubsArena, stub);
         muonStubsInLayers[iLayer][iInput + 1]->type = MuonStub::RPC_DROPPED;
       } else {
         //no stub was added at this input already, so adding a stub and marking it as dropped
-        muonStubsInLayers[iLayer].at(iInput) = std::make_shared<MuonStub>(stub);
+        muonStubsInLayers[iLayer].at(iInput) = makeSharedInArena<MuonStub>(stubsArena, stub);
         muonStubsInLayers[iLayer][iInput]->type = MuonStub::RPC_DROPPED;
 
-        muonStubsInLayers[iLayer][iInput + 1] = std::make_shared<MuonStub>(stub);
+        muonStubsInLayers[iLayer][iInput + 1] = makeSharedInArena<MuonStub>(stubsArena, stub);
         muonStubsInLayers[iLayer][iInput + 1]->type = MuonStub::RPC_DROPPED;
       }
     } else
-      OMTFinputMaker::addStub(config, muonStubsInLayers, iLayer, iInput, stub);
+      OMTFinputMaker::addStub(config, muonStubsInLayers, iLayer, iInput, stub, stubsArena);
   } else {
     if (cluster.size() <= config->getRpcMaxClusterSize())
-      OMTFinputMaker::addStub(config, muonStubsInLayers, iLayer, iInput, stub);
+      OMTFinputMaker::addStub(config, muonStubsInLayers, iLayer, iInput, stub, stubsArena);
   }
 
   std::ostringstream str;
@@ -336,6 +340,9 @@ void OMTFinputMaker::initialize(const edm::ParameterSet& edmCfg,
                                 const MuonGeometryTokens& muonGeometryTokens) {
   MuonStubMakerBase::initialize(edmCfg, es, muonGeometryTokens);
   angleConverter->checkAndUpdateGeometry(es, config, muonGeometryTokens);
+
+  //the number of processors is known only after the configuration is read, so it is set here and not in the constructor
+  nProcessors = config->nProcessors();
 }
 
 ///////////////////////////////////////
@@ -446,7 +453,8 @@ void OMTFinputMaker::addStub(const OMTFConfiguration* config,
                              MuonStubPtrs2D& muonStubsInLayers,
                              unsigned int iLayer,
                              unsigned int iInput,
-                             MuonStub& stub) {
+                             MuonStub& stub,
+                             EventArena* stubsArena) {
   //LogTrace("l1tOmtfEventPrint") << __FUNCTION__ << ":" << __LINE__ << " iInput " << iInput << " " << stub << endl;
   //there is a small rate of duplicated digis in the real data in the DT and CSC, the reason for this duplicates is not understood
   //in case of RPC the duplicated digis appear in data only for the layer 17 (RE3), where the rolls 2 and 3 has the same eta = 115 assigned, and the muon can hit both rolls
@@ -468,5 +476,5 @@ void OMTFinputMaker::addStub(const OMTFConfiguration* config,
     return;
   //in this implementation only two first stubs are added for a given iInput
 
-  muonStubsInLayers.at(iLayer).at(iInput) = std::make_shared<MuonStub>(stub);
+  muonStubsInLayers.at(iLayer).at(iInput) = makeSharedInArena<MuonStub>(stubsArena, stub);
 }
@@ -0,0 +1,149 @@
+/*
+ * OMTFinputSnapshotWriter.cc
+ */
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinputSnapshotWriter.h"
+
+#include "DataFormats/Provenance/interface/EventID.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <cstring>
+
+OMTFinputSnapshotWriter::OMTFinputSnapshotWriter(const OMTFConfiguration* omtfConfig, const std::string& fName)
+    : omtfConfig(omtfConfig), outFile(fName, std::ios::binary | std::ios::trunc) {
+  if (!outFile)
+    throw cms::Exception("OMTFinputSnapshotWriter: cannot open the file " + fName);
+
+  FileHeader fileHeader;
+  std::memset(&fileHeader, 0, sizeof(fileHeader));
+  fileHeader.fileType = BinaryFileHeader::make(magic, version);
+  fileHeader.nLayers = omtfConfig->nLayers();
+  fileHeader.patternsVersion = omtfConfig->patternsVersion();
+  write(fileHeader);
+}
+
+OMTFinputSnapshotWriter::~OMTFinputSnapshotWriter() { outFile.flush(); }
+
+OMTFinputSnapshotWriter::CandidateRecord OMTFinputSnapshotWriter::makeCandidateRecord(
+    const l1t::RegionalMuonCand& candMuon) {
+  CandidateRecord record;
+  record.hwPt = candMuon.hwPt();
+  record.hwPtUnconstrained = candMuon.hwPtUnconstrained();
+  record.hwPhi = candMuon.hwPhi();
+  record.hwEta = candMuon.hwEta();
+  record.hwQual = candMuon.hwQual();
+  record.hwSign = candMuon.hwSign();
+  record.hwSignValid = candMuon.hwSignValid();
+  return record;
+}
+
+void OMTFinputSnapshotWriter::observeProcesorEmulation(unsigned int iProcessor,
+                                                       l1t::tftype mtfType,
+                                                       const std::shared_ptr<OMTFinput>& input,
+                                                       const AlgoMuons& algoCandidates,
+                                                       const AlgoMuons& gbCandidates,
+                                                       const std::vector<l1t::RegionalMuonCand>& candMuons) {
+  stubRecords.clear();
+  const MuonStubPtrs2D& muonStubs = input->getMuonStubs();
+  for (unsigned int iLayer = 0; iLayer < muonStubs.size(); ++iLayer) {
+    for (unsigned int iInput = 0; iInput < muonStubs[iLayer].size(); ++iInput) {
+      const MuonStubPtr& stub = muonStubs[iLayer][iInput];
+      if (!stub)
+        continue;
+      stubRecords.push_back({iLayer,
+                             iInput,
+                             stub->type,
+                             stub->phiHw,
+                             stub->phiBHw,
+                             stub->etaHw,
+                             stub->etaSigmaHw,
+                             stub->qualityHw,
+                             stub->bx,
+                             stub->timing,
+                             stub->logicLayer,
+                             stub->detId});
+    }
+  }
+
+  if (stubRecords.empty())
+    return;
+
+  write(SnapshotRecord{eventNum, iProcessor, mtfType, (uint32_t)stubRecords.size(), (uint32_t)candMuons.size()});
+  outFile.write(reinterpret_cast<const char*>(stubRecords.data()), stubRecords.size() * sizeof(StubRecord));
+  for (auto& candMuon : candMuons)
+    write(makeCandidateRecord(candMuon));
+}
+
+void OMTFinputSnapshotWriter::observeEventBegin(const edm::Event& iEvent) { eventNum = iEvent.id().event(); }
+
+void OMTFinputSnapshotWriter::endJob() {
+  outFile.flush();
+  if (!outFile)
+    throw cms::Exception("OMTFinputSnapshotWriter: writing the file failed");
+}
+
+std::vector<OMTFinputSnapshotWriter::Snapshot> OMTFinputSnapshotWriter::readSnapshots(
+    const std::string& fileName, const OMTFConfiguration* omtfConfig) {
+  std::ifstream inFile(fileName, std::ios::binary);
+  if (!inFile)
+    throw cms::Exception("OMTFinputSnapshotWriter::readSnapshots: cannot open the file " + fileName);
+
+  FileHeader fileHeader;
+  inFile.read(reinterpret_cast<char*>(&fileHeader), sizeof(fileHeader));
+  std::string error = inFile ? fileHeader.fileType.check(magic, version) : "wrong magic";
+  if (error.empty() && fileHeader.nLayers != omtfConfig->nLayers())
+    error = "nLayers " + std::to_string(fileHeader.nLayers) + " different than in the configuration";
+
+  std::vector<Snapshot> snapshots;
+  SnapshotRecord snapshotRecord;
+  while (error.empty() && inFile.read(reinterpret_cast<char*>(&snapshotRecord), sizeof(snapshotRecord))) {
+    Snapshot snapshot;
+    snapshot.iEvent = snapshotRecord.iEvent;
+    snapshot.iProcessor = snapshotRecord.iProcessor;
+    snapshot.mtfType = static_cast<l1t::tftype>(snapshotRecord.mtfType);
+    snapshot.input = std::make_shared<OMTFinput>(omtfConfig);
+
+    MuonStubPtrs2D& muonStubs = snapshot.input->getMuonStubs();
+    StubRecord stubRecord;
+    for (unsigned int iStub = 0; iStub < snapshotRecord.nStubs; ++iStub) {
+      if (!inFile.read(reinterpret_cast<char*>(&stubRecord), sizeof(stubRecord))) {
+        error = "truncated file";
+        break;
+      }
+      if (stubRecord.iLayer >= muonStubs.size() || stubRecord.iInput >= muonStubs[stubRecord.iLayer].size()) {
+        error = "wrong stub iLayer " + std::to_string(stubRecord.iLayer) + " iInput " +
+                std::to_string(stubRecord.iInput);
+        break;
+      }
+
+      auto stub = std::make_shared<MuonStub>(stubRecord.phiHw, stubRecord.phiBHw);
+      stub->type = static_cast<MuonStub::Type>(stubRecord.type);
+      stub->etaHw = stubRecord.etaHw;
+      stub->etaSigmaHw = stubRecord.etaSigmaHw;
+      stub->qualityHw = stubRecord.qualityHw;
+      stub->bx = stubRecord.bx;
+      stub->timing = stubRecord.timing;
+      stub->logicLayer = stubRecord.logicLayer;
+      stub->detId = stubRecord.detId;
+      muonStubs[stubRecord.iLayer][stubRecord.iInput] = stub;
+    }
+
+    snapshot.candidates.resize(snapshotRecord.nCandidates);
+    if (error.empty() && snapshotRecord.nCandidates &&
+        !inFile.read(reinterpret_cast<char*>(snapshot.candidates.data()),
+                     snapshotRecord.nCandidates * sizeof(CandidateRecord)))
+      error = "truncated file";
+
+    snapshots.emplace_back(std::move(snapshot));
+  }
+
+  //a part of the SnapshotRecord at the end of the file
+  if (error.empty() && inFile.gcount() != 0)
+    error = "truncated file";
+
+  if (!error.empty())
+    throw cms::Exception("OMTFinputSnapshotWriter::readSnapshots: " + fileName + ": " + error);
+
+  return snapshots;
+}
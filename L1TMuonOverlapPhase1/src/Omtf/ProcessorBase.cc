@@ -142,25 +142,14 @@ void ProcessorBase<GoldenPatternType>::addGP(GoldenPatternType* aGP) {
 ////////////////////////////////////////////
 ////////////////////////////////////////////
 template <class GoldenPatternType>
-MuonStubPtrs1D ProcessorBase<GoldenPatternType>::restrictInput(unsigned int iProcessor,
-                                                               unsigned int iRegion,
-                                                               unsigned int iLayer,
-                                                               const OMTFinput& input) {
-  MuonStubPtrs1D layerStubs;
-
-  unsigned int iStart = myOmtfConfig->getConnections()[iProcessor][iRegion][iLayer].first;
-  unsigned int iEnd = iStart + myOmtfConfig->getConnections()[iProcessor][iRegion][iLayer].second - 1;
-
-  for (unsigned int iInput = 0; iInput < input.getMuonStubs()[iLayer].size(); ++iInput) {
-    if (iInput >= iStart && iInput <= iEnd) {
-      if (this->myOmtfConfig->isBendingLayer(iLayer)) {
-        layerStubs.push_back(input.getMuonStub(iLayer - 1, iInput));
-      } else
-        layerStubs.push_back(input.getMuonStub(iLayer, iInput));  //input.getHitPhi(iLayer, iInput)
-    }
-  }
-  //LogTrace("OMTFReconstruction") <<__FUNCTION__<<":"<<__LINE__<<" layerHits.size() "<<layerHits.size()<<std::endl;
-  return layerStubs;
+MuonStubPtrsView ProcessorBase<GoldenPatternType>::restrictInput(unsigned int iProcessor,
+                                                                 unsigned int iRegion,
+                                                                 unsigned int iLayer,
+                                                                 const OMTFinput& input) {
+  //for the bending layers the stubLayer is iLayer - 1
+  const OMTFConfiguration::LayerInputs& layerInputs = myOmtfConfig->getLayerInputs(iProcessor, iRegion, iLayer);
+
+  return MuonStubPtrsView(input.getMuonStubs()[layerInputs.stubLayer], layerInputs.iFirstInput, layerInputs.nInputs);
 }
 
 ////////////////////////////////////////////
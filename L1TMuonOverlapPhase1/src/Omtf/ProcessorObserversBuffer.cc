@@ -0,0 +1,52 @@
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/ProcessorObserversBuffer.h"
+
+void ProcessorObserversBuffer::observeProcesorBegin(unsigned int iProcessor, l1t::tftype mtfType) {
+  this->iProcessor = iProcessor;
+  this->mtfType = mtfType;
+  processorBegin = true;
+}
+
+void ProcessorObserversBuffer::addProcesorData(std::string key, boost::property_tree::ptree& procDataTree) {
+  procData.emplace_back(key, procDataTree);
+}
+
+void ProcessorObserversBuffer::observeProcesorEmulation(unsigned int iProcessor,
+                                                        l1t::tftype mtfType,
+                                                        const std::shared_ptr<OMTFinput>& input,
+                                                        const AlgoMuons& algoCandidates,
+                                                        const AlgoMuons& gbCandidates,
+                                                        const std::vector<l1t::RegionalMuonCand>& candMuons) {
+  this->iProcessor = iProcessor;
+  this->mtfType = mtfType;
+  this->input = input;
+  this->algoCandidates = algoCandidates;
+  this->gbCandidates = gbCandidates;
+  this->candMuons = candMuons;
+  processorEmulation = true;
+}
+
+void ProcessorObserversBuffer::replay(std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) {
+  //the order of the calls is the same as in the OMTFProcessor::run
+  if (processorBegin) {
+    for (auto& obs : observers)
+      obs->observeProcesorBegin(iProcessor, mtfType);
+  }
+
+  for (auto& keyAndTree : procData) {
+    for (auto& obs : observers)
+      obs->addProcesorData(keyAndTree.first, keyAndTree.second);
+  }
+
+  if (processorEmulation) {
+    for (auto& obs : observers)
+      obs->observeProcesorEmulation(iProcessor, mtfType, input, algoCandidates, gbCandidates, candMuons);
+  }
+
+  processorBegin = false;
+  procData.clear();
+  processorEmulation = false;
+  input.reset();
+  algoCandidates.clear();
+  gbCandidates.clear();
+  candMuons.clear();
+}
@@ -1,6 +1,7 @@
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigReader.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternWithStat.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternsBinaryFile.h"
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinput.h"
 #include "L1Trigger/RPCTrigger/interface/RPCConst.h"
 
@@ -238,16 +239,25 @@ GoldenPatternVec<GoldenPatternType> XMLConfigReader::readPatterns(const L1TMuonO
                                                                   const std::string &patternsFile,
                                                                   bool buildEmptyPatterns,
                                                                   bool resetNumbering) {
-  GoldenPatternVec<GoldenPatternType> aGPs;
-  aGPs.clear();
-
-  XMLPlatformUtils::Initialize();
-
   if (resetNumbering) {
     iGPNumber = 0;
     iPatternGroup = 0;
   }
 
+  ///the patterns converted with the omtfPatternsConverter can be given instead of the XML
+  if (GoldenPatternsBinaryFile::isBinaryFile(patternsFile)) {
+    GoldenPatternsBinaryFile binaryFile(patternsFile);
+    auto aGPs = binaryFile.buildPatterns<GoldenPatternType>(aConfig, buildEmptyPatterns, iGPNumber, iPatternGroup);
+    iGPNumber += aGPs.size();
+    iPatternGroup += binaryFile.header().nGroups;
+    return aGPs;
+  }
+
+  GoldenPatternVec<GoldenPatternType> aGPs;
+  aGPs.clear();
+
+  XMLPlatformUtils::Initialize();
+
   XMLCh *xmlGP = _toDOMS("GP");
   std::array<XMLCh *, 4> xmliPt = {{_toDOMS("iPt1"), _toDOMS("iPt2"), _toDOMS("iPt3"), _toDOMS("iPt4")}};
 
@@ -14,16 +14,6 @@ ProcConfigurationBase::ProcConfigurationBase() : cscLctCentralBx_(CSCConstants::
 
 ProcConfigurationBase::~ProcConfigurationBase() {}
 
-int ProcConfigurationBase::foldPhi(int phi) const {
-  int phiBins = nPhiBins();
-  if (phi > phiBins / 2)
-    return (phi - phiBins);
-  else if (phi < -phiBins / 2)
-    return (phi + phiBins);
-
-  return phi;
-}
-
 void ProcConfigurationBase::configureFromEdmParameterSet(const edm::ParameterSet& edmParameterSet) {
   if (edmParameterSet.exists("rpcMaxClusterSize")) {
     setRpcMaxClusterSize(edmParameterSet.getParameter<int>("rpcMaxClusterSize"));
@@ -61,4 +51,10 @@ void ProcConfigurationBase::configureFromEdmParameterSet(const edm::ParameterSet
     edm::LogVerbatim("OMTFReconstruction")
         << "minDtPhiBQuality: " << edmParameterSet.getParameter<int>("minDtPhiBQuality") << std::endl;
   }
+
+  if (edmParameterSet.exists("angleConverterCacheValidation")) {
+    angleConverterCacheValidation = edmParameterSet.getParameter<bool>("angleConverterCacheValidation");
+    edm::LogVerbatim("OMTFReconstruction") << "angleConverterCacheValidation: " << angleConverterCacheValidation
+                                           << std::endl;
+  }
 }
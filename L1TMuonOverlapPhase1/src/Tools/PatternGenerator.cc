@@ -6,6 +6,7 @@
  */
 
 #include "L1Trigger/L1TMuonOverlapPhase1/interface/Tools/PatternGenerator.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternsStatFile.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include <boost/range/adaptor/reversed.hpp>
@@ -23,7 +24,8 @@ PatternGenerator::PatternGenerator(const edm::ParameterSet& edmCfg,
   edm::LogImportant("l1tOmtfEventPrint") << "constructing PatternGenerator, type: "
                                          << edmCfg.getParameter<string>("patternGenerator") << std::endl;
 
-  if (edmCfg.getParameter<string>("patternGenerator") == "patternGen" || edmCfg.getParameter<string>("patternGenerator") == "2DHists")
+  if (edmCfg.getParameter<string>("patternGenerator") == "patternGen" || edmCfg.getParameter<string>("patternGenerator") == "2DHists" ||
+      edmCfg.getParameter<string>("patternGenerator") == "patternGenFromPartialStat")
     initPatternGen();
 
   //2DHists are done for the displaced muons, then using the propagation for the matching is needed
@@ -41,6 +43,11 @@ PatternGenerator::PatternGenerator(const edm::ParameterSet& edmCfg,
 PatternGenerator::~PatternGenerator() {}
 
 void PatternGenerator::initPatternGen() {
+  //the sparse storage allocates only the filled parts of the statistics, needed for the 2DHists with many ref layers
+  GoldenPatternWithStat::StatArrayType::Storage statStorage = GoldenPatternWithStat::StatArrayType::Storage::dense;
+  if (edmCfg.exists("sparsePatternStat") && edmCfg.getParameter<bool>("sparsePatternStat"))
+    statStorage = GoldenPatternWithStat::StatArrayType::Storage::sparse;
+
   //reseting the golden patterns
   unsigned int i = 0;
   for (auto& gp : goldenPatterns) {
@@ -60,7 +67,7 @@ void PatternGenerator::initPatternGen() {
     //if(statBinsCnt2 > 10 && omtfConfig->nRefLayers() > 2)
     //  throw cms::Exception("PatternGenerator::initPatternGen(): statBinsCnt2 and omtfConfig->nRefLayers() too big, will consume too much memory");
 
-    gp->iniStatisitics(statBinsCnt1, statBinsCnt2);
+    gp->iniStatisitics(statBinsCnt1, statBinsCnt2, statStorage);
 
     if(statBinsCnt2 < 10 && sizeof(gp->getStatistics()[0][0][0][0]) < 4) {
       edm::LogImportant("l1tOmtfEventPrint") << "PatternGenerator::initPatternGen():" << __LINE__
@@ -335,11 +342,29 @@ void PatternGenerator::endJob() {
     modifyClassProb(1);
   else if (edmCfg.getParameter<string>("patternGenerator") == "groupPatterns")
     groupPatterns();
-  else if (edmCfg.getParameter<string>("patternGenerator") == "patternGen") {
-    upadatePdfs();
+  else if (edmCfg.getParameter<string>("patternGenerator") == "patternGen" ||
+           edmCfg.getParameter<string>("patternGenerator") == "2DHists") {
+    //the job processes a part of the sample, only the partial statistics are written,
+    //the pdfs are made by the patternGenFromPartialStat from the merged statistics of all parts
+    if (edmCfg.exists("partialStatFile")) {
+      std::string partialStatFile = edmCfg.getParameter<std::string>("partialStatFile");
+      GoldenPatternsStatFile(goldenPatterns, eventCntPerGp).write(partialStatFile);
+      edm::LogImportant("l1tOmtfEventPrint")
+          << "PatternGenerator::endJob() partial statistics written to " << partialStatFile << std::endl;
+    } else
+      upadatePdfs();
     writeLayerStat = true;
   }
-  else if (edmCfg.getParameter<string>("patternGenerator") == "2DHists") {
+  else if (edmCfg.getParameter<string>("patternGenerator") == "patternGenFromPartialStat") {
+    //the statistics are integer counts, so the pdfs are the same as if the whole sample was processed by one job
+    GoldenPatternsStatFile mergedStat;
+    for (auto& partialStatFile : edmCfg.getParameter<std::vector<std::string> >("partialStatFiles")) {
+      edm::LogImportant("l1tOmtfEventPrint")
+          << "PatternGenerator::endJob() adding partial statistics " << partialStatFile << std::endl;
+      mergedStat.add(GoldenPatternsStatFile(partialStatFile));
+    }
+    mergedStat.addTo(goldenPatterns, eventCntPerGp);
+
     upadatePdfs();
     writeLayerStat = true;
   }
@@ -0,0 +1,122 @@
+/*
+ * OmtfCandidatesComparator.cc
+ *
+ * Compares the RegionalMuonCand collections produced by the OMTF emulator in different modes (e.g. serial and
+ * parallel processors), the tested collections must be identical to the reference one, in every bx and in the same
+ * order. Throws at the first difference, so that the cmsRun (and the unit test running it) fails.
+ */
+
+#include "DataFormats/L1TMuon/interface/RegionalMuonCand.h"
+#include "DataFormats/L1TMuon/interface/RegionalMuonCandFwd.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/global/EDAnalyzer.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include <atomic>
+#include <vector>
+
+class OmtfCandidatesComparator : public edm::global::EDAnalyzer<> {
+public:
+  explicit OmtfCandidatesComparator(const edm::ParameterSet& edmParameterSet);
+
+  void analyze(edm::StreamID, const edm::Event& iEvent, const edm::EventSetup& evSetup) const override;
+
+  void endJob() override;
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+private:
+  void compare(const edm::Event& iEvent,
+               const l1t::RegionalMuonCandBxCollection& reference,
+               const l1t::RegionalMuonCandBxCollection& tested,
+               const edm::InputTag& testedTag) const;
+
+  const edm::InputTag referenceTag;
+  const edm::EDGetTokenT<l1t::RegionalMuonCandBxCollection> referenceToken;
+
+  const std::vector<edm::InputTag> testedTags;
+  std::vector<edm::EDGetTokenT<l1t::RegionalMuonCandBxCollection> > testedTokens;
+
+  //the job fails if less candidates are produced, to be sure the comparison is not done on empty collections
+  const unsigned int minCandidates;
+
+  mutable std::atomic<unsigned int> eventCnt = 0;
+  mutable std::atomic<unsigned int> candidateCnt = 0;
+};
+
+OmtfCandidatesComparator::OmtfCandidatesComparator(const edm::ParameterSet& edmParameterSet)
+    : referenceTag(edmParameterSet.getParameter<edm::InputTag>("reference")),
+      referenceToken(consumes<l1t::RegionalMuonCandBxCollection>(referenceTag)),
+      testedTags(edmParameterSet.getParameter<std::vector<edm::InputTag> >("tested")),
+      minCandidates(edmParameterSet.getParameter<unsigned int>("minCandidates")) {
+  for (const auto& testedTag : testedTags)
+    testedTokens.push_back(consumes<l1t::RegionalMuonCandBxCollection>(testedTag));
+}
+
+void OmtfCandidatesComparator::analyze(edm::StreamID, const edm::Event& iEvent, const edm::EventSetup& evSetup) const {
+  const auto& reference = iEvent.get(referenceToken);
+
+  for (unsigned int iTested = 0; iTested < testedTokens.size(); iTested++)
+    compare(iEvent, reference, iEvent.get(testedTokens[iTested]), testedTags[iTested]);
+
+  eventCnt++;
+  candidateCnt += reference.size();
+}
+
+void OmtfCandidatesComparator::compare(const edm::Event& iEvent,
+                                       const l1t::RegionalMuonCandBxCollection& reference,
+                                       const l1t::RegionalMuonCandBxCollection& tested,
+                                       const edm::InputTag& testedTag) const {
+  if (reference.getFirstBX() != tested.getFirstBX() || reference.getLastBX() != tested.getLastBX())
+    throw cms::Exception("OmtfCandidatesComparator")
+        << iEvent.id() << " " << testedTag.encode() << ": bx range " << tested.getFirstBX() << " - "
+        << tested.getLastBX() << ", in the " << referenceTag.encode() << " " << reference.getFirstBX() << " - "
+        << reference.getLastBX();
+
+  for (int bx = reference.getFirstBX(); bx <= reference.getLastBX(); bx++) {
+    if (reference.size(bx) != tested.size(bx))
+      throw cms::Exception("OmtfCandidatesComparator")
+          << iEvent.id() << " bx " << bx << " " << testedTag.encode() << ": " << tested.size(bx)
+          << " candidates, in the " << referenceTag.encode() << " " << reference.size(bx);
+
+    for (unsigned int iCand = 0; iCand < reference.size(bx); iCand++) {
+      const auto& referenceCand = reference.at(bx, iCand);
+      const auto& testedCand = tested.at(bx, iCand);
+      if (!(referenceCand == testedCand))
+        throw cms::Exception("OmtfCandidatesComparator")
+            << iEvent.id() << " bx " << bx << " candidate " << iCand << " " << testedTag.encode()
+            << " differs from the " << referenceTag.encode() << ": processor " << testedCand.processor() << " pt "
+            << testedCand.hwPt() << " phi " << testedCand.hwPhi() << " eta " << testedCand.hwEta() << " quality "
+            << testedCand.hwQual() << ", in the reference processor " << referenceCand.processor() << " pt "
+            << referenceCand.hwPt() << " phi " << referenceCand.hwPhi() << " eta " << referenceCand.hwEta()
+            << " quality " << referenceCand.hwQual();
+    }
+  }
+}
+
+void OmtfCandidatesComparator::endJob() {
+  edm::LogVerbatim("OMTFReconstruction") << "OmtfCandidatesComparator: " << eventCnt << " events, " << candidateCnt
+                                         << " candidates in the " << referenceTag.encode() << ", identical in "
+                                         << testedTags.size() << " tested collections";
+
+  if (candidateCnt < minCandidates)
+    throw cms::Exception("OmtfCandidatesComparator")
+        << "only " << candidateCnt << " candidates were compared, expected at least " << minCandidates;
+}
+
+void OmtfCandidatesComparator::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::InputTag>("reference", edm::InputTag("simOmtfDigis", "OMTF"));
+  desc.add<std::vector<edm::InputTag> >("tested", {});
+  desc.add<unsigned int>("minCandidates", 1);
+  descriptions.add("omtfCandidatesComparator", desc);
+}
+
+DEFINE_FWK_MODULE(OmtfCandidatesComparator);
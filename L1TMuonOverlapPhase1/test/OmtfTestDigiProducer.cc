@@ -0,0 +1,162 @@
+/*
+ * OmtfTestDigiProducer.cc
+ *
+ * Produces the DT, CSC and RPC trigger digis for the OMTF unit tests from a text file (see makeOmtfTestDigis.py
+ * for the format), so that the emulator can be run by the cmsRun without the EDM input file.
+ * The digis of the given event are taken from the lines with the event number equal to the edm::EventID::event().
+ */
+
+#include "DataFormats/CSCDigi/interface/CSCCorrelatedLCTDigiCollection.h"
+#include "DataFormats/L1DTTrackFinder/interface/L1MuDTChambPhContainer.h"
+#include "DataFormats/L1DTTrackFinder/interface/L1MuDTChambThContainer.h"
+#include "DataFormats/MuonDetId/interface/CSCDetId.h"
+#include "DataFormats/MuonDetId/interface/RPCDetId.h"
+#include "DataFormats/RPCDigi/interface/RPCDigiCollection.h"
+#include "FWCore/Framework/interface/Event.h"
+#include "FWCore/Framework/interface/global/EDProducer.h"
+#include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/Utilities/interface/EDPutToken.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <fstream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+class OmtfTestDigiProducer : public edm::global::EDProducer<> {
+public:
+  explicit OmtfTestDigiProducer(const edm::ParameterSet& edmParameterSet);
+
+  void produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& evSetup) const override;
+
+  static void fillDescriptions(edm::ConfigurationDescriptions& descriptions);
+
+private:
+  struct CscDigi {
+    CSCDetId detId;
+    CSCCorrelatedLCTDigi digi;
+  };
+
+  struct RpcDigi {
+    RPCDetId detId;
+    RPCDigi digi;
+  };
+
+  struct EventDigis {
+    L1MuDTChambPhContainer::Phi_Container dtPhDigis;
+    L1MuDTChambThContainer::The_Container dtThDigis;
+    std::vector<CscDigi> cscDigis;
+    std::vector<RpcDigi> rpcDigis;
+  };
+
+  void readDigis(const std::string& fileName);
+
+  std::map<unsigned long long, EventDigis> eventsDigis;
+
+  const edm::EDPutTokenT<L1MuDTChambPhContainer> dtPhPutToken;
+  const edm::EDPutTokenT<L1MuDTChambThContainer> dtThPutToken;
+  const edm::EDPutTokenT<CSCCorrelatedLCTDigiCollection> cscPutToken;
+  const edm::EDPutTokenT<RPCDigiCollection> rpcPutToken;
+};
+
+OmtfTestDigiProducer::OmtfTestDigiProducer(const edm::ParameterSet& edmParameterSet)
+    : dtPhPutToken(produces<L1MuDTChambPhContainer>()),
+      dtThPutToken(produces<L1MuDTChambThContainer>()),
+      cscPutToken(produces<CSCCorrelatedLCTDigiCollection>()),
+      rpcPutToken(produces<RPCDigiCollection>()) {
+  readDigis(edmParameterSet.getParameter<edm::FileInPath>("digisFile").fullPath());
+}
+
+void OmtfTestDigiProducer::readDigis(const std::string& fileName) {
+  std::ifstream inFile(fileName);
+  if (!inFile)
+    throw cms::Exception("OmtfTestDigiProducer") << "cannot open the file " << fileName;
+
+  std::string line;
+  unsigned int iLine = 0;
+  unsigned int nDigis = 0;
+  while (std::getline(inFile, line)) {
+    iLine++;
+    if (line.empty() || line[0] == '#')
+      continue;
+
+    std::istringstream lineStream(line);
+    unsigned long long event = 0;
+    std::string type;
+    lineStream >> event >> type;
+
+    EventDigis& eventDigis = eventsDigis[event];
+    if (type == "DTPH") {
+      int bx, wheel, sector, station, phi, phiB, code;
+      lineStream >> bx >> wheel >> sector >> station >> phi >> phiB >> code;
+      eventDigis.dtPhDigis.emplace_back(bx, wheel, sector, station, phi, phiB, code, 0, 0);
+    } else if (type == "DTTH") {
+      int bx, wheel, sector, station;
+      int position[7], quality[7];
+      lineStream >> bx >> wheel >> sector >> station;
+      for (auto& pos : position)
+        lineStream >> pos;
+      for (auto& qual : quality)
+        lineStream >> qual;
+      eventDigis.dtThDigis.emplace_back(bx, wheel, sector, station, position, quality);
+    } else if (type == "CSC") {
+      int endcap, station, ring, chamber, quality, keyWireGroup, keyHalfStrip, pattern, bend, bx;
+      lineStream >> endcap >> station >> ring >> chamber >> quality >> keyWireGroup >> keyHalfStrip >> pattern >>
+          bend >> bx;
+      eventDigis.cscDigis.push_back({CSCDetId(endcap, station, ring, chamber, 0),
+                                     CSCCorrelatedLCTDigi(1, 1, quality, keyWireGroup, keyHalfStrip, pattern, bend, bx)});
+    } else if (type == "RPC") {
+      int region, ring, station, sector, layer, subsector, roll, strip, bx;
+      lineStream >> region >> ring >> station >> sector >> layer >> subsector >> roll >> strip >> bx;
+      eventDigis.rpcDigis.push_back(
+          {RPCDetId(region, ring, station, sector, layer, subsector, roll), RPCDigi(strip, bx)});
+    } else {
+      throw cms::Exception("OmtfTestDigiProducer")
+          << fileName << " line " << iLine << ": unknown digi type " << type;
+    }
+
+    if (lineStream.fail())
+      throw cms::Exception("OmtfTestDigiProducer") << fileName << " line " << iLine << ": wrong format: " << line;
+    nDigis++;
+  }
+
+  edm::LogVerbatim("OMTFReconstruction") << "OmtfTestDigiProducer: read " << nDigis << " digis of "
+                                         << eventsDigis.size() << " events from " << fileName;
+}
+
+void OmtfTestDigiProducer::produce(edm::StreamID, edm::Event& iEvent, const edm::EventSetup& evSetup) const {
+  L1MuDTChambPhContainer dtPhDigis;
+  L1MuDTChambThContainer dtThDigis;
+  CSCCorrelatedLCTDigiCollection cscDigis;
+  RPCDigiCollection rpcDigis;
+
+  auto eventDigis = eventsDigis.find(iEvent.id().event());
+  if (eventDigis != eventsDigis.end()) {
+    dtPhDigis.setContainer(eventDigis->second.dtPhDigis);
+    dtThDigis.setContainer(eventDigis->second.dtThDigis);
+    for (const auto& cscDigi : eventDigis->second.cscDigis)
+      cscDigis.insertDigi(cscDigi.detId, cscDigi.digi);
+    for (const auto& rpcDigi : eventDigis->second.rpcDigis)
+      rpcDigis.insertDigi(rpcDigi.detId, rpcDigi.digi);
+  }
+
+  iEvent.emplace(dtPhPutToken, std::move(dtPhDigis));
+  iEvent.emplace(dtThPutToken, std::move(dtThDigis));
+  iEvent.emplace(cscPutToken, std::move(cscDigis));
+  iEvent.emplace(rpcPutToken, std::move(rpcDigis));
+}
+
+void OmtfTestDigiProducer::fillDescriptions(edm::ConfigurationDescriptions& descriptions) {
+  edm::ParameterSetDescription desc;
+  desc.add<edm::FileInPath>("digisFile", edm::FileInPath("L1Trigger/L1TMuonOverlapPhase1/test/omtfTestDigis.txt"));
+  descriptions.add("omtfTestDigis", desc);
+}
+
+DEFINE_FWK_MODULE(OmtfTestDigiProducer);
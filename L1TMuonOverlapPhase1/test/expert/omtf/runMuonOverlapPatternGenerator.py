@@ -193,6 +193,11 @@ process.simOmtfDigis.patternsXMLFile = cms.FileInPath("L1Trigger/L1TMuonOverlapP
 #)
 
 process.simOmtfDigis.patternGenerator = cms.string("patternGen")
+#to split the sample between many jobs: each job writes only its partial statistics,
+#then one job with patternGenerator = "patternGenFromPartialStat" (and no input events) merges them and makes the pdfs
+#process.simOmtfDigis.partialStatFile = cms.string("partialStat_job0.bin")
+#process.simOmtfDigis.patternGenerator = cms.string("patternGenFromPartialStat")
+#process.simOmtfDigis.partialStatFiles = cms.vstring("partialStat_job0.bin", "partialStat_job1.bin")
 
 process.simOmtfDigis.patternType = cms.string("GoldenPatternWithStat")
 process.simOmtfDigis.generatePatterns = cms.bool(True)
@@ -208,6 +213,10 @@ process.simOmtfDigis.minDtPhiBQuality = cms.int32(4)
 process.simOmtfDigis.dtRefHitMinQuality =  cms.int32(4)
 
 process.simOmtfDigis.usePhiBExtrapolationFromMB1 = cms.bool(True)
+#the ExtrapolationFactors_withQAndEta.xml is expected in this directory (it was read from the working directory before),
+#without the extrapolFactorsFile the ExtrapolFactorsTable::defaultFile from the omtf_config is used,
+#the binary file made with the omtfExtrapolFactorsConverter can be given instead of the XML
+process.simOmtfDigis.extrapolFactorsFile = cms.FileInPath("L1Trigger/L1TMuonOverlapPhase1/test/expert/omtf/ExtrapolationFactors_withQAndEta.xml")
 process.simOmtfDigis.usePhiBExtrapolationFromMB2 = cms.bool(True)
 
 process.simOmtfDigis.goldenPatternResultFinalizeFunction = cms.int32(3) ## is needed here , becasue it just counts the number of layers with a stub
@@ -246,6 +246,7 @@ process.simOmtfDigis.patternsXMLFile = cms.FileInPath("L1Trigger/L1TMuonOverlapP
 
 #process.simOmtfDigis.patternGenerator = cms.string("patternGen")
 process.simOmtfDigis.patternGenerator = cms.string("2DHists")
+process.simOmtfDigis.sparsePatternStat = cms.bool(True) #the 2DHists statistics are mostly empty, allocate only the filled tiles
 
 
 process.simOmtfDigis.patternType = cms.string("GoldenPatternWithStat")
@@ -263,6 +264,9 @@ process.simOmtfDigis.dtRefHitMinQuality =  cms.int32(4)
 
 process.simOmtfDigis.usePhiBExtrapolationFromMB1 = cms.bool(True)
 process.simOmtfDigis.usePhiBExtrapolationFromMB2 = cms.bool(True)
+#the ExtrapolationFactors_withQAndEta.xml is expected in this directory (it was read from the working directory before),
+#without the extrapolFactorsFile the ExtrapolFactorsTable::defaultFile from the omtf_config is used
+process.simOmtfDigis.extrapolFactorsFile = cms.FileInPath("L1Trigger/L1TMuonOverlapPhase1/test/expert/omtf/ExtrapolationFactors_withQAndEta.xml")
 
 process.simOmtfDigis.goldenPatternResultFinalizeFunction = cms.int32(3) ## is needed here , becasue it just counts the number of layers with a stub
 process.simOmtfDigis.lctCentralBx = cms.int32(cscBx);#<<<<<<<<<<<<<<<<!!!!!!!!!!!!!!!!!!!!TODO this was changed in CMSSW 10(?) to 8. if the data were generated with the previous CMSSW then you have to use 6
@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# Generates the omtfTestDigis.txt read by the OmtfTestDigiProducer in the OMTF unit tests.
+# The digis are not a simulation, they only resemble muons crossing the overlap region: a few DT, CSC and RPC hits
+# along a slightly bending track, plus some RPC noise. They are meant to give the emulator enough inputs to build
+# candidates in all processors, so that the different emulation modes can be compared on the same events.
+# The file is checked in, rerun the script only if the format of the lines is changed.
+#
+# Line formats (one digi per line, the first field is the event number):
+# <event> DTPH <bx> <wheel> <sector> <station> <phi> <phiB> <code>
+# <event> DTTH <bx> <wheel> <sector> <station> <position x 7> <quality x 7>
+# <event> CSC <endcap> <station> <ring> <chamber> <quality> <keyWireGroup> <keyHalfStrip> <pattern> <bend> <bx>
+# <event> RPC <region> <ring> <station> <sector> <layer> <subsector> <roll> <strip> <bx>
+
+import math
+import random
+import sys
+
+nEvents = 100
+lctCentralBx = 8
+
+rnd = random.Random(20241017)
+
+
+def dtDigis(event, bx, side, phi, eta, bend, lines):
+    wheel = 2 * side
+    sector = int(round(phi / 30.)) % 12
+    #phi of the track in the stations 1, 2, 3 (in degrees), and the phiB (1/512 rad)
+    for station, phiShift, phiB in ((1, 0., 250.), (2, 4., 170.), (3, 8., 90.)):
+        if station == 3 and abs(eta) > 1.0:
+            continue
+        phiSt = phi + bend * phiShift
+        localPhi = math.radians(phiSt - sector * 30.)
+        if localPhi > math.pi:
+            localPhi -= 2 * math.pi
+        if localPhi < -math.pi:
+            localPhi += 2 * math.pi
+        phiHw = int(round(localPhi * 4096))
+        phiBHw = max(-511, min(511, int(round(-bend * phiB + rnd.gauss(0, 5)))))
+        code = rnd.choice((4, 5, 6, 6))
+        lines.append("%d DTPH %d %d %d %d %d %d %d" % (event, bx, wheel, sector, station, phiHw, phiBHw, code))
+
+        if station < 3 and rnd.random() < 0.7:
+            position = [0] * 7
+            quality = [0] * 7
+            #eta 0.8 - 1.2 mapped on the 7 bits, the order is reversed for the negative wheels
+            iBit = max(0, min(6, int((abs(eta) - 0.8) / 0.4 * 7)))
+            if side < 0:
+                iBit = 6 - iBit
+            position[iBit] = 1
+            quality[iBit] = rnd.choice((0, 1))
+            lines.append("%d DTTH %d %d %d %d %s %s" % (event, bx, wheel, sector, station,
+                                                        " ".join(str(p) for p in position),
+                                                        " ".join(str(q) for q in quality)))
+
+
+def cscDigis(event, bx, side, phi, eta, bend, lines):
+    endcap = 1 if side > 0 else 2
+    #(station, ring, phi shift, number of half strips, number of wire groups)
+    for station, ring, phiShift, nHalfStrips, nWireGroups in ((1, 3, 2., 128, 32), (2, 2, 6., 160, 64),
+                                                             (3, 2, 9., 160, 64)):
+        if station == 1 and abs(eta) > 1.15:
+            continue
+        if station > 1 and abs(eta) < 1.0:
+            continue
+        phiSt = (phi + bend * phiShift) % 360.
+        chamber = int(round(phiSt / 10.)) % 36 + 1
+        localPhi = phiSt - (chamber - 1) * 10.
+        if localPhi > 180.:
+            localPhi -= 360.
+        halfStrip = max(0, min(nHalfStrips - 1, int(nHalfStrips / 2 + localPhi / 10. * nHalfStrips)))
+        wireGroup = rnd.randrange(2, nWireGroups - 2)
+        quality = rnd.randrange(11, 16)
+        pattern = rnd.randrange(6, 11)
+        lines.append("%d CSC %d %d %d %d %d %d %d %d %d %d" % (event, endcap, station, ring, chamber, quality,
+                                                               wireGroup, halfStrip, pattern, 0,
+                                                               lctCentralBx + bx))
+
+
+def rpcDigis(event, bx, side, phi, eta, bend, lines):
+    if abs(eta) < 1.05:
+        #barrel, (station, layer, roll, phi shift)
+        sector = int(round(phi / 30.)) % 12 + 1
+        for station, layer, roll, phiShift in ((1, 1, 1, 0.), (1, 2, 1, 1.), (2, 1, 1, 4.)):
+            phiSt = phi + bend * phiShift
+            localPhi = (phiSt - (sector - 1) * 30. + 180.) % 360. - 180.
+            strip = max(1, min(72, int((localPhi + 15.) / 30. * 72) + 1))
+            for iStrip in range(rnd.choice((1, 1, 2))):
+                lines.append("%d RPC %d %d %d %d %d %d %d %d %d" % (event, 0, 2 * side, station, sector, layer, 1,
+                                                                    roll, strip + iStrip, bx))
+    if abs(eta) > 0.95:
+        #endcap, ring 3, (station, phi shift)
+        region = 1 if side > 0 else -1
+        for station, phiShift in ((1, 2.), (2, 6.), (3, 9.)):
+            phiSt = (phi + bend * phiShift) % 360.
+            chamber = int(round(phiSt / 10.)) % 36
+            localPhi = (phiSt - chamber * 10. + 180.) % 360. - 180.
+            strip = max(1, min(32, int((localPhi + 5.) / 10. * 32) + 1))
+            lines.append("%d RPC %d %d %d %d %d %d %d %d %d" % (event, region, 3, station, chamber // 6 + 1, 1,
+                                                                chamber % 6 + 1, rnd.randrange(1, 4), strip, bx))
+
+
+def noiseDigis(event, lines):
+    for iNoise in range(rnd.randrange(0, 3)):
+        side = rnd.choice((-1, 1))
+        lines.append("%d RPC %d %d %d %d %d %d %d %d %d" % (event, 0, 2 * side, 1, rnd.randrange(1, 13),
+                                                            rnd.choice((1, 2)), 1, 1, rnd.randrange(1, 73),
+                                                            rnd.choice((-1, 0, 0, 1))))
+
+
+def main(fileName):
+    lines = []
+    for event in range(1, nEvents + 1):
+        for iMuon in range(rnd.choice((1, 1, 2, 3))):
+            side = rnd.choice((-1, 1))
+            phi = rnd.uniform(0., 360.)
+            eta = side * rnd.uniform(0.85, 1.2)
+            #the bending grows with the 1/pt, the sign is the charge
+            bend = rnd.choice((-1, 1)) * rnd.uniform(0.05, 1.)
+            bx = rnd.choice((-1, 0, 0, 0, 0, 1))
+            dtDigis(event, bx, side, phi, eta, bend, lines)
+            cscDigis(event, bx, side, phi, eta, bend, lines)
+            rpcDigis(event, bx, side, phi, eta, bend, lines)
+        noiseDigis(event, lines)
+
+    with open(fileName, "w") as out:
+        out.write("# generated with makeOmtfTestDigis.py, see there for the format of the lines\n")
+        for line in lines:
+            out.write(line + "\n")
+
+
+if __name__ == "__main__":
+    main(sys.argv[1] if len(sys.argv) > 1 else "omtfTestDigis.txt")
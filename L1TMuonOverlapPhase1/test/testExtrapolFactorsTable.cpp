@@ -0,0 +1,167 @@
+/*
+ * testExtrapolFactorsTable.cpp
+ *
+ * Checks that the ExtrapolFactorsTable read from the ExtrapolationFactors XML and from the binary file made from it
+ * gives exactly the same extrapolated phi as the map lookup and the division used before in the
+ * OMTFProcessor::extrapolateDtPhiBFP, on random (refLayer, layer, key, refPhiB) inputs,
+ * and that the files with the keys or layers out of range are rejected.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/ExtrapolFactorsTable.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  const int multiplier = 128;
+  const unsigned int nRefLayers = 2;
+  const unsigned int nLayers = 18;
+
+  //[refLayer][layer][key], as the OMTFProcessor::extrapolFactors
+  typedef std::vector<std::vector<std::map<int, double> > > FactorsMap;
+
+  //the keys as in the OMTFProcessor::extrapolateDtPhiBFP: the quality, 0 or the eta2Bits
+  std::vector<unsigned int> layerKeys(unsigned int iLayer) {
+    if (iLayer == 0 || iLayer == 2 || iLayer == 4)
+      return {0, 1, 2, 3, 4, 5, 6};
+    if (iLayer >= 10 && iLayer <= 14)
+      return {0};
+    if ((iLayer >= 6 && iLayer <= 9) || (iLayer >= 15 && iLayer <= 17))
+      return {1, 2, 4, 8, 16, 32, 64, 128, 256};
+    return {};
+  }
+
+  void writeXml(const FactorsMap& factors, const std::string& fileName) {
+    boost::property_tree::ptree tree;
+    auto& factorsTree = tree.add("ExtrapolationFactors", "");
+    factorsTree.add("<xmlattr>.multiplier", multiplier);
+    for (unsigned int iRefLayer = 0; iRefLayer < factors.size(); iRefLayer++) {
+      for (unsigned int iLayer = 0; iLayer < factors[iRefLayer].size(); iLayer++) {
+        if (factors[iRefLayer][iLayer].empty())
+          continue;
+        auto& lutTree = factorsTree.add("Lut", "");
+        lutTree.add("<xmlattr>.RefLayer", iRefLayer);
+        lutTree.add("<xmlattr>.Layer", iLayer);
+        for (auto& keyValue : factors[iRefLayer][iLayer]) {
+          auto& lutValTree = lutTree.add("LutVal", "");
+          lutValTree.add("<xmlattr>.key", keyValue.first);
+          lutValTree.add("<xmlattr>.value", keyValue.second);
+        }
+      }
+    }
+    boost::property_tree::write_xml(fileName, tree);
+  }
+
+  ///the factors as read before by the OMTFProcessor::loadExtrapolFactors
+  FactorsMap readMap(const std::string& fileName) {
+    FactorsMap factors(nRefLayers, std::vector<std::map<int, double> >(nLayers));
+    boost::property_tree::ptree tree;
+    boost::property_tree::read_xml(fileName, tree);
+    for (auto& lutNode : tree.get_child("ExtrapolationFactors")) {
+      if (lutNode.first != "Lut")
+        continue;
+      int iRefLayer = lutNode.second.get<int>("<xmlattr>.RefLayer");
+      int iLayer = lutNode.second.get<int>("<xmlattr>.Layer");
+      for (auto& valueNode : lutNode.second) {
+        if (valueNode.first == "LutVal")
+          factors.at(iRefLayer).at(iLayer)[valueNode.second.get<int>("<xmlattr>.key")] =
+              valueNode.second.get<float>("<xmlattr>.value");
+      }
+    }
+    return factors;
+  }
+}  // namespace
+
+TEST_CASE("ExtrapolFactorsTable gives the same phiExtr as the map of the factors", "[ExtrapolFactorsTable]") {
+  std::mt19937 generator(12345);
+  std::uniform_real_distribution<double> factorDist(-400, 400);
+
+  //some keys are left out, their factors are 0
+  FactorsMap randomFactors(nRefLayers, std::vector<std::map<int, double> >(nLayers));
+  for (unsigned int iRefLayer = 0; iRefLayer < nRefLayers; iRefLayer++) {
+    for (unsigned int iLayer = 0; iLayer < nLayers; iLayer++) {
+      for (auto key : layerKeys(iLayer)) {
+        if (generator() % 5 != 0)
+          randomFactors[iRefLayer][iLayer][key] = factorDist(generator);
+      }
+    }
+  }
+
+  const std::string xmlFile = "testExtrapolFactorsTable.xml";
+  const std::string binaryFile = "testExtrapolFactorsTable.bin";
+  writeXml(randomFactors, xmlFile);
+
+  FactorsMap factorsMap = readMap(xmlFile);
+
+  ExtrapolFactorsTable xmlTable;
+  xmlTable.read(xmlFile);
+  REQUIRE(!ExtrapolFactorsTable::isBinaryFile(xmlFile));
+  REQUIRE(xmlTable.getMultiplier() == multiplier);
+
+  xmlTable.writeBinary(binaryFile);
+  REQUIRE(ExtrapolFactorsTable::isBinaryFile(binaryFile));
+  ExtrapolFactorsTable binaryTable;
+  binaryTable.read(binaryFile);
+
+  std::uniform_int_distribution<int> refPhiBDist(-1023, 1023);
+  const unsigned int nInputs = 1000000;
+  unsigned int nDifferent = 0;
+  unsigned int nNonZero = 0;
+  for (unsigned int iInput = 0; iInput < nInputs; iInput++) {
+    unsigned int iRefLayer = generator() % nRefLayers;
+    unsigned int iLayer = generator() % nLayers;
+    //mostly the keys used by the extrapolateDtPhiBFP, sometimes any key
+    std::vector<unsigned int> keys = layerKeys(iLayer);
+    unsigned int key = (keys.empty() || generator() % 10 == 0) ? generator() % ExtrapolFactorsTable::maxKeys
+                                                                : keys[generator() % keys.size()];
+    int refPhiB = refPhiBDist(generator);
+
+    //as in the OMTFProcessor::extrapolateDtPhiBFP before, the factor was truncated to int
+    auto& layerFactors = factorsMap[iRefLayer][iLayer];
+    auto factorIt = layerFactors.find(key);
+    int extrFactor = factorIt != layerFactors.end() ? (int)factorIt->second : 0;
+    int expectedPhiExtr = extrFactor * refPhiB / multiplier;
+
+    int xmlPhiExtr = xmlTable.extrapolate(iRefLayer, iLayer, key, refPhiB);
+    int binaryPhiExtr = binaryTable.extrapolate(iRefLayer, iLayer, key, refPhiB);
+    if (xmlPhiExtr != expectedPhiExtr || binaryPhiExtr != expectedPhiExtr) {
+      if (nDifferent < 10)
+        UNSCOPED_INFO("refLayer " << iRefLayer << " layer " << iLayer << " key " << key << " refPhiB " << refPhiB
+                                  << ": expected " << expectedPhiExtr << " xml " << xmlPhiExtr << " binary "
+                                  << binaryPhiExtr);
+      nDifferent++;
+    }
+    if (expectedPhiExtr != 0)
+      nNonZero++;
+  }
+
+  INFO("non-zero phiExtr " << nNonZero);
+  REQUIRE(nNonZero > 0);
+  REQUIRE(nDifferent == 0);
+}
+
+TEST_CASE("ExtrapolFactorsTable rejects the keys and layers out of range", "[ExtrapolFactorsTable]") {
+  const std::string xmlFile = "testExtrapolFactorsTable_outOfRange.xml";
+
+  FactorsMap factors(nRefLayers, std::vector<std::map<int, double> >(nLayers));
+  factors[0][0][ExtrapolFactorsTable::maxKeys] = 10;
+  writeXml(factors, xmlFile);
+  ExtrapolFactorsTable keyTable;
+  REQUIRE_THROWS_AS(keyTable.readXml(xmlFile), cms::Exception);
+
+  factors.assign(nRefLayers + 1, std::vector<std::map<int, double> >(nLayers));
+  factors[nRefLayers][0][0] = 10;
+  writeXml(factors, xmlFile);
+  ExtrapolFactorsTable refLayerTable;
+  REQUIRE_THROWS_AS(refLayerTable.readXml(xmlFile), cms::Exception);
+}
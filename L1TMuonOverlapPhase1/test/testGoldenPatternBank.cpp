@@ -0,0 +1,111 @@
+/*
+ * testGoldenPatternBank.cpp
+ *
+ * Checks that the GoldenPatternBank (the processorType "OMTFProcessorPatternBank") gives exactly the same StubResults
+ * as the GoldenPattern::process1Layer1RefLayer, on random stubs and with the patterns from the cms-data.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternBank.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessingContext.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigReader.h"
+
+#include "CondFormats/L1TObjects/interface/L1TMuonOverlapParams.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+TEST_CASE("GoldenPatternBank gives the same StubResults as the GoldenPattern", "[GoldenPatternBank]") {
+  L1TMuonOverlapParams omtfParams;
+  XMLConfigReader configReader;
+  configReader.setConfigFile(
+      edm::FileInPath("L1Trigger/L1TMuon/data/omtf_config/hwToLogicLayer_0x0008.xml").fullPath());
+  configReader.readConfig(&omtfParams);
+
+  OMTFConfiguration omtfConfig;
+  omtfConfig.configure(&omtfParams);
+
+  XMLConfigReader reader;
+  GoldenPatternVec<GoldenPattern> gps = reader.readPatterns<GoldenPattern>(
+      omtfParams,
+      edm::FileInPath("L1Trigger/L1TMuon/data/omtf_config/"
+                      "Patterns_0x00012_oldSample_3_30Files_grouped1_classProb17_recalib2.xml")
+          .fullPath(),
+      false);
+  REQUIRE(!gps.empty());
+
+  GoldenPatternBank patternBank(&omtfConfig, gps);
+  OMTFProcessingContext context(&omtfConfig, gps.size());
+
+  std::mt19937 generator(12345);
+  std::uniform_int_distribution<int> refPhiDist(-1000, 1000);
+  //wider than the pdf range, so that also the stubs outside the pdf are tested
+  std::uniform_int_distribution<int> deltaPhiDist(-300, 300);
+  std::uniform_int_distribution<int> phiBDist(-150, 150);
+  std::uniform_int_distribution<int> extrapolatedPhiDist(-20, 20);
+  std::uniform_int_distribution<int> occupancyDist(0, 3);
+
+  const unsigned int procIndx = 0;
+  const unsigned int iRefHit = 0;
+  const unsigned int nCases = 100000;
+
+  unsigned int nDifferent = 0;
+  for (unsigned int iCase = 0; iCase < nCases; iCase++) {
+    omtfConfig.setNoHitValueInPdf(iCase % 2);
+
+    unsigned int iRefLayer = generator() % omtfConfig.nRefLayers();
+    unsigned int iLayer = generator() % omtfConfig.nLayers();
+
+    int refPhi = refPhiDist(generator);
+    auto refStub = std::make_shared<MuonStub>(refPhi, phiBDist(generator));
+    refStub->qualityHw = 4;
+
+    MuonStubPtrs1D stubs(omtfConfig.nInputs());
+    std::vector<int> extrapolatedPhi(omtfConfig.nInputs(), 0);
+    for (unsigned int iInput = 0; iInput < stubs.size(); iInput++) {
+      if (occupancyDist(generator) == 0) {
+        stubs[iInput] = std::make_shared<MuonStub>(refPhi + deltaPhiDist(generator), phiBDist(generator));
+        //the stubs with phi >= nPhiBins are skipped in the processing
+        if (generator() % 50 == 0)
+          stubs[iInput]->phiHw = omtfConfig.nPhiBins();
+      }
+      if (iCase % 4 == 0)
+        extrapolatedPhi[iInput] = extrapolatedPhiDist(generator);
+    }
+    MuonStubPtrsView layerStubs(stubs);
+
+    patternBank.process1Layer1RefLayer(
+        context, procIndx, iRefHit, iRefLayer, iLayer, layerStubs, extrapolatedPhi, refStub);
+
+    for (unsigned int iGP = 0; iGP < gps.size(); iGP++) {
+      if (gps[iGP]->key().thePt == 0)  //empty pattern
+        continue;
+
+      StubResult expected = gps[iGP]->process1Layer1RefLayer(iRefLayer, iLayer, layerStubs, extrapolatedPhi, refStub);
+      const StubResult& result = context.getResults(iGP)[procIndx][iRefHit].getStubResults()[iLayer];
+
+      //the pdfVal is compared bitwise, both paths must read the same value from the pattern
+      PdfValueType resultPdfVal = result.getPdfVal();
+      PdfValueType expectedPdfVal = expected.getPdfVal();
+      if (std::memcmp(&resultPdfVal, &expectedPdfVal, sizeof(PdfValueType)) != 0 ||
+          result.getValid() != expected.getValid() || result.getPdfBin() != expected.getPdfBin() ||
+          result.getMuonStub() != expected.getMuonStub()) {
+        if (nDifferent < 10)
+          UNSCOPED_INFO("case " << iCase << " pattern " << gps[iGP]->key() << " iRefLayer " << iRefLayer << " iLayer "
+                                << iLayer << ": pdfVal " << result.getPdfVal() << " vs " << expected.getPdfVal()
+                                << ", valid " << result.getValid() << " vs " << expected.getValid() << ", pdfBin "
+                                << result.getPdfBin() << " vs " << expected.getPdfBin());
+        nDifferent++;
+      }
+    }
+  }
+
+  REQUIRE(nDifferent == 0);
+}
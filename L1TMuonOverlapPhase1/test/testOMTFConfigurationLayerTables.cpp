@@ -0,0 +1,96 @@
+/*
+ * testOMTFConfigurationLayerTables.cpp
+ *
+ * Checks that the OMTFConfiguration layer tables (getLogicLayer, getHwLayer, getConnectedLayer, isBendingLayer)
+ * give the same as the maps they are built from, for all indices and for every hwToLogicLayer_0x*.xml
+ * version in the omtf_config of the cms-data.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigReader.h"
+
+#include "CondFormats/L1TObjects/interface/L1TMuonOverlapParams.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+  std::vector<std::string> configFiles() {
+    //the version used in the fakeOmtfParams_cff gives the directory with all versions
+    std::filesystem::path configDir =
+        std::filesystem::path(edm::FileInPath("L1Trigger/L1TMuon/data/omtf_config/hwToLogicLayer_0x0008.xml").fullPath())
+            .parent_path();
+
+    std::vector<std::string> files;
+    for (const auto& entry : std::filesystem::directory_iterator(configDir)) {
+      const std::string fileName = entry.path().filename().string();
+      if (fileName.rfind("hwToLogicLayer_0x", 0) == 0 && entry.path().extension() == ".xml")
+        files.push_back(entry.path().string());
+    }
+    std::sort(files.begin(), files.end());
+    return files;
+  }
+
+  int mapValue(const std::map<int, int>& map, int key) {
+    auto it = map.find(key);
+    return it != map.end() ? it->second : -1;
+  }
+}  // namespace
+
+TEST_CASE("OMTFConfiguration layer tables give the same as the layer maps", "[OMTFConfiguration]") {
+  std::vector<std::string> files = configFiles();
+  REQUIRE(!files.empty());
+
+  for (const auto& configFile : files) {
+    INFO("config " << configFile);
+
+    L1TMuonOverlapParams omtfParams;
+    XMLConfigReader configReader;
+    configReader.setConfigFile(configFile);
+    configReader.readConfig(&omtfParams);
+
+    OMTFConfiguration omtfConfig;
+    omtfConfig.configure(&omtfParams);
+
+    unsigned int nDifferent = 0;
+    //also the indices beyond the tables, for which -1 (false) is expected
+    for (unsigned int hwNumber = 0; hwNumber < OMTFConfiguration::hwLayerNumbersCnt + 16; hwNumber++) {
+      int expected = mapValue(omtfConfig.getHwToLogicLayer(), hwNumber);
+      if (omtfConfig.getLogicLayer(hwNumber) != expected) {
+        if (nDifferent++ < 10)
+          UNSCOPED_INFO("getLogicLayer(" << hwNumber << ") " << omtfConfig.getLogicLayer(hwNumber) << " expected "
+                                         << expected);
+      }
+    }
+
+    for (unsigned int iLayer = 0; iLayer < OMTFConfiguration::maxLayers + 16; iLayer++) {
+      int expectedHw = mapValue(omtfConfig.getLogicToHwLayer(), iLayer);
+      int expectedConnected = mapValue(omtfConfig.getLogicToLogic(), iLayer);
+      bool expectedBending = omtfConfig.getBendingLayers().count(iLayer);
+
+      if (omtfConfig.getHwLayer(iLayer) != expectedHw || omtfConfig.getConnectedLayer(iLayer) != expectedConnected ||
+          omtfConfig.isBendingLayer(iLayer) != expectedBending) {
+        if (nDifferent++ < 10)
+          UNSCOPED_INFO("logic layer " << iLayer << " getHwLayer " << omtfConfig.getHwLayer(iLayer) << " expected "
+                                       << expectedHw << " getConnectedLayer " << omtfConfig.getConnectedLayer(iLayer)
+                                       << " expected " << expectedConnected << " isBendingLayer "
+                                       << omtfConfig.isBendingLayer(iLayer) << " expected " << expectedBending);
+      }
+    }
+    REQUIRE(nDifferent == 0);
+
+    //the GoldenPatternResult::finalise* need the connected layer of every logic layer
+    for (unsigned int iLayer = 0; iLayer < omtfConfig.nLayers(); iLayer++) {
+      INFO("logic layer " << iLayer);
+      REQUIRE(omtfConfig.getConnectedLayer(iLayer) >= 0);
+      REQUIRE(omtfConfig.getConnectedLayer(iLayer) < (int)omtfConfig.nLayers());
+    }
+  }
+}
@@ -0,0 +1,147 @@
+/*
+ * testOMTFSorterFused.cpp
+ *
+ * Checks that the fused sorting (the best candidates selected while the results of the patterns are finalised)
+ * gives exactly the same refHit candidates and final candidates as the scan of all results in the
+ * OMTFSorter::sortRefHitResults (fusedSorting = false), on random stubs and with the patterns from the cms-data.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPattern.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFinput.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessingContext.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFProcessor.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigReader.h"
+
+#include "CondFormats/L1TObjects/interface/L1TMuonOverlapParams.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+  bool sameCandidate(const AlgoMuon& fused, const AlgoMuon& scanned) {
+    //the pdfSum is compared bitwise, both modes must select the same pattern result
+    PdfValueType fusedPdfSum = fused.getGpResult().getPdfSum();
+    PdfValueType scannedPdfSum = scanned.getGpResult().getPdfSum();
+    PdfValueType fusedPdfSumUpt = fused.getGpResultUpt().getPdfSum();
+    PdfValueType scannedPdfSumUpt = scanned.getGpResultUpt().getPdfSum();
+
+    auto uptPatternNumber = [](const AlgoMuon& algoMuon) {
+      return algoMuon.getGoldenPaternUpt() ? (int)algoMuon.getGoldenPaternUpt()->key().theNumber : -1;
+    };
+
+    return fused.isValid() == scanned.isValid() && fused.getRefHitNumber() == scanned.getRefHitNumber() &&
+           fused.getPatternNumber() == scanned.getPatternNumber() &&
+           uptPatternNumber(fused) == uptPatternNumber(scanned) &&
+           fused.getFiredLayerCnt() == scanned.getFiredLayerCnt() &&
+           fused.getFiredLayerBits() == scanned.getFiredLayerBits() &&
+           std::memcmp(&fusedPdfSum, &scannedPdfSum, sizeof(PdfValueType)) == 0 &&
+           std::memcmp(&fusedPdfSumUpt, &scannedPdfSumUpt, sizeof(PdfValueType)) == 0;
+  }
+}  // namespace
+
+TEST_CASE("fused sorting gives the same candidates as the scan of all results", "[OMTFSorter]") {
+  L1TMuonOverlapParams omtfParams;
+  XMLConfigReader configReader;
+  configReader.setConfigFile(
+      edm::FileInPath("L1Trigger/L1TMuon/data/omtf_config/hwToLogicLayer_0x0008.xml").fullPath());
+  configReader.readConfig(&omtfParams);
+
+  edm::ParameterSet fusedCfg;
+  fusedCfg.addParameter<bool>("fusedSorting", true);
+
+  edm::ParameterSet scanCfg;
+  scanCfg.addParameter<bool>("fusedSorting", false);
+
+  OMTFConfiguration omtfConfig;
+  omtfConfig.configure(&omtfParams);
+  omtfConfig.configureFromEdmParameterSet(fusedCfg);
+
+  const std::string patternsFile = edm::FileInPath(
+                                       "L1Trigger/L1TMuon/data/omtf_config/"
+                                       "Patterns_0x00012_oldSample_3_30Files_grouped1_classProb17_recalib2.xml")
+                                       .fullPath();
+
+  //each processor gets its own copy of the patterns
+  XMLConfigReader reader;
+  OMTFProcessor<GoldenPattern> fusedProc(
+      &omtfConfig, fusedCfg, reader.readPatterns<GoldenPattern>(omtfParams, patternsFile, false));
+
+  OMTFProcessor<GoldenPattern> scanProc(
+      &omtfConfig, scanCfg, reader.readPatterns<GoldenPattern>(omtfParams, patternsFile, false));
+
+  std::unique_ptr<OMTFProcessingContext> fusedContext = fusedProc.makeProcessingContext();
+  std::unique_ptr<OMTFProcessingContext> scanContext = scanProc.makeProcessingContext();
+  std::vector<std::unique_ptr<IOMTFEmulationObserver> > observers;
+
+  std::mt19937 generator(12345);
+  std::uniform_int_distribution<int> muonPhiDist(0, omtfConfig.nPhiBins() / 6);
+  std::uniform_int_distribution<int> deltaPhiDist(-100, 100);
+  std::uniform_int_distribution<int> phiBDist(-150, 150);
+  std::uniform_int_distribution<int> qualityDist(0, 6);
+  std::uniform_int_distribution<int> occupancyDist(0, 2);
+
+  const unsigned int nInputs = 20000;
+  const l1t::tftype mtfType = l1t::tftype::omtf_pos;
+
+  unsigned int nValidCandidates = 0;
+  unsigned int nDifferent = 0;
+  for (unsigned int iInput = 0; iInput < nInputs; iInput++) {
+    unsigned int iProcessor = iInput % omtfConfig.nProcessors();
+
+    //the stubs of one or two muons, so that there are both valid candidates and ghosts
+    OMTFinput input(&omtfConfig);
+    MuonStubPtrs2D& muonStubs = input.getMuonStubs();
+    unsigned int nMuons = 1 + generator() % 2;
+    for (unsigned int iMuon = 0; iMuon < nMuons; iMuon++) {
+      int muonPhi = muonPhiDist(generator);
+      for (unsigned int iLayer = 0; iLayer < muonStubs.size(); iLayer++) {
+        for (unsigned int iStubInput = 0; iStubInput < muonStubs[iLayer].size(); iStubInput++) {
+          if (muonStubs[iLayer][iStubInput] || occupancyDist(generator) != 0 || generator() % 4 != 0)
+            continue;
+          auto stub = std::make_shared<MuonStub>(muonPhi + deltaPhiDist(generator), phiBDist(generator));
+          stub->qualityHw = qualityDist(generator);
+          muonStubs[iLayer][iStubInput] = stub;
+        }
+      }
+    }
+
+    fusedProc.processInput(*fusedContext, iProcessor, mtfType, input, observers);
+    fusedProc.sortResults(*fusedContext, iProcessor, mtfType);
+    fusedProc.ghostBust(*fusedContext);
+
+    scanProc.processInput(*scanContext, iProcessor, mtfType, input, observers);
+    scanProc.sortResults(*scanContext, iProcessor, mtfType);
+    scanProc.ghostBust(*scanContext);
+
+    const auto& fusedCands = fusedContext->getRefHitCands();
+    const auto& scannedCands = scanContext->getRefHitCands();
+    bool same = fusedCands.size() == scannedCands.size();
+    for (unsigned int iCand = 0; same && iCand < fusedCands.size(); iCand++) {
+      same = sameCandidate(fusedCands[iCand], scannedCands[iCand]);
+      if (fusedCands[iCand].isValid())
+        nValidCandidates++;
+    }
+
+    if (same)
+      same = fusedProc.getFinalcandidates(iProcessor, mtfType, fusedContext->getGbCands()) ==
+             scanProc.getFinalcandidates(iProcessor, mtfType, scanContext->getGbCands());
+
+    if (!same) {
+      if (nDifferent < 10)
+        UNSCOPED_INFO("input " << iInput << " iProcessor " << iProcessor << ": the candidates differ\n" << input);
+      nDifferent++;
+    }
+  }
+
+  INFO("valid refHit candidates " << nValidCandidates);
+  REQUIRE(nValidCandidates > 0);
+  REQUIRE(nDifferent == 0);
+}
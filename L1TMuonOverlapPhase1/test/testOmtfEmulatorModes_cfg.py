@@ -0,0 +1,67 @@
+import FWCore.ParameterSet.Config as cms
+
+#runs the OMTF emulator in different modes on the digis from the omtfTestDigis.txt (see makeOmtfTestDigis.py)
+#and checks that all of them give the same candidates as the default, serial simOmtfDigis
+process = cms.Process("L1TMuonEmulationTest")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport.reportEvery = cms.untracked.int32(100)
+
+process.options = cms.untracked.PSet(numberOfThreads = cms.untracked.uint32(4),
+                                     numberOfStreams = cms.untracked.uint32(0))
+
+process.load('Configuration.Geometry.GeometryExtended2022Reco_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2022_realistic', '')
+
+#two runs, to check that the processor built in the first run is re-used correctly in the next one
+#(the event numbers start from 1 in every run, so the same digis are used in both runs)
+process.source = cms.Source("EmptySource", numberEventsInRun = cms.untracked.uint32(50))
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(100))
+
+process.omtfTestDigis = cms.EDProducer("OmtfTestDigiProducer",
+    digisFile = cms.FileInPath("L1Trigger/L1TMuonOverlapPhase1/test/omtfTestDigis.txt")
+)
+
+####Event Setup Producer
+process.load('L1Trigger.L1TMuonOverlapPhase1.fakeOmtfParams_cff')
+
+####OMTF Emulator
+process.load('L1Trigger.L1TMuonOverlapPhase1.simOmtfDigis_cfi')
+
+process.simOmtfDigis.srcDTPh = cms.InputTag('omtfTestDigis')
+process.simOmtfDigis.srcDTTh = cms.InputTag('omtfTestDigis')
+process.simOmtfDigis.srcCSC = cms.InputTag('omtfTestDigis')
+process.simOmtfDigis.srcRPC = cms.InputTag('omtfTestDigis')
+process.simOmtfDigis.lctCentralBx = cms.int32(8)
+process.simOmtfDigis.bxMin = cms.int32(-1)
+process.simOmtfDigis.bxMax = cms.int32(1)
+
+process.simOmtfDigisParallel = process.simOmtfDigis.clone(processorsInParallel = True)
+
+#the best candidates selected by scanning all results after the finalise, instead of during it
+process.simOmtfDigisNotFused = process.simOmtfDigis.clone(fusedSorting = cms.bool(False))
+
+process.simOmtfDigisPatternBank = process.simOmtfDigis.clone(processorType = "OMTFProcessorPatternBank")
+
+process.simOmtfDigisGlobal = cms.EDProducer("L1TMuonOverlapPhase1TrackProducerGlobal",
+                                            **process.simOmtfDigis.parameters_())
+
+process.omtfCandidatesComparator = cms.EDAnalyzer("OmtfCandidatesComparator",
+    reference = cms.InputTag("simOmtfDigis", "OMTF"),
+    tested = cms.VInputTag(cms.InputTag("simOmtfDigisParallel", "OMTF"),
+                           cms.InputTag("simOmtfDigisNotFused", "OMTF"),
+                           cms.InputTag("simOmtfDigisPatternBank", "OMTF"),
+                           cms.InputTag("simOmtfDigisGlobal", "OMTF")),
+    minCandidates = cms.uint32(1)
+)
+
+process.L1TMuonPath = cms.Path(process.omtfTestDigis
+                               + process.simOmtfDigis
+                               + process.simOmtfDigisParallel
+                               + process.simOmtfDigisNotFused
+                               + process.simOmtfDigisPatternBank
+                               + process.simOmtfDigisGlobal
+                               + process.omtfCandidatesComparator)
@@ -0,0 +1,40 @@
+import FWCore.ParameterSet.Config as cms
+
+#records the processor inputs of the digis from the omtfTestDigis.txt to the testOmtfProcessorBenchmark.bin,
+#which is then replayed by the omtfProcessorBenchmark in the testOmtfProcessorBenchmark (see the test/BuildFile.xml),
+#the benchmark fails if its candidates differ from the ones recorded here
+process = cms.Process("L1TMuonEmulationSnapshot")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+process.MessageLogger.cerr.FwkReport.reportEvery = cms.untracked.int32(100)
+
+process.load('Configuration.Geometry.GeometryExtended2022Reco_cff')
+process.load('Configuration.StandardSequences.MagneticField_cff')
+process.load('Configuration.StandardSequences.FrontierConditions_GlobalTag_cff')
+from Configuration.AlCa.GlobalTag import GlobalTag
+process.GlobalTag = GlobalTag(process.GlobalTag, 'auto:phase1_2022_realistic', '')
+
+process.source = cms.Source("EmptySource")
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(50))
+
+process.omtfTestDigis = cms.EDProducer("OmtfTestDigiProducer",
+    digisFile = cms.FileInPath("L1Trigger/L1TMuonOverlapPhase1/test/omtfTestDigis.txt")
+)
+
+####Event Setup Producer
+process.load('L1Trigger.L1TMuonOverlapPhase1.fakeOmtfParams_cff')
+
+####OMTF Emulator
+process.load('L1Trigger.L1TMuonOverlapPhase1.simOmtfDigis_cfi')
+
+#the same lctCentralBx is given to the omtfProcessorBenchmark
+process.simOmtfDigis.srcDTPh = cms.InputTag('omtfTestDigis')
+process.simOmtfDigis.srcDTTh = cms.InputTag('omtfTestDigis')
+process.simOmtfDigis.srcCSC = cms.InputTag('omtfTestDigis')
+process.simOmtfDigis.srcRPC = cms.InputTag('omtfTestDigis')
+process.simOmtfDigis.lctCentralBx = cms.int32(8)
+process.simOmtfDigis.bxMin = cms.int32(-1)
+process.simOmtfDigis.bxMax = cms.int32(1)
+process.simOmtfDigis.inputSnapshotsFileName = cms.string("testOmtfProcessorBenchmark.bin")
+
+process.L1TMuonPath = cms.Path(process.omtfTestDigis + process.simOmtfDigis)
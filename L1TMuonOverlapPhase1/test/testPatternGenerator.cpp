@@ -0,0 +1,284 @@
+/*
+ * testPatternGenerator.cpp
+ *
+ * Checks that the pdfs made by the PatternGenerator::upadatePdfs are exactly the same
+ * - if made by the patternGenFromPartialStat from the partial statistics of several patternGen jobs (each processing
+ *   a part of the sample and writing the partialStatFile) as if made by a single job processing the whole sample,
+ * - with the sparse statistics storage (sparsePatternStat) as with the dense one,
+ * - with the sparse storage merged from the partial statistics, which then allocates only the tiles filled
+ *   by the single job, while the partial statistics files keep only the non-zero bins.
+ * The statistics are filled with random stubs.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternWithStat.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/GoldenPatternsStatFile.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/XMLConfigReader.h"
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Tools/PatternGenerator.h"
+
+#include "CondFormats/L1TObjects/interface/L1TMuonOverlapParams.h"
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+  //the stubs of one simulated muon, as the PatternGenerator::updateStat gets them from the omtfCand
+  struct StatEvent {
+    unsigned int iGp;
+    unsigned int iRefLayer;
+    std::vector<int> statBins;  //[iLayer], 0 means no hit
+  };
+
+  //fills the statistics in the same way as the PatternGenerator::updateStat, but without the simMuon and omtfCand
+  class PatternGeneratorForTest : public PatternGenerator {
+  public:
+    using PatternGenerator::PatternGenerator;
+
+    void fill(const StatEvent& event) {
+      eventCntPerGp.at(event.iGp)++;
+      for (unsigned int iLayer = 0; iLayer < event.statBins.size(); iLayer++)
+        goldenPatterns.at(event.iGp)->updateStat(iLayer, event.iRefLayer, event.statBins[iLayer], 0, 1);
+    }
+  };
+
+  edm::ParameterSet makeEdmCfg(const std::string& patternGenerator, const std::string& optimisedPatsXmlFile) {
+    edm::ParameterSet edmCfg;
+    edmCfg.addParameter<std::string>("patternGenerator", patternGenerator);
+    edmCfg.addParameter<edm::InputTag>("simTracksTag", edm::InputTag("g4SimHits"));
+    edmCfg.addParameter<std::string>("optimisedPatsXmlFile", optimisedPatsXmlFile);
+    return edmCfg;
+  }
+
+  //the configuration, the patterns from the cms-data and the random events filling their statistics
+  class PatternGeneratorTestSetup {
+  public:
+    PatternGeneratorTestSetup() {
+      XMLConfigReader configReader;
+      configReader.setConfigFile(
+          edm::FileInPath("L1Trigger/L1TMuon/data/omtf_config/hwToLogicLayer_0x0008.xml").fullPath());
+      configReader.readConfig(&omtfParams);
+
+      omtfConfig.configure(&omtfParams);
+
+      patternsFile = edm::FileInPath(
+                         "L1Trigger/L1TMuon/data/omtf_config/"
+                         "Patterns_0x00012_oldSample_3_30Files_grouped1_classProb17_recalib2.xml")
+                         .fullPath();
+
+      GoldenPatternVec<GoldenPatternWithStat> gps = readPatterns();
+      std::vector<unsigned int> filledGps;
+      for (unsigned int iGp = 0; iGp < gps.size(); iGp++) {
+        if (gps[iGp]->key().thePt != 0)
+          filledGps.push_back(iGp);
+      }
+      REQUIRE(!filledGps.empty());
+
+      //the statistics have 1024 bins, see the PatternGenerator::initPatternGen
+      const int statBinsCnt = 1024;
+      std::mt19937 generator(12345);
+      std::normal_distribution<double> phiDistDist(statBinsCnt / 2, 40);
+
+      const unsigned int nEvents = 200000;
+      events.resize(nEvents);
+      for (auto& event : events) {
+        event.iGp = filledGps[generator() % filledGps.size()];
+        event.iRefLayer = generator() % omtfConfig.nRefLayers();
+        event.statBins.resize(omtfConfig.nLayers(), 0);
+        for (auto& statBin : event.statBins) {
+          if (generator() % 3 == 0)
+            continue;
+          int phiDist = std::lround(phiDistDist(generator));
+          if (phiDist > 0 && phiDist < statBinsCnt)
+            statBin = phiDist;
+        }
+      }
+    }
+
+    GoldenPatternVec<GoldenPatternWithStat> readPatterns() {
+      return reader.readPatterns<GoldenPatternWithStat>(omtfParams, patternsFile, false);
+    }
+
+    L1TMuonOverlapParams omtfParams;
+    OMTFConfiguration omtfConfig;
+    XMLConfigReader reader;
+    std::string patternsFile;
+    std::vector<StatEvent> events;
+  };
+
+  ///returns the number of the patterns with different pdfs or meanDistPhi
+  unsigned int comparePdfs(const GoldenPatternVec<GoldenPatternWithStat>& gps,
+                           const GoldenPatternVec<GoldenPatternWithStat>& otherGps) {
+    REQUIRE(gps.size() == otherGps.size());
+    unsigned int nDifferent = 0;
+    unsigned int nFilledPdfValues = 0;
+    for (unsigned int iGp = 0; iGp < gps.size(); iGp++) {
+      auto& gp = *gps[iGp];
+      auto& otherGp = *otherGps[iGp];
+      for (unsigned int iLayer = 0; iLayer < gp.getPdf().size(); ++iLayer) {
+        for (unsigned int iRefLayer = 0; iRefLayer < gp.getPdf()[iLayer].size(); ++iRefLayer) {
+          for (auto pdfValue : gp.getPdf()[iLayer][iRefLayer])
+            nFilledPdfValues += (pdfValue != 0);
+        }
+      }
+
+      if (gp.getPdf() == otherGp.getPdf() && gp.getMeanDistPhi() == otherGp.getMeanDistPhi())
+        continue;
+
+      if (nDifferent < 10)
+        UNSCOPED_INFO("the pdfs of the pattern " << gp.key() << " differ");
+      nDifferent++;
+    }
+
+    INFO("non-zero pdf values " << nFilledPdfValues);
+    REQUIRE(nFilledPdfValues > 0);
+    return nDifferent;
+  }
+}  // namespace
+
+TEST_CASE("pdfs from the merged partial statistics are the same as from a single job", "[PatternGenerator]") {
+  PatternGeneratorTestSetup setup;
+  OMTFConfiguration& omtfConfig = setup.omtfConfig;
+  auto& events = setup.events;
+
+  //the single job processing the whole sample
+  GoldenPatternVec<GoldenPatternWithStat> singleJobGps = setup.readPatterns();
+  PatternGeneratorForTest singleJob(
+      makeEdmCfg("patternGen", "testPatternGenerator_merge_singleJob.xml"), &omtfConfig, singleJobGps, nullptr);
+  for (auto& event : events)
+    singleJob.fill(event);
+  singleJob.endJob();
+
+  //the jobs processing the parts of the sample, writing only the partial statistics
+  const unsigned int nParts = 3;
+  std::vector<std::string> partialStatFiles;
+  for (unsigned int iPart = 0; iPart < nParts; iPart++) {
+    partialStatFiles.push_back("testPatternGenerator_merge_part" + std::to_string(iPart) + ".bin");
+
+    edm::ParameterSet partCfg =
+        makeEdmCfg("patternGen", "testPatternGenerator_merge_part" + std::to_string(iPart) + ".xml");
+    partCfg.addParameter<std::string>("partialStatFile", partialStatFiles.back());
+
+    GoldenPatternVec<GoldenPatternWithStat> partGps = setup.readPatterns();
+    PatternGeneratorForTest partJob(partCfg, &omtfConfig, partGps, nullptr);
+    for (unsigned int iEvent = iPart; iEvent < events.size(); iEvent += nParts)
+      partJob.fill(events[iEvent]);
+    partJob.endJob();
+  }
+
+  //merging the partial statistics and making the pdfs
+  edm::ParameterSet mergeCfg = makeEdmCfg("patternGenFromPartialStat", "testPatternGenerator_merge_merged.xml");
+  mergeCfg.addParameter<std::vector<std::string> >("partialStatFiles", partialStatFiles);
+
+  GoldenPatternVec<GoldenPatternWithStat> mergedGps = setup.readPatterns();
+  PatternGeneratorForTest mergeJob(mergeCfg, &omtfConfig, mergedGps, nullptr);
+  mergeJob.endJob();
+
+  REQUIRE(comparePdfs(singleJobGps, mergedGps) == 0);
+}
+
+TEST_CASE("pdfs from the sparse statistics storage are the same as from the dense one", "[PatternGenerator]") {
+  PatternGeneratorTestSetup setup;
+  OMTFConfiguration& omtfConfig = setup.omtfConfig;
+
+  GoldenPatternVec<GoldenPatternWithStat> denseGps = setup.readPatterns();
+  PatternGeneratorForTest denseJob(
+      makeEdmCfg("patternGen", "testPatternGenerator_dense.xml"), &omtfConfig, denseGps, nullptr);
+
+  edm::ParameterSet sparseCfg = makeEdmCfg("patternGen", "testPatternGenerator_sparse.xml");
+  sparseCfg.addParameter<bool>("sparsePatternStat", true);
+  GoldenPatternVec<GoldenPatternWithStat> sparseGps = setup.readPatterns();
+  PatternGeneratorForTest sparseJob(sparseCfg, &omtfConfig, sparseGps, nullptr);
+
+  for (auto& gp : sparseGps) {
+    if (gp->key().thePt != 0)
+      REQUIRE(gp->getStatistics().getStorage() == GoldenPatternWithStat::StatArrayType::Storage::sparse);
+  }
+
+  for (auto& event : setup.events) {
+    denseJob.fill(event);
+    sparseJob.fill(event);
+  }
+  denseJob.endJob();
+  sparseJob.endJob();
+
+  REQUIRE(comparePdfs(denseGps, sparseGps) == 0);
+}
+
+TEST_CASE("sparse statistics merged from the partial statistics allocate only the filled tiles", "[PatternGenerator]") {
+  PatternGeneratorTestSetup setup;
+  OMTFConfiguration& omtfConfig = setup.omtfConfig;
+  auto& events = setup.events;
+
+  edm::ParameterSet singleJobCfg = makeEdmCfg("patternGen", "testPatternGenerator_sparseMerge_singleJob.xml");
+  singleJobCfg.addParameter<bool>("sparsePatternStat", true);
+  GoldenPatternVec<GoldenPatternWithStat> singleJobGps = setup.readPatterns();
+  PatternGeneratorForTest singleJob(singleJobCfg, &omtfConfig, singleJobGps, nullptr);
+  for (auto& event : events)
+    singleJob.fill(event);
+  singleJob.endJob();
+
+  const unsigned int nParts = 3;
+  std::vector<std::string> partialStatFiles;
+  for (unsigned int iPart = 0; iPart < nParts; iPart++) {
+    partialStatFiles.push_back("testPatternGenerator_sparseMerge_part" + std::to_string(iPart) + ".bin");
+
+    edm::ParameterSet partCfg =
+        makeEdmCfg("patternGen", "testPatternGenerator_sparseMerge_part" + std::to_string(iPart) + ".xml");
+    partCfg.addParameter<bool>("sparsePatternStat", true);
+    partCfg.addParameter<std::string>("partialStatFile", partialStatFiles.back());
+
+    GoldenPatternVec<GoldenPatternWithStat> partGps = setup.readPatterns();
+    PatternGeneratorForTest partJob(partCfg, &omtfConfig, partGps, nullptr);
+    for (unsigned int iEvent = iPart; iEvent < events.size(); iEvent += nParts)
+      partJob.fill(events[iEvent]);
+    partJob.endJob();
+  }
+
+  //each event adds at most one count per layer
+  GoldenPatternsStatFile partialStat(partialStatFiles[0]);
+  std::size_t nStoredBins = 0;
+  for (auto& patternStat : partialStat.getPatterns()) {
+    REQUIRE(patternStat.record.nBins == patternStat.statistics.size());
+    for (auto& binCount : patternStat.statistics)
+      REQUIRE(binCount.count != 0);
+    nStoredBins += patternStat.statistics.size();
+  }
+  REQUIRE(nStoredBins > 0);
+  REQUIRE(nStoredBins <= (events.size() / nParts + 1) * omtfConfig.nLayers());
+
+  edm::ParameterSet mergeCfg = makeEdmCfg("patternGenFromPartialStat", "testPatternGenerator_sparseMerge_merged.xml");
+  mergeCfg.addParameter<bool>("sparsePatternStat", true);
+  mergeCfg.addParameter<std::vector<std::string> >("partialStatFiles", partialStatFiles);
+
+  GoldenPatternVec<GoldenPatternWithStat> mergedGps = setup.readPatterns();
+  PatternGeneratorForTest mergeJob(mergeCfg, &omtfConfig, mergedGps, nullptr);
+  mergeJob.endJob();
+
+  REQUIRE(comparePdfs(singleJobGps, mergedGps) == 0);
+
+  std::size_t mergedBytes = 0;
+  std::size_t denseBytes = 0;
+  for (unsigned int iGp = 0; iGp < mergedGps.size(); iGp++) {
+    if (mergedGps[iGp]->key().thePt == 0)
+      continue;
+
+    auto& mergedStatistics = mergedGps[iGp]->getStatistics();
+    INFO("pattern " << mergedGps[iGp]->key());
+    REQUIRE(mergedStatistics.getStorage() == GoldenPatternWithStat::StatArrayType::Storage::sparse);
+    //the zero counts of the partial statistics must not allocate the tiles
+    REQUIRE(mergedStatistics.allocatedBytes() == singleJobGps[iGp]->getStatistics().allocatedBytes());
+    mergedBytes += mergedStatistics.allocatedBytes();
+    denseBytes += mergedStatistics.num_elements() * sizeof(GoldenPatternWithStat::StatArrayType::ValueType);
+  }
+
+  INFO("merged sparse statistics " << mergedBytes << " B, dense " << denseBytes << " B");
+  REQUIRE(mergedBytes < denseBytes);
+}
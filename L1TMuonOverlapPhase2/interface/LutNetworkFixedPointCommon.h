@@ -10,9 +10,15 @@
 
 #include <ap_fixed.h>
 #include <ap_int.h>
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
 #include <vector>
 #include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
 
 #include <boost/property_tree/ptree.hpp>
 
@@ -32,6 +38,23 @@ const ap_fixed<W, I> max_ap_fixed() {
     //AP_SAT Saturate the value to the maximum value in case of overflow
 }
 
+//integer version of the conversion of the raw value with F fractional bits to F - shift fractional bits,
+//with the AP_RND_CONV (round half to even) and AP_SAT to [min, max] (in the raw bits of the result)
+inline int64_t roundConvergentSat(int64_t raw, int shift, int64_t min, int64_t max) {
+    int64_t result = raw;
+    if(shift > 0) {
+        result = raw >> shift; //floor
+        int64_t remainder = raw & ((int64_t(1) << shift) - 1);
+        int64_t half = int64_t(1) << (shift - 1);
+        if(remainder > half || (remainder == half && (result & 1)))
+            result++;
+    }
+    else if(shift < 0) {
+        result = raw * (int64_t(1) << -shift);
+    }
+    return std::clamp(result, min, max);
+}
+
 #define PUT_VAR(tree, keyPath, var) tree.put( (keyPath) + "." + #var, (var) );
 
 #define CHECK_VAR(tree, keyPath, var) if( (var) != tree.get<int>( (keyPath) + "." + #var) ) throw std::runtime_error( (keyPath) + "." + #var + " has different value in the file then given");
@@ -60,6 +83,55 @@ public:
 
     //pt in the hardware scale, ptGeV = (ptHw -1) / 2
     virtual int getCalibratedHwPt() = 0;
+
+    //integer only version of the run() followed by the getCalibratedHwPt(), gives bit-identical results,
+    //returns the calibrated hw pt.
+    //It does not modify the network (the intermediate values are on the stack), so can be called concurrently
+    virtual int runInt(const std::vector<float>& inputs, float noHitVal, std::vector<double>& nnResult) const = 0;
+
+    //prepares the int LUTs used by the runInt(), called in the load(),
+    //must be called again if the LUTs are modified after the load
+    virtual void compileIntLuts() = 0;
+
+    //compares the runInt() with the run() and getCalibratedHwPt() for the nRandomInputs random input vectors,
+    //throws std::runtime_error on the first difference
+    void checkIntInference(unsigned int inputCnt, float noHitVal, unsigned int nRandomInputs, unsigned int seed = 1) {
+        std::mt19937 generator(seed);
+        std::uniform_real_distribution<float> probability(0, 1);
+        //slightly outside the input range, to check the saturation
+        std::uniform_real_distribution<float> inputValue(-2, noHitVal + 4);
+
+        std::vector<float> inputs(inputCnt);
+        std::vector<double> nnResult(2);
+        std::vector<double> nnResultInt(2);
+
+        for(unsigned int iSample = 0; iSample < nRandomInputs; iSample++) {
+            //different fraction of the no-hit inputs, to cover all layer1Bias values
+            float noHitProbability = probability(generator);
+            for(auto& input : inputs) {
+                if(probability(generator) < noHitProbability)
+                    input = noHitVal;
+                else if(iSample % 2)
+                    input = inputValue(generator);
+                else //exactly on the input LSB grid (1/16), i.e. on the boundaries of the interpolation
+                    input = std::floor(inputValue(generator) * 16) / 16;
+            }
+
+            run(inputs, noHitVal, nnResult);
+            int calibratedHwPt = getCalibratedHwPt();
+            int calibratedHwPtInt = runInt(inputs, noHitVal, nnResultInt);
+
+            if(nnResult != nnResultInt || calibratedHwPt != calibratedHwPtInt) {
+                std::ostringstream ostr;
+                ostr<<"LutNetworkFixedPointRegressionBase::checkIntInference: runInt differs from run, sample "<<iSample
+                    <<" nnResult "<<nnResult[0]<<" "<<nnResult[1]<<" calibratedHwPt "<<calibratedHwPt
+                    <<" int: nnResult "<<nnResultInt[0]<<" "<<nnResultInt[1]<<" calibratedHwPt "<<calibratedHwPtInt<<" inputs";
+                for(auto& input : inputs)
+                    ostr<<" "<<input;
+                throw std::runtime_error(ostr.str());
+            }
+        }
+    }
 };
 
 }
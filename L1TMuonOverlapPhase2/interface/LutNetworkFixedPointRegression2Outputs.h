@@ -120,6 +120,70 @@ public:
         LogTrace("l1tOmtfEventPrint")<<"layer3_0_out[0] "<<layer3_0_out[0]<<" layer3_1_out[0] "<<layer3_1_out[0]<<std::endl;
     }
 
+    int runInt(const std::vector<float>& inputs, float noHitVal, std::vector<double>& nnResult) const override {
+        if(inputs.size() != inputSize)
+            throw std::runtime_error("LutNetworkFixedPointRegression2Outputs::runInt: wrong number of inputs");
+
+        //all intermediate values are on the stack, as the raw bits of the corresponding ap_fixed values from the runWithInterpolation()
+        std::array<uint32_t, inputSize> layer1Input;
+        unsigned int noHitsCnt = 0;
+        for(unsigned int iInput = 0; iInput < inputs.size(); iInput++) {
+            layer1Input[iInput] = LutLayer1::inputFromFloat(inputs[iInput]);
+            if(inputs[iInput] == noHitVal)
+                noHitsCnt++;
+        }
+
+        //the layer1Bias is ap_uint<layer2_input_I>, so the bias is wrapped
+        uint32_t layer1BiasInt = (noHitsCnt << noHitCntShift) & ((1u << layer2_input_I) - 1);
+
+        std::array<int32_t, layer1_neurons> layer1Out;
+        lutLayer1.runInt(layer1Input.data(), layer1Out.data());
+
+        std::array<uint32_t, layer1_neurons> layer2Input;
+        for(unsigned int i = 0; i < layer1Out.size(); i++) {
+            uint32_t layer1OutWithBias = LutLayer1::outWithOffsetInt(layer1Out[i]) + (layer1BiasInt << layer2_input_F);
+            layer2Input[i] = std::min(layer1OutWithBias, LutLayer2::maxInput); //AP_SAT
+        }
+
+        std::array<int32_t, layer2_neurons> layer2Out;
+        lutLayer2.runInt(layer2Input.data(), layer2Out.data());
+
+        std::array<uint32_t, layer2_neurons> layer3Input;
+        for(unsigned int i = 0; i < layer2Out.size(); i++)
+            layer3Input[i] = LutLayer2::outWithOffsetInt(layer2Out[i]);
+
+        int32_t layer3_0_sum = 0;
+        int32_t layer3_1_sum = 0;
+        lutLayer3_0.runInt(layer3Input.data(), &layer3_0_sum);
+        lutLayer3_1.runInt(layer3Input.data() + layer3_0_inputCnt, &layer3_1_sum);
+
+        //ap_ufixed<output0_I+output0_F, output0_I, AP_RND_CONV, AP_SAT> and ap_fixed <output1_I+output1_F, output1_I, AP_RND_CONV, AP_SAT>
+        int64_t layer3_0_out = roundConvergentSat(layer3_0_sum, layer3_0_lut_F - output0_F, 0, (int64_t(1) << (output0_I + output0_F)) - 1);
+        int64_t layer3_1_out = roundConvergentSat(layer3_1_sum, layer3_1_lut_F - output1_F,
+                                                  -(int64_t(1) << (output1_I + output1_F - 1)), (int64_t(1) << (output1_I + output1_F - 1)) - 1);
+
+        nnResult[0] = std::ldexp(static_cast<double>(layer3_0_out), -output0_F);
+        nnResult[1] = std::ldexp(static_cast<double>(layer3_1_out), -output1_F);
+
+        //as in the getCalibratedHwPt(): the lutAddr is ap_ufixed<output0_I+output0_F+output0_F, output0_I+output0_F, AP_RND_CONV, AP_SAT>,
+        //the lutAddr<<output0_F drops the upper output0_F bits, and the to_uint() the fractional bits
+        const int lutAddr_W = output0_I + output0_F + output0_F;
+        int64_t lutAddr = roundConvergentSat(layer3_0_sum, layer3_0_lut_F - output0_F, 0, (int64_t(1) << lutAddr_W) - 1);
+        lutAddr = ((lutAddr << output0_F) & ((int64_t(1) << lutAddr_W) - 1)) >> output0_F;
+
+        return intPtCalibrationArray[lutAddr];
+    }
+
+    void compileIntLuts() override {
+        lutLayer1.compileIntLuts();
+        lutLayer2.compileIntLuts();
+        lutLayer3_0.compileIntLuts();
+        lutLayer3_1.compileIntLuts();
+
+        for(unsigned int i = 0; i < ptCalibrationArray.size(); i++)
+            intPtCalibrationArray[i] = ptCalibrationArray[i].to_uint();
+    }
+
     //pt in the hardware scale, ptGeV = (ptHw -1) / 2
     int getCalibratedHwPt() override {
         auto lutAddr = ap_ufixed<output0_I+output0_F+output0_F, output0_I+output0_F, AP_RND_CONV, AP_SAT>(lutLayer3_0.getLutOutSum()[0]);
@@ -180,6 +244,10 @@ public:
                 throw std::runtime_error("LutNetworkFixedPointRegression2Outputs::read: number of items get from file is smaller than lut size");
             }
         }
+
+        //the LUTs of the layers are compiled in their load()
+        for(unsigned int i = 0; i < ptCalibrationArray.size(); i++)
+            intPtCalibrationArray[i] = ptCalibrationArray[i].to_uint();
     }
 
     auto& getPtCalibrationArray() {
@@ -193,6 +261,9 @@ private:
     //ptCalibrationArray size should be 1024, the LSB of the input 0.25 GeV,
     //the output is int, with range 0...511, the LSB of output 0.5 GeV
     std::array<ap_uint<9>, 1<<(output0_I+output0_F)> ptCalibrationArray;
+
+    //ptCalibrationArray for the runInt()
+    std::array<int, 1<<(output0_I+output0_F)> intPtCalibrationArray;
 };
 
 } /* namespace lutNN */
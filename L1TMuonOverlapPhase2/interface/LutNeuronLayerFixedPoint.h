@@ -12,8 +12,12 @@
 
 #include <ap_fixed.h>
 #include <ap_int.h>
+#include <algorithm>
 #include <array>
+#include <cmath>
+#include <cstdint>
 #include <limits>
+#include <vector>
 
 #include <boost/property_tree/ptree.hpp>
 
@@ -44,6 +48,10 @@ public:
 
     typedef std::array<ap_fixed<lutOutSum_W, lutOutSum_I> , neurons> lutSumArrayType;
 
+    //the runInt works on the raw bits of the above types, the intermediate values must fit into the int32_t
+    static_assert(input_F + lut_W + 2 <= 32, "the interpolation does not fit into int32_t");
+    static_assert(lutOutSum_W < 32 && output_I + lut_F < 32, "the lutOutSum does not fit into int32_t");
+
     LutNeuronLayerFixedPoint()  { //FIXME initialise name(name)
         //static_assert(lut_I <= (output_I - ceil(log2(inputSize)) ), "not correct lut_I, output_I  and inputSize"); //TODO
 
@@ -128,6 +136,30 @@ public:
                 }
             }
         }
+
+        compileIntLuts();
+    }
+
+    //converts the lutArray to the int LUTs used by the runInt,
+    //must be called again if the lutArray is modified after the load (e.g. by getLutArray())
+    void compileIntLuts() {
+        intLutValues.assign(inputSize * lutSize * neurons, 0);
+        intLutDerivatives.assign(inputSize * lutSize * neurons, 0);
+
+        for(unsigned int iInput = 0; iInput < inputSize; iInput++) {
+            for(unsigned int iNeuron = 0; iNeuron < neurons; iNeuron++) {
+                auto& lut = lutArray[iInput][iNeuron];
+                for(unsigned int address = 0; address < lutSize; address++) {
+                    int32_t value = lutRawValue(lut[address]);
+                    int32_t valuePlus1 = (address + 1 < lutSize) ? lutRawValue(lut[address + 1]) : value;
+
+                    unsigned int index = (iInput * lutSize + address) * neurons + iNeuron;
+                    //multiplied by 2^input_F, i.e. in the same scale as the fractionalPart * derivative
+                    intLutValues[index] = value * (1 << input_F);
+                    intLutDerivatives[index] = valuePlus1 - value;
+                }
+            }
+        }
     }
 
     lutSumArrayType&
@@ -169,6 +201,49 @@ public:
         return lutOutSumArray;
     }
 
+    //integer only version of the runWithInterpolation, gives bit-identical results
+    //inputs - raw bits of the inputArrayType values, lutOutSums[neurons] - raw bits of the lutSumArrayType values,
+    //the layer is not modified, so it can be called concurrently (the compileIntLuts() must be called before)
+    void runInt(const uint32_t* inputs, int32_t* lutOutSums) const {
+        for(unsigned int iNeuron = 0; iNeuron < neurons; iNeuron++)
+            lutOutSums[iNeuron] = 0;
+
+        for(unsigned int iInput = 0; iInput < inputSize; iInput++) {
+            //the address and fractionalPart is the same for all neurons, so the int LUTs are ordered [iInput][address][iNeuron]
+            uint32_t address = inputs[iInput] >> input_F;
+            int32_t fractionalPart = inputs[iInput] & ((1u << input_F) - 1);
+
+            const int32_t* values = intLutValues.data() + (iInput * lutSize + address) * neurons;
+            const int32_t* derivatives = intLutDerivatives.data() + (iInput * lutSize + address) * neurons;
+
+            //the ap_fixed lutOutSum += result truncates the result to the lut_F fractional bits (floor)
+            for(unsigned int iNeuron = 0; iNeuron < neurons; iNeuron++)
+                lutOutSums[iNeuron] += (values[iNeuron] + fractionalPart * derivatives[iNeuron]) >> input_F;
+        }
+
+        //the wrap to the lutOutSum_W bits (AP_WRAP) can be done once at the end, as the sum is modulo 2^lutOutSum_W anyway
+        for(unsigned int iNeuron = 0; iNeuron < neurons; iNeuron++)
+            lutOutSums[iNeuron] = signExtend(lutOutSums[iNeuron], lutOutSum_W);
+    }
+
+    //raw bits of the inputArrayType value assigned from the float (AP_TRN, AP_SAT)
+    static uint32_t inputFromFloat(float input) {
+        double value = std::floor(std::ldexp(static_cast<double>(input), input_F));
+        if(!(value > 0))
+            return 0;
+        if(value >= maxInput)
+            return maxInput;
+        return static_cast<uint32_t>(value);
+    }
+
+    //as getOutWithOffset(), but on the raw bits, the result is the raw bits of the next layer input
+    static uint32_t outWithOffsetInt(int32_t lutOutSum) {
+        int64_t out = static_cast<int64_t>(lutOutSum) + (int64_t(1) << (output_I - 1 + lut_F));
+        return std::clamp<int64_t>(out, 0, (int64_t(1) << output_W) - 1);
+    }
+
+    static constexpr uint32_t maxInput = (uint32_t(1) << input_W) - 1;
+
     //Output without offset
     auto& getLutOutSum() {
         return lutOutSumArray;
@@ -191,6 +266,18 @@ public:
     }
 
 private:
+    static int32_t lutRawValue(const ap_fixed<lut_W, lut_I>& value) {
+        return signExtend(static_cast<int32_t>(value.bits_to_uint64()), lut_W);
+    }
+
+    static int32_t signExtend(int32_t value, int width) {
+        uint32_t mask = (uint32_t(1) << width) - 1;
+        uint32_t bits = static_cast<uint32_t>(value) & mask;
+        if(bits & (uint32_t(1) << (width - 1)))
+            bits |= ~mask;
+        return static_cast<int32_t>(bits);
+    }
+
     lutSumArrayType lutOutSumArray;
     std::array<ap_ufixed<output_W, output_I, AP_TRN, AP_SAT> , neurons> outputArray;
 
@@ -199,6 +286,10 @@ private:
 
     std::array< std::array<std::array<ap_fixed<lut_W, lut_I> , lutSize>, neurons>, inputSize> lutArray; //[inputNum][outputNum =  neuronNum][address]
 
+    //the lutArray converted by the compileIntLuts(), [inputNum][address][neuronNum]
+    std::vector<int32_t> intLutValues; //lut[address] * 2^input_F
+    std::vector<int32_t> intLutDerivatives; //lut[address + 1] - lut[address]
+
     std::string name;
 };
 
@@ -21,9 +21,16 @@ public:
   std::vector<float> getPts(AlgoMuons::value_type& algoMuon,
       std::vector<std::unique_ptr<IOMTFEmulationObserver> >& observers) override;
 
+  //the network is run with the runInt(), which does not modify it, unless the validation is on
+  bool isReentrant() const override { return intInferenceValidation == 0; }
+
 private:
   unique_ptr<lutNN::LutNetworkFixedPointRegressionBase> lutNetworkFP;
 
+  //if > 0, the number of random input vectors for which the runInt() is compared with the ap_fixed run() at the construction,
+  //then also the result of every candidate is compared
+  unsigned int intInferenceValidation = 0;
+
 };
 
 
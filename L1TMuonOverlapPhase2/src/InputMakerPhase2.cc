@@ -56,12 +56,11 @@ void DtPhase2DigiToStubsConverterOmtf::addDTphiDigi(MuonStubPtrs2D& muonStubsInL
   if (digi.quality() < config->getMinDtPhiQuality())
     return;
 
-  unsigned int hwNumber = config->getLayerNumber(detid.rawId());
-  if (config->getHwToLogicLayer().find(hwNumber) == config->getHwToLogicLayer().end())
+  int logicLayer = config->getLogicLayer(config->getLayerNumber(detid.rawId()));
+  if (logicLayer < 0)
     return;
 
-  auto iter = config->getHwToLogicLayer().find(hwNumber);
-  unsigned int iLayer = iter->second;
+  unsigned int iLayer = logicLayer;
   unsigned int iInput = OMTFinputMaker::getInputNumber(config, detid.rawId(), iProcessor, procTyp);
   //MuonStub& stub = muonStubsInLayers[iLayer][iInput];
   MuonStub stub;
@@ -88,7 +87,7 @@ void DtPhase2DigiToStubsConverterOmtf::addDTphiDigi(MuonStubPtrs2D& muonStubsInL
   stub.logicLayer = iLayer;
   stub.detId = detid;
 
-  OMTFinputMaker::addStub(config, muonStubsInLayers, iLayer, iInput, stub);
+  OMTFinputMaker::addStub(config, muonStubsInLayers, iLayer, iInput, stub, stubsArena);
 }
 
 void DtPhase2DigiToStubsConverterOmtf::addDTetaStubs(MuonStubPtrs2D& muonStubsInLayers,
@@ -8,6 +8,7 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/Framework/interface/EventSetup.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/Utilities/interface/Exception.h"
 
 #include "DataFormats/MuonDetId/interface/CSCDetId.h"
 
@@ -64,6 +65,15 @@ PtAssignmentNNRegression::PtAssignmentNNRegression(const edm::ParameterSet& edmC
     edm::LogImportant("OMTFReconstruction") <<" "<<__FUNCTION__<<":"<<__LINE__<<" networkFile "<<networkFile<<std::endl;
     lutNetworkFP->load(networkFile);
     edm::LogImportant("OMTFReconstruction") <<" "<<__FUNCTION__<<":"<<__LINE__<<std::endl;
+
+    if(edmCfg.exists("nnIntInferenceValidation"))
+      intInferenceValidation = edmCfg.getParameter<unsigned int>("nnIntInferenceValidation");
+
+    if(intInferenceValidation) {
+      lutNetworkFP->checkIntInference(networkInputSize, 1023., intInferenceValidation);
+      edm::LogImportant("OMTFReconstruction") <<" "<<__FUNCTION__<<":"<<__LINE__<<" runInt checked with "
+          <<intInferenceValidation<<" random inputs, the results are the same as of the ap_fixed run"<<std::endl;
+    }
   }
 
 }
@@ -225,7 +235,14 @@ std::vector<float> PtAssignmentNNRegression::getPts(AlgoMuons::value_type& algoM
   LogTrace("l1tOmtfEventPrint") <<" "<<__FUNCTION__<<":"<<__LINE__<<std::endl;
 
   std::vector<double> nnResult(outputCnt);
-  lutNetworkFP->run(inputs, noHitVal, nnResult);
+  int calibratedHwPt = lutNetworkFP->runInt(inputs, noHitVal, nnResult);
+
+  if(intInferenceValidation) {
+    std::vector<double> nnResultApFixed(outputCnt);
+    lutNetworkFP->run(inputs, noHitVal, nnResultApFixed);
+    if(nnResultApFixed != nnResult || lutNetworkFP->getCalibratedHwPt() != calibratedHwPt)
+      throw cms::Exception("PtAssignmentNNRegression::getPts: the runInt result is different than of the ap_fixed run");
+  }
 
   LogTrace("l1tOmtfEventPrint") <<" "<<__FUNCTION__<<":"<<__LINE__<<std::endl;
 
@@ -238,7 +255,7 @@ std::vector<float> PtAssignmentNNRegression::getPts(AlgoMuons::value_type& algoM
   pts.emplace_back(pt);
 
   //algoMuon->setPtNN(omtfConfig->ptGevToHw(nnResult.at(0)));
-  algoMuon->setPtNN(lutNetworkFP->getCalibratedHwPt());
+  algoMuon->setPtNN(calibratedHwPt);
 
   algoMuon->setChargeNN(nnResult[1] >= 0 ? 1 : -1);
 
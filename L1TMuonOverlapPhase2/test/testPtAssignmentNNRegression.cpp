@@ -0,0 +1,33 @@
+/*
+ * testPtAssignmentNNRegression.cpp
+ *
+ * Checks that the integer-only inference of the LUT network (runInt) used by the PtAssignmentNNRegression gives
+ * bit-identical results as the ap_fixed run() and getCalibratedHwPt(), on random inputs and with the network from the
+ * cms-data. The comparison is the one done at the construction when the nnIntInferenceValidation is set.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "L1Trigger/L1TMuonOverlapPhase1/interface/Omtf/OMTFConfiguration.h"
+#include "L1Trigger/L1TMuonOverlapPhase2/interface/PtAssignmentNNRegression.h"
+
+#include "FWCore/ParameterSet/interface/FileInPath.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include <memory>
+
+TEST_CASE("runInt of the LUT network gives the same pt as the ap_fixed run", "[PtAssignmentNNRegression]") {
+  const std::string networkFile =
+      edm::FileInPath("L1Trigger/L1TMuon/data/omtf_config/lutNN_omtfRegression_v59_FP.xml").fullPath();
+
+  //the configuration is not used in the constructor
+  OMTFConfiguration omtfConfig;
+
+  edm::ParameterSet edmCfg;
+  edmCfg.addParameter<unsigned int>("nnIntInferenceValidation", 200000);
+
+  //the checkIntInference throws std::runtime_error with the inputs of the first different sample
+  std::unique_ptr<PtAssignmentNNRegression> ptAssignment;
+  REQUIRE_NOTHROW(ptAssignment = std::make_unique<PtAssignmentNNRegression>(edmCfg, &omtfConfig, networkFile));
+}